@@ -0,0 +1,86 @@
+/*
+ * Mesure la copie et le remplissage d'un bloc de 64 mots : boucle de MOV case par case
+ * contre une seule instruction MOVS / STOS (CX = 64).
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_blocs_memoire bench/bench_blocs_memoire.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_blocs_memoire [iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/assembleur.h"
+#include "../include/interpreteur.h"
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Assemble `corps` répété `iterations` fois (compteur en mémoire : le corps utilise
+// AX..DX) et retourne le temps d'exécution. a occupe DS[0..63], b DS[64..127].
+static double mesurer(const char *corps, long iterations) {
+    char source[1024];
+    snprintf(source, sizeof(source),
+             ".DATA\n"
+             "a DW 64 DUP(1)\n"
+             "b DW 64 DUP(0)\n"
+             "n DW %ld\n"
+             ".CODE\n"
+             "debut: MOV BX, 0\n"
+             "%s"
+             "MOV AX, [n]\n"
+             "ADD AX, -1\n"
+             "MOV [n], AX\n"
+             "CMP AX, 0\n"
+             "JNZ debut\n",
+             iterations, corps);
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) exit(EXIT_FAILURE);
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    if (!cpu || load_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: chargement impossible\n");
+        exit(EXIT_FAILURE);
+    }
+    double debut = maintenant();
+    if (run_decoded_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: échec d'exécution\n");
+        exit(EXIT_FAILURE);
+    }
+    double duree = maintenant() - debut;
+    cpu_destroy(cpu);
+    free_program(prog);
+    return duree;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 100000;
+
+    double t_copie = mesurer("copie: MOV AX, [DS:BX]\n"
+                             "MOV DX, BX\n"
+                             "ADD DX, 64\n"
+                             "MOV [DS:DX], AX\n"
+                             "ADD BX, 1\n"
+                             "CMP BX, 64\n"
+                             "JNZ copie\n", iterations);
+    double t_movs = mesurer("MOV CX, 64\n"
+                            "MOVS [64], [0]\n", iterations);
+    double t_remplit = mesurer("remplit: MOV [DS:BX], 7\n"
+                               "ADD BX, 1\n"
+                               "CMP BX, 64\n"
+                               "JNZ remplit\n", iterations);
+    double t_stos = mesurer("MOV CX, 64\n"
+                            "STOS [0], 7\n", iterations);
+
+    printf("itérations         : %ld (blocs de 64 mots)\n", iterations);
+    printf("copie par MOV      : %.3f s (%.2f ns par bloc)\n", t_copie, t_copie * 1e9 / iterations);
+    printf("copie par MOVS     : %.3f s (%.2f ns par bloc)\n", t_movs, t_movs * 1e9 / iterations);
+    printf("remplissage MOV    : %.3f s (%.2f ns par bloc)\n", t_remplit, t_remplit * 1e9 / iterations);
+    printf("remplissage STOS   : %.3f s (%.2f ns par bloc)\n", t_stos, t_stos * 1e9 / iterations);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+/*
+ * Compare l'interpréteur instruction par instruction, l'exécution par blocs de base
+ * (cache indexé par IP, successeurs reliés) et les traces de boucles chaudes sur une
+ * boucle : temps et nombre de recherches.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_blocs bench/bench_cache_blocs.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_blocs [iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/assembleur.h"
+#include "../include/interpreteur.h"
+#include "../include/cache_blocs.h"
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Exécute le programme sur un CPU neuf, par blocs si `cache` n'est pas NULL
+static double mesurer(const Programme *prog, CacheBlocs *cache, int *dx) {
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    if (!cpu || load_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: chargement impossible\n");
+        exit(EXIT_FAILURE);
+    }
+    double debut = maintenant();
+    int rc = cache ? run_block_cache(cpu, cache) : run_decoded_program(cpu, prog);
+    if (rc != 0) {
+        fprintf(stderr, "bench: échec d'exécution\n");
+        exit(EXIT_FAILURE);
+    }
+    double duree = maintenant() - debut;
+    *dx = *cpu->registres[REG_DX];
+    cpu_destroy(cpu);
+    return duree;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 5000000;
+
+    char source[512];
+    snprintf(source, sizeof(source),
+             ".DATA\n"
+             "n DW %ld\n"
+             ".CODE\n"
+             "MOV CX, [n]\n"
+             "boucle: MOV AX, CX\n"
+             "ADD AX, 3\n"
+             "ADD DX, AX\n"
+             "CMP AX, 4\n"
+             "JZ saut\n"
+             "ADD BX, 1\n"
+             "saut: ADD CX, -1\n"
+             "CMP CX, 0\n"
+             "JNZ boucle\n",
+             iterations);
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) return EXIT_FAILURE;
+    CacheBlocs *cache = block_cache_create(prog);
+    if (!cache) return EXIT_FAILURE;
+
+    CacheBlocs *cache_traces = block_cache_create(prog);
+    if (!cache_traces) return EXIT_FAILURE;
+    block_cache_enable_traces(cache_traces, 50);
+
+    int dx_ref, dx_blocs, dx_traces;
+    double t_ref = mesurer(prog, NULL, &dx_ref);
+    double t_blocs = mesurer(prog, cache, &dx_blocs);
+    double t_traces = mesurer(prog, cache_traces, &dx_traces);
+
+    printf("itérations     : %ld\n", iterations);
+    printf("interpréteur   : %.3f s\n", t_ref);
+    printf("blocs          : %.3f s (%d blocs, %ld chaînages, %ld recherches)\n",
+           t_blocs, cache->nb_blocs, cache->chainages, cache->recherches);
+    printf("accélération   : x%.2f\n", t_blocs > 0 ? t_ref / t_blocs : 0.0);
+    printf("traces         : %.3f s (%d trace(s), %ld recherches)\n",
+           t_traces, cache_traces->nb_traces, cache_traces->recherches);
+    printf("accélération   : x%.2f\n", t_traces > 0 ? t_ref / t_traces : 0.0);
+    if (dx_ref != dx_blocs || dx_ref != dx_traces) {
+        fprintf(stderr, "bench: résultats différents (%d / %d / %d)\n", dx_ref, dx_blocs, dx_traces);
+        return EXIT_FAILURE;
+    }
+
+    block_cache_destroy(cache_traces);
+    block_cache_destroy(cache);
+    free_program(prog);
+    return EXIT_SUCCESS;
+}
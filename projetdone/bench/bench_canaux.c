@@ -0,0 +1,107 @@
+/*
+ * Mesure le passage de mots entre deux cœurs : le cœur 0 envoie `messages` mots au cœur 1,
+ * qui les additionne. Trois variantes : canal SPSC, canal MPMC (SEND / RECV), et boîte aux
+ * lettres en mémoire partagée (une case et un drapeau, attente active en XADD / XCHG).
+ * Chaque passage par la boîte aux lettres coûte un aller-retour entre les deux threads
+ * (une tranche entière quand ils partagent un cœur de l'hôte) : cette variante ne passe
+ * qu'un centième des messages.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_canaux bench/bench_canaux.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_canaux [messages] [capacite]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/assembleur.h"
+#include "../include/multicoeur.h"
+
+// Le cœur 0 exécute `emetteur`, le cœur 1 `recepteur` ; CX compte les messages restants
+static double mesurer(const char *emetteur, const char *recepteur, long messages, int type, int capacite) {
+    char source[2048];
+    snprintf(source, sizeof(source),
+             ".DATA\n"
+             "boite DW 0\n"
+             "plein DW 0\n"
+             "somme DW 0\n"
+             ".CODE\n"
+             "MOV CX, %ld\n"
+             "MOV BX, 0\n"
+             "CMP DX, 0\n"
+             "JNZ recepteur\n"
+             "%s"
+             "HALT 0\n"
+             "recepteur: %s"
+             "MOV [2], BX\n",
+             messages, emetteur, recepteur);
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) exit(EXIT_FAILURE);
+    Machine *m = machine_create(prog, 2, 0);
+    if (!m || (type >= 0 && machine_add_channel(m, (TypeCanal)type, capacite) != 0)) {
+        fprintf(stderr, "bench: machine impossible\n");
+        exit(EXIT_FAILURE);
+    }
+    BilanMachine bilan;
+    if (machine_run(m, NULL, &bilan) != 0) {
+        fprintf(stderr, "bench: échec d'exécution\n");
+        exit(EXIT_FAILURE);
+    }
+    long attendu = messages * (messages + 1) / 2;
+    if (m->coeurs[0]->memory_handler->mots[2] != (int)attendu) {
+        fprintf(stderr, "bench: somme fausse\n");
+        exit(EXIT_FAILURE);
+    }
+    machine_destroy(m);
+    free_program(prog);
+    return bilan.duree;
+}
+
+static void afficher(const char *nom, double duree, long messages) {
+    printf("%-22s : %.3f s (%.1f ns par message)\n", nom, duree, duree * 1e9 / messages);
+}
+
+int main(int argc, char **argv) {
+    long messages = argc > 1 ? atol(argv[1]) : 200000;
+    int capacite = argc > 2 ? atoi(argv[2]) : 1024;
+
+    const char *envoi = "envoi: SEND 0, CX\n"
+                        "ADD CX, -1\n"
+                        "CMP CX, 0\n"
+                        "JNZ envoi\n";
+    const char *reception = "RECV AX, 0\n"
+                            "ADD BX, AX\n"
+                            "ADD CX, -1\n"
+                            "CMP CX, 0\n"
+                            "JNZ recepteur\n";
+    // Boîte aux lettres : le drapeau est lu par XADD [1], 0 (lecture atomique)
+    const char *depot = "depot: MOV AX, 0\n"
+                        "XADD [1], AX\n"
+                        "CMP AX, 0\n"
+                        "JNZ depot\n"
+                        "MOV [0], CX\n"
+                        "MOV AX, 1\n"
+                        "XCHG [1], AX\n"
+                        "ADD CX, -1\n"
+                        "CMP CX, 0\n"
+                        "JNZ depot\n";
+    const char *retrait = "MOV AX, 0\n"
+                          "XADD [1], AX\n"
+                          "CMP AX, 1\n"
+                          "JNZ recepteur\n"
+                          "ADD BX, [0]\n"
+                          "MOV AX, 0\n"
+                          "XCHG [1], AX\n"
+                          "ADD CX, -1\n"
+                          "CMP CX, 0\n"
+                          "JNZ recepteur\n";
+
+    printf("messages               : %ld (capacité des canaux : %d)\n", messages, capacite);
+    afficher("canal SPSC", mesurer(envoi, reception, messages, CANAL_SPSC, capacite), messages);
+    afficher("canal MPMC", mesurer(envoi, reception, messages, CANAL_MPMC, capacite), messages);
+    long echanges = messages / 100 > 0 ? messages / 100 : 1;
+    afficher("mémoire partagée", mesurer(depot, retrait, echanges, -1, 0), echanges);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/*
+ * Compare l'exécution libre (`machine_run`) et l'exécution déterministe
+ * (`machine_run_deterministic`) pour plusieurs quanta. Chaque cœur fait `iterations` tours
+ * d'une boucle de calcul sur ses registres, écrit son résultat dans sa case de DS, puis
+ * incrémente un compteur commun par XADD (une synchronisation toutes les `periode`
+ * itérations). Le mode déterministe paie une barrière par tour et une par instruction
+ * atomique ; le bench vérifie aussi que deux exécutions déterministes donnent le même
+ * nombre de dispatchs.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_deterministe bench/bench_deterministe.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_deterministe [coeurs] [iterations] [periode]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/assembleur.h"
+#include "../include/multicoeur.h"
+
+static Programme *programme(int coeurs, long iterations, long periode) {
+    char source[1024];
+    int n = snprintf(source, sizeof(source), ".DATA\ncompteur DW 0\n");
+    for (int i = 0; i < coeurs; i++) n += snprintf(source + n, sizeof(source) - n, "r%d DW 0\n", i);
+    snprintf(source + n, sizeof(source) - n,
+             ".CODE\n"
+             "MOV CX, %ld\n"
+             "MOV AX, 0\n"
+             "externe: MOV BX, %ld\n"
+             "interne: ADD AX, CX\n"
+             "ADD AX, BX\n"
+             "ADD BX, -1\n"
+             "CMP BX, 0\n"
+             "JNZ interne\n"
+             "XADD [0], 1\n"
+             "ADD CX, -1\n"
+             "CMP CX, 0\n"
+             "JNZ externe\n"
+             "ADD DX, 1\n"
+             "MOV [DS:DX], AX\n",
+             iterations / periode, periode);
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) exit(EXIT_FAILURE);
+    return prog;
+}
+
+// quantum < 0 : machine_run
+static BilanMachine mesurer(const Programme *prog, int coeurs, long quantum, long attendu) {
+    Machine *m = machine_create(prog, coeurs, 0);
+    if (!m) exit(EXIT_FAILURE);
+    BilanMachine bilan;
+    int rc = quantum < 0 ? machine_run(m, NULL, &bilan) : machine_run_deterministic(m, quantum, NULL, &bilan);
+    if (rc != 0 || m->coeurs[0]->memory_handler->mots[0] != (int)attendu) {
+        fprintf(stderr, "bench: échec d'exécution\n");
+        exit(EXIT_FAILURE);
+    }
+    machine_destroy(m);
+    return bilan;
+}
+
+int main(int argc, char **argv) {
+    int coeurs = argc > 1 ? atoi(argv[1]) : 4;
+    long iterations = argc > 2 ? atol(argv[2]) : 2000000;
+    long periode = argc > 3 ? atol(argv[3]) : 1000;
+    if (coeurs < 1 || coeurs > 32 || periode < 1 || iterations < periode) {
+        fprintf(stderr, "usage: %s [coeurs <= 32] [iterations] [periode <= iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    Programme *prog = programme(coeurs, iterations, periode);
+    long attendu = (long)coeurs * (iterations / periode);
+
+    printf("cœurs : %d, itérations : %ld, une synchronisation toutes les %ld\n", coeurs, iterations, periode);
+    BilanMachine libre = mesurer(prog, coeurs, -1, attendu);
+    printf("%-24s : %.3f s (%.1f M dispatchs/s)\n", "machine_run", libre.duree, libre.dispatchs_par_seconde / 1e6);
+    long quanta[] = {1000, 10000, 100000};
+    for (size_t k = 0; k < sizeof(quanta) / sizeof(quanta[0]); k++) {
+        BilanMachine a = mesurer(prog, coeurs, quanta[k], attendu);
+        BilanMachine b = mesurer(prog, coeurs, quanta[k], attendu);
+        char nom[32];
+        snprintf(nom, sizeof(nom), "déterministe q=%ld", quanta[k]);
+        printf("%-24s : %.3f s (%.1f M dispatchs/s, %ld tours)%s\n", nom, a.duree, a.dispatchs_par_seconde / 1e6,
+               a.tours, a.dispatchs == b.dispatchs && a.tours == b.tours ? "" : "  NON REPRODUCTIBLE");
+    }
+    free_program(prog);
+    return EXIT_SUCCESS;
+}
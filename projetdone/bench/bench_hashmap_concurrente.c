@@ -0,0 +1,143 @@
+/*
+ * Recherches par seconde de T threads lecteurs sur une même table, pour T = 1 à N :
+ * `HashMap` protégée par un mutex contre `HashMapConcurrente` (lectures sans verrou). Avec
+ * l'option écrivain, un thread de plus remplace des valeurs et ajoute / retire des clés
+ * (donc agrandit la table) pendant toute la mesure.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_hashmap_concurrente bench/bench_hashmap_concurrente.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_hashmap_concurrente [lecteurs_max] [recherches_par_thread] [ecrivain 0|1]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "../include/th_generique.h"
+
+#define NB_CLES 1024
+#define MAX_THREADS 64
+
+static char cles[NB_CLES][16];
+static int valeurs[NB_CLES];
+
+typedef struct {
+    HashMap *map;               // Table classique, sous `verrou`
+    pthread_mutex_t verrou;
+    HashMapConcurrente *concurrente;
+    long recherches;
+    atomic_int fini;
+} Commun;
+
+typedef struct {
+    Commun *commun;
+    int concurrente;
+    int premier;                // Première clé cherchée (threads décalés)
+    long trouvees;
+} Lecteur;
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *lire(void *arg) {
+    Lecteur *l = arg;
+    Commun *c = l->commun;
+    long trouvees = 0;
+    for (long n = 0; n < c->recherches; n++) {
+        const char *cle = cles[(l->premier + n * 7) % NB_CLES];
+        void *v;
+        if (l->concurrente) {
+            v = concurrent_hashmap_get(c->concurrente, cle);
+        } else {
+            pthread_mutex_lock(&c->verrou);
+            v = hashmap_get(c->map, cle);
+            pthread_mutex_unlock(&c->verrou);
+        }
+        if (v) trouvees++;
+    }
+    l->trouvees = trouvees;
+    return NULL;
+}
+
+// Écrivain : remplace une valeur, ajoute une clé et en retire une, en boucle
+static void *ecrire(void *arg) {
+    Lecteur *l = arg;
+    Commun *c = l->commun;
+    char cle[24];
+    for (long n = 0; !atomic_load(&c->fini); n++) {
+        int i = (int)(n % NB_CLES);
+        snprintf(cle, sizeof(cle), "tmp%ld", n);
+        if (l->concurrente) {
+            concurrent_hashmap_insert(c->concurrente, cles[i], &valeurs[i]);
+            concurrent_hashmap_insert(c->concurrente, cle, &valeurs[i]);
+            concurrent_hashmap_remove(c->concurrente, cle);
+        } else {
+            pthread_mutex_lock(&c->verrou);
+            hashmap_insert(c->map, cles[i], &valeurs[i]);
+            hashmap_insert(c->map, cle, &valeurs[i]);
+            hashmap_remove(c->map, cle);
+            pthread_mutex_unlock(&c->verrou);
+        }
+    }
+    return NULL;
+}
+
+static double mesurer(Commun *c, int concurrente, int nb_lecteurs, int ecrivain) {
+    pthread_t threads[MAX_THREADS + 1];
+    Lecteur lecteurs[MAX_THREADS + 1];
+    atomic_store(&c->fini, 0);
+    if (ecrivain) {
+        lecteurs[MAX_THREADS] = (Lecteur){ c, concurrente, 0, 0 };
+        pthread_create(&threads[MAX_THREADS], NULL, ecrire, &lecteurs[MAX_THREADS]);
+    }
+    double debut = maintenant();
+    for (int t = 0; t < nb_lecteurs; t++) {
+        lecteurs[t] = (Lecteur){ c, concurrente, t * 97, 0 };
+        pthread_create(&threads[t], NULL, lire, &lecteurs[t]);
+    }
+    for (int t = 0; t < nb_lecteurs; t++) {
+        pthread_join(threads[t], NULL);
+        if (lecteurs[t].trouvees != c->recherches) fprintf(stderr, "bench: clé manquante\n");
+    }
+    double duree = maintenant() - debut;
+    atomic_store(&c->fini, 1);
+    if (ecrivain) pthread_join(threads[MAX_THREADS], NULL);
+    return (double)c->recherches * nb_lecteurs / duree;
+}
+
+int main(int argc, char **argv) {
+    long coeurs = sysconf(_SC_NPROCESSORS_ONLN);
+    int max = argc > 1 ? atoi(argv[1]) : (coeurs > 0 ? (int)coeurs : 1);
+    long recherches = argc > 2 ? atol(argv[2]) : 2000000;
+    int ecrivain = argc > 3 ? atoi(argv[3]) : 0;
+    if (max < 1 || max > MAX_THREADS) return EXIT_FAILURE;
+
+    Commun c = { hashmap_create(), PTHREAD_MUTEX_INITIALIZER, concurrent_hashmap_create(), recherches, 0 };
+    if (!c.map || !c.concurrente) return EXIT_FAILURE;
+    // Noms proches de ceux des tables de symboles
+    for (int i = 0; i < NB_CLES; i++) {
+        snprintf(cles[i], sizeof(cles[i]), "label_%d", i);
+        hashmap_insert(c.map, cles[i], &valeurs[i]);
+        concurrent_hashmap_insert(c.concurrente, cles[i], &valeurs[i]);
+    }
+
+    printf("clés : %d, recherches par thread : %ld, écrivain : %s, cœurs en ligne : %ld\n", NB_CLES, recherches,
+           ecrivain ? "oui" : "non", coeurs);
+    printf("lecteurs   HashMap+mutex (M/s)   HashMapConcurrente (M/s)\n");
+    for (int n = 1; n <= max; n = n * 2 > max && n < max ? max : n * 2) {
+        double verrou = mesurer(&c, 0, n, ecrivain);
+        double sans_verrou = mesurer(&c, 1, n, ecrivain);
+        printf("%8d   %19.1f   %24.1f\n", n, verrou / 1e6, sans_verrou / 1e6);
+    }
+
+    hashmap_destroy(c.map);
+    concurrent_hashmap_destroy(c.concurrente);
+    return EXIT_SUCCESS;
+}
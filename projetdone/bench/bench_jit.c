@@ -0,0 +1,92 @@
+/*
+ * Compare l'interpréteur et le JIT x86-64 sur une boucle arithmétique sans pile
+ * (MOV, ADD, CMP, JNZ, accès [n]) : temps d'exécution et résultat final.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_jit bench/bench_jit.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_jit [iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/assembleur.h"
+#include "../include/interpreteur.h"
+#include "../include/jit.h"
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Exécute le programme sur un CPU neuf avec le moteur choisi ; retourne le temps écoulé
+static double mesurer(const Programme *prog, const JitCode *jit, int *dx) {
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    if (!cpu || load_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: chargement impossible\n");
+        exit(EXIT_FAILURE);
+    }
+    double debut = maintenant();
+    int rc = jit ? jit_run(cpu, prog, jit) : run_decoded_program(cpu, prog);
+    if (rc != 0) {
+        fprintf(stderr, "bench: échec d'exécution\n");
+        exit(EXIT_FAILURE);
+    }
+    double duree = maintenant() - debut;
+    *dx = *cpu->registres[REG_DX];
+    cpu_destroy(cpu);
+    return duree;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 20000000;
+
+    char source[512];
+    snprintf(source, sizeof(source),
+             ".DATA\n"
+             "n DW %ld\n"
+             "total DW 0\n"
+             ".CODE\n"
+             "MOV CX, [n]\n"
+             "boucle: MOV AX, CX\n"
+             "ADD AX, 3\n"
+             "ADD DX, AX\n"
+             "ADD [1], 1\n"
+             "ADD CX, -1\n"
+             "CMP CX, 0\n"
+             "JNZ boucle\n",
+             iterations);
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) return EXIT_FAILURE;
+
+    double debut = maintenant();
+    JitCode *jit = jit_compile(prog);
+    double t_compile = maintenant() - debut;
+    if (!jit) {
+        fprintf(stderr, "bench: JIT indisponible sur cette plateforme\n");
+        free_program(prog);
+        return EXIT_FAILURE;
+    }
+
+    int dx_ref, dx_jit;
+    double t_ref = mesurer(prog, NULL, &dx_ref);
+    double t_jit = mesurer(prog, jit, &dx_jit);
+
+    printf("itérations     : %ld\n", iterations);
+    printf("compilation    : %d blocs, %zu octets réservés, %.6f s\n", jit->nb_blocs, jit->taille, t_compile);
+    printf("interpréteur   : %.3f s\n", t_ref);
+    printf("jit            : %.3f s\n", t_jit);
+    printf("accélération   : x%.2f\n", t_jit > 0 ? t_ref / t_jit : 0.0);
+    if (dx_ref != dx_jit) {
+        fprintf(stderr, "bench: résultats différents (%d / %d)\n", dx_ref, dx_jit);
+        return EXIT_FAILURE;
+    }
+
+    jit_free(jit);
+    free_program(prog);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+/*
+ * Mesure le débit d'un lot de petits programmes indépendants exécutés par `batch_run`,
+ * de 1 thread jusqu'au nombre de cœurs (puissances de deux, puis le nombre de cœurs).
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_lot bench/bench_lot.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_lot [taches] [threads_max]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/assembleur.h"
+#include "../include/lot.h"
+
+// Somme 1 + 2 + ... + n, n lu dans DS (une centaine de dispatchs par tâche)
+static const char *SOURCE =
+    ".DATA\n"
+    "n DW 0\n"
+    "r DW 0\n"
+    ".CODE\n"
+    "MOV CX, [n]\n"
+    "MOV AX, 0\n"
+    "boucle: ADD AX, CX\n"
+    "ADD CX, -1\n"
+    "CMP CX, 0\n"
+    "JNZ boucle\n"
+    "MOV [r], AX\n";
+
+int main(int argc, char **argv) {
+    int nb_taches = argc > 1 ? atoi(argv[1]) : 50000;
+    long coeurs = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = argc > 2 ? atoi(argv[2]) : (coeurs > 0 ? (int)coeurs : 1);
+
+    Programme *prog = assemble_buffer(SOURCE, strlen(SOURCE));
+    TacheLot *taches = calloc((size_t)nb_taches, sizeof(TacheLot));
+    int32_t *entrees = calloc((size_t)nb_taches, sizeof(int32_t));
+    ResultatLot *resultats = calloc((size_t)nb_taches, sizeof(ResultatLot));
+    if (!prog || !taches || !entrees || !resultats) return EXIT_FAILURE;
+    for (int i = 0; i < nb_taches; i++) {
+        entrees[i] = 20 + i % 20;
+        taches[i].prog = prog;
+        taches[i].entrees = &entrees[i];
+        taches[i].nb_entrees = 1;
+    }
+
+    printf("tâches : %d, cœurs en ligne : %ld\n", nb_taches, coeurs);
+    double reference = 0;
+    for (int n = 1; n <= max_threads; n = n * 2 > max_threads && n < max_threads ? max_threads : n * 2) {
+        BilanLot bilan;
+        OptionsLot options = { n, 0, 0 };
+        if (batch_run(taches, nb_taches, &options, resultats, &bilan) != 0 || bilan.nb_echecs != 0) {
+            fprintf(stderr, "bench: échec du lot\n");
+            return EXIT_FAILURE;
+        }
+        batch_results_free(resultats, nb_taches);
+        if (n == 1) reference = bilan.duree;
+        printf("%3d threads : %.3f s, %9.0f tâches/s, %6.1f M dispatchs/s, accélération x%.2f\n",
+               bilan.nb_threads, bilan.duree, bilan.taches_par_seconde,
+               bilan.dispatchs_par_seconde / 1e6, reference / bilan.duree);
+    }
+
+    free(resultats);
+    free(entrees);
+    free(taches);
+    free_program(prog);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+/*
+ * Compare `batch_run` (threads) et `batch_run_processes` (processus isolés, résultats en
+ * mémoire partagée) sur le même lot, pour 1 à N travailleurs. Le coût propre aux processus
+ * est celui des fork() et de la table partagée ; il se voit surtout sur les petits lots.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_lot_processus bench/bench_lot_processus.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_lot_processus [taches] [travailleurs_max]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/assembleur.h"
+#include "../include/lot_processus.h"
+
+// Somme 1 + 2 + ... + n, n lu dans DS (une centaine de dispatchs par tâche)
+static const char *SOURCE =
+    ".DATA\n"
+    "n DW 0\n"
+    "r DW 0\n"
+    ".CODE\n"
+    "MOV CX, [n]\n"
+    "MOV AX, 0\n"
+    "boucle: ADD AX, CX\n"
+    "ADD CX, -1\n"
+    "CMP CX, 0\n"
+    "JNZ boucle\n"
+    "MOV [r], AX\n";
+
+int main(int argc, char **argv) {
+    int nb_taches = argc > 1 ? atoi(argv[1]) : 50000;
+    long coeurs = sysconf(_SC_NPROCESSORS_ONLN);
+    int max = argc > 2 ? atoi(argv[2]) : (coeurs > 0 ? (int)coeurs : 1);
+
+    Programme *prog = assemble_buffer(SOURCE, strlen(SOURCE));
+    TacheLot *taches = calloc((size_t)nb_taches, sizeof(TacheLot));
+    int32_t *entrees = calloc((size_t)nb_taches, sizeof(int32_t));
+    ResultatLot *resultats = calloc((size_t)nb_taches, sizeof(ResultatLot));
+    if (!prog || !taches || !entrees || !resultats) return EXIT_FAILURE;
+    for (int i = 0; i < nb_taches; i++) {
+        entrees[i] = 20 + i % 20;
+        taches[i].prog = prog;
+        taches[i].entrees = &entrees[i];
+        taches[i].nb_entrees = 1;
+    }
+
+    printf("tâches : %d, cœurs en ligne : %ld\n", nb_taches, coeurs);
+    for (int n = 1; n <= max; n = n * 2 > max && n < max ? max : n * 2) {
+        BilanLot lot;
+        OptionsLot options_lot = { n, -1, 0 };
+        if (batch_run(taches, nb_taches, &options_lot, resultats, &lot) != 0 || lot.nb_echecs != 0) {
+            fprintf(stderr, "bench: échec du lot\n");
+            return EXIT_FAILURE;
+        }
+        batch_results_free(resultats, nb_taches);
+
+        BilanProcessus proc;
+        OptionsProcessus options = { n, NULL, NULL };
+        if (batch_run_processes(taches, nb_taches, &options, resultats, &proc) != 0 || proc.nb_echecs != 0) {
+            fprintf(stderr, "bench: échec du lot (processus)\n");
+            return EXIT_FAILURE;
+        }
+        batch_results_free(resultats, nb_taches);
+        printf("%3d travailleurs : threads %.3f s (%9.0f tâches/s), processus %.3f s (%9.0f tâches/s)\n",
+               n, lot.duree, lot.taches_par_seconde, proc.duree, proc.taches_par_seconde);
+    }
+
+    free(resultats);
+    free(entrees);
+    free(taches);
+    free_program(prog);
+    return EXIT_SUCCESS;
+}
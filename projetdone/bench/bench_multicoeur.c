@@ -0,0 +1,69 @@
+/*
+ * Mesure le passage à l'échelle de la machine multicœur : chaque cœur exécute la même
+ * boucle de `iterations` tours, avec 1, 2, 4 et 8 cœurs. Trois corps de boucle :
+ * calcul sur registres seulement, XADD sur une case propre au cœur ([DS:DX]), XADD sur
+ * un compteur commun à tous les cœurs (contention sur une même ligne de cache).
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_multicoeur bench/bench_multicoeur.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_multicoeur [iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/assembleur.h"
+#include "../include/multicoeur.h"
+
+// Exécute `corps` `iterations` fois sur chacun des `nb_coeurs` cœurs ; retourne le bilan
+static BilanMachine mesurer(const char *corps, long iterations, int nb_coeurs) {
+    char source[1024];
+    snprintf(source, sizeof(source),
+             ".DATA\n"
+             "commun DW 0\n"
+             "propres DW 64 DUP(0)\n"
+             ".CODE\n"
+             "ADD DX, 1\n"
+             "MOV CX, %ld\n"
+             "boucle: %s"
+             "ADD CX, -1\n"
+             "CMP CX, 0\n"
+             "JNZ boucle\n",
+             iterations, corps);
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) exit(EXIT_FAILURE);
+    Machine *m = machine_create(prog, nb_coeurs, 0);
+    BilanMachine bilan;
+    if (!m || machine_run(m, NULL, &bilan) != 0) {
+        fprintf(stderr, "bench: échec d'exécution\n");
+        exit(EXIT_FAILURE);
+    }
+    machine_destroy(m);
+    free_program(prog);
+    return bilan;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 2000000;
+
+    const struct { const char *nom; const char *corps; } cas[] = {
+        { "registres", "ADD AX, 1\n" },
+        { "XADD propre", "XADD [DS:DX], 1\n" },
+        { "XADD commun", "XADD [0], 1\n" },
+    };
+
+    printf("itérations par cœur    : %ld\n", iterations);
+    for (size_t c = 0; c < sizeof(cas) / sizeof(cas[0]); c++) {
+        double reference = 0;
+        for (int nb = 1; nb <= 8; nb *= 2) {
+            BilanMachine b = mesurer(cas[c].corps, iterations, nb);
+            double debit = b.dispatchs_par_seconde / 1e6;
+            if (nb == 1) reference = debit;
+            printf("%-12s %d cœur(s) : %.3f s, %7.1f M dispatchs/s (x%.2f)\n",
+                   cas[c].nom, nb, b.duree, debit, reference > 0 ? debit / reference : 0);
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,67 @@
+/*
+ * Mesure le coût de la pile sur deux boucles : quatre PUSH puis quatre POP, et un PUSHA
+ * suivi d'un POPA (mêmes quatre registres en deux instructions).
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_pile bench/bench_pile.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_pile [iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/assembleur.h"
+#include "../include/interpreteur.h"
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Assemble la boucle `corps` répétée `iterations` fois et retourne le temps d'exécution
+static double mesurer(const char *corps, long iterations) {
+    char source[512];
+    snprintf(source, sizeof(source),
+             ".DATA\n"
+             "n DW %ld\n"
+             ".CODE\n"
+             "MOV CX, [n]\n"
+             "boucle: ADD CX, -1\n"
+             "%s"
+             "CMP CX, 0\n"
+             "JNZ boucle\n",
+             iterations, corps);
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) exit(EXIT_FAILURE);
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    if (!cpu || load_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: chargement impossible\n");
+        exit(EXIT_FAILURE);
+    }
+    double debut = maintenant();
+    if (run_decoded_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: échec d'exécution\n");
+        exit(EXIT_FAILURE);
+    }
+    double duree = maintenant() - debut;
+    cpu_destroy(cpu);
+    free_program(prog);
+    return duree;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 2000000;
+
+    double t_unitaire = mesurer("PUSH AX\nPUSH BX\nPUSH CX\nPUSH DX\n"
+                                "POP DX\nPOP CX\nPOP BX\nPOP AX\n", iterations);
+    double t_groupe = mesurer("PUSHA\nPOPA\n", iterations);
+
+    printf("itérations     : %ld\n", iterations);
+    printf("PUSH/POP x4    : %.3f s (%.2f ns par tour)\n", t_unitaire, t_unitaire * 1e9 / iterations);
+    printf("PUSHA/POPA     : %.3f s (%.2f ns par tour)\n", t_groupe, t_groupe * 1e9 / iterations);
+    return EXIT_SUCCESS;
+}
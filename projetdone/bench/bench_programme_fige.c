@@ -0,0 +1,98 @@
+/*
+ * Compare des CPU chargés par `load_program` (CS et table des constantes par CPU) et des
+ * CPU créés depuis un programme figé (`cpu_init_frozen` : DS et pile seulement), répartis
+ * sur T threads qui exécutent tous le même programme. Affiche les cases mémoire par CPU et
+ * le temps création + exécution + destruction.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_programme_fige bench/bench_programme_fige.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_programme_fige [cpu] [threads] [instructions]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "../include/assembleur.h"
+#include "../include/interpreteur.h"
+#include "../include/programme_fige.h"
+
+typedef struct {
+    const Programme *prog;
+    ProgrammeFige *fige;    // NULL : load_program
+    int nb_cpu;
+    int echecs;
+} Travail;
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *travailler(void *arg) {
+    Travail *t = arg;
+    for (int i = 0; i < t->nb_cpu; i++) {
+        CPU *cpu;
+        if (t->fige) {
+            cpu = cpu_init_frozen(t->fige);
+        } else {
+            cpu = cpu_init(t->prog->data_size + t->prog->code_count + STACK_SIZE);
+            if (cpu && load_program(cpu, t->prog) != 0) {
+                cpu_destroy(cpu);
+                cpu = NULL;
+            }
+        }
+        if (!cpu || run_decoded_program(cpu, t->prog) != 0) t->echecs++;
+        cpu_destroy(cpu);
+    }
+    return NULL;
+}
+
+static double mesurer(const Programme *prog, ProgrammeFige *fige, int nb_cpu, int nb_threads) {
+    pthread_t threads[64];
+    Travail travaux[64];
+    double debut = maintenant();
+    for (int t = 0; t < nb_threads; t++) {
+        travaux[t] = (Travail){ prog, fige, nb_cpu / nb_threads, 0 };
+        pthread_create(&threads[t], NULL, travailler, &travaux[t]);
+    }
+    for (int t = 0; t < nb_threads; t++) {
+        pthread_join(threads[t], NULL);
+        if (travaux[t].echecs) fprintf(stderr, "bench: %d échecs\n", travaux[t].echecs);
+    }
+    return maintenant() - debut;
+}
+
+int main(int argc, char **argv) {
+    int nb_cpu = argc > 1 ? atoi(argv[1]) : 4096;
+    int nb_threads = argc > 2 ? atoi(argv[2]) : 4;
+    int nb_instructions = argc > 3 ? atoi(argv[3]) : 2000;
+    if (nb_threads < 1 || nb_threads > 64 || nb_cpu < nb_threads) return EXIT_FAILURE;
+
+    // Programme en ligne droite : un immédiat différent par instruction
+    size_t capacite = 64 + (size_t)nb_instructions * 24;
+    char *source = malloc(capacite);
+    if (!source) return EXIT_FAILURE;
+    int n = snprintf(source, capacite, ".DATA\nr DW 0\n.CODE\nMOV AX, 0\n");
+    for (int i = 1; i < nb_instructions; i++) n += snprintf(source + n, capacite - n, "ADD AX, %d\n", i);
+    Programme *prog = assemble_buffer(source, (size_t)n);
+    free(source);
+    if (!prog) return EXIT_FAILURE;
+
+    printf("cpu : %d, threads : %d, instructions : %d\n", nb_cpu, nb_threads, prog->code_count);
+    double t_charge = mesurer(prog, NULL, nb_cpu, nb_threads);
+    printf("load_program     : %6d cases/CPU  %8.3f s  (%.1f µs/CPU)\n",
+           prog->data_size + prog->code_count + STACK_SIZE, t_charge, t_charge * 1e6 / nb_cpu);
+
+    ProgrammeFige *fige = program_freeze(prog);
+    if (!fige) return EXIT_FAILURE;
+    const Programme *vue = frozen_program(fige);
+    double t_fige = mesurer(vue, fige, nb_cpu, nb_threads);
+    printf("programme figé   : %6d cases/CPU  %8.3f s  (%.1f µs/CPU)\n",
+           vue->data_size + STACK_SIZE, t_fige, t_fige * 1e6 / nb_cpu);
+    frozen_release(fige);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+/*
+ * Mesure l'effet des superinstructions sur une boucle qui contient les trois paires
+ * fusionnées (MOV + ADD, PUSH + POP, CMP + JNZ) : nombre de dispatchs et temps d'exécution.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_super bench/bench_superinstructions.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_super [iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/assembleur.h"
+#include "../include/interpreteur.h"
+#include "../include/optimiseur.h"
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Exécute le programme sur un CPU neuf ; retourne le temps écoulé
+static double mesurer(const Programme *prog, long *dispatchs, int *dx) {
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    if (!cpu || load_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: chargement impossible\n");
+        exit(EXIT_FAILURE);
+    }
+    double debut = maintenant();
+    if (run_decoded_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: échec d'exécution\n");
+        exit(EXIT_FAILURE);
+    }
+    double duree = maintenant() - debut;
+    *dispatchs = cpu->dispatchs;
+    *dx = *cpu->registres[REG_DX];
+    cpu_destroy(cpu);
+    return duree;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 2000000;
+
+    char source[512];
+    snprintf(source, sizeof(source),
+             ".DATA\n"
+             "n DW %ld\n"
+             ".CODE\n"
+             "MOV CX, [n]\n"
+             "boucle: MOV AX, CX\n"
+             "ADD AX, 3\n"
+             "PUSH AX\n"
+             "POP BX\n"
+             "ADD DX, BX\n"
+             "ADD CX, -1\n"
+             "CMP CX, 0\n"
+             "JNZ boucle\n",
+             iterations);
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) return EXIT_FAILURE;
+
+    long d_ref, d_fus;
+    int dx_ref, dx_fus;
+    double t_ref = mesurer(prog, &d_ref, &dx_ref);
+    int fusions = fuse_superinstructions(prog);
+    double t_fus = mesurer(prog, &d_fus, &dx_fus);
+
+    printf("itérations        : %ld\n", iterations);
+    printf("paires fusionnées : %d\n", fusions);
+    printf("sans fusion       : %ld dispatchs, %.3f s\n", d_ref, t_ref);
+    printf("avec fusion       : %ld dispatchs, %.3f s\n", d_fus, t_fus);
+    printf("dispatchs évités  : %.1f %%, accélération x%.2f\n",
+           100.0 * (d_ref - d_fus) / d_ref, t_fus > 0 ? t_ref / t_fus : 0.0);
+    if (dx_ref != dx_fus) {
+        fprintf(stderr, "bench: résultats différents (%d / %d)\n", dx_ref, dx_fus);
+        return EXIT_FAILURE;
+    }
+
+    free_program(prog);
+    return EXIT_SUCCESS;
+}
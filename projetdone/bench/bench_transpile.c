@@ -0,0 +1,96 @@
+/*
+ * Compare l'interpréteur et la traduction en C compilée à -O2 sur une boucle
+ * arithmétique : temps d'exécution (compilation comprise ou non) et état final.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_transpile bench/bench_transpile.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_transpile [iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/assembleur.h"
+#include "../include/interpreteur.h"
+#include "../include/transpileur.h"
+
+#define SOURCE_C "/tmp/bench_transpile_prog.c"
+#define BINAIRE "/tmp/bench_transpile_prog"
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 20000000;
+
+    char source[512];
+    snprintf(source, sizeof(source),
+             ".DATA\n"
+             "n DW %ld\n"
+             "total DW 0\n"
+             ".CODE\n"
+             "MOV CX, [n]\n"
+             "boucle: MOV AX, CX\n"
+             "ADD AX, 3\n"
+             "PUSH AX\n"
+             "POP BX\n"
+             "ADD DX, BX\n"
+             "ADD [1], 1\n"
+             "ADD CX, -1\n"
+             "CMP CX, 0\n"
+             "JNZ boucle\n",
+             iterations);
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) return EXIT_FAILURE;
+    int taille = prog->data_size + prog->code_count + STACK_SIZE;
+
+    // Interpréteur
+    CPU *cpu = cpu_init(taille);
+    if (!cpu || load_program(cpu, prog) != 0) return EXIT_FAILURE;
+    double debut = maintenant();
+    if (run_decoded_program(cpu, prog) != 0) return EXIT_FAILURE;
+    double t_ref = maintenant() - debut;
+    int dx_ref = *cpu->registres[REG_DX];
+    cpu_destroy(cpu);
+
+    // Traduction, compilation, exécution
+    FILE *f = fopen(SOURCE_C, "w");
+    if (!f || transpile_program(prog, taille, f) != 0) return EXIT_FAILURE;
+    fclose(f);
+    debut = maintenant();
+    if (system("cc -O2 -o " BINAIRE " " SOURCE_C) != 0) {
+        fprintf(stderr, "bench: compilation du C généré impossible\n");
+        return EXIT_FAILURE;
+    }
+    double t_compile = maintenant() - debut;
+
+    debut = maintenant();
+    FILE *p = popen(BINAIRE, "r");
+    if (!p) return EXIT_FAILURE;
+    char ligne[128];
+    int dx_aot = 0;
+    while (fgets(ligne, sizeof(ligne), p)) sscanf(ligne, "  DX = %d", &dx_aot);
+    int rc = pclose(p);
+    double t_aot = maintenant() - debut;
+
+    printf("itérations          : %ld\n", iterations);
+    printf("interpréteur        : %.3f s\n", t_ref);
+    printf("C compilé (-O2)     : %.3f s (+ %.3f s de compilation)\n", t_aot, t_compile);
+    printf("accélération        : x%.2f, x%.2f compilation comprise\n",
+           t_aot > 0 ? t_ref / t_aot : 0.0, t_ref / (t_aot + t_compile));
+
+    remove(SOURCE_C);
+    remove(BINAIRE);
+    free_program(prog);
+    if (rc != 0 || dx_ref != dx_aot) {
+        fprintf(stderr, "bench: résultats différents (%d / %d)\n", dx_ref, dx_aot);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
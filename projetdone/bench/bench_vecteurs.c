@@ -0,0 +1,99 @@
+/*
+ * Mesure l'addition élément par élément et la somme de tableaux de 256 mots : boucle
+ * d'instructions scalaires contre VADD / VSUM, ces dernières à chaque niveau disponible
+ * (scalaire, SSE2, AVX2).
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_vecteurs bench/bench_vecteurs.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_vecteurs [iterations]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/assembleur.h"
+#include "../include/interpreteur.h"
+#include "../include/vecteurs.h"
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Assemble `corps` répété `iterations` fois (compteur en mémoire : le corps utilise
+// AX..DX) et retourne le temps d'exécution. a occupe DS[0..255], b DS[256..511].
+static double mesurer(const char *corps, long iterations) {
+    char source[1024];
+    snprintf(source, sizeof(source),
+             ".DATA\n"
+             "a DW 256 DUP(1)\n"
+             "b DW 256 DUP(2)\n"
+             "n DW %ld\n"
+             ".CODE\n"
+             "debut: MOV BX, 0\n"
+             "%s"
+             "MOV AX, [n]\n"
+             "ADD AX, -1\n"
+             "MOV [n], AX\n"
+             "CMP AX, 0\n"
+             "JNZ debut\n",
+             iterations, corps);
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    if (!prog) exit(EXIT_FAILURE);
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    if (!cpu || load_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: chargement impossible\n");
+        exit(EXIT_FAILURE);
+    }
+    double debut = maintenant();
+    if (run_decoded_program(cpu, prog) != 0) {
+        fprintf(stderr, "bench: échec d'exécution\n");
+        exit(EXIT_FAILURE);
+    }
+    double duree = maintenant() - debut;
+    cpu_destroy(cpu);
+    free_program(prog);
+    return duree;
+}
+
+static void afficher(const char *nom, double duree, long iterations) {
+    printf("%-22s : %.3f s (%.2f ns par tableau)\n", nom, duree, duree * 1e9 / iterations);
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 20000;
+
+    const char *ajout_boucle = "MOV DX, 256\n"
+                               "ajout: MOV AX, [DS:DX]\n"
+                               "ADD [DS:BX], AX\n"
+                               "ADD BX, 1\n"
+                               "ADD DX, 1\n"
+                               "CMP BX, 256\n"
+                               "JNZ ajout\n";
+    const char *somme_boucle = "MOV DX, 0\n"
+                               "somme: ADD DX, [DS:BX]\n"
+                               "ADD BX, 1\n"
+                               "CMP BX, 256\n"
+                               "JNZ somme\n";
+    const char *ajout_vecteur = "MOV CX, 256\nVADD [0], [256]\n";
+    const char *somme_vecteur = "MOV CX, 256\nVSUM DX, [0]\n";
+
+    printf("itérations             : %ld (tableaux de 256 mots)\n", iterations);
+    afficher("a += b, boucle", mesurer(ajout_boucle, iterations), iterations);
+    afficher("somme, boucle", mesurer(somme_boucle, iterations), iterations);
+
+    NiveauVecteurs detecte = vector_level();
+    for (int niveau = VECTEURS_SCALAIRE; niveau <= (int)detecte; niveau++) {
+        char nom[32];
+        vector_set_level((NiveauVecteurs)niveau);
+        snprintf(nom, sizeof(nom), "VADD (%s)", vector_level_name((NiveauVecteurs)niveau));
+        afficher(nom, mesurer(ajout_vecteur, iterations), iterations);
+        snprintf(nom, sizeof(nom), "VSUM (%s)", vector_level_name((NiveauVecteurs)niveau));
+        afficher(nom, mesurer(somme_vecteur, iterations), iterations);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*
+ * Compare l'exécution par voies (`lanes_run`, 8 et 16 voies) à `batch_run` sur un thread
+ * pour le même programme et les mêmes jeux d'entrées. Deux jeux d'entrées : n identique pour
+ * tous les jeux (aucune divergence), puis n tiré entre 1 et 2 * n (boucles de longueurs
+ * différentes, les voies finies attendent les autres).
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_voies bench/bench_voies.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_voies [jeux] [n]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/assembleur.h"
+#include "../include/voies.h"
+
+// Somme 1 + 2 + ... + n et nombre de tours de boucle, n lu dans DS
+static const char *SOURCE =
+    ".DATA\n"
+    "n DW 0\n"
+    "r DW 0\n"
+    "tours DW 0\n"
+    ".CODE\n"
+    "MOV CX, [n]\n"
+    "MOV AX, 0\n"
+    "MOV BX, 0\n"
+    "boucle: ADD AX, CX\n"
+    "ADD BX, 1\n"
+    "ADD CX, -1\n"
+    "CMP CX, 0\n"
+    "JNZ boucle\n"
+    "MOV [r], AX\n"
+    "MOV [tours], BX\n";
+
+static void afficher(const char *nom, double duree, long dispatchs, int jeux, double occupation) {
+    printf("%-20s : %.3f s (%.1f M dispatchs/s, %.0f jeux/s", nom, duree, dispatchs / duree / 1e6, jeux / duree);
+    if (occupation > 0) printf(", voies actives %.0f %%", occupation * 100);
+    printf(")\n");
+}
+
+static void mesurer(const Programme *prog, const int32_t *entrees, int jeux) {
+    ResultatLot *scalaires = calloc((size_t)jeux, sizeof(ResultatLot));
+    ResultatLot *voies = calloc((size_t)jeux, sizeof(ResultatLot));
+    TacheLot *taches = calloc((size_t)jeux, sizeof(TacheLot));
+    if (!scalaires || !voies || !taches) exit(EXIT_FAILURE);
+    for (int j = 0; j < jeux; j++) {
+        taches[j].prog = prog;
+        taches[j].entrees = &entrees[j];
+        taches[j].nb_entrees = 1;
+    }
+    OptionsLot options = { 1, -1, 1 };
+    BilanLot bilan_lot;
+    batch_run(taches, jeux, &options, scalaires, &bilan_lot);
+    afficher("batch_run (1 thread)", bilan_lot.duree, bilan_lot.dispatchs, jeux, 0);
+
+    for (int largeur = 8; largeur <= 16; largeur += 8) {
+        BilanVoies bilan;
+        if (lanes_run(prog, largeur, entrees, 1, jeux, voies, &bilan) != 0) exit(EXIT_FAILURE);
+        for (int j = 0; j < jeux; j++) {
+            if (voies[j].ds[1] != scalaires[j].ds[1] || voies[j].dispatchs != scalaires[j].dispatchs) {
+                fprintf(stderr, "bench: résultats différents pour le jeu %d\n", j);
+                exit(EXIT_FAILURE);
+            }
+        }
+        char nom[32];
+        snprintf(nom, sizeof(nom), "lanes_run (%d voies)", largeur);
+        afficher(nom, bilan.duree, bilan.dispatchs, jeux, bilan.occupation);
+        batch_results_free(voies, jeux);
+    }
+    batch_results_free(scalaires, jeux);
+    free(scalaires);
+    free(voies);
+    free(taches);
+}
+
+int main(int argc, char **argv) {
+    int jeux = argc > 1 ? atoi(argv[1]) : 20000;
+    int n = argc > 2 ? atoi(argv[2]) : 200;
+    if (jeux < 1 || n < 1) {
+        fprintf(stderr, "usage: %s [jeux] [n]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    Programme *prog = assemble_buffer(SOURCE, strlen(SOURCE));
+    int32_t *entrees = malloc(sizeof(int32_t) * (size_t)jeux);
+    if (!prog || !entrees) return EXIT_FAILURE;
+
+    printf("jeux : %d, n = %d\n", jeux, n);
+    for (int j = 0; j < jeux; j++) entrees[j] = n;
+    printf("-- même n pour tous les jeux\n");
+    mesurer(prog, entrees, jeux);
+    srand(1);
+    for (int j = 0; j < jeux; j++) entrees[j] = 1 + rand() % (2 * n);
+    printf("-- n entre 1 et %d\n", 2 * n);
+    mesurer(prog, entrees, jeux);
+
+    free(entrees);
+    free_program(prog);
+    return EXIT_SUCCESS;
+}
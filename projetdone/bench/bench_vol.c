@@ -0,0 +1,83 @@
+/*
+ * Lot aux durées très inégales : 2 % de tâches longues (quelques millions de dispatchs),
+ * les autres courtes (quelques dizaines), les longues regroupées en tête du lot. Compare la
+ * répartition statique sans tranches (chaque thread exécute sa part jusqu'au bout) et les
+ * files avec tranches et vol : temps total, utilisation des cœurs et fin médiane / au
+ * 99e centile des tâches courtes.
+ *
+ * Compilation (depuis projetdone/) :
+ *   gcc -O2 -o bench_vol bench/bench_vol.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+ * Usage :
+ *   ./bench_vol [taches] [threads]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/assembleur.h"
+#include "../include/lot.h"
+
+static const char *SOURCE =
+    ".DATA\n"
+    "n DW 0\n"
+    ".CODE\n"
+    "MOV CX, [n]\n"
+    "boucle: ADD CX, -1\n"
+    "CMP CX, 0\n"
+    "JNZ boucle\n";
+
+static int comparer(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void mesurer(const char *nom, const TacheLot *taches, const int32_t *n, int nb_taches,
+                    const OptionsLot *options) {
+    ResultatLot *resultats = calloc((size_t)nb_taches, sizeof(ResultatLot));
+    double *fins = calloc((size_t)nb_taches, sizeof(double));
+    BilanLot bilan;
+    if (!resultats || !fins || batch_run(taches, nb_taches, options, resultats, &bilan) != 0 || bilan.nb_echecs) {
+        fprintf(stderr, "bench: échec du lot\n");
+        exit(EXIT_FAILURE);
+    }
+    int courtes = 0;
+    for (int i = 0; i < nb_taches; i++) {
+        if (n[i] < 1000) fins[courtes++] = resultats[i].fin;
+    }
+    qsort(fins, (size_t)courtes, sizeof(double), comparer);
+    printf("%-22s : %.3f s, utilisation %5.1f %%, %7ld tranches, %5ld vols, "
+           "courtes finies à %.4f s (médiane) / %.4f s (99 %%)\n",
+           nom, bilan.duree, bilan.utilisation * 100, bilan.tranches, bilan.vols,
+           fins[courtes / 2], fins[courtes * 99 / 100]);
+    batch_results_free(resultats, nb_taches);
+    free(resultats);
+    free(fins);
+}
+
+int main(int argc, char **argv) {
+    int nb_taches = argc > 1 ? atoi(argv[1]) : 5000;
+    long coeurs = sysconf(_SC_NPROCESSORS_ONLN);
+    int nb_threads = argc > 2 ? atoi(argv[2]) : (coeurs > 0 ? (int)coeurs : 1);
+
+    Programme *prog = assemble_buffer(SOURCE, strlen(SOURCE));
+    TacheLot *taches = calloc((size_t)nb_taches, sizeof(TacheLot));
+    int32_t *n = calloc((size_t)nb_taches, sizeof(int32_t));
+    if (!prog || !taches || !n) return EXIT_FAILURE;
+    int longues = nb_taches / 50 > 0 ? nb_taches / 50 : 1;
+    for (int i = 0; i < nb_taches; i++) {
+        n[i] = i < longues ? 1000000 : 10 + i % 50;
+        taches[i] = (TacheLot){ prog, &n[i], 1, 0 };
+    }
+
+    printf("tâches : %d (%d longues en tête), threads : %d\n", nb_taches, longues, nb_threads);
+    OptionsLot statique = { nb_threads, -1, 1 };
+    OptionsLot vol = { nb_threads, 0, 0 };
+    mesurer("statique, sans tranches", taches, n, nb_taches, &statique);
+    mesurer("tranches + vol", taches, n, nb_taches, &vol);
+
+    free(n);
+    free(taches);
+    free_program(prog);
+    return EXIT_SUCCESS;
+}
@@ -11,17 +11,20 @@
 char *trim(char *str);
 
 /**
- * Parcourt la table `values` et remplace dans la chaîne *str* toutes les occurrences
- * des clés par leur valeur entière (convertie en chaîne de caractères).
- * @param str La chaîne dans laquelle les remplacements doivent être effectués.
- * @param values La table de hachage contenant les clés et valeurs à remplacer.
- * @return 1 si au moins un remplacement a été effectué, 0 sinon.
+ * Résout un opérande qui est exactement un symbole (`nom`) ou un symbole entre crochets (`[nom]`)
+ * par une recherche exacte dans `symbols`, et le remplace par sa valeur entière.
+ * Aucune sous-chaîne n'est remplacée : seul l'opérande entier est comparé aux clés.
+ * @param operand L'opérande à résoudre (réalloué en cas de remplacement).
+ * @param symbols La table de hachage des symboles (valeurs int*).
+ * @param brackets Si non nul, un symbole nu devient une référence mémoire "[valeur]".
+ * @return 1 si l'opérande a été résolu, 0 sinon.
  */
-int search_and_replace(char **str, HashMap *values);
+int resolve_symbol(char **operand, HashMap *symbols, int brackets);
 
 /**
  * Résout les constantes dans une séquence d'instructions. Remplace les opérandes
- * dans les instructions à l'aide des tables `labels` et `memory_locations`.
+ * dans les instructions à l'aide des tables `labels` et `memory_locations`, en temps
+ * linéaire (une recherche exacte par opérande, voir `resolve_symbol`).
  * - Si l'instruction a un seul opérande, elle est remplacée à partir de `labels`.
  * - Si l'instruction a deux opérandes, elles sont remplacées à partir de `memory_locations`.
  * @param result L'objet contenant les instructions à traiter.
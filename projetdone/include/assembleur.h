@@ -0,0 +1,109 @@
+#ifndef ASSEMBLEUR_H
+#define ASSEMBLEUR_H
+
+#include <stdio.h>
+#include "decodeur.h"
+
+// =============================
+// ASSEMBLEUR INCRÉMENTAL
+// =============================
+
+/**
+ * @brief Référence en avant en attente de la définition de son symbole.
+ */
+typedef struct correctif {
+    int32_t instruction;        /**< Indice de l'instruction à corriger */
+    int32_t operande;           /**< 0 = dest (operand1), 1 = src (operand2) */
+    struct correctif *suivant;  /**< Référence suivante vers le même symbole */
+} Correctif;
+
+/**
+ * @brief Contexte d'assemblage incrémental.
+ *
+ * Le texte source est fourni par morceaux quelconques (`assembler_feed`) : seule la ligne
+ * en cours est conservée, chaque ligne complète est aussitôt analysée, décodée puis oubliée.
+ * La mémoire utilisée est donc proportionnelle au programme produit, pas au texte lu.
+ * Les références à un label ou une variable pas encore définis sont enregistrées et
+ * corrigées dès que le symbole apparaît.
+ */
+typedef struct {
+    char *ligne;                 /**< Ligne en cours (incomplète) */
+    size_t longueur;             /**< Longueur de la ligne en cours */
+    size_t capacite;             /**< Taille allouée pour `ligne` */
+    int numero_ligne;            /**< Numéro de la ligne en cours (messages d'erreur) */
+    int section;                 /**< 0 = aucune, 1 = .DATA, 2 = .CODE */
+
+    HashMap *labels;             /**< Label -> indice d'instruction (int*) */
+    HashMap *memory_locations;   /**< Variable -> adresse dans DS (int*) */
+    HashMap *constantes;         /**< Constante EQU -> valeur (int*) */
+    int compteur;                /**< Prochaine adresse libre de DS */
+
+    InstructionDecodee *code;    /**< Instructions décodées */
+    int code_count;
+    int code_capacite;
+    DonneesCompactes donnees;    /**< Valeurs initiales de DS, par plages (`compteur` cases) */
+
+    HashMap *attente_labels;     /**< Label inconnu -> liste de Correctif */
+    HashMap *attente_variables;  /**< Variable inconnue -> liste de Correctif */
+    int nb_attentes;             /**< Nombre total de références en attente */
+
+    int erreur;                  /**< Non nul après une erreur : l'assemblage échouera */
+} Assembleur;
+
+/**
+ * @brief Crée un contexte d'assemblage vide.
+ *
+ * @return Assembleur* Le contexte, ou NULL en cas d'erreur d'allocation.
+ */
+Assembleur *assembler_create(void);
+
+/**
+ * @brief Fournit un morceau de texte source.
+ *
+ * Le morceau peut couper une ligne n'importe où : la fin de ligne sera complétée par les
+ * appels suivants.
+ *
+ * @param as Contexte d'assemblage.
+ * @param texte Octets du source.
+ * @param taille Nombre d'octets.
+ * @return int 0 si succès, -1 si une erreur a été rencontrée (message sur stderr).
+ */
+int assembler_feed(Assembleur *as, const char *texte, size_t taille);
+
+/**
+ * @brief Termine l'assemblage et retourne le programme décodé.
+ *
+ * Traite la dernière ligne, vérifie que toutes les références en avant ont été résolues,
+ * puis détruit le contexte (dans tous les cas). Le programme peut être chargé avec
+ * `load_program` et exécuté sans passer par un fichier.
+ *
+ * @param as Contexte d'assemblage (libéré par l'appel).
+ * @return Programme* Le programme, ou NULL en cas d'erreur.
+ */
+Programme *assembler_finish(Assembleur *as);
+
+/**
+ * @brief Abandonne un assemblage et libère le contexte.
+ *
+ * @param as Contexte d'assemblage (NULL accepté).
+ */
+void assembler_destroy(Assembleur *as);
+
+/**
+ * @brief Assemble un texte source complet présent en mémoire.
+ *
+ * @param texte Source.
+ * @param taille Taille du source en octets.
+ * @return Programme* Le programme, ou NULL en cas d'erreur.
+ */
+Programme *assemble_buffer(const char *texte, size_t taille);
+
+/**
+ * @brief Assemble un source lu par blocs depuis un flux (fichier, tube, stdin...).
+ *
+ * @param flux Flux ouvert en lecture.
+ * @return Programme* Le programme, ou NULL en cas d'erreur.
+ */
+Programme *assemble_stream(FILE *flux);
+
+#endif /* ASSEMBLEUR_H */
@@ -0,0 +1,149 @@
+#ifndef CACHE_BLOCS_H
+#define CACHE_BLOCS_H
+
+#include <stdint.h>
+#include "decodeur.h"
+
+// =============================
+// CACHE DE BLOCS DE BASE
+// =============================
+
+#define TRACE_MAX_OPS 512   // longueur maximale d'une trace
+
+/**
+ * @brief Nature d'une opération de trace.
+ */
+typedef enum {
+    TRACE_EXEC,                   /**< Exécute une instruction (ou superinstruction) copiée */
+    TRACE_GARDE                   /**< Saut conditionnel enregistré : sortie si ZF contredit le chemin */
+} GenreOpTrace;
+
+/**
+ * @brief Opération d'une trace.
+ */
+typedef struct {
+    GenreOpTrace genre;
+    int32_t instr;                /**< TRACE_EXEC : indice de l'instruction dans `Trace.code` */
+    int32_t ip_apres;             /**< TRACE_EXEC : IP pendant l'exécution (indice d'origine + 1) */
+    int32_t zf_saut;              /**< TRACE_GARDE : valeur de ZF qui fait sauter (1 JZ, 0 JNZ) */
+    int32_t pris;                 /**< TRACE_GARDE : le saut était pris à l'enregistrement */
+    int32_t sortie;               /**< TRACE_GARDE : IP à reprendre si la garde échoue */
+} OpTrace;
+
+/**
+ * @brief Trace : chemin linéaire d'une boucle chaude, rejoué d'un seul tenant.
+ *
+ * Les instructions du chemin sont copiées à la suite ; les JMP immédiats disparaissent et
+ * chaque JZ/JNZ devient une garde. Après la dernière opération, la trace reprend au début
+ * (retour à l'entête de boucle) ; une garde qui échoue rend la main aux blocs.
+ */
+typedef struct {
+    int32_t entree;               /**< IP de l'entête de boucle */
+    InstructionDecodee *code;     /**< Copies des instructions du chemin */
+    int32_t code_count;
+    int32_t code_capacite;
+    OpTrace *ops;                 /**< Opérations, dans l'ordre du chemin */
+    int32_t nb_ops;
+    int32_t ops_capacite;
+    long executions;              /**< Entrées dans la trace */
+    long sorties;                 /**< Sorties par une garde */
+} Trace;
+
+/**
+ * @brief Bloc de base : suite d'instructions décodées contiguës exécutée d'un seul tenant.
+ *
+ * Un bloc commence à un IP d'entrée et s'arrête après la première instruction qui peut
+ * changer IP (JMP, JZ, JNZ, HALT, superinstruction CMP + saut, opérande [IP]) ou à la fin
+ * du code. Deux blocs peuvent se recouvrir (saut au milieu d'un bloc déjà construit).
+ * Les successeurs sont reliés au premier passage : ensuite, passer d'un bloc au suivant
+ * ne coûte qu'une comparaison d'IP et un pointeur suivi.
+ */
+typedef struct bloc_base {
+    int32_t debut;                /**< IP d'entrée */
+    int32_t longueur;             /**< Nombre d'instructions */
+    const InstructionDecodee *ops;  /**< Première instruction (dans le code du programme) */
+    int32_t ip_suivant;           /**< IP en séquence après le bloc */
+    int32_t ip_cible;             /**< Cible immédiate du saut final, ou -1 */
+    struct bloc_base *suivant;    /**< Bloc commençant à `ip_suivant` (relié au premier passage) */
+    struct bloc_base *pris;       /**< Bloc commençant à `ip_cible` (relié au premier passage) */
+    long passages;                /**< Entrées par un saut arrière (entête de boucle) */
+    Trace *trace;                 /**< Trace enregistrée depuis ce bloc, ou NULL */
+    int trace_impossible;         /**< L'enregistrement a échoué : on ne réessaie pas */
+} BlocBase;
+
+/**
+ * @brief Cache des blocs d'un programme, indexé par IP d'entrée.
+ *
+ * Le cache ne dépend que du code : il peut servir à plusieurs exécutions (plusieurs CPU)
+ * du même programme, tant que celui-ci n'est ni modifié ni libéré.
+ */
+typedef struct {
+    const Programme *prog;        /**< Programme dont les blocs sont construits */
+    BlocBase **par_ip;            /**< Bloc commençant à chaque IP, ou NULL s'il n'est pas construit */
+    int32_t nb_blocs;             /**< Blocs construits */
+    long chainages;               /**< Passages d'un bloc à l'autre par pointeur */
+    long recherches;              /**< Passages par l'index (IP calculé ou lien absent) */
+
+    int seuil_trace;              /**< Passages avant enregistrement d'une trace (0 : pas de trace) */
+    Trace *enregistrement;        /**< Trace en cours d'enregistrement, ou NULL */
+    BlocBase *entete;             /**< Bloc d'entête de la trace en cours */
+    int32_t nb_traces;            /**< Traces installées */
+} CacheBlocs;
+
+/**
+ * @brief Crée un cache de blocs vide pour un programme.
+ *
+ * @param prog Programme décodé.
+ * @return CacheBlocs* Le cache, ou NULL en cas d'erreur.
+ */
+CacheBlocs *block_cache_create(const Programme *prog);
+
+/**
+ * @brief Libère le cache et ses blocs.
+ *
+ * @param cache Le cache (NULL accepté).
+ */
+void block_cache_destroy(CacheBlocs *cache);
+
+/**
+ * @brief Retourne le bloc qui commence à `ip`, en le construisant au besoin.
+ *
+ * @param cache Le cache.
+ * @param ip IP d'entrée.
+ * @return BlocBase* Le bloc, ou NULL si `ip` est hors du code.
+ */
+BlocBase *block_cache_get(CacheBlocs *cache, int32_t ip);
+
+/**
+ * @brief Active l'enregistrement de traces.
+ *
+ * Un bloc atteint par un saut arrière est un entête de boucle ; quand il a été atteint
+ * `seuil` fois, le chemin suivi depuis lui est enregistré bloc par bloc jusqu'au retour à
+ * l'entête. L'enregistrement est abandonné (et l'entête marqué) si le chemin quitte le code,
+ * passe par HALT, un saut calculé, un opérande [IP], ou dépasse TRACE_MAX_OPS opérations.
+ *
+ * @param cache Le cache.
+ * @param seuil Nombre de passages avant enregistrement (0 désactive les traces).
+ */
+void block_cache_enable_traces(CacheBlocs *cache, int seuil);
+
+/**
+ * @brief Commence l'enregistrement d'une trace à partir d'un entête de boucle.
+ *
+ * @param cache Le cache.
+ * @param entete Bloc d'entête (le prochain bloc exécuté).
+ */
+void trace_start(CacheBlocs *cache, BlocBase *entete);
+
+/**
+ * @brief Ajoute à la trace en cours un bloc qui vient d'être exécuté.
+ *
+ * @param cache Le cache (avec un enregistrement en cours).
+ * @param bloc Bloc exécuté.
+ * @param ip_apres IP après le bloc (chemin suivi).
+ * @return int 1 si la trace est complète et installée sur l'entête, 0 si l'enregistrement
+ *         continue, -1 s'il est abandonné.
+ */
+int trace_record_block(CacheBlocs *cache, const BlocBase *bloc, int32_t ip_apres);
+
+#endif /* CACHE_BLOCS_H */
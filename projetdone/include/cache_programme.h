@@ -0,0 +1,97 @@
+#ifndef CACHE_PROGRAMME_H
+#define CACHE_PROGRAMME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "decodeur.h"
+
+// =============================
+// CACHE DE PROGRAMMES DÉCODÉS
+// =============================
+
+/**
+ * @brief Entrée du cache en mémoire (liste doublement chaînée, ordre LRU).
+ */
+typedef struct entree_cache {
+    uint64_t hash;                /**< Empreinte du source */
+    char *source;                 /**< Copie du source, comparée à chaque succès (l'empreinte
+                                       seule n'exclut pas une collision) */
+    size_t taille;                /**< Taille du source en octets */
+    Programme *prog;              /**< Programme décodé (possédé par le cache) */
+    struct entree_cache *prec;    /**< Entrée plus récemment utilisée */
+    struct entree_cache *suiv;    /**< Entrée moins récemment utilisée */
+} EntreeCache;
+
+/**
+ * @brief Cache de programmes décodés, indexé par l'empreinte du texte source.
+ *
+ * Deux niveaux : une LRU en mémoire de `capacite` entrées, puis un répertoire d'images
+ * binaires (objet.h) nommées d'après l'empreinte et la version du format. Sur un succès,
+ * ni parse, ni résolution des symboles, ni décodage n'ont lieu. Une entrée en mémoire
+ * garde une copie de son source : un succès exige le même texte, pas seulement la même
+ * empreinte.
+ */
+typedef struct {
+    char *repertoire;             /**< Répertoire des images, ou NULL (pas de cache disque) */
+    int capacite;                 /**< Nombre maximal d'entrées en mémoire */
+    int nb_entrees;               /**< Nombre d'entrées en mémoire */
+    HashMap *index;               /**< Empreinte (hexadécimal) -> EntreeCache* */
+    EntreeCache *tete;            /**< Plus récemment utilisée */
+    EntreeCache *queue;           /**< Moins récemment utilisée (prochaine évincée) */
+
+    long hits_memoire;            /**< Succès dans la LRU */
+    long hits_disque;             /**< Succès dans le répertoire */
+    long misses;                  /**< Échecs : source assemblé */
+    long evictions;               /**< Entrées retirées de la LRU */
+} CacheProgrammes;
+
+/**
+ * @brief Empreinte 64 bits (FNV-1a) d'un texte source.
+ *
+ * @param data Octets du source.
+ * @param taille Nombre d'octets.
+ * @return uint64_t L'empreinte (jamais 0).
+ */
+uint64_t hash_source(const void *data, size_t taille);
+
+/**
+ * @brief Crée un cache de programmes.
+ *
+ * @param repertoire Répertoire des images (créé s'il n'existe pas), ou NULL.
+ * @param capacite Nombre maximal de programmes gardés en mémoire (au moins 1).
+ * @return CacheProgrammes* Le cache, ou NULL en cas d'erreur.
+ */
+CacheProgrammes *program_cache_create(const char *repertoire, int capacite);
+
+/**
+ * @brief Détruit le cache et tous les programmes qu'il contient.
+ *
+ * @param cache Le cache (NULL accepté).
+ */
+void program_cache_destroy(CacheProgrammes *cache);
+
+/**
+ * @brief Retourne le programme décodé correspondant à un texte source.
+ *
+ * Cherche l'empreinte du source dans la LRU, puis dans le répertoire ; en cas d'échec,
+ * assemble le source et enregistre le résultat aux deux niveaux. Le programme retourné
+ * appartient au cache : il reste valide jusqu'au prochain appel qui peut l'évincer
+ * (chargement d'un autre source) ou jusqu'à la destruction du cache.
+ *
+ * @param cache Le cache.
+ * @param texte Source.
+ * @param taille Taille du source en octets.
+ * @return const Programme* Le programme, ou NULL si le source est invalide.
+ */
+const Programme *program_cache_load_buffer(CacheProgrammes *cache, const char *texte, size_t taille);
+
+/**
+ * @brief Variante de `program_cache_load_buffer` lisant le source dans un fichier.
+ *
+ * @param cache Le cache.
+ * @param chemin Fichier source.
+ * @return const Programme* Le programme, ou NULL si le fichier est illisible ou invalide.
+ */
+const Programme *program_cache_load(CacheProgrammes *cache, const char *chemin);
+
+#endif /* CACHE_PROGRAMME_H */
@@ -0,0 +1,88 @@
+#ifndef CANAL_H
+#define CANAL_H
+
+#include <stdint.h>
+#include <time.h>
+
+// =============================
+// CANAUX ENTRE CŒURS (SEND / RECV)
+// =============================
+
+/**
+ * @brief Discipline d'un canal.
+ */
+typedef enum {
+    CANAL_SPSC,   /**< Un seul émetteur et un seul récepteur : anneau sans opération atomique de lecture-modification-écriture */
+    CANAL_MPMC    /**< Plusieurs émetteurs et récepteurs : anneau à numéros de séquence (une CAS par opération) */
+} TypeCanal;
+
+typedef struct canal Canal;
+
+/**
+ * @brief Crée un canal borné de mots 32 bits.
+ *
+ * Les envois et réceptions sont sans verrou ; le verrou du canal ne sert qu'à endormir un
+ * cœur qui attend (`channel_wait`) et à le réveiller.
+ *
+ * @param type CANAL_SPSC ou CANAL_MPMC.
+ * @param capacite Nombre de mots (>= 1), arrondi à la puissance de 2 supérieure ; un canal
+ *                 CANAL_MPMC a au moins 2 cases.
+ * @return Canal* Le canal, ou NULL en cas d'échec.
+ */
+Canal *channel_create(TypeCanal type, int capacite);
+
+/**
+ * @brief Libère un canal (aucun cœur ne doit s'en servir).
+ */
+void channel_destroy(Canal *canal);
+
+TypeCanal channel_type(const Canal *canal);
+
+/**
+ * @brief Réserve un bout d'un canal SPSC à un cœur.
+ *
+ * Le premier cœur qui envoie (ou reçoit) devient l'unique émetteur (ou récepteur) ; un
+ * autre cœur est refusé. Sans effet pour un canal MPMC.
+ *
+ * @param canal Le canal.
+ * @param envoi 1 pour le bout émetteur, 0 pour le bout récepteur.
+ * @param coeur Numéro du cœur (>= 0).
+ * @return int 0 si le cœur peut utiliser ce bout, -1 sinon.
+ */
+int channel_bind(Canal *canal, int envoi, int coeur);
+
+/**
+ * @brief Envoie un mot sans attendre.
+ *
+ * @return int 1 si le mot a été déposé, 0 si le canal est plein.
+ */
+int channel_try_send(Canal *canal, int32_t valeur);
+
+/**
+ * @brief Reçoit un mot sans attendre.
+ *
+ * @return int 1 si un mot a été lu dans `*valeur`, 0 si le canal est vide.
+ */
+int channel_try_recv(Canal *canal, int32_t *valeur);
+
+/**
+ * @brief Indique si une opération pourrait réussir maintenant (instantané, sans garantie).
+ *
+ * @param envoi 1 : le canal a de la place ; 0 : le canal contient un mot.
+ */
+int channel_ready(const Canal *canal, int envoi);
+
+/**
+ * @brief Endort l'appelant jusqu'à ce que le canal change ou jusqu'à une échéance.
+ *
+ * Retourne tout de suite si `channel_ready(canal, envoi)` est vrai. Un envoi ou une
+ * réception réussi réveille les cœurs endormis sur le canal ; un réveil ne garantit pas
+ * que l'opération réussira (un autre cœur a pu la faire avant).
+ *
+ * @param canal Le canal.
+ * @param envoi Opération attendue (voir `channel_ready`).
+ * @param echeance Date limite (CLOCK_MONOTONIC).
+ */
+void channel_wait(Canal *canal, int envoi, const struct timespec *echeance);
+
+#endif /* CANAL_H */
@@ -1,12 +1,138 @@
+#ifndef DATASEGMENT_H
+#define DATASEGMENT_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdatomic.h>
 #include "gestion_memoire.h"
 
+#define STACK_SIZE 128  // Cases de la pile (SS) de chaque cœur, en fin de mémoire
+
+// Index des registres du CPU (ordre de NOMS_REGISTRES)
+typedef enum {
+    REG_AX, REG_BX, REG_CX, REG_DX,
+    REG_IP, REG_ZF, REG_SF, REG_ES,
+    REG_SP, REG_BP,
+    NB_REGISTRES
+} IndexRegistre;
+
+// Noms des registres, indexés par IndexRegistre
+extern const char *const NOMS_REGISTRES[NB_REGISTRES];
+
+#define CONSTANTES_PAR_BLOC 64
+
+// Bloc de stockage de la table des constantes : ses cases ne sont jamais déplacées
+typedef struct bloc_constantes {
+    int valeurs[CONSTANTES_PAR_BLOC];
+    struct bloc_constantes *suivant;
+} BlocConstantes;
+
+// Table des constantes immédiates, en lecture seule : une case par valeur distincte, pour
+// l'exécution textuelle qui passe les opérandes par pointeur (l'exécution décodée garde
+// les immédiats comme valeurs dans l'instruction)
+typedef struct {
+    const int **index;             // Cases triées par valeur (recherche dichotomique)
+    int count;
+    int capacite;
+    BlocConstantes *blocs;         // Stockage, bloc courant en tête
+    int utilisees;                 // Cases occupées dans le bloc courant
+} TableConstantes;
+
+// État d'exécution d'un CPU, rendu par cpu_run_for / cpu_run_until
+typedef enum {
+    CPU_EN_COURS,                  // Programme chargé, exécution possible
+    CPU_ARRETE,                    // IP hors du code (fin du code ou HALT)
+    CPU_EN_FAUTE,                  // Une instruction a échoué (ou aucun programme chargé)
+    CPU_BUDGET_EPUISE,             // Tranche terminée avant la fin du programme : à reprendre
+    CPU_BLOQUE,                    // SEND sur un canal plein ou RECV sur un canal vide : IP désigne
+                                   // l'instruction, à reprendre quand le canal a changé
+    CPU_SYNCHRO                    // Mode déterministe : IP désigne une instruction à exécuter au
+                                   // prochain point de synchronisation (ou le journal est plein)
+} EtatCPU;
+
+struct programme;
+struct canal;
+struct journal;
+struct programme_fige;
+
 // Structure représentant un CPU avec ses composants principaux
 typedef struct {
     MemoryHandler *memory_handler;  // Gestionnaire de mémoire
     HashMap *context;              // Registres (AX, BX, CX, DX, IP, etc.)
-    HashMap *constant_pool;        // Pool de constantes (pour les valeurs immédiates)
+    TableConstantes *constant_pool;  // Constantes immédiates (exécution textuelle), créée au premier usage
+    int *registres[NB_REGISTRES];  // Accès direct aux registres de `context` (mêmes pointeurs)
+    long dispatchs;                // Instructions décodées dispatchées (run_decoded_program)
+    int pile_debut;                // Bornes de SS [pile_debut, pile_fin), fixées par cpu_init
+    int pile_fin;
+    const struct programme *programme;  // Programme chargé par load_program (cpu_run_for)
+    EtatCPU etat;                  // Dernier état rendu par cpu_run_for / cpu_run_until
+    int memoire_partagee;          // Cœur secondaire : memory_handler appartient à un autre CPU
+    pthread_mutex_t *verrou_memoire;  // Multicœur : sérialise ALLOC / FREE (NULL sinon)
+    _Atomic uint64_t *bornes_es;   // Multicœur : bornes d'ES de la machine, lues sans verrou (NULL sinon)
+    int numero;                    // Numéro du cœur (0 pour cpu_init)
+    struct canal **canaux;         // Canaux de SEND / RECV (ceux de la machine), NULL sinon
+    int nb_canaux;
+    int canal_attendu;             // CPU_BLOQUE : canal de l'instruction bloquée
+    int attente_envoi;             // CPU_BLOQUE : 1 pour SEND, 0 pour RECV
+    struct journal *journal;       // Mode déterministe : écritures mémoire en attente, NULL sinon
+    struct programme_fige *fige;   // Programme figé tenu par cpu_init_frozen, NULL sinon
 } CPU;
 
+/**
+ * @brief Retourne l'index d'un registre à partir de son nom.
+ *
+ * @param nom Nom du registre (ex: "AX").
+ * @return int Index du registre (IndexRegistre), ou -1 si le nom est inconnu.
+ */
+int register_index(const char *nom);
+
+/**
+ * @brief Crée une table de constantes vide.
+ *
+ * @return TableConstantes* La table, ou NULL en cas d'erreur d'allocation.
+ */
+TableConstantes *constant_table_create(void);
+
+/**
+ * @brief Libère une table de constantes et ses cases.
+ *
+ * @param table La table (NULL accepté).
+ */
+void constant_table_destroy(TableConstantes *table);
+
+/**
+ * @brief Retourne la case d'une valeur, en l'ajoutant si elle n'y est pas encore.
+ *
+ * Une case ne change jamais d'adresse ni de valeur : deux opérandes de même valeur
+ * partagent la même case.
+ *
+ * @param table La table.
+ * @param valeur Valeur immédiate.
+ * @return const int* La case, ou NULL en cas d'erreur d'allocation.
+ */
+const int *constant_table_get(TableConstantes *table, int valeur);
+
+/**
+ * @brief Indique si un pointeur désigne une case de la table (une constante non modifiable).
+ *
+ * @param table La table.
+ * @param p Pointeur à tester (vers un int).
+ * @return int 1 si `p` est une case de la table, 0 sinon.
+ */
+int constant_table_contains(const TableConstantes *table, const void *p);
+
+/**
+ * @brief Écrit les drapeaux d'une comparaison dans les registres ZF et SF.
+ *
+ * ZF = (gauche - droite == 0) et SF = (gauche - droite < 0), la différence étant calculée
+ * modulo 2^32.
+ *
+ * @param cpu Pointeur vers le CPU.
+ * @param gauche Premier opérande de CMP.
+ * @param droite Second opérande de CMP.
+ */
+void cpu_set_flags_cmp(CPU *cpu, int gauche, int droite);
+
 /**
  * @brief Initialise un CPU avec un gestionnaire de mémoire et des registres.
  *
@@ -15,6 +141,22 @@ typedef struct {
  */
 CPU *cpu_init(int memory_size);
 
+/**
+ * @brief Crée un cœur supplémentaire qui partage la mémoire d'un CPU.
+ *
+ * Le cœur a ses propres registres (IP compris) et sa propre pile : la pile du cœur `numero`
+ * occupe les STACK_SIZE cases situées sous celle du cœur `numero - 1`, la pile du CPU
+ * principal (numéro 0) étant en fin de mémoire. Ces cases sont retirées de l'espace libre
+ * (segment "SS<numero>"). La mémoire doit donc avoir été dimensionnée pour toutes les piles.
+ * DS, CS et ES sont ceux du CPU principal ; `cpu_destroy` d'un cœur ne libère pas la
+ * mémoire partagée, qui doit survivre à tous les cœurs.
+ *
+ * @param principal CPU qui possède la mémoire.
+ * @param numero Numéro du cœur (>= 1).
+ * @return CPU* Le cœur, ou NULL si sa pile n'est pas libre.
+ */
+CPU *cpu_init_core(CPU *principal, int numero);
+
 /**
  * @brief Détruit une instance de CPU en libérant la mémoire associée.
  *
@@ -71,9 +213,14 @@ int matches(const char *pattern, const char *string);
 /**
  * @brief Gestion de l'adressage immédiat (valeur littérale).
  *
+ * La valeur est prise dans la table des constantes du CPU (`constant_pool`, créée au premier
+ * immédiat) : après le
+ * chargement, qui y range les immédiats du code, aucune allocation n'a lieu. La case
+ * retournée est en lecture seule (voir `constant_table_contains`).
+ *
  * @param cpu Pointeur vers le CPU.
- * @param operand Opérande à analyser.
- * @return void* Pointeur vers la valeur correspondante.
+ * @param operand Opérande à analyser (entier décimal, signe moins accepté).
+ * @return void* Pointeur vers la valeur correspondante, ou NULL si l'opérande n'est pas un immédiat.
  */
 void *immediate_adressing(CPU *cpu, const char *operand);
 
@@ -145,6 +292,9 @@ int free_es_segment(CPU *cpu);
  * et renvoie un code d'erreur si la pile est pleine. La pile est gérée dans la mémoire du CPU 
  * et fait partie de la structure `CPU`.
  *
+ * La case empilée est le mot contigu `mots[SP]` du MemoryHandler (aucune allocation) ;
+ * SP est un indice dans la mémoire, borné par `pile_debut` / `pile_fin`.
+ *
  * @param cpu Pointeur vers le CPU dans lequel la valeur doit être empilée.
  * @param value Valeur entière à empiler dans la pile du CPU.
  * @return int Retourne 0 si la valeur a été empilée avec succès, -1 si la pile est pleine.
@@ -163,3 +313,26 @@ int push_value(CPU *cpu, int value);
  * @return int Retourne 0 si la valeur a été dépilée avec succès, -1 si la pile est vide.
  */
 int pop_value(CPU *cpu, int *dest);
+
+/**
+ * @brief Empile AX, BX, CX puis DX (PUSHA).
+ *
+ * Les quatre mots sont écrits d'un coup après un seul contrôle de bornes : si la pile n'a
+ * pas quatre places, rien n'est empilé.
+ *
+ * @param cpu Pointeur vers le CPU.
+ * @return int 0 en cas de succès, -1 si la pile n'a pas assez de place.
+ */
+int push_all_registers(CPU *cpu);
+
+/**
+ * @brief Dépile DX, CX, BX puis AX (POPA), inverse de `push_all_registers`.
+ *
+ * Si la pile ne contient pas quatre valeurs, aucun registre n'est modifié.
+ *
+ * @param cpu Pointeur vers le CPU.
+ * @return int 0 en cas de succès, -1 si la pile n'a pas assez de valeurs.
+ */
+int pop_all_registers(CPU *cpu);
+
+#endif /* DATASEGMENT_H */
@@ -0,0 +1,358 @@
+#ifndef DECODEUR_H
+#define DECODEUR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "CodeSegment.h"
+
+// =============================
+// INSTRUCTIONS DÉCODÉES
+// =============================
+
+/**
+ * @brief Code opération d'une instruction décodée.
+ *
+ * Les valeurs sont figées : elles sont écrites telles quelles dans les images
+ * binaires (voir objet.h). Toute nouvelle opération s'ajoute à la fin.
+ *
+ * Les superinstructions (OPC_CMP_JZ à OPC_PUSH_POP) n'ont pas de mnémonique : elles sont
+ * produites par `fuse_superinstructions` (optimiseur.h) et exécutent l'instruction courante
+ * puis la suivante, qui reste en place dans le code.
+ */
+typedef enum {
+    OPC_INVALIDE = 0,
+    OPC_MOV,
+    OPC_ADD,
+    OPC_CMP,
+    OPC_JMP,
+    OPC_JZ,
+    OPC_JNZ,
+    OPC_HALT,
+    OPC_PUSH,
+    OPC_POP,
+    OPC_ALLOC,
+    OPC_FREE,
+    OPC_CMP_JZ,       /**< CMP a, b puis JZ (instruction suivante) */
+    OPC_CMP_JNZ,      /**< CMP a, b puis JNZ (instruction suivante) */
+    OPC_MOV_ADD,      /**< MOV a, b puis ADD (instruction suivante) */
+    OPC_PUSH_POP,     /**< PUSH a puis POP (instruction suivante) */
+    OPC_PUSHA,        /**< Empile AX, BX, CX, DX */
+    OPC_POPA,         /**< Dépile DX, CX, BX, AX */
+    OPC_MOVS,         /**< MOVS dest, src : copie CX cases */
+    OPC_STOS,         /**< STOS dest, valeur : remplit CX cases */
+    OPC_CMPS,         /**< CMPS a, b : compare CX cases (ZF, SF) */
+    OPC_VADD,         /**< VADD dest, src : ajoute CX cases (ou une valeur) */
+    OPC_VMUL,         /**< VMUL dest, src : multiplie CX cases (ou par une valeur) */
+    OPC_VSUM,         /**< VSUM dest, src : dest = somme de CX cases */
+    OPC_XCHG,         /**< XCHG dest, src : échange atomique */
+    OPC_CMPXCHG,      /**< CMPXCHG dest, src : si dest == AX, dest = src (ZF), sinon AX = dest */
+    OPC_XADD,         /**< XADD dest, src : dest += src atomiquement, src = ancienne valeur */
+    OPC_MFENCE,       /**< Barrière mémoire complète */
+    OPC_SEND,         /**< SEND canal, valeur : dépose valeur dans un canal de la machine */
+    OPC_RECV,         /**< RECV dest, canal : dest reçoit le plus ancien mot du canal */
+    NB_OPCODES
+} CodeOperation;
+
+// Un nouvel opcode doit être classé dans `synchronisante` (interpreteur.c) : mode
+// déterministe, s'exécute-t-il seulement aux points de synchronisation ? Mettre ensuite ce
+// compte à jour.
+_Static_assert(NB_OPCODES == OPC_RECV + 1, "nouvel opcode : le classer dans synchronisante");
+
+// Vrai pour une superinstruction (deux instructions exécutées en un dispatch)
+#define EST_SUPERINSTRUCTION(opcode) ((opcode) >= OPC_CMP_JZ && (opcode) <= OPC_PUSH_POP)
+
+/**
+ * @brief Mode d'adressage d'un opérande décodé.
+ *
+ * Chaque mode correspond à une fonction d'adressage de dataSegment.c, avec la même
+ * sémantique (en particulier MODE_INDIRECT désigne le registre lui-même, comme
+ * `register_indirect_addressing`).
+ */
+typedef enum {
+    MODE_AUCUN = 0,   /**< Pas d'opérande */
+    MODE_IMMEDIAT,    /**< Valeur littérale : `valeur` */
+    MODE_REGISTRE,    /**< AX..DX : `valeur` = index du registre */
+    MODE_DIRECT,      /**< [n] : `valeur` = adresse absolue */
+    MODE_INDIRECT,    /**< [XX] : `valeur` = index du registre */
+    MODE_SEGMENT      /**< [SEG:XX] : `segment` = index du segment, `valeur` = index du registre */
+} ModeAdressage;
+
+/**
+ * @brief Index des segments adressables par préfixe ([DS:..], [ES:..], ...).
+ */
+typedef enum {
+    SEG_DS, SEG_CS, SEG_SS, SEG_ES,
+    NB_SEGMENTS
+} IndexSegment;
+
+// Noms des segments, indexés par IndexSegment
+extern const char *const NOMS_SEGMENTS[NB_SEGMENTS];
+
+/**
+ * @brief Opérande décodé : mode d'adressage et valeurs numériques associées.
+ */
+typedef struct {
+    int32_t mode;     /**< ModeAdressage */
+    int32_t valeur;   /**< Valeur immédiate, adresse ou index de registre */
+    int32_t segment;  /**< Index de segment (MODE_SEGMENT uniquement) */
+} Operande;
+
+/**
+ * @brief Instruction décodée, de taille fixe et sans pointeur.
+ *
+ * `dest` correspond à `operand1` et `src` à `operand2` de la structure `Instruction`.
+ */
+typedef struct {
+    int32_t opcode;   /**< CodeOperation */
+    Operande dest;    /**< Premier opérande */
+    Operande src;     /**< Second opérande */
+} InstructionDecodee;
+
+// Code de retour de decode_operand : identifiant absent de la table des symboles
+#define DECODE_SYMBOLE_INCONNU (-2)
+
+/**
+ * @brief Entrée d'une table de symboles (label ou variable).
+ */
+typedef struct {
+    char nom[64];     /**< Nom du symbole */
+    int32_t valeur;   /**< Indice d'instruction (label) ou adresse (variable) */
+} Symbole;
+
+// =============================
+// PROGRAMME DÉCODÉ
+// =============================
+
+/**
+ * @brief Plage contiguë des valeurs initiales de DS.
+ *
+ * Une répétition `N DUP(v)` occupe une seule plage quelle que soit sa longueur : elle est
+ * développée au chargement (memset ou remplissage), jamais stockée case par case. Les valeurs
+ * littérales consécutives partagent une plage qui pointe dans le tableau `valeurs`.
+ */
+typedef struct {
+    int32_t adresse;   /**< Première case de DS */
+    int32_t longueur;  /**< Nombre de cases */
+    int32_t valeur;    /**< Valeur répétée (si `indice` < 0) */
+    int32_t indice;    /**< Première valeur dans `valeurs`, ou -1 pour une répétition */
+} PlageDonnees;
+
+/**
+ * @brief Valeurs initiales de DS en cours de construction (forme compacte).
+ *
+ * Les plages couvrent [0, taille) sans trou, dans l'ordre des adresses.
+ */
+typedef struct {
+    int32_t *valeurs;         /**< Valeurs littérales */
+    int32_t valeur_count;
+    int32_t valeur_capacite;
+    PlageDonnees *plages;     /**< Plages, triées par adresse */
+    int32_t plage_count;
+    int32_t plage_capacite;
+    int32_t taille;           /**< Nombre de cases couvertes */
+} DonneesCompactes;
+
+/**
+ * @brief Programme prêt à être exécuté, sans aucun texte à analyser.
+ *
+ * Les tableaux peuvent être alloués sur le tas (`decode_program`) ou pointer dans une
+ * image projetée en mémoire (`map_image`, voir objet.h) : dans ce cas `mapping` est non NULL
+ * et le contenu est en lecture seule.
+ */
+typedef struct programme {
+    const InstructionDecodee *code;  /**< Instructions de .CODE */
+    int32_t code_count;              /**< Nombre d'instructions */
+
+    const int32_t *valeurs;          /**< Valeurs littérales de DS */
+    int32_t valeur_count;
+    const PlageDonnees *plages;      /**< Contenu initial de DS, par plages */
+    int32_t plage_count;
+    int32_t data_size;               /**< Taille de DS (en cases) */
+
+    const Symbole *labels;           /**< Table des labels */
+    int32_t label_count;
+    const Symbole *variables;        /**< Table des variables de .DATA */
+    int32_t variable_count;
+
+    uint64_t source_hash;            /**< Empreinte du source (0 si inconnue), voir cache_programme.h */
+
+    InstructionDecodee *code_copie;  /**< Copie modifiable du code d'une image projetée, ou NULL */
+    void *mapping;                   /**< Zone projetée par mmap, ou NULL */
+    size_t mapping_size;             /**< Taille de la zone projetée */
+} Programme;
+
+/**
+ * @brief Décode un opérande textuel.
+ *
+ * Reconnaît les mêmes formes que `resolve_addressing` : immédiat, registre, [n], [XX]
+ * et [SEG:XX]. Les symboles sont résolus au passage par une recherche exacte dans
+ * `symboles` : `nom` donne sa valeur (ou son contenu [valeur] si `crochets`), `[nom]`
+ * donne son contenu. Une expression constante (`SIZE*2+1`, voir expression.h) est calculée
+ * ici et devient un immédiat, ou une adresse directe entre crochets. Les espaces en début
+ * et fin sont ignorés.
+ *
+ * @param texte Opérande à décoder (NULL pour « pas d'opérande »).
+ * @param symboles Table des symboles (valeurs int*), ou NULL si le texte est déjà résolu.
+ * @param constantes Table des constantes EQU (valeurs int*), ou NULL.
+ * @param crochets Si non nul, un symbole nu désigne le contenu de la case mémoire.
+ * @param op Opérande décodé (sortie).
+ * @return int 0 si succès, DECODE_SYMBOLE_INCONNU si l'opérande est un identifiant absent de
+ *         `symboles` (`op` a alors son mode définitif et une valeur nulle, à corriger plus tard),
+ *         -1 si l'opérande n'est pas reconnu.
+ */
+int decode_operand(const char *texte, HashMap *symboles, HashMap *constantes, int crochets, Operande *op);
+
+/**
+ * @brief Retourne le code opération d'un mnémonique.
+ *
+ * @param mnemonic Mnémonique (ex: "MOV").
+ * @return int Le CodeOperation, ou OPC_INVALIDE s'il est inconnu.
+ */
+int decode_mnemonic(const char *mnemonic);
+
+/**
+ * @brief Retourne le mnémonique d'un code opération.
+ *
+ * @param opcode Code opération.
+ * @return const char* Le mnémonique, ou NULL (code invalide ou superinstruction).
+ */
+const char *mnemonic_name(int opcode);
+
+/**
+ * @brief Décode une instruction de .CODE.
+ *
+ * Les symboles sont résolus comme dans `resolve_constants` : un opérande unique est cherché
+ * dans `labels`, deux opérandes dans `variables` (le second désignant le contenu mémoire).
+ *
+ * @param instr Instruction textuelle.
+ * @param labels Table des labels (ou NULL).
+ * @param variables Table des variables de .DATA (ou NULL).
+ * @param constantes Table des constantes EQU (ou NULL).
+ * @param out Instruction décodée (sortie).
+ * @return int 0 si succès, -1 si le mnémonique ou un opérande est invalide.
+ */
+int decode_instruction(const Instruction *instr, HashMap *labels, HashMap *variables,
+                       HashMap *constantes, InstructionDecodee *out);
+
+/**
+ * @brief Construit un programme décodé à partir d'un résultat de parsing.
+ *
+ * Les symboles sont résolus pendant le décodage (inutile d'appeler `resolve_constants`,
+ * qui reste sans effet si elle l'a été). Les valeurs de .DATA sont gardées sous forme
+ * compacte : une répétition `N DUP(v)` reste une seule plage.
+ *
+ * @param result Résultat de `parse`.
+ * @return Programme* Programme décodé, ou NULL en cas d'erreur (message sur stderr).
+ */
+Programme *decode_program(ParserResult *result);
+
+/**
+ * @brief Nombre de cases occupées par les valeurs d'une ligne .DATA.
+ *
+ * Les valeurs sont sous forme canonique (voir `fold_data_values`) : une répétition
+ * `N DUP(v)` compte pour N cases.
+ *
+ * @param valeurs Valeurs initiales (operand2 d'une instruction .DATA).
+ * @return int Nombre de cases.
+ */
+int count_data_values(const char *valeurs);
+
+/**
+ * @brief Développe les valeurs d'une ligne .DATA en entiers, sans modifier la chaîne.
+ *
+ * Les répétitions sont écrites par memset (valeur nulle) ou par une boucle de remplissage.
+ *
+ * @param valeurs Valeurs initiales sous forme canonique (operand2 d'une instruction .DATA).
+ * @param out Tableau de sortie.
+ * @param max Nombre maximal de cases à écrire.
+ * @return int Nombre de cases écrites, -1 si la chaîne n'est pas sous forme canonique.
+ */
+int decode_data_values(const char *valeurs, int32_t *out, int max);
+
+/**
+ * @brief Ajoute les valeurs d'une ligne .DATA à la suite de `d`, sans les développer.
+ *
+ * @param d Données en construction (initialisées à zéro avant le premier appel).
+ * @param valeurs Valeurs initiales sous forme canonique.
+ * @return int Nombre de cases ajoutées, -1 en cas d'erreur.
+ */
+int compact_data_values(DonneesCompactes *d, const char *valeurs);
+
+/**
+ * @brief Libère les tableaux de `d` (la structure elle-même n'est pas libérée).
+ *
+ * @param d Données compactes.
+ */
+void free_compact_data(DonneesCompactes *d);
+
+/**
+ * @brief Développe le contenu initial de DS d'un programme.
+ *
+ * @param prog Programme.
+ * @param out Tableau de `prog->data_size` cases (sortie).
+ */
+void expand_program_data(const Programme *prog, int32_t *out);
+
+/**
+ * @brief Valeur initiale d'une case de DS (recherche dichotomique dans les plages).
+ *
+ * @param prog Programme.
+ * @param adresse Adresse dans DS.
+ * @return int32_t La valeur, ou 0 si l'adresse est hors de DS.
+ */
+int32_t program_data_at(const Programme *prog, int32_t adresse);
+
+/**
+ * @brief Copie les entrées d'une HashMap de symboles (valeurs int*) dans une table.
+ *
+ * @param map Table de hachage (labels ou memory_locations).
+ * @param count Nombre d'entrées copiées (sortie).
+ * @return Symbole* Table allouée (à libérer avec free), ou NULL en cas d'erreur.
+ */
+Symbole *extract_symbols(HashMap *map, int32_t *count);
+
+/**
+ * @brief Libère un programme (tableaux sur le tas ou projection mmap).
+ *
+ * @param prog Programme à libérer (NULL accepté).
+ */
+void free_program(Programme *prog);
+
+/**
+ * @brief Recherche un symbole par son nom.
+ *
+ * @param table Table de symboles.
+ * @param count Nombre d'entrées.
+ * @param nom Nom recherché.
+ * @return const Symbole* Le symbole, ou NULL s'il est absent.
+ */
+const Symbole *find_symbol(const Symbole *table, int count, const char *nom);
+
+/**
+ * @brief Charge un programme décodé dans le CPU.
+ *
+ * Crée DS à l'adresse 0 et CS juste après, comme le chemin textuel (`allocate_variables`
+ * puis `allocate_code_segment`), et remet IP à 0. Les cases de DS sont des mots contigus
+ * (`memory_bind_words`) remplis plage par plage par memcpy, memset ou remplissage.
+ * Les cases de CS ne sont pas remplies : le code est lu directement dans `prog`.
+ *
+ * @param cpu CPU cible.
+ * @param prog Programme à charger.
+ * @return int 0 si succès, -1 en cas d'erreur.
+ */
+int load_program(CPU *cpu, const Programme *prog);
+
+/**
+ * @brief Charge un programme décodé sans lui réserver de CS dans la mémoire du CPU.
+ *
+ * Comme `load_program`, mais seul DS est créé : le code n'est lu que dans `prog`, qui peut
+ * être partagé par autant de CPU qu'on veut. La mémoire du CPU peut alors se limiter à DS
+ * et la pile ; [CS:XX] ne désigne plus rien.
+ *
+ * @param cpu CPU cible.
+ * @param prog Programme à charger.
+ * @return int 0 si succès, -1 en cas d'erreur.
+ */
+int load_program_data(CPU *cpu, const Programme *prog);
+
+#endif /* DECODEUR_H */
@@ -0,0 +1,54 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <stdint.h>
+#include "th_generique.h"
+
+// =============================
+// EXPRESSIONS CONSTANTES
+// =============================
+
+#define EXPR_INVALIDE         (-1)  /* Texte qui n'est pas une expression */
+#define EXPR_SYMBOLE_INCONNU  (-2)  /* Identifiant absent de la table des constantes */
+#define EXPR_DIVISION_ZERO    (-3)  /* Division ou modulo par zéro */
+
+/**
+ * @brief Évalue une expression constante à l'assemblage.
+ *
+ * Grammaire : entiers décimaux ou hexadécimaux (`0x1F`), constantes définies par `EQU`,
+ * opérateurs `+ - * / %`, moins unaire et parenthèses, avec les priorités habituelles.
+ * Les blancs sont ignorés. Aucun message n'est affiché : c'est à l'appelant de signaler
+ * l'erreur (le décodeur essaie cette forme parmi d'autres).
+ *
+ * @param texte Expression (ex: "SIZE*2+1").
+ * @param constantes Table nom -> int* des constantes, ou NULL.
+ * @param valeur Résultat (sortie).
+ * @return int 0 si succès, sinon EXPR_INVALIDE, EXPR_SYMBOLE_INCONNU ou EXPR_DIVISION_ZERO.
+ */
+int eval_expression(const char *texte, HashMap *constantes, int32_t *valeur);
+
+/**
+ * @brief Réduit la liste de valeurs d'une ligne .DATA à sa forme canonique.
+ *
+ * Chaque élément (séparé par des virgules) est soit une expression, soit une répétition
+ * `N DUP(v)` ; `?` vaut 0. Toutes les expressions sont évaluées ici, une seule fois :
+ * la forme produite ne contient plus que des entiers, par exemple "1,2,65536 DUP(0)".
+ * Une répétition reste compacte, elle n'est jamais développée dans le texte.
+ *
+ * @param texte Valeurs telles qu'écrites dans le source (les apostrophes sont ignorées).
+ * @param constantes Table des constantes, ou NULL.
+ * @param canonique Forme canonique allouée avec malloc (sortie, à libérer par l'appelant).
+ * @param nb_cases Nombre de cases de DS occupées (sortie).
+ * @return int 0 si succès, un code EXPR_* sinon.
+ */
+int fold_data_values(const char *texte, HashMap *constantes, char **canonique, int32_t *nb_cases);
+
+/**
+ * @brief Message lisible pour un code d'erreur EXPR_*.
+ *
+ * @param code Code retourné par `eval_expression` ou `fold_data_values`.
+ * @return const char* Message (chaîne statique).
+ */
+const char *expression_error(int code);
+
+#endif /* EXPRESSION_H */
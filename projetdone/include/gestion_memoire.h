@@ -23,9 +23,14 @@ typedef struct segment {
  * Cette structure gère l'allocation et la libération de mémoire, en maintenant un 
  * tableau de mémoire allouée, une liste de segments libres, et une table de hachage 
  * des segments alloués.
+ * 
+ * Une case de `memory` pointe soit vers un int alloué sur le tas, soit vers le mot 
+ * correspondant de `mots` (case « liée », voir `memory_bind_words`) : un segment lié se 
+ * remplit alors d'un seul memcpy ou memset.
  */
 typedef struct memoryHandler {
     void **memory;      /**< Tableau de mémoire allouée */
+    int *mots;          /**< Stockage contigu des cases liées (total_size mots) */
     int total_size;     /**< Taille totale de la mémoire */
     Segment *free_list; /**< Liste des segments libres */
     HashMap *allocated; /**< Table de hachage des segments alloués */
@@ -95,6 +100,42 @@ int remove_segment(MemoryHandler *handler, const char *name);
  */
 void destroy_memory_handler(MemoryHandler* m);
 
+/**
+ * @brief Lie les cases [start, start + size) à leurs mots contigus.
+ * 
+ * Chaque case `memory[i]` pointe ensuite vers `mots[i]` ; une ancienne case allouée sur 
+ * le tas est libérée. Le contenu des mots n'est pas modifié.
+ * 
+ * @param handler Pointeur vers le gestionnaire de mémoire.
+ * @param start Première case.
+ * @param size Nombre de cases.
+ * @return int* Adresse du premier mot (`&mots[start]`), ou NULL si la plage est invalide.
+ */
+int *memory_bind_words(MemoryHandler *handler, int start, int size);
+
+/**
+ * @brief Lie les cases [start, start + size) à leurs mots en conservant leur valeur.
+ * 
+ * Une case allouée sur le tas est recopiée dans son mot puis libérée. Les mots de la plage
+ * peuvent ensuite être traités d'un bloc (memcpy, memset, memcmp).
+ * 
+ * @param handler Pointeur vers le gestionnaire de mémoire.
+ * @param start Première case.
+ * @param size Nombre de cases.
+ * @return int* Adresse du premier mot, ou NULL si la plage est invalide ou contient une case vide.
+ */
+int *memory_words(MemoryHandler *handler, int start, int size);
+
+/**
+ * @brief Vide une case : libère l'int sur le tas s'il y en a un, puis met la case à NULL.
+ * 
+ * Une case liée à son mot n'est jamais passée à free.
+ * 
+ * @param handler Pointeur vers le gestionnaire de mémoire.
+ * @param addr Adresse de la case.
+ */
+void memory_release_cell(MemoryHandler *handler, int addr);
+
 /**
  * @brief Recherche un segment libre selon une stratégie de recherche.
  * 
@@ -0,0 +1,100 @@
+#ifndef INTERPRETEUR_H
+#define INTERPRETEUR_H
+
+#include <time.h>
+#include "decodeur.h"
+#include "cache_blocs.h"
+
+/**
+ * @brief Exécute une instruction décodée sur le CPU.
+ *
+ * Même sémantique que `handle_instruction`, sans analyse de texte ni affichage :
+ * les opérandes sont lus directement dans l'instruction décodée. Une superinstruction
+ * (voir optimiseur.h) lit sa seconde moitié dans `instr[1]` : `instr` doit alors pointer
+ * dans le code du programme, IP valant l'indice de `instr` + 1.
+ *
+ * @param cpu Le CPU sur lequel l'instruction est exécutée.
+ * @param instr L'instruction décodée.
+ * @return int 0 en cas de succès, -1 en cas d'erreur (opérande introuvable pour un saut ou la pile).
+ */
+int execute_decoded(CPU *cpu, const InstructionDecodee *instr);
+
+/**
+ * @brief Exécute un programme décodé jusqu'à sa fin.
+ *
+ * Le programme doit avoir été chargé avec `load_program`. L'exécution part de la valeur
+ * courante de IP et s'arrête quand IP sort de [0, code_count) (fin du code ou HALT).
+ * Contrairement à `run_program`, aucune interaction ni affichage n'a lieu. Chaque
+ * instruction (ou superinstruction) exécutée incrémente `cpu->dispatchs`.
+ *
+ * @param cpu Le CPU.
+ * @param prog Le programme décodé.
+ * @return int 0 en cas de succès, -1 en cas d'erreur d'exécution.
+ */
+int run_decoded_program(CPU *cpu, const Programme *prog);
+
+/**
+ * @brief Exécute au plus `quantum` dispatchs d'un programme chargé.
+ *
+ * Comme `run_decoded_program`, mais rend la main après `quantum` dispatchs (une
+ * superinstruction compte pour un) ; l'exécution reprend à l'appel suivant, tout l'état
+ * étant dans le CPU. Les drapeaux sont écrits dans ZF/SF à chaque retour.
+ *
+ * @param cpu Le CPU.
+ * @param prog Le programme décodé.
+ * @param quantum Nombre maximal de dispatchs (> 0).
+ * @return int 1 si le programme n'est pas terminé, 0 s'il est terminé, -1 en cas d'erreur.
+ */
+int run_decoded_quantum(CPU *cpu, const Programme *prog, long quantum);
+
+/**
+ * @brief Exécute une tranche d'au plus `n_instructions` dispatchs du programme chargé.
+ *
+ * Le programme est celui du dernier `load_program` ; tout l'état de l'exécution est dans
+ * le CPU, l'appel suivant reprend là où celui-ci s'est arrêté. Un thread peut ainsi faire
+ * avancer tour à tour autant de CPU qu'il veut, et une boucle sans fin (JMP sur place) ne
+ * bloque jamais l'appelant. Rien n'est affiché. Les drapeaux sont écrits dans ZF/SF à
+ * chaque retour.
+ *
+ * CPU_ARRETE et CPU_EN_FAUTE sont définitifs : les appels suivants les rendent sans rien
+ * exécuter (après une faute, IP désigne l'instruction qui suit celle qui a échoué).
+ * L'état rendu est aussi gardé dans `cpu->etat`.
+ *
+ * @param cpu Le CPU, chargé avec `load_program`.
+ * @param n_instructions Budget de la tranche (une superinstruction compte pour un ; 0
+ *                       n'exécute rien).
+ * @return EtatCPU CPU_BUDGET_EPUISE si le budget est atteint avant la fin, CPU_ARRETE si IP
+ *         est sorti du code, CPU_EN_FAUTE si une instruction a échoué ou si aucun programme
+ *         n'est chargé, CPU_BLOQUE si un SEND / RECV attend son canal (l'appel suivant
+ *         refait l'instruction), CPU_SYNCHRO si `cpu->journal` est posé et que l'instruction
+ *         suivante doit attendre la synchronisation (voir `machine_run_deterministic`).
+ */
+EtatCPU cpu_run_for(CPU *cpu, long n_instructions);
+
+/**
+ * @brief Exécute le programme chargé jusqu'à une échéance (horloge CLOCK_MONOTONIC).
+ *
+ * Même contrat que `cpu_run_for`, la limite étant une date : l'horloge est lue tous les
+ * 1024 dispatchs, l'échéance peut donc être dépassée de la durée de ces dispatchs. Une
+ * échéance déjà passée rend CPU_BUDGET_EPUISE sans rien exécuter.
+ *
+ * @param cpu Le CPU, chargé avec `load_program`.
+ * @param echeance Date limite (`clock_gettime(CLOCK_MONOTONIC, ...)`), ou NULL pour
+ *                 exécuter jusqu'à la fin.
+ * @return EtatCPU Voir `cpu_run_for`.
+ */
+EtatCPU cpu_run_until(CPU *cpu, const struct timespec *echeance);
+
+/**
+ * @brief Exécute un programme chargé bloc par bloc.
+ *
+ * Même contrat et mêmes effets que `run_decoded_program` (y compris `cpu->dispatchs`),
+ * sans recherche ni contrôle de bornes par instruction à l'intérieur d'un bloc.
+ *
+ * @param cpu Le CPU.
+ * @param cache Cache de blocs du programme chargé.
+ * @return int 0 en cas de succès, -1 en cas d'erreur d'exécution.
+ */
+int run_block_cache(CPU *cpu, CacheBlocs *cache);
+
+#endif /* INTERPRETEUR_H */
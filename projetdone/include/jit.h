@@ -0,0 +1,99 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "decodeur.h"
+
+// =============================
+// COMPILATION À LA VOLÉE (x86-64)
+// =============================
+
+/**
+ * @brief Moteur d'exécution d'un programme décodé.
+ */
+typedef enum {
+    MOTEUR_INTERPRETEUR = 0,  /**< `run_decoded_program` */
+    MOTEUR_JIT                /**< Blocs de base compilés en x86-64 (repli sur l'interpréteur) */
+} MoteurExecution;
+
+/**
+ * @brief État échangé entre le CPU et le code natif à l'entrée et à la sortie d'un bloc.
+ *
+ * Pendant l'exécution native, AX..DX vivent dans des registres de l'hôte (ebx, r12d,
+ * r13d, r14d) ; ils ne sont recopiés ici qu'à la sortie.
+ */
+typedef struct {
+    int32_t registres[4];     /**< AX, BX, CX, DX */
+    int32_t zf;               /**< Drapeau ZF */
+    int32_t sf;               /**< Drapeau SF */
+    int32_t ip;               /**< Instruction à exécuter après la sortie du code natif */
+    int32_t total_size;       /**< Taille de la mémoire (bornes de l'adressage direct) */
+    void **memory;            /**< Cases mémoire du CPU */
+} JitEtat;
+
+/**
+ * @brief Code natif d'un programme.
+ *
+ * Le code est découpé en blocs de base (entrées : début du code, labels, cibles de saut,
+ * instruction qui suit un saut ou une instruction non compilée). Les blocs sont émis à la
+ * suite dans des pages exécutables : un bloc se termine en tombant dans le suivant ou par un
+ * saut natif direct vers le bloc cible, sans repasser par le répartiteur.
+ */
+typedef struct {
+    uint8_t *code;            /**< Pages exécutables (mmap) */
+    size_t taille;            /**< Taille de la projection */
+    void **entrees;           /**< Adresse native du bloc commençant à chaque indice, ou NULL */
+    int32_t code_count;       /**< Nombre d'instructions du programme compilé */
+    int32_t nb_blocs;         /**< Nombre de blocs de base */
+    int32_t nb_compilees;     /**< Instructions traduites en code natif */
+} JitCode;
+
+/**
+ * @brief Compile un programme décodé en code natif x86-64.
+ *
+ * Sont compilés : MOV, ADD, CMP, JMP, JZ, JNZ, HALT (et les superinstructions qui en
+ * dérivent), avec les modes immédiat, registre, [n] et [XX] (XX parmi AX..DX). Toute autre
+ * instruction (pile, ALLOC/FREE, préfixe de segment...) n'a pas de code natif : le bloc
+ * précédent rend la main et l'interpréteur l'exécute.
+ *
+ * @param prog Programme à compiler.
+ * @return JitCode* Le code natif, ou NULL si la plateforme n'est pas x86-64 ou si les pages
+ *         exécutables ne peuvent pas être obtenues.
+ */
+JitCode *jit_compile(const Programme *prog);
+
+/**
+ * @brief Libère le code natif.
+ *
+ * @param jit Code natif (NULL accepté).
+ */
+void jit_free(JitCode *jit);
+
+/**
+ * @brief Exécute un programme avec son code natif, en repli sur l'interpréteur.
+ *
+ * Même contrat que `run_decoded_program` (le programme doit être chargé). Seules les
+ * instructions exécutées par l'interpréteur sont comptées dans `cpu->dispatchs`.
+ *
+ * @param cpu Le CPU.
+ * @param prog Le programme décodé.
+ * @param jit Code natif de `prog` (résultat de `jit_compile`).
+ * @return int 0 en cas de succès, -1 en cas d'erreur d'exécution.
+ */
+int jit_run(CPU *cpu, const Programme *prog, const JitCode *jit);
+
+/**
+ * @brief Exécute un programme chargé avec le moteur choisi.
+ *
+ * Avec MOTEUR_JIT, le programme est compilé pour l'occasion ; si la compilation est
+ * impossible, l'interpréteur est utilisé.
+ *
+ * @param cpu Le CPU.
+ * @param prog Le programme décodé.
+ * @param moteur Moteur d'exécution.
+ * @return int 0 en cas de succès, -1 en cas d'erreur d'exécution.
+ */
+int run_program_engine(CPU *cpu, const Programme *prog, MoteurExecution moteur);
+
+#endif /* JIT_H */
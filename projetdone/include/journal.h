@@ -0,0 +1,59 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "gestion_memoire.h"
+
+// =============================
+// JOURNAL D'ÉCRITURES (MODE DÉTERMINISTE)
+// =============================
+
+#define JOURNAL_CAPACITE 4096   // cases écrites au plus par cœur entre deux synchronisations
+
+/**
+ * @brief Copies privées des cases mémoire qu'un cœur a touchées depuis la dernière
+ *        synchronisation.
+ *
+ * Pendant une tranche déterministe, un cœur ne modifie pas la mémoire commune : ses
+ * écritures vont dans son journal, ses lectures voient son journal puis la mémoire telle
+ * qu'elle était à la dernière synchronisation. Aux synchronisations, les journaux sont
+ * recopiés dans la mémoire dans l'ordre des cœurs.
+ */
+typedef struct journal Journal;
+
+Journal *journal_create(void);
+void journal_destroy(Journal *journal);
+
+/**
+ * @brief Copie privée de la case `adresse`, créée (avec la valeur de la mémoire) au premier
+ *        accès.
+ *
+ * Le pointeur reste valide jusqu'à `journal_commit`. Le journal ne grandit pas : l'appelant
+ * vérifie `journal_full` avant chaque instruction.
+ *
+ * @return int* La copie, ou NULL si la case mémoire est vide (ou hors mémoire).
+ */
+int *journal_cell(Journal *journal, MemoryHandler *handler, int adresse);
+
+/**
+ * @brief Lit la case `adresse` : copie privée si le cœur l'a touchée, mémoire sinon.
+ *
+ * @return int 1 si la valeur a été lue, 0 si la case est vide (ou hors mémoire).
+ */
+int journal_read(const Journal *journal, const MemoryHandler *handler, int adresse, int *valeur);
+
+/**
+ * @brief Indique qu'une instruction de plus pourrait ne plus trouver de place.
+ */
+int journal_full(const Journal *journal);
+
+/**
+ * @brief Nombre de cases du journal.
+ */
+int journal_size(const Journal *journal);
+
+/**
+ * @brief Recopie les cases du journal dans la mémoire puis vide le journal.
+ */
+void journal_commit(Journal *journal, MemoryHandler *handler);
+
+#endif /* JOURNAL_H */
@@ -0,0 +1,119 @@
+#ifndef LOT_H
+#define LOT_H
+
+#include <stdint.h>
+#include "decodeur.h"
+
+// =============================
+// EXÉCUTION PAR LOTS (POOL DE THREADS)
+// =============================
+
+#define LOT_QUANTUM_DEFAUT 10000   // dispatchs par tranche d'exécution
+
+/**
+ * @brief Une exécution du lot : un programme et son jeu d'entrées.
+ *
+ * Le programme n'est que lu : plusieurs tâches (et plusieurs threads) peuvent partager le
+ * même `Programme`, qui ne doit être ni modifié ni libéré pendant `batch_run`.
+ */
+typedef struct {
+    const Programme *prog;      /**< Programme décodé (assemble_buffer, decode_program...) */
+    const int32_t *entrees;     /**< Valeurs écrites dans DS[0..nb_entrees) après le chargement, ou NULL */
+    int32_t nb_entrees;         /**< Au plus `prog->data_size` */
+    int memory_size;            /**< Taille mémoire du CPU, ou 0 pour DS + CS + pile */
+} TacheLot;
+
+/**
+ * @brief État final d'une tâche.
+ */
+typedef struct {
+    int statut;                     /**< 0 : exécution terminée ; -1 : chargement ou exécution en échec */
+    int registres[NB_REGISTRES];    /**< Registres à la fin (drapeaux à jour) */
+    int32_t *ds;                    /**< Copie de DS à la fin (case vide : 0), ou NULL */
+    int32_t ds_taille;
+    long dispatchs;                 /**< Dispatchs de l'exécution */
+    double fin;                     /**< Fin de la tâche, en secondes depuis le début du lot */
+} ResultatLot;
+
+/**
+ * @brief Réglages d'un lot (NULL dans `batch_run` : valeurs par défaut, toutes à 0).
+ */
+typedef struct {
+    int nb_threads;                 /**< Taille du pool, ou 0 pour le nombre de cœurs en ligne */
+    long quantum;                   /**< Dispatchs par tranche ; 0 : LOT_QUANTUM_DEFAUT ; < 0 : pas de tranches */
+    int sans_vol;                   /**< 1 : chaque thread ne traite que sa part (répartition statique) */
+} OptionsLot;
+
+/**
+ * @brief Bilan d'un appel à `batch_run`.
+ */
+typedef struct {
+    int nb_threads;                 /**< Threads effectivement utilisés */
+    int nb_taches;
+    int nb_echecs;                  /**< Tâches avec `statut` != 0 */
+    long dispatchs;                 /**< Somme des dispatchs */
+    long tranches;                  /**< Tranches exécutées (une par tâche sans tranches) */
+    long vols;                      /**< Tâches prises dans la file d'un autre thread */
+    double duree;                   /**< Temps écoulé (secondes) */
+    double utilisation;             /**< Part du temps des threads passée à exécuter (0 à 1) */
+    double taches_par_seconde;
+    double dispatchs_par_seconde;
+} BilanLot;
+
+/**
+ * @brief Exécute un lot de tâches indépendantes sur un pool fixe de threads.
+ *
+ * Chaque tâche a son propre CPU, créé et chargé (`load_program`) à sa première tranche,
+ * détruit à sa fin. Les tâches sont réparties par blocs contigus dans une file par thread ;
+ * un thread prend en tête de sa file, exécute une tranche de `quantum` dispatchs
+ * (`run_decoded_quantum`) et remet la tâche inachevée en queue : une tâche longue ne bloque
+ * pas les courtes placées derrière elle. Un thread dont la file est vide vole en queue de
+ * la file d'un autre ; s'il n'y a rien à voler, il se gare (variable de condition) jusqu'à
+ * ce qu'une tâche soit remise en file ou que le lot soit fini. Une tâche n'est jamais
+ * exécutée par deux threads à la fois ; les threads ne partagent que les programmes (en
+ * lecture) et les files. Aucune entrée ni sortie standard n'est utilisée. L'échec d'une
+ * tâche n'arrête pas les autres.
+ *
+ * @param taches Tâches à exécuter.
+ * @param nb_taches Nombre de tâches.
+ * @param options Réglages, ou NULL pour les valeurs par défaut.
+ * @param resultats Tableau de `nb_taches` résultats, rempli dans l'ordre des tâches
+ *                  (à libérer avec `batch_results_free`).
+ * @param bilan Bilan global (NULL accepté).
+ * @return int 0 si le lot a été exécuté (même avec des tâches en échec), -1 si les
+ *         paramètres sont invalides.
+ */
+int batch_run(const TacheLot *taches, int nb_taches, const OptionsLot *options, ResultatLot *resultats, BilanLot *bilan);
+
+/**
+ * @brief Prépare l'exécution d'une tâche : CPU neuf, programme chargé (`load_program`) et
+ *        entrées écrites dans DS.
+ *
+ * Commun à `batch_run` et `batch_run_processes`, avec `batch_task_finish`.
+ *
+ * @param tache La tâche.
+ * @return CPU* Le CPU prêt à exécuter `tache->prog`, ou NULL si la tâche est invalide ou
+ *         si le chargement échoue.
+ */
+CPU *batch_task_start(const TacheLot *tache);
+
+/**
+ * @brief Relève l'état final d'une tâche puis détruit son CPU.
+ *
+ * @param cpu CPU rendu par `batch_task_start`.
+ * @param registres Reçoit les registres (drapeaux à jour).
+ * @param dispatchs Reçoit les dispatchs de l'exécution.
+ * @param ds Reçoit les `ds_taille` premières cases de DS (case vide : 0), ou NULL.
+ * @param ds_taille Au plus `data_size` du programme de la tâche.
+ */
+void batch_task_finish(CPU *cpu, int registres[NB_REGISTRES], long *dispatchs, int32_t *ds, int32_t ds_taille);
+
+/**
+ * @brief Libère les copies de DS des résultats d'un lot.
+ *
+ * @param resultats Résultats remplis par `batch_run`.
+ * @param nb Nombre de résultats.
+ */
+void batch_results_free(ResultatLot *resultats, int nb);
+
+#endif /* LOT_H */
@@ -0,0 +1,63 @@
+#ifndef LOT_PROCESSUS_H
+#define LOT_PROCESSUS_H
+
+#include "lot.h"
+
+// =============================
+// EXÉCUTION PAR LOTS (PROCESSUS ISOLÉS)
+// =============================
+
+#define LOT_PLANTAGE (-2)   // statut d'une tâche dont le processus est mort pendant l'exécution
+
+/**
+ * @brief Réglages de `batch_run_processes` (NULL : valeurs par défaut, toutes à 0).
+ */
+typedef struct {
+    int nb_processus;                          /**< Processus travailleurs, ou 0 pour le nombre de cœurs en ligne */
+    void (*preparer)(int tache, void *contexte);  /**< Appelé dans le travailleur avant chaque tâche, ou NULL */
+    void *contexte;                            /**< Passé à `preparer` */
+} OptionsProcessus;
+
+/**
+ * @brief Bilan d'un appel à `batch_run_processes`.
+ */
+typedef struct {
+    int nb_processus;               /**< Parts (une par travailleur de départ) */
+    int nb_taches;
+    int nb_echecs;                  /**< Tâches avec `statut` != 0, plantages compris */
+    int nb_plantages;               /**< Tâches perdues avec leur processus (statut LOT_PLANTAGE) */
+    int nb_relances;                /**< Travailleurs recréés pour finir la part d'un processus mort */
+    long dispatchs;                 /**< Somme des dispatchs des tâches terminées */
+    double duree;                   /**< Temps écoulé (secondes) */
+    double taches_par_seconde;
+    double dispatchs_par_seconde;
+} BilanProcessus;
+
+/**
+ * @brief Exécute un lot de tâches indépendantes dans des processus séparés.
+ *
+ * Les tâches sont découpées en `nb_processus` parts contiguës ; chaque part est exécutée par
+ * un processus créé par fork(), qui hérite des programmes décodés du parent sans copie (les
+ * pages ne sont que lues, le noyau les partage) et exécute ses tâches l'une après l'autre
+ * comme `batch_run` (un CPU par tâche, `run_decoded_program`). Chaque travailleur écrit
+ * l'état final de ses tâches (registres, DS, dispatchs) directement dans une table en
+ * mémoire partagée, où le parent le lit sans tube ni sérialisation.
+ *
+ * Un bug du programme invité ou de l'interpréteur qui tue un travailleur (signal, exit) ne
+ * coûte que la tâche qu'il exécutait : elle reçoit le statut LOT_PLANTAGE, un nouveau
+ * travailleur reprend la suite de la part. Un travailleur qui meurt sans avoir commencé de
+ * tâche n'est pas recréé : les tâches restantes de sa part sont en échec (-1).
+ *
+ * @param taches Tâches à exécuter (voir `TacheLot`).
+ * @param nb_taches Nombre de tâches.
+ * @param options Réglages, ou NULL pour les valeurs par défaut.
+ * @param resultats Tableau de `nb_taches` résultats, rempli dans l'ordre des tâches
+ *                  (à libérer avec `batch_results_free`) ; `statut` vaut 0, -1 ou LOT_PLANTAGE.
+ * @param bilan Bilan global (NULL accepté).
+ * @return int 0 si le lot a été exécuté (même avec des tâches en échec), -1 si les
+ *         paramètres sont invalides ou si la table partagée n'a pu être créée.
+ */
+int batch_run_processes(const TacheLot *taches, int nb_taches, const OptionsProcessus *options, ResultatLot *resultats,
+                        BilanProcessus *bilan);
+
+#endif /* LOT_PROCESSUS_H */
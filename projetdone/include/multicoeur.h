@@ -0,0 +1,138 @@
+#ifndef MULTICOEUR_H
+#define MULTICOEUR_H
+
+#include <pthread.h>
+#include <time.h>
+#include "decodeur.h"
+#include "canal.h"
+
+// =============================
+// MACHINE MULTICŒUR (MÉMOIRE PARTAGÉE)
+// =============================
+
+#define MACHINE_TRANCHE 100000   // dispatchs exécutés par un cœur entre deux contrôles
+#define MACHINE_ATTENTE_NS 1000000   // un cœur bloqué vérifie l'arrêt et l'interblocage toutes les 1 ms
+#define MACHINE_QUANTUM 10000    // mode déterministe : dispatchs d'un cœur entre deux synchronisations
+
+/**
+ * @brief N cœurs qui exécutent le même programme sur une mémoire commune.
+ *
+ * Le cœur 0 possède la mémoire (DS, CS, ES, liste libre) ; chaque cœur a ses registres,
+ * son IP et sa pile (voir `cpu_init_core`). Les cœurs se coordonnent par la mémoire :
+ * XCHG, CMPXCHG et XADD sont atomiques sur leur case destination, MFENCE est une barrière
+ * complète. Les MOV / ADD ordinaires sur une case partagée ne sont pas synchronisés : comme
+ * sur un vrai processeur, un programme qui en dépend doit passer par un verrou ou une
+ * instruction atomique. ALLOC / FREE sont sérialisés ; ES est commun à tous les cœurs.
+ *
+ * Les cœurs peuvent aussi s'échanger des mots par des canaux (`machine_add_channel`) :
+ * `SEND canal, valeur` et `RECV dest, canal`, sans verrou. Un SEND sur un canal plein ou un
+ * RECV sur un canal vide bloque le cœur : son thread s'endort sur le canal (il ne tourne
+ * pas à vide) et reprend l'instruction quand un autre cœur a changé le canal.
+ */
+typedef struct {
+    CPU **coeurs;                   /**< coeurs[0] possède la mémoire */
+    int nb_coeurs;
+    const Programme *prog;          /**< Programme partagé, en lecture seule */
+    pthread_mutex_t verrou_memoire; /**< Sérialise ALLOC / FREE et la table des segments */
+    _Atomic uint64_t bornes_es;     /**< ES courant ((début + 1) << 32 | taille, 0 sans ES) : écrit
+                                         par ALLOC / FREE sous le verrou, lu sans verrou */
+    Canal **canaux;                 /**< Canaux de SEND / RECV, numérotés à partir de 0 */
+    int nb_canaux;
+} Machine;
+
+/**
+ * @brief Bilan d'un appel à `machine_run` ou `machine_run_deterministic`.
+ */
+typedef struct {
+    int nb_coeurs;
+    int nb_fautes;                  /**< Cœurs en CPU_EN_FAUTE */
+    int nb_actifs;                  /**< Cœurs encore en cours (échéance atteinte, ou bloqués) */
+    int nb_bloques;                 /**< Cœurs en CPU_BLOQUE à la fin de l'appel */
+    int interblocage;               /**< 1 : tous les cœurs restants attendaient des canaux inertes */
+    long dispatchs;                 /**< Dispatchs de tous les cœurs pendant l'appel */
+    double duree;                   /**< Temps écoulé (secondes) */
+    double dispatchs_par_seconde;
+    long tours;                     /**< Mode déterministe : synchronisations effectuées */
+} BilanMachine;
+
+/**
+ * @brief Crée une machine et charge le programme sur chaque cœur.
+ *
+ * Tous les cœurs partent de l'instruction 0 ; DX contient le numéro du cœur (0 à
+ * nb_coeurs - 1), ce qui permet à chacun de choisir sa part du travail.
+ *
+ * @param prog Programme décodé, ni modifié ni libéré avant `machine_destroy`.
+ * @param nb_coeurs Nombre de cœurs (>= 1).
+ * @param memory_size Taille de la mémoire, ou 0 pour DS + CS + une pile par cœur.
+ * @return Machine* La machine, ou NULL en cas d'échec.
+ */
+Machine *machine_create(const Programme *prog, int nb_coeurs, int memory_size);
+
+/**
+ * @brief Ajoute un canal à la machine (avant `machine_run`).
+ *
+ * Un canal CANAL_SPSC n'accepte qu'un cœur émetteur et un cœur récepteur (les premiers à
+ * s'en servir) : un autre cœur qui y envoie ou y reçoit est en faute. CANAL_MPMC accepte
+ * tous les cœurs.
+ *
+ * @param m La machine.
+ * @param type CANAL_SPSC ou CANAL_MPMC.
+ * @param capacite Nombre de mots en attente au plus (arrondi à une puissance de 2, au moins 2
+ *                 pour CANAL_MPMC).
+ * @return int Numéro du canal (opérande de SEND / RECV), ou -1 en cas d'échec.
+ */
+int machine_add_channel(Machine *m, TypeCanal type, int capacite);
+
+/**
+ * @brief Exécute tous les cœurs en parallèle, un thread par cœur.
+ *
+ * Chaque thread avance son cœur par tranches de MACHINE_TRANCHE dispatchs (`cpu_run_for`)
+ * jusqu'à ce qu'il s'arrête. Une faute sur un cœur arrête les autres à la fin de leur
+ * tranche (un cœur qui attend un verrou tenu par un cœur en faute ne finirait jamais).
+ * L'échéance est contrôlée entre deux tranches ; les cœurs qui l'atteignent restent en
+ * cours et un nouvel appel les reprend. Quand tous les cœurs non terminés sont bloqués sur
+ * des canaux qu'aucun d'eux ne peut plus débloquer, l'appel s'arrête (interblocage).
+ *
+ * @param m La machine.
+ * @param echeance Date limite (CLOCK_MONOTONIC), ou NULL pour exécuter jusqu'à la fin.
+ * @param bilan Bilan de l'appel (NULL accepté).
+ * @return int 0 si tous les cœurs sont arrêtés, 1 si certains sont encore en cours, -1 si
+ *         un cœur est en faute, en cas d'interblocage ou si les threads n'ont pu être créés.
+ */
+int machine_run(Machine *m, const struct timespec *echeance, BilanMachine *bilan);
+
+/**
+ * @brief Exécute tous les cœurs en parallèle avec un résultat reproductible.
+ *
+ * L'exécution avance par tours. Pendant un tour, chaque cœur exécute au plus `quantum`
+ * dispatchs sur son thread sans modifier la mémoire commune : ses écritures dans DS (et
+ * toute case hors pile) vont dans un journal privé et ses lectures voient la mémoire telle
+ * qu'elle était au début du tour. Tous les cœurs se retrouvent ensuite à une barrière où
+ * un seul thread :
+ *   - recopie les journaux dans la mémoire, dans l'ordre des cœurs (pour une case écrite
+ *     par plusieurs cœurs, le plus grand numéro l'emporte) ;
+ *   - exécute, toujours dans l'ordre des cœurs, l'instruction qui a arrêté chaque cœur
+ *     avant la fin de son quantum : XCHG / CMPXCHG / XADD / MFENCE, SEND / RECV,
+ *     ALLOC / FREE et les instructions de bloc et vectorielles. Elles voient donc la mémoire
+ *     à jour et restent exactes (compteurs en XADD, verrous). Un SEND / RECV bloqué est
+ *     réessayé à chaque barrière.
+ *
+ * Le résultat (mémoire, registres, dispatchs) ne dépend que du programme, du nombre de
+ * cœurs et du quantum, jamais de l'ordonnancement des threads de l'hôte. Un cœur ne lit pas
+ * de façon déterministe la pile d'un autre cœur. L'échéance est contrôlée à chaque barrière
+ * (un appel interrompu par l'échéance n'est reproductible qu'à ce tour près).
+ *
+ * @param m La machine.
+ * @param quantum Dispatchs d'un cœur par tour, ou 0 pour MACHINE_QUANTUM.
+ * @param echeance Date limite (CLOCK_MONOTONIC), ou NULL pour exécuter jusqu'à la fin.
+ * @param bilan Bilan de l'appel (NULL accepté).
+ * @return int Comme `machine_run`.
+ */
+int machine_run_deterministic(Machine *m, long quantum, const struct timespec *echeance, BilanMachine *bilan);
+
+/**
+ * @brief Détruit les cœurs puis la mémoire partagée.
+ */
+void machine_destroy(Machine *m);
+
+#endif /* MULTICOEUR_H */
@@ -0,0 +1,80 @@
+#ifndef OBJET_H
+#define OBJET_H
+
+#include <stdint.h>
+#include "decodeur.h"
+
+// =============================
+// FORMAT D'IMAGE BINAIRE
+// =============================
+
+#define IMAGE_MAGIC      "CPUIMAGE"   /* 8 octets, sans '\0' */
+#define IMAGE_VERSION    2u           /* À incrémenter à chaque changement de format */
+#define IMAGE_ENDIAN_TAG 0x01020304u  /* Lu à l'envers si l'ordre des octets diffère */
+
+/**
+ * @brief En-tête d'une image binaire de programme assemblé.
+ *
+ * L'image est écrite dans l'ordre d'octets de la machine. Les sections suivent
+ * l'en-tête, chacune alignée sur 8 octets :
+ * - code : `code_count` × InstructionDecodee
+ * - valeurs : `valeur_count` × int32_t (valeurs littérales de DS)
+ * - plages : `plage_count` × PlageDonnees (contenu initial de DS, répétitions non développées)
+ * - labels : `label_count` × Symbole
+ * - variables : `variable_count` × Symbole
+ */
+typedef struct {
+    char magic[8];             /**< IMAGE_MAGIC */
+    uint32_t version;          /**< IMAGE_VERSION */
+    uint32_t endianness;       /**< IMAGE_ENDIAN_TAG */
+    uint64_t source_hash;      /**< Empreinte du source assemblé (0 si inconnue) */
+    uint64_t total_size;       /**< Taille totale de l'image en octets */
+
+    uint32_t code_count;       /**< Nombre d'instructions */
+    uint32_t data_size;        /**< Taille de DS */
+    uint32_t valeur_count;     /**< Nombre de valeurs littérales */
+    uint32_t plage_count;      /**< Nombre de plages de DS */
+    uint32_t label_count;      /**< Nombre de labels */
+    uint32_t variable_count;   /**< Nombre de variables */
+
+    uint64_t code_offset;      /**< Position de la section code */
+    uint64_t valeurs_offset;   /**< Position des valeurs littérales */
+    uint64_t plages_offset;    /**< Position des plages de DS */
+    uint64_t labels_offset;    /**< Position de la table des labels */
+    uint64_t variables_offset; /**< Position de la table des variables */
+} ImageEntete;
+
+/**
+ * @brief Écrit un programme décodé dans une image binaire.
+ *
+ * Le fichier est d'abord écrit sous un nom temporaire puis renommé, de sorte qu'un lecteur
+ * concurrent ne voit jamais une image incomplète.
+ *
+ * @param prog Programme à écrire.
+ * @param path Chemin du fichier image.
+ * @return int 0 si succès, -1 en cas d'erreur.
+ */
+int write_image(const Programme *prog, const char *path);
+
+/**
+ * @brief Projette une image binaire en mémoire (mmap) et la présente comme un Programme.
+ *
+ * Aucune analyse de texte n'a lieu : l'en-tête et les instructions sont seulement validés
+ * (bornes, version, codes opération), puis le programme pointe directement dans la projection.
+ * Le programme retourné se libère avec `free_program`.
+ *
+ * @param path Chemin du fichier image.
+ * @return Programme* Le programme, ou NULL si l'image est absente ou invalide.
+ */
+Programme *map_image(const char *path);
+
+/**
+ * @brief Assemble un fichier source en image binaire (assemblage incrémental puis écriture).
+ *
+ * @param source Fichier source assembleur.
+ * @param image Chemin du fichier image à produire.
+ * @return int 0 si succès, -1 en cas d'erreur.
+ */
+int assemble_file(const char *source, const char *image);
+
+#endif /* OBJET_H */
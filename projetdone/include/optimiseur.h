@@ -0,0 +1,59 @@
+#ifndef OPTIMISEUR_H
+#define OPTIMISEUR_H
+
+#include "decodeur.h"
+
+// =============================
+// SUPERINSTRUCTIONS
+// =============================
+
+/**
+ * @brief Opcode de la superinstruction qui fusionne deux instructions, ou OPC_INVALIDE.
+ *
+ * Paires reconnues : CMP + JZ, CMP + JNZ, MOV + ADD et PUSH + POP.
+ *
+ * @param premier Opcode de la première instruction.
+ * @param second Opcode de l'instruction suivante.
+ * @return int La superinstruction, ou OPC_INVALIDE si la paire n'est pas fusionnable.
+ */
+int superinstruction_for(int premier, int second);
+
+/**
+ * @brief Opcode de la première moitié d'une superinstruction.
+ *
+ * Permet à un moteur qui traite les instructions une à une (JIT, transpileur) d'ignorer la
+ * fusion : la seconde moitié est de toute façon l'instruction suivante.
+ *
+ * @param opcode Opcode, fusionné ou non.
+ * @return int La première moitié si `opcode` est une superinstruction, `opcode` sinon.
+ */
+int superinstruction_first(int opcode);
+
+/**
+ * @brief Vérifie qu'une superinstruction est cohérente avec l'instruction qui la suit.
+ *
+ * Utilisé pour valider une image : une superinstruction n'est exécutable que si
+ * l'instruction suivante existe et correspond à la seconde moitié de la paire.
+ *
+ * @param code Code décodé.
+ * @param count Nombre d'instructions.
+ * @param i Indice à vérifier.
+ * @return int 1 si `code[i]` n'est pas une superinstruction ou si elle est cohérente, 0 sinon.
+ */
+int superinstruction_valid(const InstructionDecodee *code, int32_t count, int32_t i);
+
+/**
+ * @brief Passe d'optimisation : fusionne les paires fréquentes en superinstructions.
+ *
+ * Seul l'opcode de la première instruction d'une paire est remplacé ; la seconde reste
+ * à sa place, intacte. Un saut vers la seconde (label placé au milieu de la paire) exécute
+ * donc l'instruction seule, comme avant, et les indices d'instruction (IP, labels) sont
+ * inchangés. Une instruction n'appartient jamais à deux paires : la paire suivante commence
+ * après la seconde moitié. Le code d'une image projetée est d'abord copié sur le tas.
+ *
+ * @param prog Programme à optimiser (modifié).
+ * @return int Nombre de paires fusionnées, -1 en cas d'erreur.
+ */
+int fuse_superinstructions(Programme *prog);
+
+#endif /* OPTIMISEUR_H */
@@ -40,6 +40,7 @@ typedef struct {
 
     HashMap *labels;                   /**< Map associant un label à son indice dans les instructions .CODE */
     HashMap *memory_locations;         /**< Map associant le nom d'une variable à son adresse mémoire */
+    HashMap *constantes;               /**< Map associant une constante EQU à sa valeur (int*) */
 } ParserResult;
 
 // =============================
@@ -59,6 +60,26 @@ typedef struct {
  */
 Instruction *parse_data_instruction(const char *line, HashMap *memory_locations);
 
+/**
+ * @brief Variante réentrante de `parse_data_instruction`.
+ * 
+ * Identique à `parse_data_instruction`, mais le compteur d'adresses et la table des constantes 
+ * sont fournis par l'appelant au lieu du compteur global : plusieurs analyses peuvent ainsi avoir 
+ * lieu en parallèle.
+ * 
+ * Les valeurs sont réduites à l'assemblage (voir `fold_data_values`) : `operand2` de l'instruction 
+ * retournée ne contient plus que des entiers et des répétitions `N DUP(v)`. Une ligne `NOM EQU expr` 
+ * enregistre la constante dans `constantes` et retourne une instruction de type "EQU" qui n'occupe 
+ * aucune case de DS. Une constante doit être définie avant d'être utilisée.
+ * 
+ * @param line La ligne à analyser, représentant une instruction dans .DATA.
+ * @param memory_locations La table de hachage des emplacements mémoire.
+ * @param constantes La table des constantes EQU (NULL : aucune constante admise).
+ * @param compteur Adresse de la prochaine case libre de DS (mise à jour).
+ * @return Instruction* L'instruction analysée, ou NULL si la ligne est vide ou invalide (message sur stderr).
+ */
+Instruction *parse_data_instruction_r(const char *line, HashMap *memory_locations, HashMap *constantes, int *compteur);
+
 /**
  * @brief Analyse une ligne de la section .CODE.
  * 
@@ -77,7 +98,8 @@ Instruction *parse_code_instruction(const char *line, HashMap *labels, int code_
  * @brief Retourne la valeur actuelle du compteur global (adresse mémoire).
  * 
  * Cette fonction retourne l'adresse mémoire actuelle à partir du compteur global, qui est mis à jour 
- * lors du parsing des sections .DATA et .CODE.
+ * lors du parsing des sections .DATA et .CODE. Le compteur est propre à chaque thread : la valeur
+ * est celle du dernier `parse` du thread appelant.
  * 
  * @return int La valeur actuelle du compteur (adresse mémoire).
  */
@@ -0,0 +1,72 @@
+#ifndef PROGRAMME_FIGE_H
+#define PROGRAMME_FIGE_H
+
+#include "decodeur.h"
+
+// =============================
+// PROGRAMME FIGÉ (PARTAGÉ ENTRE CPU ET THREADS)
+// =============================
+
+/**
+ * @brief Programme décodé immuable, compté par références.
+ *
+ * Le code, les valeurs initiales de DS et les tables de symboles sont recopiés dans une
+ * seule zone projetée puis protégée en lecture seule (mprotect) : une écriture, même par
+ * erreur, est une faute de l'hôte et non une corruption silencieuse. N'importe quel nombre
+ * de CPU et de threads le lisent sans verrou ; seul le compteur de références est modifié,
+ * atomiquement. Un CPU créé par `cpu_init_frozen` ne possède que ses registres, DS et sa
+ * pile.
+ */
+typedef struct programme_fige ProgrammeFige;
+
+/**
+ * @brief Fige un programme.
+ *
+ * Le programme est consommé : ses tableaux sont recopiés puis il est libéré
+ * (`free_program`), y compris en cas d'échec. Les superinstructions éventuelles
+ * (`fuse_superinstructions`) doivent être produites avant.
+ *
+ * @param prog Programme décodé (assemble_buffer, decode_program, map_image...).
+ * @return ProgrammeFige* Le programme figé, avec une référence, ou NULL en cas d'échec.
+ */
+ProgrammeFige *program_freeze(Programme *prog);
+
+/**
+ * @brief Prend une référence de plus (sans verrou, depuis n'importe quel thread).
+ *
+ * @return ProgrammeFige* `fige`, pour écrire `x = frozen_acquire(f)`.
+ */
+ProgrammeFige *frozen_acquire(ProgrammeFige *fige);
+
+/**
+ * @brief Rend une référence ; la dernière libère le programme.
+ */
+void frozen_release(ProgrammeFige *fige);
+
+/**
+ * @brief Vue `Programme` du programme figé, utilisable par toutes les fonctions qui
+ *        prennent un `const Programme *` (run_decoded_program, batch_run, machine_create...).
+ *
+ * La vue est valide tant qu'une référence est tenue ; elle ne doit pas être passée à
+ * `free_program`.
+ */
+const Programme *frozen_program(const ProgrammeFige *fige);
+
+/**
+ * @brief Nombre de références courant (tests, diagnostic).
+ */
+int frozen_references(const ProgrammeFige *fige);
+
+/**
+ * @brief Crée un CPU prêt à exécuter le programme figé.
+ *
+ * La mémoire du CPU ne contient que DS (initialisé) et la pile, sans cases CS
+ * (`load_program_data`) ; la table des constantes du chemin textuel n'est pas créée. Le
+ * CPU tient une référence sur le programme, rendue par `cpu_destroy`.
+ *
+ * @param fige Programme figé.
+ * @return CPU* Le CPU (IP à 0, état CPU_EN_COURS), ou NULL en cas d'échec.
+ */
+CPU *cpu_init_frozen(ProgrammeFige *fige);
+
+#endif /* PROGRAMME_FIGE_H */
@@ -4,8 +4,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
-#define TABLE_SIZE 128  // Taille de la table de hachage
+#define TABLE_SIZE 128  // Taille initiale de la table de hachage (puissance de 2)
 
 // =============================
 // STRUCTURE : HashEntry
@@ -30,11 +32,13 @@ typedef struct hashentry {
 /**
  * @brief Représente une table de hachage.
  * 
- * Cette structure contient une table d'entrées de hachage. Elle utilise une taille fixe 
- * (`TABLE_SIZE`) pour déterminer le nombre de "buckets" ou compartiments dans la table.
+ * Cette structure contient une table d'entrées de hachage à adressage ouvert. Elle démarre
+ * avec `TABLE_SIZE` compartiments et double de taille dès qu'elle est à moitié pleine,
+ * de sorte qu'une recherche reste en temps constant quel que soit le nombre de clés.
  */
 typedef struct hashmap {
-    int size;         /**< Taille de la table de hachage */
+    int size;         /**< Taille de la table de hachage (puissance de 2) */
+    int count;        /**< Nombre de compartiments occupés (TOMBSTONE compris) */
     HashEntry *table; /**< Tableau d'entrées de hachage */
 } HashMap;
 
@@ -45,18 +49,18 @@ typedef struct hashmap {
 /**
  * @brief Fonction de hachage simple pour une chaîne de caractères.
  * 
- * Cette fonction calcule une valeur de hachage pour une chaîne donnée. Elle est utilisée 
- * pour déterminer l'emplacement de la clé dans la table de hachage.
+ * Cette fonction calcule une valeur de hachage (FNV-1a) pour une chaîne donnée. Elle est
+ * utilisée, réduite à la taille de la table, pour déterminer l'emplacement de la clé.
  * 
  * @param str La chaîne de caractères à hacher.
- * @return unsigned long La valeur de hachage calculée pour la chaîne.
+ * @return unsigned long La valeur de hachage calculée pour la chaîne (non réduite).
  */
 unsigned long simple_hash(const char *str);
 
 /**
  * @brief Crée et initialise une table de hachage.
  * 
- * Cette fonction crée une nouvelle table de hachage de taille fixe (`TABLE_SIZE`) et 
+ * Cette fonction crée une nouvelle table de hachage de taille initiale `TABLE_SIZE` et 
  * initialise toutes les entrées de la table à `NULL`.
  * 
  * @return HashMap* Pointeur vers la nouvelle table de hachage.
@@ -109,4 +113,116 @@ int hashmap_remove(HashMap *map, const char *key);
  */
 void hashmap_destroy(HashMap *map);
 
+/**
+ * @brief Détruit la table de hachage en libérant aussi chaque valeur.
+ *
+ * @param map Pointeur vers la table de hachage à détruire.
+ * @param free_value Appelée sur chaque valeur encore présente (par exemple `free`).
+ */
+void hashmap_destroy_values(HashMap *map, void (*free_value)(void *));
+
+// =============================
+// VARIANTE CONCURRENTE (LECTURES SANS VERROU)
+// =============================
+
+#define BANDES_LECTEURS 16  // Compteurs de lecteurs, un par bande de threads
+
+/**
+ * @brief Entrée d'une `HashMapConcurrente`.
+ *
+ * Une entrée publiée n'est plus modifiée, sauf sa valeur (remplacée atomiquement). Une
+ * suppression la retire de la table sans la toucher : un lecteur qui la tient encore la
+ * lit en entier avant qu'elle ne soit libérée.
+ */
+typedef struct entree_concurrente {
+    unsigned long hash;        /**< simple_hash(key), évite la plupart des strcmp */
+    _Atomic(void *) value;     /**< Valeur associée à la clé */
+    char key[];                /**< Clé (copiée) */
+} EntreeConcurrente;
+
+/**
+ * @brief Table d'une `HashMapConcurrente` : adressage ouvert, cases atomiques.
+ */
+typedef struct table_concurrente {
+    int size;                                /**< Nombre de cases (puissance de 2) */
+    int count;                               /**< Cases occupées (TOMBSTONE compris) */
+    _Atomic(EntreeConcurrente *) cases[];    /**< NULL, TOMBSTONE ou entrée publiée */
+} TableConcurrente;
+
+/**
+ * @brief Compteurs de lecteurs d'une bande, chacun sur sa propre ligne de cache.
+ */
+typedef struct {
+    _Alignas(64) atomic_long actifs[2];      /**< Lecteurs en cours, par phase */
+} BandeLecteurs;
+
+/**
+ * @brief Table de hachage pour les tables lues par plusieurs threads (symboles, segments...).
+ *
+ * Les lectures (`concurrent_hashmap_get`) ne prennent aucun verrou : un lecteur se signale
+ * dans le compteur de sa bande, lit la table courante puis se retire. Les écritures sont
+ * sérialisées par un verrou. Comme en RCU, une table agrandie est construite à côté puis
+ * publiée d'un seul pointeur ; l'ancienne table et les entrées supprimées ne sont libérées
+ * qu'après une période de grâce, quand aucun lecteur ne peut plus les tenir. Une écriture
+ * peut donc attendre la fin des lectures en cours, jamais l'inverse.
+ */
+typedef struct hashmap_concurrente {
+    _Atomic(TableConcurrente *) table;       /**< Table courante */
+    atomic_int phase;                        /**< Compteur (0 ou 1) où s'inscrivent les nouveaux lecteurs */
+    atomic_int nb_cles;                      /**< Clés présentes */
+    pthread_mutex_t verrou;                  /**< Sérialise insertions et suppressions */
+    BandeLecteurs lecteurs[BANDES_LECTEURS];
+} HashMapConcurrente;
+
+/**
+ * @brief Crée une table concurrente vide de `TABLE_SIZE` cases.
+ *
+ * @return HashMapConcurrente* La table, ou NULL en cas d'échec d'allocation.
+ */
+HashMapConcurrente *concurrent_hashmap_create(void);
+
+/**
+ * @brief Insère ou remplace une paire clé-valeur (sérialisé avec les autres écritures).
+ *
+ * Un remplacement est visible des lecteurs d'un seul coup ; une nouvelle clé aussi, une
+ * fois l'entrée entièrement écrite. Un agrandissement attend la fin des lectures de
+ * l'ancienne table avant de la libérer.
+ *
+ * @param map Table concurrente.
+ * @param key Clé (copiée).
+ * @param value Valeur associée.
+ * @return int 0 si succès, -1 en cas d'erreur.
+ */
+int concurrent_hashmap_insert(HashMapConcurrente *map, const char *key, void *value);
+
+/**
+ * @brief Recherche une clé, sans verrou, depuis n'importe quel thread.
+ *
+ * @param map Table concurrente.
+ * @param key Clé recherchée.
+ * @return void* La valeur associée, ou NULL si la clé est absente.
+ */
+void *concurrent_hashmap_get(HashMapConcurrente *map, const char *key);
+
+/**
+ * @brief Supprime une clé ; l'entrée est libérée après la fin des lectures en cours.
+ *
+ * @param map Table concurrente.
+ * @param key Clé à supprimer.
+ * @return int 0 si la clé a été supprimée, -1 si elle est absente ou en cas d'erreur.
+ */
+int concurrent_hashmap_remove(HashMapConcurrente *map, const char *key);
+
+/**
+ * @brief Nombre de clés présentes (instantané, lu sans verrou).
+ */
+int concurrent_hashmap_count(HashMapConcurrente *map);
+
+/**
+ * @brief Détruit la table ; aucun autre thread ne doit plus l'utiliser.
+ *
+ * Comme pour `hashmap_destroy`, les valeurs ne sont pas libérées.
+ */
+void concurrent_hashmap_destroy(HashMapConcurrente *map);
+
 #endif /* TH_GENERIQUE_H */
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef TRANSPILEUR_H
+#define TRANSPILEUR_H
+
+#include <stdio.h>
+#include "decodeur.h"
+
+// =============================
+// TRADUCTION EN C (COMPILATION ANTICIPÉE)
+// =============================
+
+/**
+ * @brief Traduit un programme décodé en un source C autonome.
+ *
+ * Chaque instruction devient du C en ligne droite précédé d'un label `L_<i>` (émis
+ * seulement s'il est la cible d'un saut), les registres deviennent des variables locales et
+ * la mémoire un tableau de `memory_size` cases accompagné d'un indicateur de présence, pour
+ * conserver la sémantique du MemoryHandler : DS à l'adresse 0, CS juste après, SS en fin de
+ * mémoire, ES pris au début de l'espace libre par ALLOC, cases vides (NULL) sans effet.
+ * Un saut dont la cible est calculée passe par un `switch` sur IP.
+ *
+ * Le programme généré ne dépend que de la bibliothèque standard ; une fois compilé (par
+ * exemple `cc -O2`), il affiche l'état final dans le format de `run_program`
+ * (`print_data_segment` puis `print_registers`) et se termine avec le code 1 si une
+ * instruction échoue, comme `run_decoded_program`.
+ *
+ * @param prog Programme décodé (les superinstructions sont traduites comme deux instructions).
+ * @param memory_size Taille de la mémoire, comme pour `cpu_init`.
+ * @param out Flux de sortie du source C.
+ * @return int 0 en cas de succès, -1 si les paramètres sont invalides ou la mémoire trop petite.
+ */
+int transpile_program(const Programme *prog, int memory_size, FILE *out);
+
+/**
+ * @brief Décode un résultat du parseur et le traduit en C (voir `transpile_program`).
+ *
+ * @param result Résultat de `parse` (symboles non résolus acceptés, comme `decode_program`).
+ * @param memory_size Taille de la mémoire, ou 0 pour la taille minimale (DS + CS + pile).
+ * @param out Flux de sortie du source C.
+ * @return int 0 en cas de succès, -1 en cas d'erreur de décodage ou de traduction.
+ */
+int transpile_parser_result(ParserResult *result, int memory_size, FILE *out);
+
+/**
+ * @brief Parse un fichier source et écrit sa traduction C dans un fichier.
+ *
+ * @param source Chemin du source assembleur.
+ * @param sortie Chemin du fichier C à écrire.
+ * @param memory_size Taille de la mémoire, ou 0 pour la taille minimale.
+ * @return int 0 en cas de succès, -1 sinon.
+ */
+int transpile_file(const char *source, const char *sortie, int memory_size);
+
+#endif /* TRANSPILEUR_H */
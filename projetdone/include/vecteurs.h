@@ -0,0 +1,76 @@
+#ifndef VECTEURS_H
+#define VECTEURS_H
+
+#include <stdint.h>
+
+// =============================
+// NOYAUX VECTORIELS (VADD, VMUL, VSUM)
+// =============================
+
+/**
+ * @brief Jeu d'instructions utilisé par les noyaux vectoriels.
+ */
+typedef enum {
+    VECTEURS_AUTO = -1,   /**< Meilleur niveau disponible (détecté par CPUID) */
+    VECTEURS_SCALAIRE,    /**< Boucles C simples (toutes plateformes) */
+    VECTEURS_SSE2,        /**< 4 mots par opération (x86) */
+    VECTEURS_AVX2         /**< 8 mots par opération (x86, si le processeur le permet) */
+} NiveauVecteurs;
+
+/**
+ * @brief Force le niveau utilisé par les noyaux (tests, mesures).
+ *
+ * Le choix est global au processus : à faire avant de lancer des exécutions en parallèle.
+ *
+ * @param niveau Niveau voulu, ou VECTEURS_AUTO pour revenir à la détection.
+ * @return int 0 en cas de succès, -1 si le processeur ne dispose pas de ce niveau.
+ */
+int vector_set_level(NiveauVecteurs niveau);
+
+/**
+ * @brief Niveau effectivement utilisé (forcé, ou détecté au premier appel).
+ */
+NiveauVecteurs vector_level(void);
+
+/**
+ * @brief Nom d'un niveau ("scalaire", "sse2", "avx2").
+ */
+const char *vector_level_name(NiveauVecteurs niveau);
+
+/**
+ * @brief dest[k] += src[k] pour k de 0 à n - 1 (arithmétique modulo 2^32).
+ *
+ * Le résultat est celui de la boucle dans l'ordre croissant, même si les plages se
+ * recouvrent : quand dest commence à l'intérieur de src, le noyau scalaire est utilisé.
+ *
+ * @param dest Mots modifiés.
+ * @param src Mots ajoutés.
+ * @param n Nombre de mots (rien n'est fait si n <= 0).
+ */
+void vector_add(int32_t *dest, const int32_t *src, int n);
+
+/**
+ * @brief dest[k] += valeur pour k de 0 à n - 1.
+ */
+void vector_add_scalar(int32_t *dest, int32_t valeur, int n);
+
+/**
+ * @brief dest[k] *= src[k] pour k de 0 à n - 1 (32 bits de poids faible du produit).
+ *
+ * Même règle de recouvrement que `vector_add`.
+ */
+void vector_mul(int32_t *dest, const int32_t *src, int n);
+
+/**
+ * @brief dest[k] *= valeur pour k de 0 à n - 1.
+ */
+void vector_mul_scalar(int32_t *dest, int32_t valeur, int n);
+
+/**
+ * @brief Somme de n mots, modulo 2^32.
+ *
+ * @return int32_t La somme, 0 si n <= 0.
+ */
+int32_t vector_sum(const int32_t *src, int n);
+
+#endif /* VECTEURS_H */
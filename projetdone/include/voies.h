@@ -0,0 +1,73 @@
+#ifndef VOIES_H
+#define VOIES_H
+
+#include <stdint.h>
+#include "decodeur.h"
+#include "lot.h"
+
+// =============================
+// EXÉCUTION PAR VOIES (SIMT)
+// =============================
+
+#define VOIES_MAX 16   // largeur d'un groupe : 8 ou 16 voies
+
+/**
+ * @brief Bilan d'un appel à `lanes_run`.
+ */
+typedef struct {
+    int largeur;                    /**< Voies par groupe */
+    int nb_jeux;
+    int nb_groupes;                 /**< Groupes exécutés (0 si le programme est passé par `batch_run`) */
+    int nb_echecs;                  /**< Jeux avec `statut` != 0 */
+    int scalaire;                   /**< 1 : programme hors du sous-ensemble, exécuté jeu par jeu */
+    long dispatchs;                 /**< Somme des dispatchs de tous les jeux */
+    long pas;                       /**< Instructions exécutées par les groupes (une pour toutes les voies actives) */
+    double occupation;              /**< dispatchs / (pas * largeur) : part moyenne des voies actives */
+    double duree;                   /**< Temps écoulé (secondes) */
+    double jeux_par_seconde;
+    double dispatchs_par_seconde;
+} BilanVoies;
+
+/**
+ * @brief Indique si un programme peut être exécuté par voies.
+ *
+ * Sous-ensemble accepté : MOV, ADD, CMP, JMP, JZ, JNZ, HALT et les superinstructions
+ * CMP_JZ / CMP_JNZ / MOV_ADD, avec des opérandes immédiats, registres (AX..DX, et ZF / SF
+ * par [XX]), cases de DS ([n] avec n < data_size) ou [DS:XX]. La pile, ES, les blocs, les
+ * vecteurs, les atomiques et les canaux n'en font pas partie.
+ *
+ * @return int 1 si le programme est accepté, 0 sinon.
+ */
+int lanes_supported(const Programme *prog);
+
+/**
+ * @brief Exécute un programme sur de nombreux jeux d'entrées, `largeur` jeux à la fois.
+ *
+ * Les jeux sont groupés par `largeur` (8 ou 16). Un groupe exécute une seule fois chaque
+ * instruction pour toutes ses voies : les registres et DS sont rangés par voie (une ligne
+ * de `largeur` mots par registre et par case), une instruction devient une opération sur la
+ * ligne, vectorisée par le compilateur (AVX2 quand `vector_level` le permet). Chaque voie a
+ * son IP ; un saut qui ne part pas dans la même direction pour toutes les voies les
+ * sépare : le groupe exécute alors l'instruction de plus petit IP pour les seules voies qui
+ * y sont (masque de voies actives), ce qui les réunit de nouveau après un if / else ou une
+ * boucle de longueur variable.
+ *
+ * Les résultats sont ceux de `batch_run` pour les mêmes tâches (registres, DS, dispatchs,
+ * statut -1 pour un saut vers une cible illisible). Un programme hors du sous-ensemble de
+ * `lanes_supported` est confié à `batch_run` sur un thread (`bilan->scalaire` vaut 1).
+ *
+ * @param prog Programme décodé, seulement lu.
+ * @param largeur 8 ou 16 voies (0 : VOIES_MAX).
+ * @param entrees `nb_jeux` lignes de `nb_entrees` valeurs, écrites dans DS[0..nb_entrees)
+ *                de chaque jeu après le chargement (NULL si nb_entrees vaut 0).
+ * @param nb_entrees Au plus `prog->data_size`.
+ * @param nb_jeux Nombre de jeux.
+ * @param resultats Tableau de `nb_jeux` résultats (à libérer avec `batch_results_free`).
+ * @param bilan Bilan global (NULL accepté).
+ * @return int 0 si les jeux ont été exécutés (même en échec), -1 si les paramètres sont
+ *         invalides ou en cas d'allocation impossible.
+ */
+int lanes_run(const Programme *prog, int largeur, const int32_t *entrees, int32_t nb_entrees, int nb_jeux,
+              ResultatLot *resultats, BilanVoies *bilan);
+
+#endif /* VOIES_H */
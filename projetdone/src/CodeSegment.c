@@ -6,6 +6,8 @@
 
 
 #include "../include/CodeSegment.h"
+#include "../include/expression.h"
+#include "../include/interpreteur.h"
 
 /*
  * Fonction trim
@@ -27,91 +29,102 @@ char * trim ( char * str ) {
     return str;
 }
 
+// Supprime les blancs de début et de fin sans déplacer le début de l'allocation
+static void trim_in_place(char *str) {
+    char *trimmed = trim(str);
+    if (trimmed != str) {
+        memmove(str, trimmed, strlen(trimmed) + 1);
+    }
+}
+
 /*
- * Fonction search_and_replace
- * Parcourt la table de hachage values et, pour chaque clé,
- * remplace (dans la chaîne *str) toutes les occurrences de cette clé par la valeur correspondante
- * (convertie en chaîne de caractères). Retourne 1 si un remplacement a été effectué, 0 sinon.
+ * Fonction resolve_symbol
+ * Résout un opérande qui est exactement un symbole (`nom`) ou un symbole entre crochets (`[nom]`) :
+ * une seule recherche exacte dans la table de hachage, jamais de remplacement de sous-chaîne
+ * (la variable `x` ne touche donc pas `xval`). Retourne 1 si l'opérande a été résolu, 0 sinon.
  */
-int search_and_replace(char **str, HashMap *values) {
-    if (!str || !*str || !values)
+int resolve_symbol(char **operand, HashMap *symbols, int brackets) {
+    if (!operand || !*operand || !symbols)
         return 0;
 
-    int replaced = 0;
-    char *input = *str;
-
-    for (int i = 0; i < values->size; i++) {
-        if (values->table[i].key && values->table[i].key != (void *)-1) {
-            char *key = values->table[i].key;
-
-            // ⚠️ Correction : on récupère correctement un int* et on le convertit en chaîne de caractères
-            int *ptr = (int *)values->table[i].value;
-            if (!ptr) continue;
+    const char *text = *operand;
+    size_t len = strlen(text);
+    int in_brackets = (len >= 2 && text[0] == '[' && text[len - 1] == ']');
+    if (in_brackets) {
+        text++;
+        len -= 2;
+    }
 
-            int value = *ptr;
+    char name[160];
+    if (len == 0 || len >= sizeof(name))
+        return 0;
+    memcpy(name, text, len);
+    name[len] = '\0';
 
-            // Préparer la chaîne de remplacement en tant qu'entier converti en chaîne
-            char replacement[64];
-            snprintf(replacement, sizeof(replacement), "%d", value);
+    // Un registre n'est jamais un symbole
+    if (register_index(name) >= 0)
+        return 0;
 
-            // Chercher toutes les occurrences dans input
-            char *new_str = NULL;
-            char *search_pos = input;
-            size_t key_len = strlen(key);
-            size_t repl_len = strlen(replacement);
+    int *value = (int *)hashmap_get(symbols, name);
+    if (!value)
+        return 0;
 
-            // Compter combien de fois on doit remplacer
-            int count = 0;
-            while ((search_pos = strstr(search_pos, key)) != NULL) {
-                count++;
-                search_pos += key_len;
-            }
+    char replacement[32];
+    if (in_brackets || brackets)
+        snprintf(replacement, sizeof(replacement), "[%d]", *value);
+    else
+        snprintf(replacement, sizeof(replacement), "%d", *value);
 
-            if (count == 0) continue;
+    char *new_str = strdup(replacement);
+    if (!new_str) {
+        fprintf(stderr, "Erreur d'allocation mémoire dans resolve_symbol.\n");
+        exit(EXIT_FAILURE);
+    }
+    free(*operand);
+    *operand = new_str;
+    return 1;
+}
 
-            // Calculer la taille de la nouvelle chaîne
-            size_t new_len = strlen(input) + count * (repl_len - key_len) + 1;
-            new_str = malloc(new_len);
-            if (!new_str) {
-                fprintf(stderr, "Erreur d'allocation mémoire dans search_and_replace.\n");
-                exit(EXIT_FAILURE);
-            }
 
-            // Construire la nouvelle chaîne avec les remplacements
-            char *src = input;
-            char *dest = new_str;
-            while (*src) {
-                if (strncmp(src, key, key_len) == 0) {
-                    strcpy(dest, replacement);
-                    src += key_len;
-                    dest += repl_len;
-                    replaced = 1;
-                } else {
-                    *dest++ = *src++;
-                }
-            }
-            *dest = '\0';
+/*
+ * Fonction resolve_expression
+ * Remplace un opérande qui est une expression constante (`SIZE*2+1`, constante EQU seule...)
+ * ou une telle expression entre crochets par sa valeur calculée. Retourne 1 si l'opérande a
+ * été remplacé, 0 sinon (registre, symbole, adressage par registre...).
+ */
+static int resolve_expression(char **operand, HashMap *constantes) {
+    if (!operand || !*operand)
+        return 0;
 
-            // Libérer et mettre à jour
-            free(input);
-            input = new_str;
-            *str = new_str;
-        }
+    char *text = *operand;
+    size_t len = strlen(text);
+    int in_brackets = (len >= 2 && text[0] == '[' && text[len - 1] == ']');
+
+    int32_t value;
+    char replacement[32];
+    if (in_brackets) {
+        text[len - 1] = '\0';
+        int rc = eval_expression(text + 1, constantes, &value);
+        text[len - 1] = ']';
+        if (rc != 0 || value < 0)
+            return 0;
+        snprintf(replacement, sizeof(replacement), "[%d]", value);
+    } else {
+        if (eval_expression(text, constantes, &value) != 0)
+            return 0;
+        snprintf(replacement, sizeof(replacement), "%d", value);
     }
 
-    // Nettoyage final avec trim
-    if (replaced) {
-        char *trimmed = trim(input);
-        if (trimmed != input) {
-            memmove(input, trimmed, strlen(trimmed) + 1);
-        }
+    char *new_str = strdup(replacement);
+    if (!new_str) {
+        fprintf(stderr, "Erreur d'allocation mémoire dans resolve_expression.\n");
+        exit(EXIT_FAILURE);
     }
-
-    return replaced;
+    free(*operand);
+    *operand = new_str;
+    return 1;
 }
 
-
-
 int resolve_constants(ParserResult *result) {
     if (!result || !result->code_instructions || result->code_count <= 0)
         return -1;
@@ -121,41 +134,23 @@ int resolve_constants(ParserResult *result) {
     for (int i = 0; i < result->code_count; i++) {
         // Trim des opérandes
         if (code[i]->operand1)
-            code[i]->operand1 = trim(code[i]->operand1);
+            trim_in_place(code[i]->operand1);
         if (code[i]->operand2)
-            code[i]->operand2 = trim(code[i]->operand2);
+            trim_in_place(code[i]->operand2);
 
         // Cas instruction à un seul opérande (labels : JMP, etc.)
         if (code[i]->operand2 == NULL) {
-           
-            search_and_replace(&code[i]->operand1, result->labels);
-          
+            if (!resolve_expression(&code[i]->operand1, result->constantes))
+                resolve_symbol(&code[i]->operand1, result->labels, 0);
         }
         else {
-            // operand1 peut aussi contenir une variable mémoire
-            search_and_replace(&code[i]->operand1, result->memory_locations);
-
-            // Remplacement dans operand2
-          
-            int replaced = search_and_replace(&code[i]->operand2, result->memory_locations);
-          
-
-            // Si on a remplacé ET qu'il n'y a pas déjà de [ ... ], on entoure
-            if (replaced) {
-                char *val = code[i]->operand2;
-                size_t n = strlen(val);
-                if (n == 0 || val[0] != '[' || val[n-1] != ']') {
-                    char *with_br = malloc(n + 3);
-                    if (!with_br) exit(1);
-                    with_br[0] = '[';
-                    memcpy(with_br+1, val, n);
-                    with_br[n+1] = ']';
-                    with_br[n+2] = '\0';
-                    free(code[i]->operand2);
-                    code[i]->operand2 = with_br;
-                    printf("→ Encadré : %s\n", code[i]->operand2);
-                }
-            }
+            // operand1 peut aussi contenir une variable mémoire (adresse laissée telle quelle)
+            if (!resolve_expression(&code[i]->operand1, result->constantes))
+                resolve_symbol(&code[i]->operand1, result->memory_locations, 0);
+
+            // Une variable en operand2 désigne toujours son contenu : on l'entoure de [ ... ]
+            if (!resolve_expression(&code[i]->operand2, result->constantes))
+                resolve_symbol(&code[i]->operand2, result->memory_locations, 1);
         }
     }
 
@@ -178,24 +173,48 @@ void allocate_code_segment(CPU *cpu, Instruction **code_instructions, int code_c
         return;
     }
 
-    // Étape 2 : stocker les instructions dans CS (chaque instruction dans une case)
+    // Étape 2 : stocker les instructions dans CS (chaque instruction dans une case) et
+    // ranger leurs immédiats dans la table des constantes, une fois pour toutes
     for (int i = 0; i < code_count; i++) {
         if (!store(cpu->memory_handler, "CS", i, code_instructions[i])) {
             fprintf(stderr, "Erreur : stockage de l'instruction %d échoué.\n", i);
         }
+        if (code_instructions[i]->operand1) immediate_adressing(cpu, code_instructions[i]->operand1);
+        if (code_instructions[i]->operand2) immediate_adressing(cpu, code_instructions[i]->operand2);
 
 
     }
 
     // Étape 3 : initialiser le registre IP à 0 dans le contexte du CPU
-    int *ip_value = malloc(sizeof(int));
+    // (on réutilise la case existante : cpu->registres[REG_IP] pointe dessus)
+    int *ip_value = (int *)hashmap_get(cpu->context, "IP");
     if (!ip_value) {
-        fprintf(stderr, "Erreur d'allocation mémoire pour IP.\n");
+        fprintf(stderr, "Erreur : registre IP introuvable.\n");
         return;
     }
     *ip_value = 0;
-    hashmap_insert(cpu->context, "IP", ip_value);
 }
+
+// Instructions confiées au moteur décodé (mêmes bornes, mêmes effets) : blocs, vecteurs,
+// atomiques et barrière
+static int par_decodeur(int opcode) {
+    switch (opcode) {
+        case OPC_MOVS:
+        case OPC_STOS:
+        case OPC_CMPS:
+        case OPC_VADD:
+        case OPC_VMUL:
+        case OPC_VSUM:
+        case OPC_XCHG:
+        case OPC_CMPXCHG:
+        case OPC_XADD:
+        case OPC_MFENCE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
 int handle_instruction(CPU *cpu, Instruction *instr, void *src, void *dest) {
     if (!cpu || !instr) return -1;
 
@@ -203,17 +222,20 @@ int handle_instruction(CPU *cpu, Instruction *instr, void *src, void *dest) {
     void *resolved_src  = instr->operand2 ? resolve_addressing(cpu, instr->operand2) : NULL;
     
     void *resolved_dest = instr->operand1 ? resolve_addressing(cpu, instr->operand1) : NULL;
-    
+
+    // Un immédiat n'est jamais écrit : MOV 5, AX est sans effet, comme dans execute_decoded
+    void *ecrite = constant_table_contains(cpu->constant_pool, resolved_dest) ? NULL : resolved_dest;
+
 
     if (strcmp(instr->mnemonic, "MOV") == 0) {
-        if (resolved_src && resolved_dest) {
-            handle_MOV(cpu, resolved_src, resolved_dest);
+        if (resolved_src && ecrite) {
+            handle_MOV(cpu, resolved_src, ecrite);
             printf("=> %s = %d\n", instr->operand1, *(int*)resolved_dest);
         }
     }
     else if (strcmp(instr->mnemonic, "ADD") == 0) {
-        if (resolved_src && resolved_dest) {
-            *(int*)resolved_dest += *(int*)resolved_src;
+        if (resolved_src && ecrite) {
+            *(int*)ecrite += *(int*)resolved_src;
             printf("=> %s = %d\n", instr->operand1, *(int*)resolved_dest);
         }
     }
@@ -221,13 +243,10 @@ int handle_instruction(CPU *cpu, Instruction *instr, void *src, void *dest) {
         if (resolved_src && resolved_dest) {
             int diff = *(int*)resolved_dest - *(int*)resolved_src;
             printf("%d\n",diff);
-            int *ZF = (int*)hashmap_get(cpu->context, "ZF");
-            int *SF = (int*)hashmap_get(cpu->context, "SF");
-            if (ZF) *ZF = (diff == 0);
-            if (SF) *SF = (diff < 0);
+            cpu_set_flags_cmp(cpu, *(int*)resolved_dest, *(int*)resolved_src);
             printf("=> ZF = %d, SF = %d\n",
-                   ZF ? *ZF : -1,
-                   SF ? *SF : -1);
+                   *cpu->registres[REG_ZF],
+                   *cpu->registres[REG_SF]);
         }
     }
     else if (strcmp(instr->mnemonic, "JMP") == 0) {
@@ -240,24 +259,24 @@ int handle_instruction(CPU *cpu, Instruction *instr, void *src, void *dest) {
         }
     }
     else if (strcmp(instr->mnemonic, "JZ") == 0) {
-        int *ZF = (int*)hashmap_get(cpu->context, "ZF");
+        int zf = *cpu->registres[REG_ZF];
         int *IP = (int*)hashmap_get(cpu->context, "IP");
-        if (ZF && *ZF == 1 && IP) {
+        if (zf == 1 && IP) {
             *IP = *(int*)resolved_dest;
         }
         printf("=> IP = %d (ZF = %d)\n",
                IP  ? *IP  : -1,
-               ZF  ? *ZF  : -1);
+               zf);
     }
     else if (strcmp(instr->mnemonic, "JNZ") == 0) {
-        int *ZF = (int*)hashmap_get(cpu->context, "ZF");
+        int zf = *cpu->registres[REG_ZF];
         int *IP = (int*)hashmap_get(cpu->context, "IP");
-        if (ZF && *ZF == 0  && IP) {
+        if (zf == 0  && IP) {
             *IP = *(int*)resolved_dest;
         }
         printf("=> IP = %d (ZF = %d)\n",
                IP  ? *IP  : -1,
-               ZF  ? *ZF  : -1);
+               zf);
     }
     else if (strcmp(instr->mnemonic, "HALT") == 0) {
         int *IP = (int*)hashmap_get(cpu->context, "IP");
@@ -277,12 +296,18 @@ int handle_instruction(CPU *cpu, Instruction *instr, void *src, void *dest) {
     else if (strcmp(instr->mnemonic, "POP") == 0) {
         
         if (instr->operand1) {
-            pop_value(cpu, (int*)resolved_dest);
+            pop_value(cpu, (int*)ecrite);
         }else{
             pop_value(cpu, (int*)hashmap_get(cpu->context, "AX"));
         }
         
     }
+    else if (strcmp(instr->mnemonic, "PUSHA") == 0) {
+        if (push_all_registers(cpu) != 0) printf("PUSHA : pile pleine\n");
+    }
+    else if (strcmp(instr->mnemonic, "POPA") == 0) {
+        if (pop_all_registers(cpu) != 0) printf("POPA : pile vide\n");
+    }
     else if (strcmp(instr->mnemonic, "ALLOC") == 0) {
         int rc = alloc_es_segment(cpu);
         if (rc != 0) {
@@ -299,6 +324,19 @@ int handle_instruction(CPU *cpu, Instruction *instr, void *src, void *dest) {
             printf("FREE réussi → ES libéré\n");
         }
     }
+    // Opérandes déjà résolus par resolve_constants : décodés sans table de symboles
+    else if (par_decodeur(decode_mnemonic(instr->mnemonic))) {
+        InstructionDecodee decodee;
+        if (decode_instruction(instr, NULL, NULL, NULL, &decodee) != 0) {
+            fprintf(stderr, "%s : opérande invalide\n", instr->mnemonic);
+            return -1;
+        }
+        if (execute_decoded(cpu, &decodee) != 0) {
+            printf("%s a échoué\n", instr->mnemonic);
+            return -1;
+        }
+        if (resolved_dest) printf("=> %s = %d\n", instr->operand1, *(int*)resolved_dest);
+    }
 
     else {
         return -1;
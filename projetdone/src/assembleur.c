@@ -0,0 +1,367 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/assembleur.h"
+
+#define SECTION_AUCUNE 0
+#define SECTION_DATA   1
+#define SECTION_CODE   2
+
+#define TAILLE_BLOC 65536  // Taille des lectures de assemble_stream
+
+Assembleur *assembler_create(void) {
+    Assembleur *as = calloc(1, sizeof(Assembleur));
+    if (!as) return NULL;
+
+    as->labels = hashmap_create();
+    as->memory_locations = hashmap_create();
+    as->constantes = hashmap_create();
+    as->attente_labels = hashmap_create();
+    as->attente_variables = hashmap_create();
+    if (!as->labels || !as->memory_locations || !as->constantes || !as->attente_labels || !as->attente_variables) {
+        assembler_destroy(as);
+        return NULL;
+    }
+    return as;
+}
+
+// Libère les valeurs d'une table de symboles (int*) puis la table
+static void detruire_symboles(HashMap *map) {
+    if (!map) return;
+    for (int i = 0; i < map->size; i++) {
+        if (map->table[i].key && map->table[i].key != (void *)-1) {
+            free(map->table[i].value);
+        }
+    }
+    hashmap_destroy(map);
+}
+
+// Libère les listes de correctifs d'une table d'attente puis la table
+static void detruire_attentes(HashMap *map) {
+    if (!map) return;
+    for (int i = 0; i < map->size; i++) {
+        if (map->table[i].key && map->table[i].key != (void *)-1) {
+            Correctif *c = map->table[i].value;
+            while (c) {
+                Correctif *suivant = c->suivant;
+                free(c);
+                c = suivant;
+            }
+        }
+    }
+    hashmap_destroy(map);
+}
+
+void assembler_destroy(Assembleur *as) {
+    if (!as) return;
+    free(as->ligne);
+    free(as->code);
+    free_compact_data(&as->donnees);
+    detruire_symboles(as->labels);
+    detruire_symboles(as->memory_locations);
+    detruire_symboles(as->constantes);
+    detruire_attentes(as->attente_labels);
+    detruire_attentes(as->attente_variables);
+    free(as);
+}
+
+static void erreur(Assembleur *as, const char *message, const char *detail) {
+    fprintf(stderr, "assembleur: ligne %d : %s%s%s\n", as->numero_ligne, message,
+            detail ? " : " : "", detail ? detail : "");
+    as->erreur = 1;
+}
+
+// Libère une instruction textuelle (chaînes comprises)
+static void liberer_instruction(Instruction *inst) {
+    free(inst->mnemonic);
+    free(inst->operand1);
+    free(inst->operand2);
+    free(inst);
+}
+
+// Nom du symbole contenu dans un opérande ("nom" ou "[nom]", blancs ignorés)
+static void nom_symbole(const char *texte, char *nom, size_t taille) {
+    while (*texte == ' ' || *texte == '\t' || *texte == '[') texte++;
+    size_t n = 0;
+    while (texte[n] && texte[n] != ']' && texte[n] != ' ' && texte[n] != '\t' &&
+           texte[n] != '\r' && texte[n] != '\n') n++;
+    if (n >= taille) n = taille - 1;
+    memcpy(nom, texte, n);
+    nom[n] = '\0';
+}
+
+// Enregistre une référence en avant vers `nom`
+static void attendre(Assembleur *as, HashMap *attente, const char *texte, int operande) {
+    char nom[160];
+    nom_symbole(texte, nom, sizeof(nom));
+
+    Correctif *c = malloc(sizeof(Correctif));
+    if (!c) {
+        erreur(as, "allocation impossible", NULL);
+        return;
+    }
+    c->instruction = as->code_count;
+    c->operande = operande;
+    c->suivant = hashmap_get(attente, nom);
+    if (hashmap_insert(attente, nom, c) != 0) {
+        free(c);
+        erreur(as, "allocation impossible", NULL);
+        return;
+    }
+    as->nb_attentes++;
+}
+
+// Corrige toutes les références en attente vers `nom`, qui vient d'être défini
+static void corriger(Assembleur *as, HashMap *attente, const char *nom, int valeur) {
+    Correctif *c = hashmap_get(attente, nom);
+    if (!c) return;
+
+    while (c) {
+        InstructionDecodee *instr = &as->code[c->instruction];
+        Operande *op = c->operande ? &instr->src : &instr->dest;
+        op->valeur = valeur;
+
+        Correctif *suivant = c->suivant;
+        free(c);
+        as->nb_attentes--;
+        c = suivant;
+    }
+    hashmap_remove(attente, nom);
+}
+
+// Décode un opérande ; un symbole encore inconnu devient une référence en attente
+static void decoder_operande(Assembleur *as, const char *texte, HashMap *symboles, HashMap *attente,
+                             int crochets, int operande, Operande *op) {
+    int rc = decode_operand(texte, symboles, as->constantes, crochets, op);
+    if (rc == DECODE_SYMBOLE_INCONNU) {
+        attendre(as, attente, texte, operande);
+    } else if (rc != 0) {
+        erreur(as, "opérande invalide", texte);
+    }
+}
+
+// Non nul si la ligne compte au moins trois mots (nom, type, valeurs)
+static int ligne_data_complete(const char *ligne) {
+    int n = -1;
+    sscanf(ligne, " %*s %*s %n", &n);
+    return n >= 0 && ligne[n] != '\0';
+}
+
+static void traiter_data(Assembleur *as, const char *ligne) {
+    int adresse = as->compteur;
+    Instruction *inst = parse_data_instruction_r(ligne, as->memory_locations, as->constantes, &as->compteur);
+    if (!inst) {
+        // Ligne vide ignorée, comme dans parse() ; une ligne complète refusée est une erreur
+        if (ligne_data_complete(ligne)) erreur(as, "ligne .DATA invalide", ligne);
+        return;
+    }
+
+    // Constante : enregistrée par le parser, aucune case de DS
+    if (strcmp(inst->operand1, "EQU") == 0) {
+        liberer_instruction(inst);
+        return;
+    }
+
+    // Les répétitions N DUP(v) restent une seule plage, jamais développées ici
+    if (compact_data_values(&as->donnees, inst->operand2) < 0) {
+        erreur(as, "allocation impossible", NULL);
+    }
+
+    corriger(as, as->attente_variables, inst->mnemonic, adresse);
+    liberer_instruction(inst);
+}
+
+static void traiter_code(Assembleur *as, const char *ligne) {
+    Instruction *inst = parse_code_instruction(ligne, as->labels, as->code_count);
+    if (!inst) return;  // Ligne ignorée, comme dans parse()
+
+    if (as->code_count == as->code_capacite) {
+        int capacite = as->code_capacite > 0 ? as->code_capacite * 2 : 64;
+        InstructionDecodee *code = realloc(as->code, sizeof(InstructionDecodee) * capacite);
+        if (!code) {
+            liberer_instruction(inst);
+            erreur(as, "allocation impossible", NULL);
+            return;
+        }
+        as->code = code;
+        as->code_capacite = capacite;
+    }
+
+    // Un label défini sur cette ligne résout les sauts en avant vers lui
+    char label[50];
+    if (sscanf(ligne, " %49[^:]:", label) == 1) {
+        int *indice = hashmap_get(as->labels, label);
+        if (indice && *indice == as->code_count) {
+            corriger(as, as->attente_labels, label, as->code_count);
+        }
+    }
+
+    InstructionDecodee *out = &as->code[as->code_count];
+    out->opcode = decode_mnemonic(inst->mnemonic);
+    if (out->opcode == OPC_INVALIDE) {
+        erreur(as, "mnémonique inconnu", inst->mnemonic);
+        liberer_instruction(inst);
+        return;
+    }
+
+    // Mêmes règles que decode_instruction : un seul opérande -> labels, sinon variables
+    if (inst->operand2 == NULL) {
+        decode_operand(NULL, NULL, NULL, 0, &out->src);
+        decoder_operande(as, inst->operand1, as->labels, as->attente_labels, 0, 0, &out->dest);
+    } else {
+        decoder_operande(as, inst->operand1, as->memory_locations, as->attente_variables, 0, 0, &out->dest);
+        decoder_operande(as, inst->operand2, as->memory_locations, as->attente_variables, 1, 1, &out->src);
+    }
+
+    as->code_count++;
+    liberer_instruction(inst);
+}
+
+// Traite une ligne complète (sans '\n')
+static void traiter_ligne(Assembleur *as, char *ligne) {
+    as->numero_ligne++;
+
+    size_t n = strlen(ligne);
+    if (n > 0 && ligne[n-1] == '\r') ligne[n-1] = '\0';
+
+    // Détecter la section actuelle
+    if (strncmp(ligne, ".DATA", 5) == 0) {
+        as->section = SECTION_DATA;
+        return;
+    }
+    if (strncmp(ligne, ".CODE", 5) == 0) {
+        as->section = SECTION_CODE;
+        return;
+    }
+
+    if (as->section == SECTION_DATA) {
+        traiter_data(as, ligne);
+    } else if (as->section == SECTION_CODE) {
+        traiter_code(as, ligne);
+    }
+}
+
+// Ajoute des octets à la ligne en cours
+static int ajouter(Assembleur *as, const char *texte, size_t taille) {
+    if (as->longueur + taille + 1 > as->capacite) {
+        size_t capacite = as->capacite > 0 ? as->capacite : 256;
+        while (capacite < as->longueur + taille + 1) capacite *= 2;
+        char *ligne = realloc(as->ligne, capacite);
+        if (!ligne) return -1;
+        as->ligne = ligne;
+        as->capacite = capacite;
+    }
+    memcpy(as->ligne + as->longueur, texte, taille);
+    as->longueur += taille;
+    as->ligne[as->longueur] = '\0';
+    return 0;
+}
+
+int assembler_feed(Assembleur *as, const char *texte, size_t taille) {
+    if (!as || (!texte && taille > 0)) return -1;
+
+    while (taille > 0 && !as->erreur) {
+        const char *fin = memchr(texte, '\n', taille);
+        size_t morceau = fin ? (size_t)(fin - texte) : taille;
+
+        if (ajouter(as, texte, morceau) != 0) {
+            erreur(as, "allocation impossible", NULL);
+            break;
+        }
+        if (!fin) break;
+
+        // Ligne complète : on la traite puis on vide le tampon
+        traiter_ligne(as, as->ligne);
+        as->longueur = 0;
+        as->ligne[0] = '\0';
+
+        texte += morceau + 1;
+        taille -= morceau + 1;
+    }
+
+    return as->erreur ? -1 : 0;
+}
+
+// Signale chaque symbole resté sans définition
+static void signaler_attentes(HashMap *attente) {
+    for (int i = 0; i < attente->size; i++) {
+        if (attente->table[i].key && attente->table[i].key != (void *)-1) {
+            fprintf(stderr, "assembleur: symbole '%s' jamais défini\n", attente->table[i].key);
+        }
+    }
+}
+
+Programme *assembler_finish(Assembleur *as) {
+    if (!as) return NULL;
+
+    // Dernière ligne sans '\n'
+    if (!as->erreur && as->longueur > 0) {
+        traiter_ligne(as, as->ligne);
+        as->longueur = 0;
+    }
+
+    if (!as->erreur && as->nb_attentes > 0) {
+        signaler_attentes(as->attente_labels);
+        signaler_attentes(as->attente_variables);
+        as->erreur = 1;
+    }
+
+    Programme *prog = as->erreur ? NULL : calloc(1, sizeof(Programme));
+    if (!prog) {
+        assembler_destroy(as);
+        return NULL;
+    }
+
+    // Le programme reprend les tableaux du contexte
+    prog->code = as->code ? as->code : malloc(sizeof(InstructionDecodee));
+    prog->code_count = as->code_count;
+    prog->valeurs = as->donnees.valeurs ? as->donnees.valeurs : calloc(1, sizeof(int32_t));
+    prog->valeur_count = as->donnees.valeur_count;
+    prog->plages = as->donnees.plages ? as->donnees.plages : calloc(1, sizeof(PlageDonnees));
+    prog->plage_count = as->donnees.plage_count;
+    prog->data_size = as->compteur;
+    prog->labels = extract_symbols(as->labels, &prog->label_count);
+    prog->variables = extract_symbols(as->memory_locations, &prog->variable_count);
+    as->code = NULL;
+    as->donnees.valeurs = NULL;
+    as->donnees.plages = NULL;
+    assembler_destroy(as);
+
+    if (!prog->code || !prog->valeurs || !prog->plages || !prog->labels || !prog->variables) {
+        free_program(prog);
+        return NULL;
+    }
+    return prog;
+}
+
+Programme *assemble_buffer(const char *texte, size_t taille) {
+    Assembleur *as = assembler_create();
+    if (!as) return NULL;
+    assembler_feed(as, texte, taille);
+    return assembler_finish(as);
+}
+
+Programme *assemble_stream(FILE *flux) {
+    if (!flux) return NULL;
+
+    Assembleur *as = assembler_create();
+    char *bloc = malloc(TAILLE_BLOC);
+    if (!as || !bloc) {
+        free(bloc);
+        assembler_destroy(as);
+        return NULL;
+    }
+
+    size_t lus;
+    while ((lus = fread(bloc, 1, TAILLE_BLOC, flux)) > 0) {
+        if (assembler_feed(as, bloc, lus) != 0) break;
+    }
+    if (ferror(flux)) {
+        perror("assemble_stream: lecture");
+        as->erreur = 1;
+    }
+
+    free(bloc);
+    return assembler_finish(as);
+}
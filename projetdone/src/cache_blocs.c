@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/cache_blocs.h"
+
+static inline int est_superinstruction(int opcode) {
+    return EST_SUPERINSTRUCTION(opcode);
+}
+
+static int est_saut(int opcode) {
+    return opcode == OPC_JMP || opcode == OPC_JZ || opcode == OPC_JNZ || opcode == OPC_HALT;
+}
+
+static int lit_ip(const InstructionDecodee *instr) {
+    const Operande *ops[2] = { &instr->dest, &instr->src };
+    for (int k = 0; k < 2; k++) {
+        if ((ops[k]->mode == MODE_INDIRECT || ops[k]->mode == MODE_SEGMENT) && ops[k]->valeur == REG_IP) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+CacheBlocs *block_cache_create(const Programme *prog) {
+    if (!prog) return NULL;
+
+    CacheBlocs *cache = calloc(1, sizeof(CacheBlocs));
+    if (!cache) return NULL;
+    cache->prog = prog;
+    cache->par_ip = calloc(prog->code_count > 0 ? prog->code_count : 1, sizeof(BlocBase *));
+    if (!cache->par_ip) {
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+static void trace_free(Trace *trace) {
+    if (!trace) return;
+    free(trace->code);
+    free(trace->ops);
+    free(trace);
+}
+
+void block_cache_destroy(CacheBlocs *cache) {
+    if (!cache) return;
+    trace_free(cache->enregistrement);
+    for (int32_t i = 0; i < cache->prog->code_count; i++) {
+        if (cache->par_ip[i]) trace_free(cache->par_ip[i]->trace);
+        free(cache->par_ip[i]);
+    }
+    free(cache->par_ip);
+    free(cache);
+}
+
+BlocBase *block_cache_get(CacheBlocs *cache, int32_t ip) {
+    const Programme *prog = cache->prog;
+    if (ip < 0 || ip >= prog->code_count) return NULL;
+    if (cache->par_ip[ip]) return cache->par_ip[ip];
+
+    BlocBase *bloc = calloc(1, sizeof(BlocBase));
+    if (!bloc) return NULL;
+    bloc->debut = ip;
+    bloc->ops = &prog->code[ip];
+    bloc->ip_cible = -1;
+
+    // Jusqu'à la première instruction qui peut changer IP ; une superinstruction est
+    // gardée entière, sa seconde moitié pouvant être le saut
+    int32_t i = ip;
+    while (i < prog->code_count) {
+        const InstructionDecodee *instr = &prog->code[i];
+        const InstructionDecodee *fin = instr;
+        if (est_superinstruction(instr->opcode)) fin = instr + 1;
+        i = (int32_t)(fin - prog->code) + 1;
+
+        if (est_saut(fin->opcode)) {
+            if (fin->opcode != OPC_HALT && fin->dest.mode == MODE_IMMEDIAT) bloc->ip_cible = fin->dest.valeur;
+            break;
+        }
+        if (lit_ip(instr) || lit_ip(fin)) break;
+    }
+    bloc->longueur = i - ip;
+    bloc->ip_suivant = i;
+
+    cache->par_ip[ip] = bloc;
+    cache->nb_blocs++;
+    return bloc;
+}
+
+void block_cache_enable_traces(CacheBlocs *cache, int seuil) {
+    if (cache) cache->seuil_trace = seuil > 0 ? seuil : 0;
+}
+
+void trace_start(CacheBlocs *cache, BlocBase *entete) {
+    if (!cache || !entete || cache->enregistrement) return;
+    cache->enregistrement = calloc(1, sizeof(Trace));
+    if (!cache->enregistrement) return;
+    cache->enregistrement->entree = entete->debut;
+    cache->entete = entete;
+}
+
+// Copie `nb` instructions consécutives dans la trace ; retourne l'indice de la première
+static int32_t copier_instructions(Trace *trace, const InstructionDecodee *instr, int32_t nb) {
+    if (trace->code_count + nb > trace->code_capacite) {
+        int32_t capacite = trace->code_capacite > 0 ? trace->code_capacite * 2 : 32;
+        while (capacite < trace->code_count + nb) capacite *= 2;
+        InstructionDecodee *code = realloc(trace->code, sizeof(InstructionDecodee) * capacite);
+        if (!code) return -1;
+        trace->code = code;
+        trace->code_capacite = capacite;
+    }
+    memcpy(trace->code + trace->code_count, instr, sizeof(InstructionDecodee) * nb);
+    trace->code_count += nb;
+    return trace->code_count - nb;
+}
+
+static OpTrace *ajouter_op(Trace *trace, GenreOpTrace genre) {
+    if (trace->nb_ops >= TRACE_MAX_OPS) return NULL;
+    if (trace->nb_ops == trace->ops_capacite) {
+        int32_t capacite = trace->ops_capacite > 0 ? trace->ops_capacite * 2 : 32;
+        OpTrace *ops = realloc(trace->ops, sizeof(OpTrace) * capacite);
+        if (!ops) return NULL;
+        trace->ops = ops;
+        trace->ops_capacite = capacite;
+    }
+    OpTrace *op = &trace->ops[trace->nb_ops++];
+    memset(op, 0, sizeof(*op));
+    op->genre = genre;
+    return op;
+}
+
+// Ajoute l'exécution de `nb` instructions (une superinstruction en copie deux)
+static int ajouter_exec(Trace *trace, const InstructionDecodee *instr, int32_t nb, int32_t ip_apres) {
+    OpTrace *op = ajouter_op(trace, TRACE_EXEC);
+    if (!op) return -1;
+    op->instr = copier_instructions(trace, instr, nb);
+    op->ip_apres = ip_apres;
+    return op->instr < 0 ? -1 : 0;
+}
+
+static int abandonner(CacheBlocs *cache) {
+    cache->entete->trace_impossible = 1;
+    trace_free(cache->enregistrement);
+    cache->enregistrement = NULL;
+    cache->entete = NULL;
+    return -1;
+}
+
+int trace_record_block(CacheBlocs *cache, const BlocBase *bloc, int32_t ip_apres) {
+    Trace *trace = cache->enregistrement;
+    if (!trace) return -1;
+
+    const InstructionDecodee *code = cache->prog->code;
+    const InstructionDecodee *instr = bloc->ops;
+    const InstructionDecodee *fin = bloc->ops + bloc->longueur;
+    int termine = 0;
+
+    while (instr < fin) {
+        int32_t indice = (int32_t)(instr - code);
+        int fusion = est_superinstruction(instr->opcode);
+        const InstructionDecodee *saut = fusion ? instr + 1 : instr;
+
+        if (instr + (fusion ? 2 : 1) < fin || !est_saut(saut->opcode)) {
+            // Corps du bloc (ou bloc coupé par [IP] / fin du code : abandon plus bas)
+            if (lit_ip(instr) || (fusion && lit_ip(instr + 1))) return abandonner(cache);
+            if (ajouter_exec(trace, instr, fusion ? 2 : 1, indice + 1) != 0) return abandonner(cache);
+            instr += fusion ? 2 : 1;
+            continue;
+        }
+
+        // Saut final : la moitié CMP d'une superinstruction est exécutée seule
+        if (fusion) {
+            InstructionDecodee cmp = *instr;
+            cmp.opcode = OPC_CMP;
+            if (ajouter_exec(trace, &cmp, 1, indice + 1) != 0) return abandonner(cache);
+        }
+        if (saut->dest.mode != MODE_IMMEDIAT || saut->opcode == OPC_HALT) return abandonner(cache);
+        if (saut->opcode == OPC_JZ || saut->opcode == OPC_JNZ) {
+            OpTrace *garde = ajouter_op(trace, TRACE_GARDE);
+            if (!garde) return abandonner(cache);
+            int32_t cible = saut->dest.valeur;
+            int32_t sequence = (int32_t)(saut - code) + 1;
+            garde->zf_saut = saut->opcode == OPC_JZ ? 1 : 0;
+            garde->pris = ip_apres == cible;
+            garde->sortie = garde->pris ? sequence : cible;
+        }
+        termine = 1;
+        instr = fin;
+    }
+
+    if (!termine || ip_apres < 0 || ip_apres >= cache->prog->code_count) return abandonner(cache);
+    if (ip_apres != cache->entete->debut) return 0;
+
+    // Retour à l'entête : la trace est installée
+    cache->entete->trace = trace;
+    cache->enregistrement = NULL;
+    cache->entete = NULL;
+    cache->nb_traces++;
+    return 1;
+}
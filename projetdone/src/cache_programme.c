@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#include "../include/cache_programme.h"
+#include "../include/assembleur.h"
+#include "../include/objet.h"
+
+uint64_t hash_source(const void *data, size_t taille) {
+    const unsigned char *octets = data;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < taille; i++) {
+        hash ^= octets[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash ? hash : 1;  // 0 est réservé à « empreinte inconnue »
+}
+
+CacheProgrammes *program_cache_create(const char *repertoire, int capacite) {
+    CacheProgrammes *cache = calloc(1, sizeof(CacheProgrammes));
+    if (!cache) return NULL;
+
+    cache->capacite = capacite > 0 ? capacite : 1;
+    cache->index = hashmap_create();
+    if (!cache->index) {
+        free(cache);
+        return NULL;
+    }
+
+    if (repertoire) {
+        if (mkdir(repertoire, 0755) != 0 && errno != EEXIST) {
+            perror("program_cache_create: création du répertoire");
+        }
+        cache->repertoire = strdup(repertoire);
+    }
+    return cache;
+}
+
+static void liberer_entree(EntreeCache *e) {
+    free_program(e->prog);
+    free(e->source);
+    free(e);
+}
+
+void program_cache_destroy(CacheProgrammes *cache) {
+    if (!cache) return;
+
+    EntreeCache *e = cache->tete;
+    while (e) {
+        EntreeCache *suiv = e->suiv;
+        liberer_entree(e);
+        e = suiv;
+    }
+    hashmap_destroy(cache->index);
+    free(cache->repertoire);
+    free(cache);
+}
+
+static void cle_hash(uint64_t hash, char *cle, size_t taille) {
+    snprintf(cle, taille, "%016" PRIx64, hash);
+}
+
+// Chemin de l'image : l'empreinte et la version du format font partie du nom
+static void chemin_image(const CacheProgrammes *cache, uint64_t hash, char *chemin, size_t taille) {
+    snprintf(chemin, taille, "%s/%016" PRIx64 "-v%u.img", cache->repertoire, hash, IMAGE_VERSION);
+}
+
+// Retire une entrée de la liste LRU (sans la libérer)
+static void detacher(CacheProgrammes *cache, EntreeCache *e) {
+    if (e->prec) e->prec->suiv = e->suiv;
+    else cache->tete = e->suiv;
+    if (e->suiv) e->suiv->prec = e->prec;
+    else cache->queue = e->prec;
+    e->prec = e->suiv = NULL;
+}
+
+// Place une entrée en tête de la liste LRU
+static void en_tete(CacheProgrammes *cache, EntreeCache *e) {
+    e->prec = NULL;
+    e->suiv = cache->tete;
+    if (cache->tete) cache->tete->prec = e;
+    cache->tete = e;
+    if (!cache->queue) cache->queue = e;
+}
+
+// Retire une entrée de la LRU et de l'index, et la libère
+static void evincer(CacheProgrammes *cache, EntreeCache *e) {
+    char cle[32];
+    detacher(cache, e);
+    cle_hash(e->hash, cle, sizeof(cle));
+    hashmap_remove(cache->index, cle);
+    liberer_entree(e);
+    cache->nb_entrees--;
+    cache->evictions++;
+}
+
+// Ajoute un programme à la LRU, en évinçant la moins récemment utilisée si nécessaire
+static const Programme *inserer(CacheProgrammes *cache, uint64_t hash, const char *texte, size_t taille,
+                                Programme *prog) {
+    char cle[32];
+
+    if (cache->nb_entrees >= cache->capacite && cache->queue) evincer(cache, cache->queue);
+
+    EntreeCache *e = calloc(1, sizeof(EntreeCache));
+    char *source = malloc(taille > 0 ? taille : 1);
+    if (!e || !source) {
+        free(e);
+        free(source);
+        free_program(prog);
+        return NULL;
+    }
+    if (taille > 0) memcpy(source, texte, taille);
+    e->hash = hash;
+    e->source = source;
+    e->taille = taille;
+    e->prog = prog;
+
+    cle_hash(hash, cle, sizeof(cle));
+    if (hashmap_insert(cache->index, cle, e) != 0) {
+        liberer_entree(e);
+        return NULL;
+    }
+    en_tete(cache, e);
+    cache->nb_entrees++;
+    return prog;
+}
+
+const Programme *program_cache_load_buffer(CacheProgrammes *cache, const char *texte, size_t taille) {
+    if (!cache || (!texte && taille > 0)) return NULL;
+
+    uint64_t hash = hash_source(texte, taille);
+    char cle[32];
+    cle_hash(hash, cle, sizeof(cle));
+
+    // 1) LRU en mémoire : même empreinte et même texte. Une collision évince l'entrée ;
+    // l'image du répertoire, nommée d'après la même empreinte, n'est alors ni lue ni
+    // remplacée.
+    int collision = 0;
+    EntreeCache *e = hashmap_get(cache->index, cle);
+    if (e && e->taille == taille && (taille == 0 || memcmp(e->source, texte, taille) == 0)) {
+        detacher(cache, e);
+        en_tete(cache, e);
+        cache->hits_memoire++;
+        return e->prog;
+    }
+    if (e) {
+        evincer(cache, e);
+        collision = 1;
+    }
+
+    // 2) Répertoire d'images : l'en-tête doit porter la même empreinte
+    char chemin[4096];
+    if (cache->repertoire && !collision) {
+        chemin_image(cache, hash, chemin, sizeof(chemin));
+        Programme *prog = map_image(chemin);
+        if (prog && prog->source_hash == hash) {
+            cache->hits_disque++;
+            return inserer(cache, hash, texte, taille, prog);
+        }
+        free_program(prog);
+    }
+
+    // 3) Échec : assemblage complet, puis enregistrement aux deux niveaux
+    cache->misses++;
+    Programme *prog = assemble_buffer(texte, taille);
+    if (!prog) return NULL;
+    prog->source_hash = hash;
+
+    if (cache->repertoire && !collision && write_image(prog, chemin) != 0) {
+        fprintf(stderr, "program_cache_load: écriture de '%s' impossible\n", chemin);
+    }
+    return inserer(cache, hash, texte, taille, prog);
+}
+
+const Programme *program_cache_load(CacheProgrammes *cache, const char *chemin) {
+    FILE *f = fopen(chemin, "rb");
+    if (!f) {
+        perror("program_cache_load: ouverture du source");
+        return NULL;
+    }
+
+    // Le source entier est nécessaire pour calculer son empreinte
+    char *texte = NULL;
+    size_t taille = 0, capacite = 0, lus;
+    char bloc[65536];
+    while ((lus = fread(bloc, 1, sizeof(bloc), f)) > 0) {
+        if (taille + lus > capacite) {
+            capacite = (taille + lus) * 2;
+            char *nouveau = realloc(texte, capacite);
+            if (!nouveau) {
+                free(texte);
+                fclose(f);
+                return NULL;
+            }
+            texte = nouveau;
+        }
+        memcpy(texte + taille, bloc, lus);
+        taille += lus;
+    }
+    fclose(f);
+
+    const Programme *prog = program_cache_load_buffer(cache, texte ? texte : "", taille);
+    free(texte);
+    return prog;
+}
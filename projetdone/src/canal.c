@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "../include/canal.h"
+
+#define LIGNE_CACHE 64
+
+// Les positions sont des compteurs qui ne font que croître ; la case est position & masque.
+// Producteur et consommateur écrivent sur des lignes de cache différentes ; en SPSC, chacun
+// garde une copie de la position de l'autre et ne relit l'originale que lorsque l'anneau
+// lui semble plein (ou vide).
+struct canal {
+    TypeCanal type;
+    size_t masque;
+    int32_t *cases;
+    atomic_size_t *sequences;                           // MPMC : numéro de tour de chaque case
+
+    _Alignas(LIGNE_CACHE) atomic_size_t queue;          // Prochaine écriture
+    size_t tete_vue;                                    // SPSC : copie de `tete` du producteur
+
+    _Alignas(LIGNE_CACHE) atomic_size_t tete;           // Prochaine lecture
+    size_t queue_vue;                                   // SPSC : copie de `queue` du consommateur
+
+    _Alignas(LIGNE_CACHE) atomic_int emetteur;          // SPSC : cœur émetteur, -1 si libre
+    atomic_int recepteur;
+    atomic_int endormis;                                // Cœurs dans channel_wait
+    pthread_mutex_t verrou;
+    pthread_cond_t signal;
+};
+
+Canal *channel_create(TypeCanal type, int capacite) {
+    if (capacite < 1 || capacite > (1 << 24) || (type != CANAL_SPSC && type != CANAL_MPMC)) {
+        fprintf(stderr, "channel_create: paramètres invalides.\n");
+        return NULL;
+    }
+    // MPMC : au moins 2 cases, sinon la séquence « pleine » d'une case (position + 1) serait
+    // aussi celle « libre au tour suivant »
+    size_t taille = type == CANAL_MPMC ? 2 : 1;
+    while (taille < (size_t)capacite) taille <<= 1;
+
+    Canal *c = aligned_alloc(LIGNE_CACHE, (sizeof(Canal) + LIGNE_CACHE - 1) / LIGNE_CACHE * LIGNE_CACHE);
+    if (!c) return NULL;
+    memset(c, 0, sizeof(*c));
+    c->type = type;
+    c->masque = taille - 1;
+    c->cases = malloc(sizeof(int32_t) * taille);
+    if (type == CANAL_MPMC) c->sequences = malloc(sizeof(atomic_size_t) * taille);
+    if (!c->cases || (type == CANAL_MPMC && !c->sequences)) {
+        free(c->cases);
+        free(c->sequences);
+        free(c);
+        return NULL;
+    }
+    for (size_t k = 0; type == CANAL_MPMC && k < taille; k++) atomic_init(&c->sequences[k], k);
+    atomic_init(&c->queue, 0);
+    atomic_init(&c->tete, 0);
+    atomic_init(&c->emetteur, -1);
+    atomic_init(&c->recepteur, -1);
+    atomic_init(&c->endormis, 0);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&c->signal, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&c->verrou, NULL);
+    return c;
+}
+
+void channel_destroy(Canal *canal) {
+    if (!canal) return;
+    pthread_mutex_destroy(&canal->verrou);
+    pthread_cond_destroy(&canal->signal);
+    free(canal->cases);
+    free(canal->sequences);
+    free(canal);
+}
+
+TypeCanal channel_type(const Canal *canal) {
+    return canal->type;
+}
+
+int channel_bind(Canal *canal, int envoi, int coeur) {
+    if (canal->type != CANAL_SPSC) return 0;
+    atomic_int *bout = envoi ? &canal->emetteur : &canal->recepteur;
+    int actuel = atomic_load_explicit(bout, memory_order_relaxed);
+    if (actuel == coeur) return 0;
+    if (actuel != -1) return -1;
+    int libre = -1;
+    // Deux cœurs qui se disputent un bout libre : un seul l'obtient
+    if (atomic_compare_exchange_strong(bout, &libre, coeur)) return 0;
+    return libre == coeur ? 0 : -1;
+}
+
+// Un envoi ou une réception a changé l'état du canal : réveille ceux qui l'attendent.
+// La barrière ordonne l'écriture de la position avant la lecture de `endormis` ; channel_wait
+// fait l'inverse, l'un des deux voit forcément l'autre.
+static void reveiller(Canal *canal) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&canal->endormis, memory_order_relaxed) > 0) {
+        pthread_mutex_lock(&canal->verrou);
+        pthread_cond_broadcast(&canal->signal);
+        pthread_mutex_unlock(&canal->verrou);
+    }
+}
+
+// -----------------------------------
+// SPSC
+// -----------------------------------
+
+static int spsc_envoyer(Canal *c, int32_t valeur) {
+    size_t queue = atomic_load_explicit(&c->queue, memory_order_relaxed);
+    if (queue - c->tete_vue > c->masque) {
+        c->tete_vue = atomic_load_explicit(&c->tete, memory_order_acquire);
+        if (queue - c->tete_vue > c->masque) return 0;
+    }
+    c->cases[queue & c->masque] = valeur;
+    atomic_store_explicit(&c->queue, queue + 1, memory_order_release);
+    return 1;
+}
+
+static int spsc_recevoir(Canal *c, int32_t *valeur) {
+    size_t tete = atomic_load_explicit(&c->tete, memory_order_relaxed);
+    if (tete == c->queue_vue) {
+        c->queue_vue = atomic_load_explicit(&c->queue, memory_order_acquire);
+        if (tete == c->queue_vue) return 0;
+    }
+    *valeur = c->cases[tete & c->masque];
+    atomic_store_explicit(&c->tete, tete + 1, memory_order_release);
+    return 1;
+}
+
+// -----------------------------------
+// MPMC : la séquence d'une case vaut sa position quand elle est libre pour l'écriture de
+// ce tour, position + 1 quand elle contient le mot de ce tour
+// -----------------------------------
+
+static int mpmc_envoyer(Canal *c, int32_t valeur) {
+    size_t position = atomic_load_explicit(&c->queue, memory_order_relaxed);
+    for (;;) {
+        size_t sequence = atomic_load_explicit(&c->sequences[position & c->masque], memory_order_acquire);
+        intptr_t ecart = (intptr_t)(sequence - position);
+        if (ecart == 0) {
+            if (atomic_compare_exchange_weak_explicit(&c->queue, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) break;
+        } else if (ecart < 0) {
+            return 0;   // la case n'a pas encore été lue au tour précédent : plein
+        } else {
+            position = atomic_load_explicit(&c->queue, memory_order_relaxed);
+        }
+    }
+    c->cases[position & c->masque] = valeur;
+    atomic_store_explicit(&c->sequences[position & c->masque], position + 1, memory_order_release);
+    return 1;
+}
+
+static int mpmc_recevoir(Canal *c, int32_t *valeur) {
+    size_t position = atomic_load_explicit(&c->tete, memory_order_relaxed);
+    for (;;) {
+        size_t sequence = atomic_load_explicit(&c->sequences[position & c->masque], memory_order_acquire);
+        intptr_t ecart = (intptr_t)(sequence - (position + 1));
+        if (ecart == 0) {
+            if (atomic_compare_exchange_weak_explicit(&c->tete, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) break;
+        } else if (ecart < 0) {
+            return 0;   // vide
+        } else {
+            position = atomic_load_explicit(&c->tete, memory_order_relaxed);
+        }
+    }
+    *valeur = c->cases[position & c->masque];
+    atomic_store_explicit(&c->sequences[position & c->masque], position + c->masque + 1, memory_order_release);
+    return 1;
+}
+
+// -----------------------------------
+// Points d'entrée
+// -----------------------------------
+
+int channel_try_send(Canal *canal, int32_t valeur) {
+    int ok = canal->type == CANAL_SPSC ? spsc_envoyer(canal, valeur) : mpmc_envoyer(canal, valeur);
+    if (ok) reveiller(canal);
+    return ok;
+}
+
+int channel_try_recv(Canal *canal, int32_t *valeur) {
+    int ok = canal->type == CANAL_SPSC ? spsc_recevoir(canal, valeur) : mpmc_recevoir(canal, valeur);
+    if (ok) reveiller(canal);
+    return ok;
+}
+
+int channel_ready(const Canal *canal, int envoi) {
+    Canal *c = (Canal *)canal;
+    size_t queue = atomic_load_explicit(&c->queue, memory_order_acquire);
+    size_t tete = atomic_load_explicit(&c->tete, memory_order_acquire);
+    // Les deux lectures ne sont pas simultanées : l'écart peut sortir de [0, capacité]
+    // d'un instant à l'autre, il est borné ici
+    intptr_t occupees = (intptr_t)(queue - tete);
+    if (occupees < 0) occupees = 0;
+    return envoi ? (size_t)occupees <= c->masque : occupees > 0;
+}
+
+void channel_wait(Canal *canal, int envoi, const struct timespec *echeance) {
+    pthread_mutex_lock(&canal->verrou);
+    atomic_fetch_add_explicit(&canal->endormis, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!channel_ready(canal, envoi)) pthread_cond_timedwait(&canal->signal, &canal->verrou, echeance);
+    atomic_fetch_sub_explicit(&canal->endormis, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&canal->verrou);
+}
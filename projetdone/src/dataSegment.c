@@ -1,22 +1,113 @@
 
 #include <regex.h>
 #include <assert.h>
-#define STACK_SIZE 128
-#define STACK_SIZE 128
 
 #include "../include/dataSegment.h"
+#include "../include/decodeur.h"
+#include "../include/programme_fige.h"
 
-#define STACK_SIZE 128
+const char *const NOMS_REGISTRES[NB_REGISTRES] = {
+    "AX", "BX", "CX", "DX", "IP", "ZF", "SF", "ES", "SP", "BP"
+};
 
-CPU* cpu_init(int memory_size) {
-    if (memory_size < STACK_SIZE) return NULL;
+int register_index(const char *nom) {
+    if (!nom) return -1;
+    for (int i = 0; i < NB_REGISTRES; i++) {
+        if (strcmp(NOMS_REGISTRES[i], nom) == 0) return i;
+    }
+    return -1;
+}
+
+TableConstantes *constant_table_create(void) {
+    return calloc(1, sizeof(TableConstantes));
+}
+
+void constant_table_destroy(TableConstantes *table) {
+    if (!table) return;
+    while (table->blocs) {
+        BlocConstantes *suivant = table->blocs->suivant;
+        free(table->blocs);
+        table->blocs = suivant;
+    }
+    free(table->index);
+    free(table);
+}
+
+// Position de `valeur` dans l'index, ou de son point d'insertion ; 1 si elle y est
+static int chercher_constante(const TableConstantes *table, int valeur, int *position) {
+    int bas = 0, haut = table->count;
+    while (bas < haut) {
+        int milieu = bas + (haut - bas) / 2;
+        if (*table->index[milieu] < valeur) bas = milieu + 1;
+        else haut = milieu;
+    }
+    *position = bas;
+    return bas < table->count && *table->index[bas] == valeur;
+}
 
+const int *constant_table_get(TableConstantes *table, int valeur) {
+    if (!table) return NULL;
+    int position;
+    if (chercher_constante(table, valeur, &position)) return table->index[position];
+
+    if (table->count == table->capacite) {
+        int capacite = table->capacite > 0 ? table->capacite * 2 : 32;
+        const int **index = realloc(table->index, sizeof(*index) * capacite);
+        if (!index) return NULL;
+        table->index = index;
+        table->capacite = capacite;
+    }
+    if (!table->blocs || table->utilisees == CONSTANTES_PAR_BLOC) {
+        BlocConstantes *bloc = malloc(sizeof(BlocConstantes));
+        if (!bloc) return NULL;
+        bloc->suivant = table->blocs;
+        table->blocs = bloc;
+        table->utilisees = 0;
+    }
+
+    int *case_valeur = &table->blocs->valeurs[table->utilisees++];
+    *case_valeur = valeur;
+    memmove(table->index + position + 1, table->index + position,
+            sizeof(*table->index) * (table->count - position));
+    table->index[position] = case_valeur;
+    table->count++;
+    return case_valeur;
+}
+
+int constant_table_contains(const TableConstantes *table, const void *p) {
+    if (!table || !p) return 0;
+    int position;
+    return chercher_constante(table, *(const int *)p, &position) && table->index[position] == p;
+}
+
+void cpu_set_flags_cmp(CPU *cpu, int gauche, int droite) {
+    // Différence calculée modulo 2^32, comme l'ancien `int diff` de CMP
+    int diff = (int)((unsigned)gauche - (unsigned)droite);
+    *cpu->registres[REG_ZF] = (diff == 0);
+    *cpu->registres[REG_SF] = (diff < 0);
+}
+
+// Registres et tables d'un CPU dont la pile est [pile_fin - STACK_SIZE, pile_fin)
+static CPU *cpu_creer(MemoryHandler *handler, int pile_fin) {
     CPU* cpu = malloc(sizeof(CPU));
     if (!cpu) return NULL;
 
-    cpu->memory_handler   = memory_init(memory_size);
+    cpu->memory_handler   = handler;
     cpu->context          = hashmap_create();
-    cpu->constant_pool    = hashmap_create();
+    cpu->constant_pool    = NULL;           // créée par immediate_adressing si besoin
+    cpu->dispatchs        = 0;
+    cpu->programme        = NULL;
+    cpu->etat             = CPU_EN_FAUTE;   // rien à exécuter avant load_program
+    cpu->memoire_partagee = 0;
+    cpu->verrou_memoire   = NULL;
+    cpu->bornes_es        = NULL;
+    cpu->numero           = 0;
+    cpu->canaux           = NULL;
+    cpu->nb_canaux        = 0;
+    cpu->canal_attendu    = -1;
+    cpu->attente_envoi    = 0;
+    cpu->journal          = NULL;
+    cpu->fige             = NULL;
 
     // Registres généraux et drapeaux
     int *ax = malloc(sizeof(int)); *ax = 0;  hashmap_insert(cpu->context, "AX", ax);
@@ -29,8 +120,24 @@ CPU* cpu_init(int memory_size) {
     int *es = malloc(sizeof(int)); *es = -1;  hashmap_insert(cpu->context, "ES", es);
 
     // Registres de pile
-    int *sp = malloc(sizeof(int)); *sp = memory_size;       hashmap_insert(cpu->context, "SP", sp);
-    int *bp = malloc(sizeof(int)); *bp = memory_size;       hashmap_insert(cpu->context, "BP", bp);
+    int *sp = malloc(sizeof(int)); *sp = pile_fin;          hashmap_insert(cpu->context, "SP", sp);
+    int *bp = malloc(sizeof(int)); *bp = pile_fin;          hashmap_insert(cpu->context, "BP", bp);
+
+    // Cache des registres : évite un hashmap_get par accès dans l'exécution décodée
+    for (int i = 0; i < NB_REGISTRES; i++) {
+        cpu->registres[i] = hashmap_get(cpu->context, NOMS_REGISTRES[i]);
+    }
+
+    cpu->pile_debut = pile_fin - STACK_SIZE;
+    cpu->pile_fin   = pile_fin;
+    return cpu;
+}
+
+CPU* cpu_init(int memory_size) {
+    if (memory_size < STACK_SIZE) return NULL;
+
+    CPU *cpu = cpu_creer(memory_init(memory_size), memory_size);
+    if (!cpu) return NULL;
 
     // Création du segment de pile SS
     create_segment(cpu->memory_handler,
@@ -41,21 +148,50 @@ CPU* cpu_init(int memory_size) {
     return cpu;
 }
 
+CPU *cpu_init_core(CPU *principal, int numero) {
+    if (!principal || numero < 1) return NULL;
+
+    MemoryHandler *handler = principal->memory_handler;
+    int pile_fin = principal->pile_fin - numero * STACK_SIZE;
+    char nom[16];
+    snprintf(nom, sizeof(nom), "SS%d", numero);
+    if (pile_fin - STACK_SIZE < 0 || create_segment(handler, nom, pile_fin - STACK_SIZE, STACK_SIZE) != 0) {
+        fprintf(stderr, "cpu_init_core: pas de place pour la pile du cœur %d.\n", numero);
+        return NULL;
+    }
+
+    CPU *coeur = cpu_creer(handler, pile_fin);
+    if (!coeur) return NULL;
+    coeur->memoire_partagee = 1;
+    coeur->verrou_memoire = principal->verrou_memoire;
+    coeur->bornes_es = principal->bornes_es;
+    coeur->numero = numero;
+    return coeur;
+}
+
 
 
 void cpu_destroy(CPU* cpu) {
     if (cpu == NULL) {
         return;
     }
-    if (cpu->memory_handler != NULL) {
+    if (cpu->memory_handler != NULL && !cpu->memoire_partagee) {
+        // Les instructions rangées dans CS appartiennent au ParserResult : on ne les libère pas ici
+        Segment *cs = hashmap_get(cpu->memory_handler->allocated, "CS");
+        if (cs) {
+            for (int i = 0; i < cs->size; i++) {
+                cpu->memory_handler->memory[cs->start + i] = NULL;
+            }
+        }
         destroy_memory_handler(cpu->memory_handler);
     }
+    // Les cases des registres ont été allouées par cpu_creer
+    for (int i = 0; i < NB_REGISTRES; i++) free(cpu->registres[i]);
     if (cpu->context != NULL) {
         hashmap_destroy(cpu->context);
     }
-    if (cpu->constant_pool != NULL) {
-        hashmap_destroy(cpu->constant_pool);
-    }
+    constant_table_destroy(cpu->constant_pool);
+    frozen_release(cpu->fige);
     free(cpu);
 }
 
@@ -79,31 +215,27 @@ void* load(MemoryHandler *handler, const char *segment_name, int pos) {
 }
 
 void allocate_variables(CPU *cpu, Instruction** data_instructions,int data_count){
-if (hashmap_get(cpu->memory_handler->allocated, "DS")){
+Segment *ancien = hashmap_get(cpu->memory_handler->allocated, "DS");
+if (ancien){
 hashmap_remove(cpu->memory_handler->allocated, "DS");
+free(ancien);
+}
+
+int taille = get_compteur_value();
+if (create_segment(cpu->memory_handler, "DS", 0, taille) != 0) {
+    return;
 }
 
-create_segment(cpu->memory_handler, "DS", 0, get_compteur_value());
+// DS est fait de mots contigus : chaque ligne est développée d'un bloc (memset pour N DUP(0))
+int32_t *mots = memory_bind_words(cpu->memory_handler, 0, taille);
 int index = 0;
-for (int i = 0; i < data_count; i++) {
-    Instruction *inst = data_instructions[i];
-    char *operand2 = inst->operand2;
-
-    // Tokenisation de operand2 pour extraire les entiers
-    char *token = strtok(operand2, "',");
-    /*########################################################################################################*/
-    /*ATAGHYOUUULTint index = 0;*/
-    /*########################################################################################################*/
-    // Tableau pour stocker les pointeurs vers les entiers
-    while (token != NULL) {
-        int value = atoi(token);  // Convertir le token en entier
-
-        // Allocation de mémoiint* value=malloc(sizeof(int));
-        cpu->memory_handler->memory[index] =(int *) malloc(sizeof(int));
-        *(int *)cpu->memory_handler->memory[index] = value;  // Stocker la valeur
-        index++;  // Incrémenter l'index pour la prochaine position mémoire
-        token = strtok(NULL, "',");  // Passer au token suivant
+for (int i = 0; i < data_count && mots; i++) {
+    int n = decode_data_values(data_instructions[i]->operand2, mots + index, taille - index);
+    if (n < 0) {
+        fprintf(stderr, "allocate_variables: valeurs invalides pour '%s'.\n", data_instructions[i]->mnemonic);
+        return;
     }
+    index += n;
 }
 }
 
@@ -146,20 +278,18 @@ int matches ( const char* pattern , const char* string ) {
      }
  
     void* immediate_adressing(CPU* cpu, const char* operand){
-    if (!matches("^-?[0-9]+$",operand)){
-        return NULL;
+    // Même forme que ^-?[0-9]+$, sans passer par regcomp
+    if (!operand) return NULL;
+    const char *p = operand[0] == '-' ? operand + 1 : operand;
+    if (*p == '\0') return NULL;
+    for (; *p; p++) {
+        if (*p < '0' || *p > '9') return NULL;
     }
-    void* existing=hashmap_get(cpu->constant_pool, operand);
-    if (existing!=NULL){
-        return existing;
-    }
-   
-    int* value=malloc(sizeof(int));
-    *value=atoi(operand);
-    char*key=strdup(operand);
-    hashmap_insert(cpu->constant_pool,key,value);
-    return value;
-        
+
+    // Seule l'exécution textuelle en a besoin : un CPU de programme décodé ne la crée jamais
+    if (!cpu->constant_pool) cpu->constant_pool = constant_table_create();
+    // Case partagée en lecture seule : le const n'est retiré que pour l'interface void*
+    return (void *)constant_table_get(cpu->constant_pool, (int)strtol(operand, NULL, 10));
     }
     void* register_adressing(CPU* cpu, const char* operand) {
     if (!matches("^(AX|BX|CX|DX)$", operand)) {
@@ -338,12 +468,9 @@ int alloc_es_segment(CPU *cpu) {
         return -1;
     }
 
-    // Initialisation à zéro
-    for (int i = 0; i < taille; i++) {
-        int *zero = malloc(sizeof(int));
-        *zero = 0;
-        cpu->memory_handler->memory[start + i] = zero;
-    }
+    // Initialisation à zéro, dans les mots contigus (MOVS/STOS/CMPS y travaillent d'un bloc)
+    int *mots = memory_bind_words(cpu->memory_handler, start, taille);
+    memset(mots, 0, sizeof(int) * (size_t)taille);
 
     *es = start;
     *zf = 0; // succès
@@ -369,15 +496,12 @@ int free_es_segment(CPU *cpu) {
 
     // 3. Libérer chaque cellule de mémoire du segment
     for (int i = 0; i < es_seg->size; i++) {
-        int addr = es_seg->start + i;
-        if (cpu->memory_handler->memory[addr]) {
-            free(cpu->memory_handler->memory[addr]);
-            cpu->memory_handler->memory[addr] = NULL;
-        }
+        memory_release_cell(cpu->memory_handler, es_seg->start + i);
     }
 
     // 4. Supprimer le segment de la table des segments
     hashmap_remove(cpu->memory_handler->allocated, "ES");
+    free(es_seg);
 
     // 5. Réinitialiser le registre ES à -1
     *es = -1;
@@ -0,0 +1,479 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/mman.h>
+
+#include "../include/decodeur.h"
+#include "../include/expression.h"
+
+const char *const NOMS_SEGMENTS[NB_SEGMENTS] = { "DS", "CS", "SS", "ES" };
+
+// Mnémoniques indexés par CodeOperation
+static const char *const MNEMONIQUES[NB_OPCODES] = {
+    NULL, "MOV", "ADD", "CMP", "JMP", "JZ", "JNZ", "HALT",
+    "PUSH", "POP", "ALLOC", "FREE",
+    NULL, NULL, NULL, NULL,  // superinstructions : jamais écrites dans un source
+    "PUSHA", "POPA", "MOVS", "STOS", "CMPS",
+    "VADD", "VMUL", "VSUM", "XCHG", "CMPXCHG", "XADD", "MFENCE", "SEND", "RECV"
+};
+
+// Copie `src` dans `buf` sans les blancs de début et de fin
+static void copier_nettoye(const char *src, char *buf, size_t taille) {
+    while (*src == ' ' || *src == '\t' || *src == '\n' || *src == '\r') src++;
+    size_t n = strlen(src);
+    while (n > 0 && (src[n-1] == ' ' || src[n-1] == '\t' || src[n-1] == '\n' || src[n-1] == '\r')) n--;
+    if (n >= taille) n = taille - 1;
+    memcpy(buf, src, n);
+    buf[n] = '\0';
+}
+
+// Équivalent de la regex "^-?[0-9]+$" (ou "^[0-9]+$" si signe == 0)
+static int est_entier(const char *s, int signe) {
+    if (signe && *s == '-') s++;
+    if (!*s) return 0;
+    for (; *s; s++) {
+        if (!isdigit((unsigned char)*s)) return 0;
+    }
+    return 1;
+}
+
+// Équivalent de la regex "^[A-Z]{2}$"
+static int est_nom_registre(const char *s) {
+    return isupper((unsigned char)s[0]) && isupper((unsigned char)s[1]) && s[2] == '\0';
+}
+
+static int segment_index(const char *nom) {
+    for (int i = 0; i < NB_SEGMENTS; i++) {
+        if (strcmp(NOMS_SEGMENTS[i], nom) == 0) return i;
+    }
+    return -1;
+}
+
+// Identifiant de symbole : lettre ou '_' puis lettres, chiffres ou '_'
+static int est_identifiant(const char *s) {
+    if (!isalpha((unsigned char)*s) && *s != '_') return 0;
+    for (s++; *s; s++) {
+        if (!isalnum((unsigned char)*s) && *s != '_') return 0;
+    }
+    return 1;
+}
+
+// Cherche un symbole exact : 1 (et sa valeur) s'il existe, -1 si c'est un identifiant
+// inconnu de la table, 0 si ce n'est pas un symbole
+static int chercher_symbole(HashMap *symboles, const char *nom, int32_t *valeur) {
+    if (!symboles || !est_identifiant(nom) || register_index(nom) >= 0) return 0;
+    int *v = hashmap_get(symboles, nom);
+    if (!v) {
+        *valeur = 0;
+        return -1;
+    }
+    *valeur = *v;
+    return 1;
+}
+
+int decode_operand(const char *texte, HashMap *symboles, HashMap *constantes, int crochets, Operande *op) {
+    if (!op) return -1;
+    op->mode = MODE_AUCUN;
+    op->valeur = 0;
+    op->segment = 0;
+    if (!texte) return 0;
+
+    char buf[160];
+    copier_nettoye(texte, buf, sizeof(buf));
+    size_t n = strlen(buf);
+    if (n == 0) return -1;
+
+    // 1. Immédiat
+    if (est_entier(buf, 1)) {
+        op->mode = MODE_IMMEDIAT;
+        op->valeur = atoi(buf);
+        return 0;
+    }
+
+    // 2. Registre général
+    int reg = register_index(buf);
+    if (reg >= REG_AX && reg <= REG_DX) {
+        op->mode = MODE_REGISTRE;
+        op->valeur = reg;
+        return 0;
+    }
+
+    // 3. Constante EQU ou expression constante : calculée une fois, ici
+    if (eval_expression(buf, constantes, &op->valeur) == 0) {
+        op->mode = MODE_IMMEDIAT;
+        return 0;
+    }
+
+    // 4. Symbole nu : adresse (ou indice de label), ou contenu si `crochets`
+    int trouve = chercher_symbole(symboles, buf, &op->valeur);
+    if (trouve != 0) {
+        op->mode = crochets ? MODE_DIRECT : MODE_IMMEDIAT;
+        return trouve > 0 ? 0 : DECODE_SYMBOLE_INCONNU;
+    }
+
+    if (buf[0] != '[' || buf[n-1] != ']') return -1;
+    buf[n-1] = '\0';
+    char *interieur = buf + 1;
+
+    // 5. Direct : [n], [expression] ou [symbole]
+    if (est_entier(interieur, 0)) {
+        op->mode = MODE_DIRECT;
+        op->valeur = atoi(interieur);
+        return 0;
+    }
+    if (eval_expression(interieur, constantes, &op->valeur) == 0) {
+        op->mode = MODE_DIRECT;
+        return op->valeur >= 0 ? 0 : -1;
+    }
+    trouve = chercher_symbole(symboles, interieur, &op->valeur);
+    if (trouve != 0) {
+        op->mode = MODE_DIRECT;
+        return trouve > 0 ? 0 : DECODE_SYMBOLE_INCONNU;
+    }
+
+    // 6. Préfixe de segment : [SEG:XX]
+    char *deux_points = strchr(interieur, ':');
+    if (deux_points) {
+        *deux_points = '\0';
+        char *nom_reg = deux_points + 1;
+        if (!est_nom_registre(interieur) || !est_nom_registre(nom_reg)) return -1;
+        int seg = segment_index(interieur);
+        reg = register_index(nom_reg);
+        if (seg < 0 || reg < 0) return -1;
+        op->mode = MODE_SEGMENT;
+        op->segment = seg;
+        op->valeur = reg;
+        return 0;
+    }
+
+    // 7. Indirect par registre : [XX]
+    if (est_nom_registre(interieur)) {
+        reg = register_index(interieur);
+        if (reg < 0) return -1;
+        op->mode = MODE_INDIRECT;
+        op->valeur = reg;
+        return 0;
+    }
+
+    return -1;
+}
+
+int decode_mnemonic(const char *mnemonic) {
+    if (!mnemonic) return OPC_INVALIDE;
+    for (int i = 1; i < NB_OPCODES; i++) {
+        if (MNEMONIQUES[i] && strcmp(MNEMONIQUES[i], mnemonic) == 0) return i;
+    }
+    return OPC_INVALIDE;
+}
+
+const char *mnemonic_name(int opcode) {
+    if (opcode <= OPC_INVALIDE || opcode >= NB_OPCODES) return NULL;
+    return MNEMONIQUES[opcode];
+}
+
+int decode_instruction(const Instruction *instr, HashMap *labels, HashMap *variables,
+                       HashMap *constantes, InstructionDecodee *out) {
+    if (!instr || !instr->mnemonic || !out) return -1;
+
+    out->opcode = decode_mnemonic(instr->mnemonic);
+    if (out->opcode == OPC_INVALIDE) return -1;
+
+    // Mêmes règles que resolve_constants : un seul opérande -> labels, sinon variables
+    if (instr->operand2 == NULL) {
+        decode_operand(NULL, NULL, NULL, 0, &out->src);
+        return decode_operand(instr->operand1, labels, constantes, 0, &out->dest);
+    }
+    if (decode_operand(instr->operand1, variables, constantes, 0, &out->dest) != 0) return -1;
+    return decode_operand(instr->operand2, variables, constantes, 1, &out->src);
+}
+
+// Lit l'élément canonique suivant ("v" ou "N DUP(v)") ; 1 si lu, 0 en fin de chaîne, -1 si invalide
+static int element_suivant(const char **curseur, int32_t *repetition, int32_t *valeur) {
+    const char *p = *curseur;
+    while (*p == ' ' || *p == ',') p++;
+    if (*p == '\0') return 0;
+
+    char *fin;
+    long v = strtol(p, &fin, 10);
+    if (fin == p) return -1;
+    *repetition = 1;
+    *valeur = (int32_t)v;
+
+    if (strncmp(fin, " DUP(", 5) == 0) {
+        *repetition = (int32_t)v;
+        p = fin + 5;
+        *valeur = (int32_t)strtol(p, &fin, 10);
+        if (fin == p || *fin != ')') return -1;
+        fin++;
+    }
+    *curseur = fin;
+    return 1;
+}
+
+// Remplit `n` mots avec `valeur` : memset pour 0 et -1, boucle vectorisable sinon
+static void remplir(int32_t *out, int32_t n, int32_t valeur) {
+    if (valeur == 0 || valeur == -1) {
+        memset(out, valeur & 0xFF, sizeof(int32_t) * (size_t)n);
+        return;
+    }
+    for (int32_t i = 0; i < n; i++) out[i] = valeur;
+}
+
+int count_data_values(const char *valeurs) {
+    if (!valeurs) return 0;
+    int nb = 0;
+    int32_t repetition, valeur;
+    while (element_suivant(&valeurs, &repetition, &valeur) > 0) nb += repetition;
+    return nb;
+}
+
+int decode_data_values(const char *valeurs, int32_t *out, int max) {
+    if (!valeurs || !out) return 0;
+
+    int n = 0, rc;
+    int32_t repetition, valeur;
+    while (n < max && (rc = element_suivant(&valeurs, &repetition, &valeur)) != 0) {
+        if (rc < 0) return -1;
+        if (repetition > max - n) repetition = max - n;
+        remplir(out + n, repetition, valeur);
+        n += repetition;
+    }
+    return n;
+}
+
+// Réserve une plage de plus dans `d`
+static PlageDonnees *nouvelle_plage(DonneesCompactes *d) {
+    if (d->plage_count == d->plage_capacite) {
+        int32_t capacite = d->plage_capacite > 0 ? d->plage_capacite * 2 : 16;
+        PlageDonnees *plages = realloc(d->plages, sizeof(PlageDonnees) * capacite);
+        if (!plages) return NULL;
+        d->plages = plages;
+        d->plage_capacite = capacite;
+    }
+    return &d->plages[d->plage_count++];
+}
+
+int compact_data_values(DonneesCompactes *d, const char *valeurs) {
+    if (!d || !valeurs) return -1;
+
+    int32_t debut = d->taille;
+    int32_t repetition, valeur;
+    int rc;
+    while ((rc = element_suivant(&valeurs, &repetition, &valeur)) > 0) {
+        if (repetition == 0) continue;
+
+        if (repetition > 1) {
+            PlageDonnees *p = nouvelle_plage(d);
+            if (!p) return -1;
+            p->adresse = d->taille;
+            p->longueur = repetition;
+            p->valeur = valeur;
+            p->indice = -1;
+            d->taille += repetition;
+            continue;
+        }
+
+        // Valeur littérale : prolonge la dernière plage littérale si elle est contiguë
+        if (d->valeur_count == d->valeur_capacite) {
+            int32_t capacite = d->valeur_capacite > 0 ? d->valeur_capacite * 2 : 64;
+            int32_t *tab = realloc(d->valeurs, sizeof(int32_t) * capacite);
+            if (!tab) return -1;
+            d->valeurs = tab;
+            d->valeur_capacite = capacite;
+        }
+        PlageDonnees *p = d->plage_count > 0 ? &d->plages[d->plage_count - 1] : NULL;
+        if (!p || p->indice < 0) {
+            p = nouvelle_plage(d);
+            if (!p) return -1;
+            p->adresse = d->taille;
+            p->longueur = 0;
+            p->valeur = 0;
+            p->indice = d->valeur_count;
+        }
+        d->valeurs[d->valeur_count++] = valeur;
+        p->longueur++;
+        d->taille++;
+    }
+    return rc < 0 ? -1 : d->taille - debut;
+}
+
+void free_compact_data(DonneesCompactes *d) {
+    if (!d) return;
+    free(d->valeurs);
+    free(d->plages);
+    memset(d, 0, sizeof(*d));
+}
+
+void expand_program_data(const Programme *prog, int32_t *out) {
+    for (int32_t i = 0; i < prog->plage_count; i++) {
+        const PlageDonnees *p = &prog->plages[i];
+        if (p->indice >= 0) {
+            memcpy(out + p->adresse, prog->valeurs + p->indice, sizeof(int32_t) * (size_t)p->longueur);
+        } else {
+            remplir(out + p->adresse, p->longueur, p->valeur);
+        }
+    }
+}
+
+int32_t program_data_at(const Programme *prog, int32_t adresse) {
+    if (!prog || adresse < 0 || adresse >= prog->data_size) return 0;
+
+    int32_t bas = 0, haut = prog->plage_count - 1;
+    while (bas <= haut) {
+        int32_t milieu = bas + (haut - bas) / 2;
+        const PlageDonnees *p = &prog->plages[milieu];
+        if (adresse < p->adresse) {
+            haut = milieu - 1;
+        } else if (adresse >= p->adresse + p->longueur) {
+            bas = milieu + 1;
+        } else {
+            return p->indice >= 0 ? prog->valeurs[p->indice + adresse - p->adresse] : p->valeur;
+        }
+    }
+    return 0;
+}
+
+Symbole *extract_symbols(HashMap *map, int32_t *count) {
+    *count = 0;
+    if (!map) return NULL;
+
+    Symbole *table = malloc(sizeof(Symbole) * (map->size > 0 ? map->size : 1));
+    if (!table) return NULL;
+
+    for (int i = 0; i < map->size; i++) {
+        if (map->table[i].key && map->table[i].key != (void *)-1 && map->table[i].value) {
+            Symbole *s = &table[*count];
+            memset(s, 0, sizeof(*s));
+            strncpy(s->nom, map->table[i].key, sizeof(s->nom) - 1);
+            s->valeur = *(int *)map->table[i].value;
+            (*count)++;
+        }
+    }
+    return table;
+}
+
+Programme *decode_program(ParserResult *result) {
+    if (!result) return NULL;
+
+    Programme *prog = calloc(1, sizeof(Programme));
+    if (!prog) return NULL;
+
+    // 1) Code
+    InstructionDecodee *code = malloc(sizeof(InstructionDecodee) * (result->code_count > 0 ? result->code_count : 1));
+    if (!code) {
+        free(prog);
+        return NULL;
+    }
+    prog->code = code;
+    prog->code_count = result->code_count;
+    for (int i = 0; i < result->code_count; i++) {
+        Instruction *instr = result->code_instructions[i];
+        if (decode_instruction(instr, result->labels, result->memory_locations, result->constantes, &code[i]) != 0) {
+            fprintf(stderr, "decode_program: instruction %d invalide (%s %s%s%s)\n", i,
+                    instr->mnemonic ? instr->mnemonic : "?",
+                    instr->operand1 ? instr->operand1 : "",
+                    instr->operand2 ? ", " : "",
+                    instr->operand2 ? instr->operand2 : "");
+            free_program(prog);
+            return NULL;
+        }
+    }
+
+    // 2) Données : forme compacte, les répétitions ne sont pas développées
+    DonneesCompactes donnees;
+    memset(&donnees, 0, sizeof(donnees));
+    for (int i = 0; i < result->data_count; i++) {
+        if (compact_data_values(&donnees, result->data_instructions[i]->operand2) < 0) {
+            fprintf(stderr, "decode_program: valeurs invalides pour '%s'\n",
+                    result->data_instructions[i]->mnemonic);
+            free_compact_data(&donnees);
+            free_program(prog);
+            return NULL;
+        }
+    }
+    prog->valeurs = donnees.valeurs ? donnees.valeurs : calloc(1, sizeof(int32_t));
+    prog->valeur_count = donnees.valeur_count;
+    prog->plages = donnees.plages ? donnees.plages : calloc(1, sizeof(PlageDonnees));
+    prog->plage_count = donnees.plage_count;
+    prog->data_size = donnees.taille;
+    if (!prog->valeurs || !prog->plages) {
+        free_program(prog);
+        return NULL;
+    }
+
+    // 3) Tables de symboles
+    prog->labels = extract_symbols(result->labels, &prog->label_count);
+    prog->variables = extract_symbols(result->memory_locations, &prog->variable_count);
+    if (!prog->labels || !prog->variables) {
+        free_program(prog);
+        return NULL;
+    }
+
+    return prog;
+}
+
+void free_program(Programme *prog) {
+    if (!prog) return;
+
+    if (prog->mapping) {
+        // Tous les tableaux pointent dans la projection, sauf une éventuelle copie du code
+        free(prog->code_copie);
+        munmap(prog->mapping, prog->mapping_size);
+    } else {
+        free((void *)prog->code);
+        free((void *)prog->valeurs);
+        free((void *)prog->plages);
+        free((void *)prog->labels);
+        free((void *)prog->variables);
+    }
+    free(prog);
+}
+
+const Symbole *find_symbol(const Symbole *table, int count, const char *nom) {
+    if (!table || !nom) return NULL;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(table[i].nom, nom) == 0) return &table[i];
+    }
+    return NULL;
+}
+
+// DS (et CS si `reserver_cs`) puis IP à 0
+static int charger(CPU *cpu, const Programme *prog, int reserver_cs) {
+    if (!cpu || !cpu->memory_handler || !prog) {
+        fprintf(stderr, "load_program: paramètres invalides.\n");
+        return -1;
+    }
+    MemoryHandler *handler = cpu->memory_handler;
+
+    // DS à l'adresse 0, comme allocate_variables
+    if (prog->data_size > 0) {
+        if (create_segment(handler, "DS", 0, prog->data_size) != 0) {
+            fprintf(stderr, "load_program: allocation de DS impossible.\n");
+            return -1;
+        }
+        int32_t *mots = memory_bind_words(handler, 0, prog->data_size);
+        if (!mots) return -1;
+        expand_program_data(prog, mots);
+    }
+
+    // CS juste après DS, comme allocate_code_segment
+    if (reserver_cs && prog->code_count > 0 &&
+        create_segment(handler, "CS", prog->data_size, prog->code_count) != 0) {
+        fprintf(stderr, "load_program: allocation de CS impossible.\n");
+        return -1;
+    }
+
+    *cpu->registres[REG_IP] = 0;
+    cpu->programme = prog;
+    cpu->etat = CPU_EN_COURS;
+    return 0;
+}
+
+int load_program(CPU *cpu, const Programme *prog) {
+    return charger(cpu, prog, 1);
+}
+
+int load_program_data(CPU *cpu, const Programme *prog) {
+    return charger(cpu, prog, 0);
+}
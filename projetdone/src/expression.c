@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <limits.h>
+
+#include "../include/expression.h"
+
+// Analyseur descendant récursif : un curseur dans le texte et le premier code d'erreur rencontré
+typedef struct {
+    const char *p;
+    HashMap *constantes;
+    int erreur;
+} Analyse;
+
+static void sauter_blancs(Analyse *a) {
+    while (*a->p == ' ' || *a->p == '\t' || *a->p == '\r' || *a->p == '\n') a->p++;
+}
+
+static int64_t expr_somme(Analyse *a);
+
+// facteur := entier | 'c' | identifiant | '(' somme ')' | ('-' | '+') facteur
+static int64_t expr_facteur(Analyse *a) {
+    sauter_blancs(a);
+    const char *p = a->p;
+
+    if (*p == '-' || *p == '+') {
+        a->p++;
+        int64_t v = expr_facteur(a);
+        return *p == '-' ? -v : v;
+    }
+
+    if (*p == '(') {
+        a->p++;
+        int64_t v = expr_somme(a);
+        sauter_blancs(a);
+        if (*a->p != ')') {
+            if (!a->erreur) a->erreur = EXPR_INVALIDE;
+            return 0;
+        }
+        a->p++;
+        return v;
+    }
+
+    if (isdigit((unsigned char)*p)) {
+        char *fin;
+        long long v = strtoll(p, &fin, 0);  // décimal, ou hexadécimal avec 0x
+        if (isalnum((unsigned char)*fin) || *fin == '_') {
+            if (!a->erreur) a->erreur = EXPR_INVALIDE;
+            return 0;
+        }
+        a->p = fin;
+        return (int32_t)v;
+    }
+
+    if (*p == '\'' && p[1] && p[1] != '\'' && p[2] == '\'') {
+        a->p += 3;
+        return (unsigned char)p[1];
+    }
+
+    if (isalpha((unsigned char)*p) || *p == '_') {
+        char nom[64];
+        size_t n = 0;
+        while (isalnum((unsigned char)p[n]) || p[n] == '_') n++;
+        a->p += n;
+        if (n >= sizeof(nom)) {
+            if (!a->erreur) a->erreur = EXPR_SYMBOLE_INCONNU;
+            return 0;
+        }
+        memcpy(nom, p, n);
+        nom[n] = '\0';
+        int *v = a->constantes ? hashmap_get(a->constantes, nom) : NULL;
+        if (!v) {
+            if (!a->erreur) a->erreur = EXPR_SYMBOLE_INCONNU;
+            return 0;
+        }
+        return *v;
+    }
+
+    if (!a->erreur) a->erreur = EXPR_INVALIDE;
+    return 0;
+}
+
+// produit := facteur (('*' | '/' | '%') facteur)*
+static int64_t expr_produit(Analyse *a) {
+    int64_t v = expr_facteur(a);
+    for (;;) {
+        sauter_blancs(a);
+        char op = *a->p;
+        if (op != '*' && op != '/' && op != '%') return v;
+        a->p++;
+        int64_t d = expr_facteur(a);
+        if (op == '*') {
+            v = (int32_t)(v * d);
+        } else if (d == 0) {
+            if (!a->erreur) a->erreur = EXPR_DIVISION_ZERO;
+            return 0;
+        } else {
+            v = op == '/' ? v / d : v % d;
+        }
+    }
+}
+
+// somme := produit (('+' | '-') produit)*
+static int64_t expr_somme(Analyse *a) {
+    int64_t v = expr_produit(a);
+    for (;;) {
+        sauter_blancs(a);
+        char op = *a->p;
+        if (op != '+' && op != '-') return v;
+        a->p++;
+        int64_t d = expr_produit(a);
+        v = (int32_t)(op == '+' ? v + d : v - d);
+    }
+}
+
+int eval_expression(const char *texte, HashMap *constantes, int32_t *valeur) {
+    if (!texte || !valeur) return EXPR_INVALIDE;
+
+    Analyse a = { texte, constantes, 0 };
+    int64_t v = expr_somme(&a);
+    sauter_blancs(&a);
+    if (!a.erreur && *a.p != '\0') a.erreur = EXPR_INVALIDE;
+    if (a.erreur) return a.erreur;
+
+    *valeur = (int32_t)v;
+    return 0;
+}
+
+const char *expression_error(int code) {
+    switch (code) {
+        case 0:                    return "succès";
+        case EXPR_SYMBOLE_INCONNU: return "constante inconnue";
+        case EXPR_DIVISION_ZERO:   return "division par zéro";
+        default:                   return "expression invalide";
+    }
+}
+
+// Cherche le mot-clé DUP (casse indifférente) isolé et suivi de '(' ; NULL s'il est absent
+static char *chercher_dup(char *element) {
+    for (char *p = element; *p; p++) {
+        if (strncasecmp(p, "DUP", 3) != 0) continue;
+        if (p > element && (isalnum((unsigned char)p[-1]) || p[-1] == '_')) continue;
+        char *q = p + 3;
+        while (*q == ' ' || *q == '\t') q++;
+        if (*q == '(') return p;
+    }
+    return NULL;
+}
+
+// Valeur d'un élément : expression, ou '?' (valeur indéterminée, mise à 0)
+static int valeur_element(const char *texte, HashMap *constantes, int32_t *valeur) {
+    const char *p = texte;
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p == '?') {
+        p++;
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        if (*p != '\0') return EXPR_INVALIDE;
+        *valeur = 0;
+        return 0;
+    }
+    return eval_expression(texte, constantes, valeur);
+}
+
+// Ajoute du texte à un tampon extensible
+static int ajouter_texte(char **buf, size_t *longueur, size_t *capacite, const char *texte) {
+    size_t n = strlen(texte);
+    if (*longueur + n + 1 > *capacite) {
+        size_t c = *capacite > 0 ? *capacite : 64;
+        while (c < *longueur + n + 1) c *= 2;
+        char *nouveau = realloc(*buf, c);
+        if (!nouveau) return -1;
+        *buf = nouveau;
+        *capacite = c;
+    }
+    memcpy(*buf + *longueur, texte, n + 1);
+    *longueur += n;
+    return 0;
+}
+
+// Retire les apostrophes qui entourent une liste ('12,8,9'), comme l'ancien découpage sur
+// "'," ; un littéral caractère 'c' est gardé tel quel
+static void retirer_apostrophes(char *texte) {
+    char *ecrit = texte;
+    for (const char *p = texte; *p;) {
+        if (p[0] == '\'' && p[1] && p[1] != '\'' && p[2] == '\'') {
+            *ecrit++ = *p++;
+            *ecrit++ = *p++;
+            *ecrit++ = *p++;
+        } else if (*p == '\'') {
+            p++;
+        } else {
+            *ecrit++ = *p++;
+        }
+    }
+    *ecrit = '\0';
+}
+
+int fold_data_values(const char *texte, HashMap *constantes, char **canonique, int32_t *nb_cases) {
+    if (!texte || !canonique || !nb_cases) return EXPR_INVALIDE;
+    *canonique = NULL;
+    *nb_cases = 0;
+
+    char *copie = strdup(texte);
+    if (!copie) return EXPR_INVALIDE;
+    retirer_apostrophes(copie);
+
+    char *sortie = NULL;
+    size_t longueur = 0, capacite = 0;
+    int64_t total = 0;
+    int rc = 0;
+
+    // Les éléments sont séparés par des virgules (une expression n'en contient jamais)
+    char *reste = copie;
+    while (rc == 0 && reste) {
+        char *element = reste;
+        char *virgule = strchr(reste, ',');
+        if (virgule) {
+            *virgule = '\0';
+            reste = virgule + 1;
+        } else {
+            reste = NULL;
+        }
+
+        int32_t repetition = 1, valeur = 0;
+        char *dup = chercher_dup(element);
+        if (dup) {
+            // N DUP(v) : N et v sont des expressions, la parenthèse fermante est la dernière
+            char *ouvrante = strchr(dup, '(');
+            char *fermante = strrchr(ouvrante, ')');
+            if (!fermante) {
+                rc = EXPR_INVALIDE;
+                break;
+            }
+            for (char *q = fermante + 1; *q; q++) {
+                if (!isspace((unsigned char)*q)) rc = EXPR_INVALIDE;
+            }
+            *dup = '\0';
+            *fermante = '\0';
+            if (rc == 0) rc = eval_expression(element, constantes, &repetition);
+            if (rc == 0) rc = valeur_element(ouvrante + 1, constantes, &valeur);
+            if (rc == 0 && repetition < 0) rc = EXPR_INVALIDE;
+        } else {
+            rc = valeur_element(element, constantes, &valeur);
+        }
+        if (rc != 0) break;
+
+        total += repetition;
+        if (total > INT_MAX) {
+            rc = EXPR_INVALIDE;
+            break;
+        }
+
+        char morceau[48];
+        if (repetition == 1) snprintf(morceau, sizeof(morceau), "%d", valeur);
+        else snprintf(morceau, sizeof(morceau), "%d DUP(%d)", repetition, valeur);
+        if ((longueur > 0 && ajouter_texte(&sortie, &longueur, &capacite, ",") != 0) ||
+            ajouter_texte(&sortie, &longueur, &capacite, morceau) != 0) {
+            rc = EXPR_INVALIDE;
+        }
+    }
+    free(copie);
+
+    if (rc == 0 && !sortie) rc = EXPR_INVALIDE;  // aucune valeur
+    if (rc != 0) {
+        free(sortie);
+        return rc;
+    }
+    *canonique = sortie;
+    *nb_cases = (int32_t)total;
+    return 0;
+}
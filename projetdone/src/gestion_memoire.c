@@ -27,10 +27,20 @@ MemoryHandler *memory_init(int size) {
         return NULL;
     }
 
+    // Mots contigus des cases liées (pages réelles allouées à la première écriture)
+    handler->mots = (int *)calloc(size, sizeof(int));
+    if (!handler->mots) {
+        printf("Erreur : Allocation des mots memoire echouee.\n");
+        free(handler->memory);
+        free(handler);
+        return NULL;
+    }
+
     // Création du segment libre couvrant toute la mémoire
     handler->free_list = (Segment *)malloc(sizeof(Segment));
     if (!handler->free_list) {
         printf("Erreur : Allocation du segment libre echouee.\n");
+        free(handler->mots);
         free(handler->memory);
         free(handler);
         return NULL;
@@ -46,14 +56,13 @@ MemoryHandler *memory_init(int size) {
     if (!handler->allocated) {
         printf("Erreur : Allocation de la table de hachage echouee.\n");
         free(handler->free_list);
+        free(handler->mots);
         free(handler->memory);
         free(handler);
         return NULL;
     }
 
     handler->total_size = size;
-
-    printf("Memoire initialisee avec %d unites.\n", size);
     return handler;
 }
 Segment *find_free_segment(MemoryHandler *handler, int start, int size, Segment **prev) {
@@ -203,9 +212,9 @@ int remove_segment(MemoryHandler *handler, const char *name) {
 void destroy_memory_handler(MemoryHandler* m) {
     if (m == NULL) return;
 
-    // Libérer la hashmap contenant les segments alloués.
+    // Libérer la hashmap contenant les segments alloués, et les segments eux-mêmes.
     if (m->allocated != NULL) {
-        hashmap_destroy(m->allocated);
+        hashmap_destroy_values(m->allocated, free);
     }
 
     // Libérer la liste chaînée des segments libres.
@@ -218,20 +227,55 @@ void destroy_memory_handler(MemoryHandler* m) {
     }
     // free(courant); // Non nécessaire, courant vaut NULL ici.
 
-    // Libérer chaque élément du tableau de mémoire.
+    // Libérer chaque élément du tableau de mémoire (sauf les cases liées à leur mot).
     if (m->memory != NULL) {
         for (int i = 0; i < m->total_size; i++) {
-            if (m->memory[i] != NULL) {
-                free(m->memory[i]);
-            }
+            memory_release_cell(m, i);
         }
         free(m->memory);
     }
+    free(m->mots);
 
     // Enfin, libérer le gestionnaire de mémoire.
     free(m);
 }
 
+int *memory_bind_words(MemoryHandler *handler, int start, int size) {
+    if (!handler || start < 0 || size < 0 || start + size > handler->total_size) {
+        return NULL;
+    }
+    for (int i = start; i < start + size; i++) {
+        if (handler->memory[i] != &handler->mots[i]) {
+            free(handler->memory[i]);
+            handler->memory[i] = &handler->mots[i];
+        }
+    }
+    return &handler->mots[start];
+}
+
+int *memory_words(MemoryHandler *handler, int start, int size) {
+    if (!handler || start < 0 || size < 0 || start + size > handler->total_size) {
+        return NULL;
+    }
+    for (int i = start; i < start + size; i++) {
+        int *cell = handler->memory[i];
+        if (cell == &handler->mots[i]) continue;
+        if (!cell) return NULL;
+        handler->mots[i] = *cell;
+        free(cell);
+        handler->memory[i] = &handler->mots[i];
+    }
+    return &handler->mots[start];
+}
+
+void memory_release_cell(MemoryHandler *handler, int addr) {
+    void *cell = handler->memory[addr];
+    if (cell != NULL && cell != &handler->mots[addr]) {
+        free(cell);
+    }
+    handler->memory[addr] = NULL;
+}
+
 #include <limits.h>
 
 
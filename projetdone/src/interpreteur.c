@@ -0,0 +1,731 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/interpreteur.h"
+#include "../include/vecteurs.h"
+#include "../include/canal.h"
+#include "../include/journal.h"
+
+// ZF et SF de CMP gauche, droite (différence modulo 2^32, voir cpu_set_flags_cmp)
+static inline void poser_drapeaux(CPU *cpu, int gauche, int droite) {
+    int diff = (int)((unsigned)gauche - (unsigned)droite);
+    *cpu->registres[REG_ZF] = (diff == 0);
+    *cpu->registres[REG_SF] = (diff < 0);
+}
+
+// Début et taille d'un segment ; SS est la pile du cœur (chaque cœur a la sienne). En
+// multicœur, la table des segments (modifiée par ALLOC / FREE) n'est pas lue : DS et CS,
+// placés par load_program et fixes ensuite, sont pris dans le programme, et ES dans les
+// bornes publiées par publier_es, sans verrou.
+static int bornes_segment(CPU *cpu, int segment, int *debut, int *taille) {
+    if (segment == SEG_SS) {
+        *debut = cpu->pile_debut;
+        *taille = cpu->pile_fin - cpu->pile_debut;
+        return 1;
+    }
+    if (cpu->bornes_es && cpu->programme) {
+        if (segment == SEG_DS) {
+            *debut = 0;
+            *taille = cpu->programme->data_size;
+            return *taille > 0;
+        }
+        if (segment == SEG_CS) {
+            *debut = cpu->programme->data_size;
+            *taille = cpu->programme->code_count;
+            return *taille > 0;
+        }
+        // acquire : les cases mises à zéro par ALLOC sont visibles avant leurs bornes
+        uint64_t bornes = atomic_load_explicit(cpu->bornes_es, memory_order_acquire);
+        if (bornes == 0) return 0;
+        *debut = (int)(uint32_t)(bornes >> 32) - 1;
+        *taille = (int)(uint32_t)bornes;
+        return 1;
+    }
+    Segment *seg = hashmap_get(cpu->memory_handler->allocated, NOMS_SEGMENTS[segment]);
+    if (seg) {
+        *debut = seg->start;
+        *taille = seg->size;
+    }
+    return seg != NULL;
+}
+
+// Multicœur : publie les bornes d'ES après ALLOC / FREE (appelée sous verrou_memoire)
+static void publier_es(CPU *cpu) {
+    if (!cpu->bornes_es) return;
+    Segment *seg = hashmap_get(cpu->memory_handler->allocated, "ES");
+    uint64_t bornes = seg ? (uint64_t)(uint32_t)(seg->start + 1) << 32 | (uint32_t)seg->size : 0;
+    atomic_store_explicit(cpu->bornes_es, bornes, memory_order_release);
+}
+
+// Case mémoire (ou registre) désignée par un opérande, NULL si elle n'existe pas
+static int *operande_cellule(CPU *cpu, const Operande *op) {
+    MemoryHandler *handler = cpu->memory_handler;
+
+    switch (op->mode) {
+        case MODE_REGISTRE:
+        case MODE_INDIRECT:
+            return cpu->registres[op->valeur];
+
+        case MODE_DIRECT:
+            if (cpu->journal) return journal_cell(cpu->journal, handler, op->valeur);
+            if (op->valeur < 0 || op->valeur >= handler->total_size) return NULL;
+            return (int *)handler->memory[op->valeur];
+
+        case MODE_SEGMENT: {
+            int debut, taille;
+            if (!bornes_segment(cpu, op->segment, &debut, &taille)) return NULL;
+            int offset = *cpu->registres[op->valeur];
+            if (offset < 0 || offset >= taille) return NULL;
+            // La pile est propre au cœur : elle n'est jamais journalisée
+            if (cpu->journal && op->segment != SEG_SS) return journal_cell(cpu->journal, handler, debut + offset);
+            return (int *)handler->memory[debut + offset];
+        }
+
+        default:
+            return NULL;
+    }
+}
+
+// Mode déterministe : lecture d'une case de la mémoire commune sans la copier dans le journal
+static int lire_journal(CPU *cpu, const Operande *op, int *valeur) {
+    int adresse = op->valeur;
+    if (op->mode == MODE_SEGMENT) {
+        int debut, taille;
+        if (!bornes_segment(cpu, op->segment, &debut, &taille)) return 0;
+        int offset = *cpu->registres[op->valeur];
+        if (offset < 0 || offset >= taille) return 0;
+        adresse = debut + offset;
+    }
+    return journal_read(cpu->journal, cpu->memory_handler, adresse, valeur);
+}
+
+// Lit la valeur d'un opérande ; retourne 0 si l'opérande ne désigne rien
+static int operande_lire(CPU *cpu, const Operande *op, int *valeur) {
+    if (op->mode == MODE_IMMEDIAT) {
+        *valeur = op->valeur;
+        return 1;
+    }
+    if (cpu->journal && (op->mode == MODE_DIRECT || (op->mode == MODE_SEGMENT && op->segment != SEG_SS))) {
+        return lire_journal(cpu, op, valeur);
+    }
+    int *cell = operande_cellule(cpu, op);
+    if (!cell) return 0;
+    *valeur = *cell;
+    return 1;
+}
+
+// CMP : seule instruction qui écrit ZF et SF (avec CMPS et CMPXCHG)
+static void comparer(CPU *cpu, const InstructionDecodee *instr) {
+    int gauche, droite;
+    if (operande_lire(cpu, &instr->dest, &gauche) && operande_lire(cpu, &instr->src, &droite)) {
+        poser_drapeaux(cpu, gauche, droite);
+    }
+}
+
+// JZ saute si ZF == 1, JNZ si ZF == 0 (comme handle_instruction)
+static int sauter_si(CPU *cpu, const InstructionDecodee *instr, int attendu) {
+    int cible;
+    if (*cpu->registres[REG_ZF] == attendu) {
+        if (!operande_lire(cpu, &instr->dest, &cible)) return -1;
+        *cpu->registres[REG_IP] = cible;
+    }
+    return 0;
+}
+
+// MOV (ajouter == 0) ou ADD (ajouter != 0)
+static void affecter(CPU *cpu, const InstructionDecodee *instr, int ajouter) {
+    int valeur;
+    int *dest = operande_cellule(cpu, &instr->dest);
+    if (dest && operande_lire(cpu, &instr->src, &valeur)) {
+        if (ajouter) *dest += valeur;
+        else *dest = valeur;
+    }
+}
+
+// Valeur empilée par PUSH (AX sans opérande)
+static int valeur_push(CPU *cpu, const InstructionDecodee *instr, int *valeur) {
+    if (instr->dest.mode == MODE_AUCUN) {
+        *valeur = *cpu->registres[REG_AX];
+        return 1;
+    }
+    return operande_lire(cpu, &instr->dest, valeur);
+}
+
+// Case écrite par POP (AX sans opérande)
+static int *cellule_pop(CPU *cpu, const InstructionDecodee *instr) {
+    return instr->dest.mode == MODE_AUCUN ? cpu->registres[REG_AX]
+                                          : operande_cellule(cpu, &instr->dest);
+}
+
+// PUSH a puis POP b : si la pile a de la place, b reçoit a sans passer par une case
+// allouée ; la case libérée par POP est vidée comme dans pop_value
+static int empiler_depiler(CPU *cpu, const InstructionDecodee *instr) {
+    int valeur;
+    if (!valeur_push(cpu, instr, &valeur)) return -1;
+
+    int *sp = cpu->registres[REG_SP];
+    (*cpu->registres[REG_IP])++;
+
+    if (*sp > cpu->pile_debut && *sp <= cpu->pile_fin) {
+        int *dest = cellule_pop(cpu, instr + 1);
+        memory_release_cell(cpu->memory_handler, *sp - 1);
+        if (!dest) return -1;
+        *dest = valeur;
+        return 0;
+    }
+
+    // Pile pleine ou SP hors de la pile : mêmes effets que les deux instructions séparées
+    push_value(cpu, valeur);
+    int *dest = cellule_pop(cpu, instr + 1);
+    if (!dest) return -1;
+    pop_value(cpu, dest);
+    return 0;
+}
+
+// Première case de la plage de `n` cases désignée par un opérande (MOVS, STOS, VADD...), ou -1
+// si elle sort de son segment : [SEG:REG] dans SEG, [n] dans le segment de données (DS, ES
+// ou SS) qui contient n
+static int operande_plage(CPU *cpu, const Operande *op, int n) {
+    int debut, taille;
+
+    if (op->mode == MODE_SEGMENT && op->segment != SEG_CS) {
+        if (!bornes_segment(cpu, op->segment, &debut, &taille)) return -1;
+        int offset = *cpu->registres[op->valeur];
+        if (offset < 0 || offset > taille - n) return -1;
+        return debut + offset;
+    }
+
+    if (op->mode == MODE_DIRECT) {
+        static const int donnees[] = { SEG_DS, SEG_ES, SEG_SS };
+        for (int k = 0; k < 3; k++) {
+            if (!bornes_segment(cpu, donnees[k], &debut, &taille) ||
+                op->valeur < debut || op->valeur >= debut + taille) continue;
+            return op->valeur <= debut + taille - n ? op->valeur : -1;
+        }
+    }
+    return -1;
+}
+
+// Mots contigus de la plage d'un opérande (CX cases), ou NULL : plage hors de son segment
+// ou contenant une case vide. Les bornes sont contrôlées une fois pour toute la plage.
+static int *operande_mots(CPU *cpu, const Operande *op, int n) {
+    int debut = operande_plage(cpu, op, n);
+    return debut < 0 ? NULL : memory_words(cpu->memory_handler, debut, n);
+}
+
+// MOVS dest, src : memmove, les deux plages pouvant se recouvrir
+static void copier_bloc(CPU *cpu, const InstructionDecodee *instr) {
+    int n = *cpu->registres[REG_CX];
+    if (n <= 0) return;
+    int *dest = operande_mots(cpu, &instr->dest, n);
+    int *src = operande_mots(cpu, &instr->src, n);
+    if (dest && src) memmove(dest, src, sizeof(int) * (size_t)n);
+}
+
+// STOS dest, valeur : memset pour 0 et -1, boucle vectorisable sinon
+static void remplir_bloc(CPU *cpu, const InstructionDecodee *instr) {
+    int n = *cpu->registres[REG_CX];
+    int valeur;
+    if (n <= 0 || !operande_lire(cpu, &instr->src, &valeur)) return;
+    int *dest = operande_mots(cpu, &instr->dest, n);
+    if (!dest) return;
+    if (valeur == 0 || valeur == -1) {
+        memset(dest, valeur & 0xFF, sizeof(int) * (size_t)n);
+    } else {
+        for (int k = 0; k < n; k++) dest[k] = valeur;
+    }
+}
+
+// CMPS a, b : drapeaux de la première différence (comme CMP a[k], b[k]), ZF = 1 si égales
+static void comparer_blocs(CPU *cpu, const InstructionDecodee *instr) {
+    int n = *cpu->registres[REG_CX];
+    if (n <= 0) return;
+    int *a = operande_mots(cpu, &instr->dest, n);
+    int *b = operande_mots(cpu, &instr->src, n);
+    if (!a || !b) return;
+
+    int k = 0;
+    if (memcmp(a, b, sizeof(int) * (size_t)n) == 0) k = n - 1;
+    else while (a[k] == b[k]) k++;
+    poser_drapeaux(cpu, a[k], b[k]);
+}
+
+// VADD / VMUL dest, src : src immédiat ou registre est appliqué à chaque case, sinon c'est
+// une seconde plage de CX cases
+static void operation_vectorielle(CPU *cpu, const InstructionDecodee *instr) {
+    int n = *cpu->registres[REG_CX];
+    if (n <= 0) return;
+    int *dest = operande_mots(cpu, &instr->dest, n);
+    if (!dest) return;
+
+    int multiplier = instr->opcode == OPC_VMUL;
+    if (instr->src.mode == MODE_IMMEDIAT || instr->src.mode == MODE_REGISTRE) {
+        int valeur;
+        if (!operande_lire(cpu, &instr->src, &valeur)) return;
+        if (multiplier) vector_mul_scalar(dest, valeur, n);
+        else vector_add_scalar(dest, valeur, n);
+        return;
+    }
+    int *src = operande_mots(cpu, &instr->src, n);
+    if (!src) return;
+    if (multiplier) vector_mul(dest, src, n);
+    else vector_add(dest, src, n);
+}
+
+// VSUM dest, src : somme des CX cases de src
+static void sommer_bloc(CPU *cpu, const InstructionDecodee *instr) {
+    int n = *cpu->registres[REG_CX];
+    if (n <= 0) return;
+    int *dest = operande_cellule(cpu, &instr->dest);
+    int *src = operande_mots(cpu, &instr->src, n);
+    if (dest && src) *dest = vector_sum(src, n);
+}
+
+// -----------------------------------
+// Instructions atomiques : atomiques sur la case dest (lecture-modification-écriture d'un
+// seul tenant, ordre séquentiellement cohérent), src étant propre au cœur (registre)
+// -----------------------------------
+
+// XCHG dest, src : src doit être modifiable
+static void echanger(CPU *cpu, const InstructionDecodee *instr) {
+    int *dest = operande_cellule(cpu, &instr->dest);
+    int *src = operande_cellule(cpu, &instr->src);
+    if (dest && src) *src = __atomic_exchange_n(dest, *src, __ATOMIC_SEQ_CST);
+}
+
+// CMPXCHG dest, src : si dest == AX, dest reçoit src ; sinon AX reçoit dest. Drapeaux de
+// CMP AX, dest (ZF = 1 si l'échange a eu lieu).
+static void comparer_echanger(CPU *cpu, const InstructionDecodee *instr) {
+    int valeur;
+    int *dest = operande_cellule(cpu, &instr->dest);
+    if (!dest || !operande_lire(cpu, &instr->src, &valeur)) return;
+
+    int *ax = cpu->registres[REG_AX];
+    int attendu = *ax;
+    if (!__atomic_compare_exchange_n(dest, &attendu, valeur, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        // attendu contient la valeur trouvée dans dest
+        poser_drapeaux(cpu, *ax, attendu);
+        *ax = attendu;
+    } else {
+        poser_drapeaux(cpu, attendu, attendu);
+    }
+}
+
+// XADD dest, src : dest += src ; src (s'il est modifiable) reçoit l'ancienne valeur de dest
+static void ajouter_echanger(CPU *cpu, const InstructionDecodee *instr) {
+    int valeur;
+    int *dest = operande_cellule(cpu, &instr->dest);
+    if (!dest || !operande_lire(cpu, &instr->src, &valeur)) return;
+    int ancienne = __atomic_fetch_add(dest, valeur, __ATOMIC_SEQ_CST);
+    if (instr->src.mode != MODE_IMMEDIAT) {
+        int *src = operande_cellule(cpu, &instr->src);
+        if (src) *src = ancienne;
+    }
+}
+
+// -----------------------------------
+// Canaux (machine multicœur)
+// -----------------------------------
+
+#define EXEC_BLOQUE 1   // Retour d'executer : SEND / RECV doit attendre que le canal change
+
+// Canal désigné par un opérande, NULL s'il n'existe pas ou si ce bout SPSC appartient à un
+// autre cœur
+static Canal *canal_operande(CPU *cpu, const Operande *op, int envoi) {
+    int numero;
+    if (!operande_lire(cpu, op, &numero) || numero < 0 || numero >= cpu->nb_canaux) return NULL;
+    Canal *canal = cpu->canaux[numero];
+    if (!canal || channel_bind(canal, envoi, cpu->numero) != 0) return NULL;
+    cpu->canal_attendu = numero;
+    cpu->attente_envoi = envoi;
+    return canal;
+}
+
+// SEND canal, valeur
+static int envoyer(CPU *cpu, const InstructionDecodee *instr) {
+    int valeur;
+    Canal *canal = canal_operande(cpu, &instr->dest, 1);
+    if (!canal || !operande_lire(cpu, &instr->src, &valeur)) return -1;
+    return channel_try_send(canal, valeur) ? 0 : EXEC_BLOQUE;
+}
+
+// RECV dest, canal
+static int recevoir(CPU *cpu, const InstructionDecodee *instr) {
+    int32_t valeur;
+    int *dest = operande_cellule(cpu, &instr->dest);
+    Canal *canal = canal_operande(cpu, &instr->src, 0);
+    if (!dest || !canal) return -1;
+    if (!channel_try_recv(canal, &valeur)) return EXEC_BLOQUE;
+    *dest = valeur;
+    return 0;
+}
+
+// Corps de execute_decoded, visible des boucles d'exécution de ce fichier pour être intégré
+static inline int executer(CPU *cpu, const InstructionDecodee *instr) {
+    int *ip = cpu->registres[REG_IP];
+    int valeur;
+    int *dest;
+
+    switch (instr->opcode) {
+        case OPC_MOV:
+            affecter(cpu, instr, 0);
+            break;
+
+        case OPC_ADD:
+            affecter(cpu, instr, 1);
+            break;
+
+        case OPC_CMP:
+            comparer(cpu, instr);
+            break;
+
+        case OPC_JMP:
+            if (operande_lire(cpu, &instr->dest, &valeur)) *ip = valeur;
+            break;
+
+        case OPC_JZ:
+            return sauter_si(cpu, instr, 1);
+
+        case OPC_JNZ:
+            return sauter_si(cpu, instr, 0);
+
+        case OPC_HALT:
+            *ip = -1;
+            break;
+
+        case OPC_PUSH:
+            if (!valeur_push(cpu, instr, &valeur)) return -1;
+            push_value(cpu, valeur);
+            break;
+
+        case OPC_POP:
+            dest = cellule_pop(cpu, instr);
+            if (!dest) return -1;
+            pop_value(cpu, dest);
+            break;
+
+        // En multicœur, ES et la liste libre sont communs à tous les cœurs
+        case OPC_ALLOC:
+            if (cpu->verrou_memoire) pthread_mutex_lock(cpu->verrou_memoire);
+            alloc_es_segment(cpu);
+            publier_es(cpu);
+            if (cpu->verrou_memoire) pthread_mutex_unlock(cpu->verrou_memoire);
+            break;
+
+        case OPC_FREE:
+            if (cpu->verrou_memoire) pthread_mutex_lock(cpu->verrou_memoire);
+            free_es_segment(cpu);
+            publier_es(cpu);
+            if (cpu->verrou_memoire) pthread_mutex_unlock(cpu->verrou_memoire);
+            break;
+
+        // Comme PUSH et POP, une pile pleine (ou vide) rend l'instruction sans effet
+        case OPC_PUSHA:
+            push_all_registers(cpu);
+            break;
+
+        case OPC_POPA:
+            pop_all_registers(cpu);
+            break;
+
+        // Opérations sur des plages de CX cases : sans effet si une plage sort de son
+        // segment ou contient une case vide
+        case OPC_MOVS:
+            copier_bloc(cpu, instr);
+            break;
+
+        case OPC_STOS:
+            remplir_bloc(cpu, instr);
+            break;
+
+        case OPC_CMPS:
+            comparer_blocs(cpu, instr);
+            break;
+
+        case OPC_VADD:
+        case OPC_VMUL:
+            operation_vectorielle(cpu, instr);
+            break;
+
+        case OPC_VSUM:
+            sommer_bloc(cpu, instr);
+            break;
+
+        case OPC_XCHG:
+            echanger(cpu, instr);
+            break;
+
+        case OPC_CMPXCHG:
+            comparer_echanger(cpu, instr);
+            break;
+
+        case OPC_XADD:
+            ajouter_echanger(cpu, instr);
+            break;
+
+        case OPC_MFENCE:
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            break;
+
+        // Canal plein ou vide : EXEC_BLOQUE, que seul executer_tranche sait reprendre ;
+        // ailleurs (run_decoded_program...) c'est un échec, aucun autre cœur ne débloquera
+        case OPC_SEND:
+            return envoyer(cpu, instr);
+
+        case OPC_RECV:
+            return recevoir(cpu, instr);
+
+        // Superinstructions : la seconde moitié est l'instruction suivante. IP avance
+        // entre les deux moitiés, exactement comme entre deux dispatchs.
+        case OPC_CMP_JZ:
+        case OPC_CMP_JNZ:
+            comparer(cpu, instr);
+            (*ip)++;
+            return sauter_si(cpu, instr + 1, instr->opcode == OPC_CMP_JZ);
+
+        case OPC_MOV_ADD:
+            affecter(cpu, instr, 0);
+            (*ip)++;
+            affecter(cpu, instr + 1, 1);
+            break;
+
+        case OPC_PUSH_POP:
+            return empiler_depiler(cpu, instr);
+
+        default:
+            return -1;
+    }
+
+    return 0;
+}
+
+int execute_decoded(CPU *cpu, const InstructionDecodee *instr) {
+    if (!cpu || !instr) return -1;
+    return executer(cpu, instr) == 0 ? 0 : -1;
+}
+
+int run_decoded_program(CPU *cpu, const Programme *prog) {
+    if (!cpu || !prog) {
+        fprintf(stderr, "run_decoded_program: paramètres invalides\n");
+        return -1;
+    }
+
+    int *ip = cpu->registres[REG_IP];
+    while (*ip >= 0 && *ip < prog->code_count) {
+        const InstructionDecodee *instr = &prog->code[*ip];
+        (*ip)++;
+        cpu->dispatchs++;
+        if (executer(cpu, instr) != 0) {
+            fprintf(stderr, "run_decoded_program: échec exécution à IP=%d\n", *ip - 1);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+#define TRANCHE_HORLOGE 1024  // dispatchs entre deux lectures de l'horloge (cpu_run_until)
+
+static int echeance_passee(const struct timespec *echeance) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec > echeance->tv_sec || (t.tv_sec == echeance->tv_sec && t.tv_nsec >= echeance->tv_nsec);
+}
+
+// Mode déterministe : instructions exécutées seulement aux points de synchronisation, dans
+// l'ordre des cœurs (atomiques, canaux, ALLOC / FREE, blocs et vecteurs qui travaillent
+// directement sur les mots de la mémoire). Tout nouvel opcode doit être classé ici (voir
+// le _Static_assert de decodeur.h).
+static inline int synchronisante(int opcode) {
+    switch (opcode) {
+        case OPC_ALLOC:
+        case OPC_FREE:
+        case OPC_MOVS:
+        case OPC_STOS:
+        case OPC_CMPS:
+        case OPC_VADD:
+        case OPC_VMUL:
+        case OPC_VSUM:
+        case OPC_XCHG:
+        case OPC_CMPXCHG:
+        case OPC_XADD:
+        case OPC_MFENCE:
+        case OPC_SEND:
+        case OPC_RECV:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Au plus `budget` dispatchs (budget < 0 : sans limite), jusqu'à `echeance` si elle est
+// donnée
+static EtatCPU executer_tranche(CPU *cpu, const Programme *prog, long budget, const struct timespec *echeance) {
+    int *ip = cpu->registres[REG_IP];
+    long fin = cpu->dispatchs + budget;
+    long executees = 0;
+    EtatCPU etat = CPU_ARRETE;
+
+    while (*ip >= 0 && *ip < prog->code_count) {
+        if ((budget >= 0 && cpu->dispatchs >= fin) ||
+            (echeance && executees % TRANCHE_HORLOGE == 0 && echeance_passee(echeance))) {
+            etat = CPU_BUDGET_EPUISE;
+            break;
+        }
+        const InstructionDecodee *instr = &prog->code[*ip];
+        if (cpu->journal && (synchronisante(instr->opcode) || journal_full(cpu->journal))) {
+            etat = CPU_SYNCHRO;
+            break;
+        }
+        (*ip)++;
+        cpu->dispatchs++;
+        executees++;
+        int rc = executer(cpu, instr);
+        if (rc == EXEC_BLOQUE) {
+            // L'instruction sera refaite à la reprise : elle ne compte pas comme dispatch
+            (*ip)--;
+            cpu->dispatchs--;
+            etat = CPU_BLOQUE;
+            break;
+        }
+        if (rc != 0) {
+            etat = CPU_EN_FAUTE;
+            break;
+        }
+    }
+
+    return etat;
+}
+
+int run_decoded_quantum(CPU *cpu, const Programme *prog, long quantum) {
+    if (!cpu || !prog || quantum <= 0) {
+        fprintf(stderr, "run_decoded_quantum: paramètres invalides\n");
+        return -1;
+    }
+
+    EtatCPU etat = executer_tranche(cpu, prog, quantum, NULL);
+    if (etat == CPU_EN_FAUTE || etat == CPU_BLOQUE) {
+        // Bloqué, IP a été ramené sur l'instruction ; en faute, il la dépasse déjà
+        int ip = *cpu->registres[REG_IP] - (etat == CPU_EN_FAUTE);
+        fprintf(stderr, "run_decoded_quantum: échec exécution à IP=%d\n", ip);
+        return -1;
+    }
+    return etat == CPU_BUDGET_EPUISE;
+}
+
+// Reprise d'un CPU : un état final (arrêt, faute) est rendu tel quel, sans rien exécuter
+static EtatCPU reprendre(CPU *cpu, long budget, const struct timespec *echeance) {
+    if (!cpu || !cpu->programme || cpu->etat == CPU_EN_FAUTE) return CPU_EN_FAUTE;
+    cpu->etat = executer_tranche(cpu, cpu->programme, budget, echeance);
+    return cpu->etat;
+}
+
+EtatCPU cpu_run_for(CPU *cpu, long n_instructions) {
+    return reprendre(cpu, n_instructions > 0 ? n_instructions : 0, NULL);
+}
+
+EtatCPU cpu_run_until(CPU *cpu, const struct timespec *echeance) {
+    return reprendre(cpu, -1, echeance);
+}
+
+// Rejoue une trace jusqu'à ce qu'une garde échoue ; IP désigne alors l'instruction à reprendre
+static int executer_trace(CPU *cpu, Trace *trace) {
+    int *ip = cpu->registres[REG_IP];
+    int *zf = cpu->registres[REG_ZF];
+    const OpTrace *debut = trace->ops, *fin = trace->ops + trace->nb_ops;
+    long executees = 0;
+    int rc = 0;
+
+    trace->executions++;
+    for (;;) {
+        for (const OpTrace *op = debut; op < fin; op++) {
+            // Seules les instructions copiées comptent comme dispatchs ; une garde n'est
+            // qu'un test de ZF en ligne
+            if (op->genre == TRACE_EXEC) {
+                executees++;
+                *ip = op->ip_apres;
+                if (executer(cpu, &trace->code[op->instr]) != 0) {
+                    fprintf(stderr, "run_block_cache: échec exécution à IP=%d (trace)\n", op->ip_apres - 1);
+                    rc = -1;
+                    goto sortie;
+                }
+            } else if ((*zf == op->zf_saut) != op->pris) {
+                *ip = op->sortie;
+                trace->sorties++;
+                goto sortie;
+            }
+        }
+    }
+
+sortie:
+    cpu->dispatchs += executees;
+    return rc;
+}
+
+int run_block_cache(CPU *cpu, CacheBlocs *cache) {
+    if (!cpu || !cache) {
+        fprintf(stderr, "run_block_cache: paramètres invalides\n");
+        return -1;
+    }
+
+    int *ip = cpu->registres[REG_IP];
+    BlocBase *bloc = block_cache_get(cache, *ip);
+    cache->recherches++;
+
+    while (bloc) {
+        // Boucle chaude déjà enregistrée : on rejoue sa trace
+        if (bloc->trace && !cache->enregistrement) {
+            if (executer_trace(cpu, bloc->trace) != 0) return -1;
+            bloc = block_cache_get(cache, *ip);
+            cache->recherches++;
+            continue;
+        }
+
+        // Corps du bloc : pas de recherche ni de contrôle de bornes ; IP suit pour les
+        // sauts et les superinstructions, qui l'avancent ou le remplacent
+        const InstructionDecodee *instr = bloc->ops;
+        const InstructionDecodee *fin = bloc->ops + bloc->longueur;
+        int32_t suivant = bloc->debut + 1;
+        long executees = 0;
+        while (instr < fin) {
+            *ip = suivant;
+            executees++;
+            if (executer(cpu, instr) != 0) {
+                cpu->dispatchs += executees;
+                fprintf(stderr, "run_block_cache: échec exécution à IP=%d\n", suivant - 1);
+                return -1;
+            }
+            int pas = EST_SUPERINSTRUCTION(instr->opcode) ? 2 : 1;  // superinstruction : deux indices
+            instr += pas;
+            suivant += pas;
+        }
+        cpu->dispatchs += executees;
+        if (cache->enregistrement) trace_record_block(cache, bloc, *ip);
+
+        // Successeur : lien direct si IP est l'une des deux sorties prévues
+        BlocBase *suite;
+        if (*ip == bloc->ip_suivant) {
+            if (!bloc->suivant) bloc->suivant = block_cache_get(cache, *ip);
+            suite = bloc->suivant;
+            cache->chainages++;
+        } else if (*ip == bloc->ip_cible) {
+            if (!bloc->pris) bloc->pris = block_cache_get(cache, *ip);
+            suite = bloc->pris;
+            cache->chainages++;
+
+            // Saut arrière : `suite` est un entête de boucle
+            if (cache->seuil_trace > 0 && bloc->ip_cible <= bloc->debut && suite && !suite->trace &&
+                !suite->trace_impossible && !cache->enregistrement &&
+                ++suite->passages >= cache->seuil_trace) {
+                trace_start(cache, suite);
+            }
+        } else {
+            suite = block_cache_get(cache, *ip);
+            cache->recherches++;
+        }
+        bloc = suite;
+    }
+    return 0;
+}
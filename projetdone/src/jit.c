@@ -0,0 +1,563 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../include/jit.h"
+#include "../include/interpreteur.h"
+#include "../include/optimiseur.h"
+
+// Point d'entrée du code natif : charge l'état, saute au bloc, rend la main à la sortie
+typedef void (*JitEntree)(JitEtat *etat, void *bloc);
+
+#if defined(__x86_64__)
+
+// Numéros des registres de l'hôte dans l'encodage x86-64
+enum { H_RAX = 0, H_RCX = 1, H_RDX = 2, H_RBX = 3, H_RSI = 6, H_RDI = 7,
+       H_R12 = 12, H_R13 = 13, H_R14 = 14, H_R15 = 15 };
+
+// AX..DX sont épinglés dans des registres préservés par l'appelé ; r15 pointe sur JitEtat
+static const int HOTE[4] = { H_RBX, H_R12, H_R13, H_R14 };
+
+#define OFF_REG(i)   ((int32_t)(offsetof(JitEtat, registres) + 4 * (i)))
+#define OFF_ZF       ((int32_t)offsetof(JitEtat, zf))
+#define OFF_SF       ((int32_t)offsetof(JitEtat, sf))
+#define OFF_IP       ((int32_t)offsetof(JitEtat, ip))
+#define OFF_TAILLE   ((int32_t)offsetof(JitEtat, total_size))
+#define OFF_MEMORY   ((int32_t)offsetof(JitEtat, memory))
+
+#define CC_JMP 0x00   // pseudo-condition : saut inconditionnel
+#define CC_JE  0x84
+#define CC_JNE 0x85
+#define CC_JLE 0x8E
+
+#define OCTETS_PAR_INSTRUCTION 192   // majorant du code émis pour une instruction
+#define MAX_SAUTS_LOCAUX 4           // sauts « opérande absent » d'une instruction
+#define ADRESSE_DIRECTE_MAX (1 << 28)  // [n] : n * 8 doit tenir dans un déplacement 32 bits
+
+// Tampon d'émission
+typedef struct {
+    uint8_t *p;
+    size_t n;
+    size_t capacite;
+    int debordement;
+} Tampon;
+
+// Saut vers un bloc dont l'adresse n'est connue qu'à la fin de l'émission
+typedef struct {
+    size_t position;   // position du déplacement rel32
+    int32_t cible;     // indice d'instruction cible
+} SautBloc;
+
+typedef struct {
+    Tampon t;
+    const Programme *prog;
+    uint8_t *compilable;
+    size_t *debut;         // position du code natif de chaque instruction, (size_t)-1 sinon
+    SautBloc *sauts;
+    int32_t nb_sauts;
+    int32_t capacite_sauts;
+    size_t epilogue;
+    int erreur;
+} Compilation;
+
+static void o8(Tampon *t, uint8_t b) {
+    if (t->n + 1 > t->capacite) {
+        t->debordement = 1;
+        return;
+    }
+    t->p[t->n++] = b;
+}
+
+static void o32(Tampon *t, int32_t v) {
+    if (t->n + 4 > t->capacite) {
+        t->debordement = 1;
+        return;
+    }
+    memcpy(t->p + t->n, &v, 4);
+    t->n += 4;
+}
+
+// Préfixe REX (omis s'il est inutile)
+static void rex(Tampon *t, int w, int reg, int rm) {
+    uint8_t v = 0x40 | (w << 3) | (((reg >> 3) & 1) << 2) | ((rm >> 3) & 1);
+    if (v != 0x40) o8(t, v);
+}
+
+static uint8_t modrm(int mod, int reg, int rm) {
+    return (uint8_t)((mod << 6) | ((reg & 7) << 3) | (rm & 7));
+}
+
+// op r32(rm), r32(reg) : 0x89 mov, 0x01 add, 0x39 cmp
+static void op_rr(Tampon *t, uint8_t opcode, int rm, int reg) {
+    rex(t, 0, reg, rm);
+    o8(t, opcode);
+    o8(t, modrm(3, reg, rm));
+}
+
+// op r32, imm32 : extension 0 add, 7 cmp
+static void op_ri(Tampon *t, int extension, int r, int32_t imm) {
+    rex(t, 0, 0, r);
+    o8(t, 0x81);
+    o8(t, modrm(3, extension, r));
+    o32(t, imm);
+}
+
+static void mov_ri(Tampon *t, int r, int32_t imm) {
+    rex(t, 0, 0, r);
+    o8(t, 0xB8 + (r & 7));
+    o32(t, imm);
+}
+
+// mov r32, [r15 + disp] (opcode 0x8B) ou mov [r15 + disp], r32 (opcode 0x89)
+static void acces_etat(Tampon *t, uint8_t opcode, int r, int32_t disp) {
+    rex(t, 0, r, H_R15);
+    o8(t, opcode);
+    o8(t, modrm(2, r, H_R15));
+    o32(t, disp);
+}
+
+// mov dword [r15 + disp], imm32 (extension 0 de 0xC7) ou cmp dword [r15 + disp], imm32 (7 de 0x81)
+static void etat_imm(Tampon *t, uint8_t opcode, int extension, int32_t disp, int32_t imm) {
+    rex(t, 0, 0, H_R15);
+    o8(t, opcode);
+    o8(t, modrm(2, extension, H_R15));
+    o32(t, disp);
+    o32(t, imm);
+}
+
+// Saut rel32 (conditionnel ou non) ; retourne la position du déplacement à corriger
+static size_t saut(Tampon *t, uint8_t cc) {
+    if (cc == CC_JMP) {
+        o8(t, 0xE9);
+    } else {
+        o8(t, 0x0F);
+        o8(t, cc);
+    }
+    size_t position = t->n;
+    o32(t, 0);
+    return position;
+}
+
+static void corriger_saut(Tampon *t, size_t position, size_t cible) {
+    if (t->debordement) return;
+    int32_t rel = (int32_t)((int64_t)cible - (int64_t)(position + 4));
+    memcpy(t->p + position, &rel, 4);
+}
+
+// Registre de l'hôte d'un opérande registre ou indirect (AX..DX), -1 sinon
+static int registre_hote(const Operande *op) {
+    if ((op->mode == MODE_REGISTRE || op->mode == MODE_INDIRECT) &&
+        op->valeur >= REG_AX && op->valeur <= REG_DX) {
+        return HOTE[op->valeur];
+    }
+    return -1;
+}
+
+// Opérande qui ne désigne jamais rien : l'instruction est sans effet, comme dans l'interpréteur
+static int operande_absent(const Operande *op) {
+    return op->mode == MODE_AUCUN || (op->mode == MODE_DIRECT && op->valeur < 0);
+}
+
+static int operande_compilable(const Operande *op) {
+    switch (op->mode) {
+        case MODE_AUCUN:
+        case MODE_IMMEDIAT:
+            return 1;
+        case MODE_REGISTRE:
+        case MODE_INDIRECT:
+            return registre_hote(op) >= 0;
+        case MODE_DIRECT:
+            return op->valeur < ADRESSE_DIRECTE_MAX;
+        default:
+            return 0;
+    }
+}
+
+static int instruction_compilable(const InstructionDecodee *instr) {
+    switch (superinstruction_first(instr->opcode)) {
+        case OPC_MOV:
+        case OPC_ADD:
+        case OPC_CMP:
+            return operande_compilable(&instr->dest) && operande_compilable(&instr->src);
+        case OPC_JMP:
+            return instr->dest.mode == MODE_IMMEDIAT || registre_hote(&instr->dest) >= 0;
+        case OPC_JZ:
+        case OPC_JNZ:
+            return instr->dest.mode == MODE_IMMEDIAT;
+        case OPC_HALT:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Case mémoire [n] dans rax ou rdx ; saute à la fin de l'instruction si n est hors de la
+// mémoire ou si la case est vide (NULL)
+static void charger_cellule(Tampon *t, int r, int32_t n, size_t *sauts, int *nb) {
+    etat_imm(t, 0x81, 7, OFF_TAILLE, n);        // cmp [total_size], n
+    sauts[(*nb)++] = saut(t, CC_JLE);           // total_size <= n : rien à faire
+    rex(t, 1, r, H_R15);                        // mov r64, [r15 + memory]
+    o8(t, 0x8B);
+    o8(t, modrm(2, r, H_R15));
+    o32(t, OFF_MEMORY);
+    rex(t, 1, r, r);                            // mov r64, [r64 + n * 8]
+    o8(t, 0x8B);
+    o8(t, modrm(2, r, r));
+    o32(t, n * 8);
+    rex(t, 1, r, r);                            // test r64, r64
+    o8(t, 0x85);
+    o8(t, modrm(3, r, r));
+    sauts[(*nb)++] = saut(t, CC_JE);
+}
+
+static void fin_instruction(Tampon *t, size_t *sauts, int nb) {
+    for (int k = 0; k < nb; k++) corriger_saut(t, sauts[k], t->n);
+}
+
+// Sortie du code natif : IP = ip, puis épilogue
+static void sortir(Compilation *c, int32_t ip) {
+    etat_imm(&c->t, 0xC7, 0, OFF_IP, ip);
+    corriger_saut(&c->t, saut(&c->t, CC_JMP), c->epilogue);
+}
+
+// Continue à l'instruction `cible` : saut direct vers son bloc s'il est compilé, sortie sinon
+static void aller_a(Compilation *c, int32_t cible) {
+    if (cible < 0 || cible >= c->prog->code_count || !c->compilable[cible]) {
+        sortir(c, cible);
+        return;
+    }
+    if (c->nb_sauts == c->capacite_sauts) {
+        int32_t capacite = c->capacite_sauts > 0 ? c->capacite_sauts * 2 : 64;
+        SautBloc *sauts = realloc(c->sauts, sizeof(SautBloc) * capacite);
+        if (!sauts) {
+            c->erreur = 1;
+            return;
+        }
+        c->sauts = sauts;
+        c->capacite_sauts = capacite;
+    }
+    c->sauts[c->nb_sauts].position = saut(&c->t, CC_JMP);
+    c->sauts[c->nb_sauts].cible = cible;
+    c->nb_sauts++;
+}
+
+// MOV ou ADD
+static void emettre_affectation(Tampon *t, const InstructionDecodee *instr, int ajouter) {
+    const Operande *d = &instr->dest, *s = &instr->src;
+    if (operande_absent(d) || d->mode == MODE_IMMEDIAT || operande_absent(s)) return;
+
+    size_t sauts[MAX_SAUTS_LOCAUX];
+    int nb = 0;
+    int rd = registre_hote(d);
+    int rs = registre_hote(s);
+
+    if (d->mode == MODE_DIRECT) charger_cellule(t, H_RDX, d->valeur, sauts, &nb);
+    if (s->mode == MODE_DIRECT) {
+        charger_cellule(t, H_RAX, s->valeur, sauts, &nb);
+        o8(t, 0x8B);                            // mov ecx, [rax]
+        o8(t, modrm(0, H_RCX, H_RAX));
+        rs = H_RCX;
+    }
+
+    if (rd >= 0) {
+        if (s->mode == MODE_IMMEDIAT) {
+            if (ajouter) op_ri(t, 0, rd, s->valeur);
+            else mov_ri(t, rd, s->valeur);
+        } else {
+            op_rr(t, ajouter ? 0x01 : 0x89, rd, rs);
+        }
+    } else if (s->mode == MODE_IMMEDIAT) {
+        o8(t, ajouter ? 0x81 : 0xC7);           // add/mov dword [rdx], imm32
+        o8(t, modrm(0, 0, H_RDX));
+        o32(t, s->valeur);
+    } else {
+        rex(t, 0, rs, H_RDX);                   // add/mov [rdx], r32
+        o8(t, ajouter ? 0x01 : 0x89);
+        o8(t, modrm(0, rs, H_RDX));
+    }
+    fin_instruction(t, sauts, nb);
+}
+
+// CMP : ZF et SF d'après gauche - droite
+static void emettre_comparaison(Tampon *t, const InstructionDecodee *instr) {
+    const Operande *a = &instr->dest, *b = &instr->src;
+    if (operande_absent(a) || operande_absent(b)) return;
+
+    if (a->mode == MODE_IMMEDIAT && b->mode == MODE_IMMEDIAT) {
+        int32_t diff = (int32_t)((uint32_t)a->valeur - (uint32_t)b->valeur);
+        etat_imm(t, 0xC7, 0, OFF_ZF, diff == 0);
+        etat_imm(t, 0xC7, 0, OFF_SF, diff < 0);
+        return;
+    }
+
+    size_t sauts[MAX_SAUTS_LOCAUX];
+    int nb = 0;
+
+    // eax = gauche
+    if (a->mode == MODE_IMMEDIAT) {
+        mov_ri(t, H_RAX, a->valeur);
+    } else if (a->mode == MODE_DIRECT) {
+        charger_cellule(t, H_RAX, a->valeur, sauts, &nb);
+        o8(t, 0x8B);                            // mov eax, [rax]
+        o8(t, modrm(0, H_RAX, H_RAX));
+    } else {
+        op_rr(t, 0x89, H_RAX, registre_hote(a));
+    }
+
+    // cmp eax, droite
+    if (b->mode == MODE_IMMEDIAT) {
+        op_ri(t, 7, H_RAX, b->valeur);
+    } else if (b->mode == MODE_DIRECT) {
+        charger_cellule(t, H_RDX, b->valeur, sauts, &nb);
+        o8(t, 0x3B);                            // cmp eax, [rdx]
+        o8(t, modrm(0, H_RAX, H_RDX));
+    } else {
+        op_rr(t, 0x39, H_RAX, registre_hote(b));
+    }
+
+    o8(t, 0x0F); o8(t, 0x94); o8(t, 0xC0);     // sete al
+    o8(t, 0x0F); o8(t, 0x98); o8(t, 0xC1);     // sets cl
+    o8(t, 0x0F); o8(t, 0xB6); o8(t, 0xC0);     // movzx eax, al
+    o8(t, 0x0F); o8(t, 0xB6); o8(t, 0xC9);     // movzx ecx, cl
+    acces_etat(t, 0x89, H_RAX, OFF_ZF);
+    acces_etat(t, 0x89, H_RCX, OFF_SF);
+    fin_instruction(t, sauts, nb);
+}
+
+static void emettre_instruction(Compilation *c, int32_t i) {
+    Tampon *t = &c->t;
+    const InstructionDecodee *instr = &c->prog->code[i];
+
+    switch (superinstruction_first(instr->opcode)) {
+        case OPC_MOV:
+            emettre_affectation(t, instr, 0);
+            break;
+
+        case OPC_ADD:
+            emettre_affectation(t, instr, 1);
+            break;
+
+        case OPC_CMP:
+            emettre_comparaison(t, instr);
+            break;
+
+        case OPC_JMP:
+            if (instr->dest.mode == MODE_IMMEDIAT) {
+                aller_a(c, instr->dest.valeur);
+            } else {
+                // Cible calculée : on rend la main au répartiteur
+                acces_etat(t, 0x89, registre_hote(&instr->dest), OFF_IP);
+                corriger_saut(t, saut(t, CC_JMP), c->epilogue);
+            }
+            return;
+
+        case OPC_JZ:
+        case OPC_JNZ: {
+            int attendu = superinstruction_first(instr->opcode) == OPC_JZ ? 1 : 0;
+            etat_imm(t, 0x81, 7, OFF_ZF, attendu);   // cmp [zf], attendu
+            size_t suite = saut(t, CC_JNE);
+            aller_a(c, instr->dest.valeur);
+            corriger_saut(t, suite, t->n);
+            break;
+        }
+
+        case OPC_HALT:
+            sortir(c, -1);
+            return;
+    }
+
+    // Fin de bloc sans saut : on tombe dans l'instruction suivante si elle est compilée
+    if (i + 1 >= c->prog->code_count || !c->compilable[i + 1]) {
+        sortir(c, i + 1);
+    }
+}
+
+static int est_saut(int opcode) {
+    return opcode == OPC_JMP || opcode == OPC_JZ || opcode == OPC_JNZ || opcode == OPC_HALT;
+}
+
+JitCode *jit_compile(const Programme *prog) {
+    if (!prog) return NULL;
+    int32_t n = prog->code_count;
+
+    JitCode *jit = calloc(1, sizeof(JitCode));
+    Compilation c;
+    memset(&c, 0, sizeof(c));
+    c.prog = prog;
+    c.compilable = calloc(n > 0 ? n : 1, 1);
+    uint8_t *tete = calloc(n + 1, 1);       // début de bloc de base
+    size_t *debut = malloc(sizeof(size_t) * (n > 0 ? n : 1));
+    if (jit) jit->entrees = calloc(n > 0 ? n : 1, sizeof(void *));
+    if (!jit || !jit->entrees || !c.compilable || !tete || !debut) {
+        free(c.compilable);
+        free(tete);
+        free(debut);
+        jit_free(jit);
+        return NULL;
+    }
+
+    // 1) Découpage en blocs de base
+    if (n > 0) tete[0] = 1;
+    for (int32_t i = 0; i < prog->label_count; i++) {
+        int32_t v = prog->labels[i].valeur;
+        if (v >= 0 && v < n) tete[v] = 1;
+    }
+    for (int32_t i = 0; i < n; i++) {
+        const InstructionDecodee *instr = &prog->code[i];
+        c.compilable[i] = (uint8_t)instruction_compilable(instr);
+        if (est_saut(instr->opcode)) {
+            tete[i + 1] = 1;
+            if (instr->dest.mode == MODE_IMMEDIAT && instr->dest.valeur >= 0 && instr->dest.valeur < n) {
+                tete[instr->dest.valeur] = 1;
+            }
+        }
+        if (!c.compilable[i]) {
+            // Après un passage par l'interpréteur, on reprend au bloc suivant
+            tete[i + 1] = 1;
+            if (superinstruction_first(instr->opcode) != instr->opcode && i + 2 <= n) tete[i + 2] = 1;
+        }
+    }
+
+    // 2) Pages inscriptibles le temps de l'émission, exécutables ensuite (jamais les deux)
+    long page = sysconf(_SC_PAGESIZE);
+    size_t taille = (size_t)n * OCTETS_PAR_INSTRUCTION + 256;
+    taille = (taille + (size_t)page - 1) / (size_t)page * (size_t)page;
+    void *pages = mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED) {
+        free(c.compilable);
+        free(tete);
+        free(debut);
+        jit_free(jit);
+        return NULL;
+    }
+    jit->code = pages;
+    jit->taille = taille;
+    jit->code_count = n;
+    c.t.p = pages;
+    c.t.capacite = taille;
+    Tampon *t = &c.t;
+
+    // Prologue : registres préservés, r15 = état, AX..DX dans les registres de l'hôte, jmp bloc
+    o8(t, 0x53);                                // push rbx
+    o8(t, 0x41); o8(t, 0x54);                   // push r12
+    o8(t, 0x41); o8(t, 0x55);                   // push r13
+    o8(t, 0x41); o8(t, 0x56);                   // push r14
+    o8(t, 0x41); o8(t, 0x57);                   // push r15
+    rex(t, 1, H_RDI, H_R15);                    // mov r15, rdi
+    o8(t, 0x89);
+    o8(t, modrm(3, H_RDI, H_R15));
+    for (int k = 0; k < 4; k++) acces_etat(t, 0x8B, HOTE[k], OFF_REG(k));
+    o8(t, 0xFF);                                // jmp rsi
+    o8(t, modrm(3, 4, H_RSI));
+
+    // Épilogue : AX..DX recopiés dans l'état, retour à l'appelant
+    c.epilogue = t->n;
+    for (int k = 0; k < 4; k++) acces_etat(t, 0x89, HOTE[k], OFF_REG(k));
+    o8(t, 0x41); o8(t, 0x5F);                   // pop r15
+    o8(t, 0x41); o8(t, 0x5E);                   // pop r14
+    o8(t, 0x41); o8(t, 0x5D);                   // pop r13
+    o8(t, 0x41); o8(t, 0x5C);                   // pop r12
+    o8(t, 0x5B);                                // pop rbx
+    o8(t, 0xC3);                                // ret
+
+    // 3) Blocs, émis dans l'ordre du code : un bloc qui ne saute pas tombe dans le suivant
+    for (int32_t i = 0; i < n; i++) {
+        debut[i] = (size_t)-1;
+        if (!c.compilable[i]) continue;
+        debut[i] = t->n;
+        if (tete[i]) jit->nb_blocs++;
+        jit->nb_compilees++;
+        emettre_instruction(&c, i);
+    }
+
+    // 4) Chaînage direct des blocs
+    for (int32_t k = 0; k < c.nb_sauts; k++) {
+        corriger_saut(t, c.sauts[k].position, debut[c.sauts[k].cible]);
+    }
+    for (int32_t i = 0; i < n; i++) {
+        if (tete[i] && c.compilable[i]) jit->entrees[i] = (uint8_t *)pages + debut[i];
+    }
+
+    int echec = t->debordement || c.erreur ||
+                mprotect(pages, taille, PROT_READ | PROT_EXEC) != 0;
+    free(c.compilable);
+    free(c.sauts);
+    free(tete);
+    free(debut);
+    if (echec) {
+        fprintf(stderr, "jit_compile: compilation impossible, repli sur l'interpréteur\n");
+        jit_free(jit);
+        return NULL;
+    }
+    return jit;
+}
+
+#else  /* !__x86_64__ */
+
+JitCode *jit_compile(const Programme *prog) {
+    (void)prog;
+    return NULL;  // pas de générateur de code pour cette architecture
+}
+
+#endif
+
+void jit_free(JitCode *jit) {
+    if (!jit) return;
+    if (jit->code) munmap(jit->code, jit->taille);
+    free(jit->entrees);
+    free(jit);
+}
+
+int jit_run(CPU *cpu, const Programme *prog, const JitCode *jit) {
+    if (!cpu || !prog) {
+        fprintf(stderr, "jit_run: paramètres invalides\n");
+        return -1;
+    }
+    if (!jit || jit->code_count != prog->code_count) return run_decoded_program(cpu, prog);
+
+    JitEntree entree;
+    void *code = jit->code;
+    memcpy(&entree, &code, sizeof(entree));
+
+    JitEtat etat;
+    etat.memory = cpu->memory_handler->memory;
+    etat.total_size = cpu->memory_handler->total_size;
+
+    int *ip = cpu->registres[REG_IP];
+    while (*ip >= 0 && *ip < prog->code_count) {
+        void *bloc = jit->entrees[*ip];
+        if (bloc) {
+            for (int k = 0; k < 4; k++) etat.registres[k] = *cpu->registres[REG_AX + k];
+            etat.zf = *cpu->registres[REG_ZF];
+            etat.sf = *cpu->registres[REG_SF];
+            entree(&etat, bloc);
+            for (int k = 0; k < 4; k++) *cpu->registres[REG_AX + k] = etat.registres[k];
+            *cpu->registres[REG_ZF] = etat.zf;
+            *cpu->registres[REG_SF] = etat.sf;
+            *ip = etat.ip;
+            continue;
+        }
+
+        // Pas de code natif ici : l'interpréteur exécute une instruction
+        const InstructionDecodee *instr = &prog->code[*ip];
+        (*ip)++;
+        cpu->dispatchs++;
+        if (execute_decoded(cpu, instr) != 0) {
+            fprintf(stderr, "jit_run: échec exécution à IP=%d\n", *ip - 1);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int run_program_engine(CPU *cpu, const Programme *prog, MoteurExecution moteur) {
+    if (moteur != MOTEUR_JIT) return run_decoded_program(cpu, prog);
+
+    JitCode *jit = jit_compile(prog);
+    int rc = jit_run(cpu, prog, jit);
+    jit_free(jit);
+    return rc;
+}
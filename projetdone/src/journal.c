@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "../include/journal.h"
+
+#define TAILLE_TABLE (2 * JOURNAL_CAPACITE)   // puissance de 2, remplie au plus à moitié
+#define MARGE 2                               // cases créées au plus par une instruction (MOV_ADD)
+
+// Table à adressage ouvert (sondage linéaire) d'indices dans les tableaux d'entrées ; les
+// entrées ne bougent jamais, leurs adresses peuvent être rendues à l'interpréteur
+struct journal {
+    int table[TAILLE_TABLE];          // -1 : place libre
+    int adresses[JOURNAL_CAPACITE];
+    int valeurs[JOURNAL_CAPACITE];
+    int nb;
+};
+
+static inline unsigned place(int adresse) {
+    return ((uint32_t)adresse * 2654435761u) & (TAILLE_TABLE - 1);
+}
+
+Journal *journal_create(void) {
+    Journal *j = malloc(sizeof(Journal));
+    if (!j) return NULL;
+    for (int k = 0; k < TAILLE_TABLE; k++) j->table[k] = -1;
+    j->nb = 0;
+    return j;
+}
+
+void journal_destroy(Journal *journal) {
+    free(journal);
+}
+
+// Indice de l'entrée de `adresse`, ou -1 ; *libre reçoit la place où l'insérer
+static int chercher(const Journal *j, int adresse, unsigned *libre) {
+    unsigned k = place(adresse);
+    while (j->table[k] >= 0) {
+        if (j->adresses[j->table[k]] == adresse) return j->table[k];
+        k = (k + 1) & (TAILLE_TABLE - 1);
+    }
+    if (libre) *libre = k;
+    return -1;
+}
+
+int *journal_cell(Journal *journal, MemoryHandler *handler, int adresse) {
+    unsigned libre;
+    int e = chercher(journal, adresse, &libre);
+    if (e >= 0) return &journal->valeurs[e];
+
+    if (adresse < 0 || adresse >= handler->total_size || journal->nb >= JOURNAL_CAPACITE) return NULL;
+    int *cellule = handler->memory[adresse];
+    if (!cellule) return NULL;
+    e = journal->nb++;
+    journal->adresses[e] = adresse;
+    journal->valeurs[e] = *cellule;
+    journal->table[libre] = e;
+    return &journal->valeurs[e];
+}
+
+int journal_read(const Journal *journal, const MemoryHandler *handler, int adresse, int *valeur) {
+    int e = chercher(journal, adresse, NULL);
+    if (e >= 0) {
+        *valeur = journal->valeurs[e];
+        return 1;
+    }
+    if (adresse < 0 || adresse >= handler->total_size || !handler->memory[adresse]) return 0;
+    *valeur = *(int *)handler->memory[adresse];
+    return 1;
+}
+
+int journal_full(const Journal *journal) {
+    return journal->nb > JOURNAL_CAPACITE - MARGE;
+}
+
+int journal_size(const Journal *journal) {
+    return journal->nb;
+}
+
+void journal_commit(Journal *journal, MemoryHandler *handler) {
+    for (int e = 0; e < journal->nb; e++) {
+        int adresse = journal->adresses[e];
+        int *cellule = handler->memory[adresse];
+        if (cellule) *cellule = journal->valeurs[e];
+        // Seules les places occupées sont remises à -1
+        unsigned k = place(adresse);
+        while (journal->table[k] != e) k = (k + 1) & (TAILLE_TABLE - 1);
+        journal->table[k] = -1;
+    }
+    journal->nb = 0;
+}
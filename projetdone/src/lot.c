@@ -0,0 +1,342 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../include/lot.h"
+#include "../include/interpreteur.h"
+
+// File d'un thread : anneau d'indices de tâches. Le propriétaire prend en tête et remet
+// en queue ; un voleur prend en queue. Chaque tâche n'est que dans une file à la fois,
+// `nb_taches` cases suffisent.
+typedef struct {
+    pthread_mutex_t verrou;
+    int *taches;
+    int capacite;
+    int tete;
+    int nb;
+} FileThread;
+
+typedef struct lot LotEnCours;
+
+typedef struct {
+    LotEnCours *lot;
+    int indice;
+    double occupe;      // Temps passé dans les tranches
+    long tranches;
+    long vols;
+} Travailleur;
+
+// État partagé par les threads du pool
+struct lot {
+    const TacheLot *taches;
+    ResultatLot *resultats;
+    CPU **cpus;              // CPU de chaque tâche commencée et non terminée
+    int nb_taches;
+    long quantum;            // < 0 : chaque tâche est exécutée jusqu'au bout
+    int vol;
+    FileThread *files;
+    int nb_threads;
+    atomic_int restantes;    // Tâches non terminées
+    double debut;
+    // Threads sans travail, garés jusqu'au prochain dépôt ou jusqu'à la fin du lot
+    pthread_mutex_t attente;
+    pthread_cond_t reveil;
+    atomic_long depots;      // Tâches remises en file depuis le début (les garés la surveillent)
+    atomic_int gares;        // Threads garés ou sur le point de l'être (modifié sous `attente`)
+};
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// -----------------------------------
+// Files
+// -----------------------------------
+
+static int file_init(FileThread *f, int capacite) {
+    f->taches = malloc(sizeof(int) * (size_t)(capacite > 0 ? capacite : 1));
+    if (!f->taches) return -1;
+    f->capacite = capacite;
+    f->tete = f->nb = 0;
+    pthread_mutex_init(&f->verrou, NULL);
+    return 0;
+}
+
+static void file_detruire(FileThread *f) {
+    pthread_mutex_destroy(&f->verrou);
+    free(f->taches);
+}
+
+// Retourne le nombre de tâches de la file après le dépôt
+static int file_deposer(FileThread *f, int tache) {
+    pthread_mutex_lock(&f->verrou);
+    f->taches[(f->tete + f->nb) % f->capacite] = tache;
+    int nb = ++f->nb;
+    pthread_mutex_unlock(&f->verrou);
+    return nb;
+}
+
+// Prend en tête (propriétaire) ou en queue (voleur) ; retourne -1 si la file est vide
+static int file_prendre(FileThread *f, int en_queue) {
+    int tache = -1;
+    pthread_mutex_lock(&f->verrou);
+    if (f->nb > 0) {
+        if (en_queue) {
+            tache = f->taches[(f->tete + f->nb - 1) % f->capacite];
+        } else {
+            tache = f->taches[f->tete];
+            f->tete = (f->tete + 1) % f->capacite;
+        }
+        f->nb--;
+    }
+    pthread_mutex_unlock(&f->verrou);
+    return tache;
+}
+
+// -----------------------------------
+// Tâches
+// -----------------------------------
+
+CPU *batch_task_start(const TacheLot *tache) {
+    const Programme *prog = tache->prog;
+    if (!prog || tache->nb_entrees < 0 || tache->nb_entrees > prog->data_size ||
+        (tache->nb_entrees > 0 && !tache->entrees)) {
+        return NULL;
+    }
+    int taille = tache->memory_size > 0 ? tache->memory_size
+                                        : prog->data_size + prog->code_count + STACK_SIZE;
+    CPU *cpu = cpu_init(taille);
+    if (!cpu) return NULL;
+    if (load_program(cpu, prog) != 0) {
+        cpu_destroy(cpu);
+        return NULL;
+    }
+    // DS est fait de mots contigus depuis l'adresse 0 (load_program)
+    if (tache->nb_entrees > 0) {
+        memcpy(cpu->memory_handler->mots, tache->entrees, sizeof(int32_t) * (size_t)tache->nb_entrees);
+    }
+    return cpu;
+}
+
+void batch_task_finish(CPU *cpu, int registres[NB_REGISTRES], long *dispatchs, int32_t *ds, int32_t ds_taille) {
+    MemoryHandler *m = cpu->memory_handler;
+    for (int r = 0; r < NB_REGISTRES; r++) registres[r] = *cpu->registres[r];
+    *dispatchs = cpu->dispatchs;
+    if (ds) {
+        for (int32_t k = 0; k < ds_taille; k++) ds[k] = m->memory[k] ? *(int *)m->memory[k] : 0;
+    }
+    cpu_destroy(cpu);
+}
+
+// Copie l'état final (cpu NULL : tâche invalide) et libère le CPU
+static void terminer(LotEnCours *lot, int i, CPU *cpu, int statut) {
+    ResultatLot *res = &lot->resultats[i];
+    res->statut = cpu ? statut : -1;
+    if (cpu) {
+        int32_t taille = lot->taches[i].prog->data_size;
+        res->ds = malloc(sizeof(int32_t) * (size_t)(taille > 0 ? taille : 1));
+        if (res->ds) {
+            res->ds_taille = taille;
+        } else {
+            res->statut = -1;
+        }
+        batch_task_finish(cpu, res->registres, &res->dispatchs, res->ds, taille);
+    }
+    lot->cpus[i] = NULL;
+    res->fin = maintenant() - lot->debut;
+    if (atomic_fetch_sub(&lot->restantes, 1) == 1) {
+        // Dernière tâche : les threads garés repartent pour s'arrêter
+        pthread_mutex_lock(&lot->attente);
+        pthread_cond_broadcast(&lot->reveil);
+        pthread_mutex_unlock(&lot->attente);
+    }
+}
+
+// Remet une tâche inachevée en file. Si la file a d'autres tâches, l'une d'elles est en
+// trop pour ce thread : un thread garé est réveillé pour la voler. Seule dans sa file, la
+// tâche est reprise aussitôt par son thread, personne n'est réveillé. Le dépôt est compté
+// avant de lire `gares` : un thread qui se gare ensuite voit le nouveau dépôt.
+static void redeposer(LotEnCours *lot, FileThread *file, int i) {
+    int surplus = file_deposer(file, i) > 1;
+    atomic_fetch_add(&lot->depots, 1);
+    if (surplus && atomic_load(&lot->gares) > 0) {
+        pthread_mutex_lock(&lot->attente);
+        pthread_cond_signal(&lot->reveil);
+        pthread_mutex_unlock(&lot->attente);
+    }
+}
+
+// Attend un dépôt postérieur à `vus` ou la fin du lot, sans consommer de cœur
+static void garer(LotEnCours *lot, long vus) {
+    pthread_mutex_lock(&lot->attente);
+    atomic_fetch_add(&lot->gares, 1);
+    while (atomic_load(&lot->depots) == vus && atomic_load(&lot->restantes) > 0) {
+        pthread_cond_wait(&lot->reveil, &lot->attente);
+    }
+    atomic_fetch_sub(&lot->gares, 1);
+    pthread_mutex_unlock(&lot->attente);
+}
+
+// Une tranche de la tâche i ; retourne 1 si elle reste à finir
+static int avancer(LotEnCours *lot, int i) {
+    CPU *cpu = lot->cpus[i];
+    if (!cpu) {
+        cpu = batch_task_start(&lot->taches[i]);
+        if (!cpu) {
+            terminer(lot, i, NULL, -1);
+            return 0;
+        }
+        lot->cpus[i] = cpu;
+    }
+
+    const Programme *prog = lot->taches[i].prog;
+    int rc = lot->quantum > 0 ? run_decoded_quantum(cpu, prog, lot->quantum)
+                              : run_decoded_program(cpu, prog);
+    if (rc > 0) return 1;
+    terminer(lot, i, cpu, rc);
+    return 0;
+}
+
+static void *travailleur(void *arg) {
+    Travailleur *moi = arg;
+    LotEnCours *lot = moi->lot;
+    FileThread *file = &lot->files[moi->indice];
+
+    for (;;) {
+        // Relevé avant de parcourir les files : un dépôt fait pendant le parcours réveille
+        long vus = atomic_load(&lot->depots);
+        int i = file_prendre(file, 0);
+        for (int k = 1; i < 0 && lot->vol && k < lot->nb_threads; k++) {
+            i = file_prendre(&lot->files[(moi->indice + k) % lot->nb_threads], 1);
+            if (i >= 0) moi->vols++;
+        }
+        if (i < 0) {
+            // Sans vol, seule la file du thread peut le nourrir ; avec vol, une tâche en cours
+            // ailleurs peut encore être remise dans une file : le thread se gare jusque-là
+            if (!lot->vol || atomic_load_explicit(&lot->restantes, memory_order_acquire) == 0) break;
+            garer(lot, vus);
+            continue;
+        }
+
+        double debut = maintenant();
+        int reste = avancer(lot, i);
+        moi->occupe += maintenant() - debut;
+        moi->tranches++;
+        if (reste) redeposer(lot, file, i);
+    }
+    return NULL;
+}
+
+int batch_run(const TacheLot *taches, int nb_taches, const OptionsLot *options, ResultatLot *resultats, BilanLot *bilan) {
+    if (!taches || !resultats || nb_taches < 0) {
+        fprintf(stderr, "batch_run: paramètres invalides.\n");
+        return -1;
+    }
+    OptionsLot defaut = { 0, 0, 0 };
+    if (!options) options = &defaut;
+
+    int nb_threads = options->nb_threads;
+    if (nb_threads <= 0) {
+        long coeurs = sysconf(_SC_NPROCESSORS_ONLN);
+        nb_threads = coeurs > 0 ? (int)coeurs : 1;
+    }
+    if (nb_threads > nb_taches) nb_threads = nb_taches > 0 ? nb_taches : 1;
+
+    LotEnCours lot;
+    memset(&lot, 0, sizeof(lot));
+    lot.taches = taches;
+    lot.resultats = resultats;
+    lot.nb_taches = nb_taches;
+    lot.quantum = options->quantum == 0 ? LOT_QUANTUM_DEFAUT : options->quantum;
+    lot.vol = !options->sans_vol;
+    lot.nb_threads = nb_threads;
+    atomic_init(&lot.restantes, nb_taches);
+    atomic_init(&lot.depots, 0);
+    atomic_init(&lot.gares, 0);
+    pthread_mutex_init(&lot.attente, NULL);
+    pthread_cond_init(&lot.reveil, NULL);
+    lot.cpus = calloc((size_t)(nb_taches > 0 ? nb_taches : 1), sizeof(CPU *));
+    lot.files = calloc((size_t)nb_threads, sizeof(FileThread));
+    Travailleur *travailleurs = calloc((size_t)nb_threads, sizeof(Travailleur));
+    pthread_t *threads = malloc(sizeof(pthread_t) * (size_t)nb_threads);
+    int files_pretes = 0;
+    while (lot.files && files_pretes < nb_threads && file_init(&lot.files[files_pretes], nb_taches) == 0) files_pretes++;
+    if (!lot.cpus || !travailleurs || !threads || files_pretes < nb_threads) {
+        for (int t = 0; t < files_pretes; t++) file_detruire(&lot.files[t]);
+        pthread_mutex_destroy(&lot.attente);
+        pthread_cond_destroy(&lot.reveil);
+        free(lot.files);
+        free(lot.cpus);
+        free(travailleurs);
+        free(threads);
+        return -1;
+    }
+
+    // Répartition statique de départ : des blocs contigus, dans l'ordre des tâches
+    memset(resultats, 0, sizeof(ResultatLot) * (size_t)nb_taches);
+    for (int i = 0; i < nb_taches; i++) {
+        file_deposer(&lot.files[(int)((long)i * nb_threads / nb_taches)], i);
+    }
+
+    lot.debut = maintenant();
+    int lances = 0;
+    for (int t = 0; t < nb_threads; t++) {
+        travailleurs[t].lot = &lot;
+        travailleurs[t].indice = t;
+    }
+    while (lances < nb_threads && pthread_create(&threads[lances], NULL, travailleur, &travailleurs[lances]) == 0) lances++;
+    for (int t = 0; t < lances; t++) pthread_join(threads[t], NULL);
+    // Threads qui n'ont pas pu être créés : l'appelant vide leurs files
+    if (atomic_load(&lot.restantes) > 0) {
+        lot.vol = 1;
+        travailleur(&travailleurs[lances < nb_threads ? lances : 0]);
+        if (lances < nb_threads) lances++;
+    }
+    double duree = maintenant() - lot.debut;
+
+    if (bilan) {
+        memset(bilan, 0, sizeof(*bilan));
+        bilan->nb_threads = lances;
+        bilan->nb_taches = nb_taches;
+        bilan->duree = duree;
+        double occupe = 0;
+        for (int t = 0; t < nb_threads; t++) {
+            occupe += travailleurs[t].occupe;
+            bilan->tranches += travailleurs[t].tranches;
+            bilan->vols += travailleurs[t].vols;
+        }
+        for (int i = 0; i < nb_taches; i++) {
+            if (resultats[i].statut != 0) bilan->nb_echecs++;
+            bilan->dispatchs += resultats[i].dispatchs;
+        }
+        if (duree > 0) {
+            bilan->utilisation = occupe / (duree * lances);
+            bilan->taches_par_seconde = nb_taches / duree;
+            bilan->dispatchs_par_seconde = bilan->dispatchs / duree;
+        }
+    }
+
+    for (int t = 0; t < nb_threads; t++) file_detruire(&lot.files[t]);
+    pthread_mutex_destroy(&lot.attente);
+    pthread_cond_destroy(&lot.reveil);
+    free(lot.files);
+    free(lot.cpus);
+    free(travailleurs);
+    free(threads);
+    return 0;
+}
+
+void batch_results_free(ResultatLot *resultats, int nb) {
+    if (!resultats) return;
+    for (int i = 0; i < nb; i++) {
+        free(resultats[i].ds);
+        resultats[i].ds = NULL;
+        resultats[i].ds_taille = 0;
+    }
+}
@@ -0,0 +1,249 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "../include/lot_processus.h"
+#include "../include/interpreteur.h"
+
+#define ATTENTE_NS 1000000   // le parent relève les travailleurs morts toutes les 1 ms
+
+enum { TACHE_LIBRE, TACHE_EN_COURS, TACHE_FINIE };
+
+// Case de la table partagée : écrite par un seul travailleur, lue par le parent après sa mort
+typedef struct {
+    atomic_int etat;
+    int statut;
+    int registres[NB_REGISTRES];
+    long dispatchs;
+    double fin;
+    int32_t ds_taille;
+    size_t ds_decalage;     // Premier mot de la copie de DS dans la zone des mots
+} CaseTable;
+
+// Part d'un travailleur : tâches [debut, fin), `prochaine` est la suivante à prendre
+typedef struct {
+    atomic_int prochaine;
+    int debut;
+    int fin;
+    pid_t pid;              // Travailleur en cours, 0 si aucun
+} Part;
+
+// Table partagée : parts, cases puis mots de DS, dans une seule projection anonyme
+typedef struct {
+    Part *parts;
+    CaseTable *cases;
+    int32_t *mots;
+    void *zone;
+    size_t taille;
+} TablePartagee;
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static size_t arrondi(size_t n) {
+    return (n + 63) / 64 * 64;
+}
+
+static int table_creer(TablePartagee *t, const TacheLot *taches, int nb_taches, int nb_parts) {
+    size_t nb_mots = 0;
+    for (int i = 0; i < nb_taches; i++) {
+        if (taches[i].prog && taches[i].prog->data_size > 0) nb_mots += (size_t)taches[i].prog->data_size;
+    }
+    size_t taille_parts = arrondi(sizeof(Part) * (size_t)nb_parts);
+    size_t taille_cases = arrondi(sizeof(CaseTable) * (size_t)nb_taches);
+    t->taille = taille_parts + taille_cases + sizeof(int32_t) * (nb_mots > 0 ? nb_mots : 1);
+    // Projection anonyme partagée : mise à zéro par le noyau, héritée par fork()
+    t->zone = mmap(NULL, t->taille, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (t->zone == MAP_FAILED) return -1;
+    t->parts = t->zone;
+    t->cases = (CaseTable *)((char *)t->zone + taille_parts);
+    t->mots = (int32_t *)((char *)t->zone + taille_parts + taille_cases);
+
+    size_t decalage = 0;
+    for (int i = 0; i < nb_taches; i++) {
+        atomic_init(&t->cases[i].etat, TACHE_LIBRE);
+        t->cases[i].statut = -1;
+        t->cases[i].ds_decalage = decalage;
+        t->cases[i].ds_taille = taches[i].prog && taches[i].prog->data_size > 0 ? taches[i].prog->data_size : 0;
+        decalage += (size_t)t->cases[i].ds_taille;
+    }
+    // Parts contiguës, comme la répartition de départ de batch_run
+    for (int p = 0; p < nb_parts; p++) {
+        t->parts[p].debut = (int)((long)p * nb_taches / nb_parts);
+        t->parts[p].fin = (int)((long)(p + 1) * nb_taches / nb_parts);
+        atomic_init(&t->parts[p].prochaine, t->parts[p].debut);
+    }
+    return 0;
+}
+
+// -----------------------------------
+// Travailleur
+// -----------------------------------
+
+// Exécute une tâche et écrit son état final dans sa case (mêmes étapes que batch_run)
+static void executer_tache(const TacheLot *tache, CaseTable *c, int32_t *ds, double debut_lot) {
+    CPU *cpu = batch_task_start(tache);
+    c->statut = -1;
+    if (cpu) {
+        c->statut = run_decoded_program(cpu, tache->prog);
+        batch_task_finish(cpu, c->registres, &c->dispatchs, ds, c->ds_taille);
+    }
+    c->fin = maintenant() - debut_lot;
+}
+
+static void travailleur(const TacheLot *taches, TablePartagee *t, Part *part, const OptionsProcessus *options,
+                        double debut_lot) {
+    for (;;) {
+        int i = atomic_fetch_add(&part->prochaine, 1);
+        if (i >= part->fin) break;
+        CaseTable *c = &t->cases[i];
+        atomic_store(&c->etat, TACHE_EN_COURS);
+        if (options->preparer) options->preparer(i, options->contexte);
+        executer_tache(&taches[i], c, t->mots + c->ds_decalage, debut_lot);
+        atomic_store(&c->etat, TACHE_FINIE);
+    }
+}
+
+// Crée le travailleur d'une part ; retourne 0 si le processus est lancé
+static int lancer(const TacheLot *taches, TablePartagee *t, Part *part, const OptionsProcessus *options,
+                  double debut_lot) {
+    // Les tampons de stdio seraient sinon écrits deux fois
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        travailleur(taches, t, part, options, debut_lot);
+        _exit(EXIT_SUCCESS);
+    }
+    part->pid = pid;
+    return 0;
+}
+
+// -----------------------------------
+// Parent
+// -----------------------------------
+
+// Le travailleur de `part` est mort anormalement : la tâche prise et non finie est perdue
+static int solder_plantage(TablePartagee *t, Part *part) {
+    int perdues = 0;
+    int prises = atomic_load(&part->prochaine);
+    if (prises > part->fin) prises = part->fin;
+    for (int i = part->debut; i < prises; i++) {
+        if (atomic_load(&t->cases[i].etat) != TACHE_FINIE) {
+            atomic_store(&t->cases[i].etat, TACHE_FINIE);
+            t->cases[i].statut = LOT_PLANTAGE;
+            perdues++;
+        }
+    }
+    return perdues;
+}
+
+int batch_run_processes(const TacheLot *taches, int nb_taches, const OptionsProcessus *options, ResultatLot *resultats,
+                        BilanProcessus *bilan) {
+    if (!taches || !resultats || nb_taches < 0) {
+        fprintf(stderr, "batch_run_processes: paramètres invalides.\n");
+        return -1;
+    }
+    OptionsProcessus defaut = { 0, NULL, NULL };
+    if (!options) options = &defaut;
+
+    int nb_parts = options->nb_processus;
+    if (nb_parts <= 0) {
+        long coeurs = sysconf(_SC_NPROCESSORS_ONLN);
+        nb_parts = coeurs > 0 ? (int)coeurs : 1;
+    }
+    if (nb_parts > nb_taches) nb_parts = nb_taches > 0 ? nb_taches : 1;
+
+    TablePartagee t;
+    if (table_creer(&t, taches, nb_taches, nb_parts) != 0) {
+        fprintf(stderr, "batch_run_processes: table partagée impossible.\n");
+        return -1;
+    }
+
+    double debut = maintenant();
+    int vivants = 0, plantages = 0, relances = 0;
+    for (int p = 0; p < nb_parts; p++) {
+        if (lancer(taches, &t, &t.parts[p], options, debut) == 0) vivants++;
+    }
+
+    // Chaque travailleur est attendu par son pid : waitpid(-1) relèverait aussi les autres
+    // fils de l'appelant
+    while (vivants > 0) {
+        int releves = 0;
+        for (int p = 0; p < nb_parts; p++) {
+            Part *part = &t.parts[p];
+            int etat;
+            if (part->pid == 0) continue;
+            pid_t pid = waitpid(part->pid, &etat, WNOHANG);
+            if (pid == 0) continue;
+            part->pid = 0;
+            vivants--;
+            releves++;
+            // pid < 0 : état perdu (SIGCHLD ignoré) ; les tâches non finies restent en échec
+            if (pid < 0 || (WIFEXITED(etat) && WEXITSTATUS(etat) == EXIT_SUCCESS)) continue;
+
+            int perdues = solder_plantage(&t, part);
+            plantages += perdues;
+            // Un travailleur mort sans avoir pris de tâche ne ferait pas mieux une seconde fois
+            if (perdues > 0 && atomic_load(&part->prochaine) < part->fin &&
+                lancer(taches, &t, part, options, debut) == 0) {
+                vivants++;
+                relances++;
+            }
+        }
+        if (releves == 0) {
+            struct timespec pause = { 0, ATTENTE_NS };
+            nanosleep(&pause, NULL);
+        }
+    }
+    double duree = maintenant() - debut;
+
+    // Les cases sont lues directement ; seules les copies de DS sont allouées
+    memset(resultats, 0, sizeof(ResultatLot) * (size_t)nb_taches);
+    for (int i = 0; i < nb_taches; i++) {
+        const CaseTable *c = &t.cases[i];
+        ResultatLot *res = &resultats[i];
+        res->statut = atomic_load(&c->etat) == TACHE_FINIE ? c->statut : -1;
+        // Tâche perdue ou jamais commencée : sa case n'a pas été remplie
+        if (res->statut == LOT_PLANTAGE || atomic_load(&c->etat) == TACHE_LIBRE) continue;
+        memcpy(res->registres, c->registres, sizeof(res->registres));
+        res->dispatchs = c->dispatchs;
+        res->fin = c->fin;
+        res->ds = malloc(sizeof(int32_t) * (size_t)(c->ds_taille > 0 ? c->ds_taille : 1));
+        if (!res->ds) {
+            res->statut = -1;
+            continue;
+        }
+        res->ds_taille = c->ds_taille;
+        memcpy(res->ds, t.mots + c->ds_decalage, sizeof(int32_t) * (size_t)c->ds_taille);
+    }
+
+    if (bilan) {
+        memset(bilan, 0, sizeof(*bilan));
+        bilan->nb_processus = nb_parts;
+        bilan->nb_taches = nb_taches;
+        bilan->nb_plantages = plantages;
+        bilan->nb_relances = relances;
+        bilan->duree = duree;
+        for (int i = 0; i < nb_taches; i++) {
+            if (resultats[i].statut != 0) bilan->nb_echecs++;
+            bilan->dispatchs += resultats[i].dispatchs;
+        }
+        if (duree > 0) {
+            bilan->taches_par_seconde = nb_taches / duree;
+            bilan->dispatchs_par_seconde = bilan->dispatchs / duree;
+        }
+    }
+    munmap(t.zone, t.taille);
+    return 0;
+}
@@ -3,9 +3,25 @@
 #include <string.h>
 #include <assert.h>
 #include <stdint.h> 
+#include <unistd.h>
+#include <signal.h>
 
 
 #include "../include/CodeSegment.h"
+#include "../include/objet.h"
+#include "../include/interpreteur.h"
+#include "../include/assembleur.h"
+#include "../include/cache_programme.h"
+#include "../include/optimiseur.h"
+#include "../include/jit.h"
+#include "../include/transpileur.h"
+#include "../include/cache_blocs.h"
+#include "../include/vecteurs.h"
+#include "../include/lot.h"
+#include "../include/multicoeur.h"
+#include "../include/voies.h"
+#include "../include/lot_processus.h"
+#include "../include/programme_fige.h"
 
 
 
@@ -94,7 +110,2068 @@ static void test_run_program_existing(void) {
     printf("✅ test_run_program_existing passed\n\n");
 }
 
+// Chemin textuel complet (parse, DS, resolve_constants, CS, run_program) ; la mémoire garde
+// `marge` cases libres pour ES. Le résultat du parsing est rendu : CS pointe sur ses
+// instructions, il est libéré après le CPU.
+static CPU *executer_texte(const char *source, int marge, ParserResult **res) {
+    const char *chemin = "/tmp/test_chemin_textuel.txt";
+    FILE *f = fopen(chemin, "w");
+    assert(f);
+    fputs(source, f);
+    fclose(f);
 
+    *res = parse(chemin);
+    assert(*res);
+    remove(chemin);
+    CPU *cpu = cpu_init(get_compteur_value() + (*res)->code_count + marge + STACK_SIZE);
+    assert(cpu);
+    allocate_variables(cpu, (*res)->data_instructions, (*res)->data_count);
+    resolve_constants(*res);
+    allocate_code_segment(cpu, (*res)->code_instructions, (*res)->code_count);
+    run_program(cpu);
+    return cpu;
+}
+
+static void test_chemin_textuel(void) {
+    printf("=== test_chemin_textuel ===\n");
+
+    // Atomiques et barrière sous run_program : mêmes effets que le moteur décodé
+    const char *source =
+        ".DATA\n"
+        "a DW 5\n"
+        "b DW 0\n"
+        ".CODE\n"
+        "MOV AX, 7\n"
+        "XCHG [0], AX\n"
+        "MOV AX, 7\n"
+        "MOV BX, 9\n"
+        "CMPXCHG [0], BX\n"
+        "MOV CX, 3\n"
+        "XADD [1], CX\n"
+        "MFENCE\n";
+    ParserResult *res;
+    CPU *cpu = executer_texte(source, 0, &res);
+    assert(*cpu->registres[REG_IP] == res->code_count);
+    assert(cpu->memory_handler->mots[0] == 9 && cpu->memory_handler->mots[1] == 3);
+    assert(*cpu->registres[REG_AX] == 7 && *cpu->registres[REG_CX] == 0 && *cpu->registres[REG_ZF] == 1);
+    cpu_destroy(cpu);
+    free_parser_result(res);
+
+    // Instructions de bloc, dans DS et vers un ES alloué
+    source =
+        ".DATA\n"
+        "a DW 1,2,3,4\n"
+        "b DW 4 DUP(0)\n"
+        ".CODE\n"
+        "MOV CX, 4\n"
+        "MOVS [4], [0]\n"
+        "MOV CX, 2\n"
+        "STOS [6], 9\n"
+        "MOV AX, 4\n"
+        "MOV BX, 0\n"
+        "ALLOC\n"
+        "MOV CX, 4\n"
+        "MOVS [ES:BX], [DS:BX]\n"
+        "CMPS [4], [0]\n";
+    cpu = executer_texte(source, 4, &res);
+    assert(*cpu->registres[REG_IP] == res->code_count);
+    const int32_t *mots = cpu->memory_handler->mots;
+    const int attendu_b[4] = { 1, 2, 9, 9 };
+    for (int k = 0; k < 4; k++) assert(mots[4 + k] == attendu_b[k]);
+    int es = *cpu->registres[REG_ES];
+    for (int k = 0; k < 4; k++) assert(mots[es + k] == k + 1);
+    assert(*cpu->registres[REG_ZF] == 0 && *cpu->registres[REG_SF] == 0);   // 9 / 3
+    cpu_destroy(cpu);
+    free_parser_result(res);
+
+    // Instructions vectorielles : plage + plage, plage * valeur, somme dans un registre
+    source =
+        ".DATA\n"
+        "a DW 1,2,3,4\n"
+        "b DW 4 DUP(3)\n"
+        ".CODE\n"
+        "MOV CX, 4\n"
+        "VADD [0], [4]\n"
+        "VMUL [4], 2\n"
+        "VMUL [0], [4]\n"
+        "VSUM AX, [0]\n";
+    cpu = executer_texte(source, 0, &res);
+    assert(*cpu->registres[REG_IP] == res->code_count);
+    mots = cpu->memory_handler->mots;
+    const int attendu_a[4] = { 24, 30, 36, 42 };
+    for (int k = 0; k < 4; k++) assert(mots[k] == attendu_a[k] && mots[4 + k] == 6);
+    assert(*cpu->registres[REG_AX] == 132);
+    cpu_destroy(cpu);
+    free_parser_result(res);
+
+    printf("✅ test_chemin_textuel passed\n\n");
+}
+
+
+static void test_image_binaire(void) {
+    printf("=== test_image_binaire ===\n");
+
+    // 1) Assembler test.txt en image binaire
+    const char *image = "/tmp/test_cpu.img";
+    assert(assemble_file("test.txt", image) == 0 && "Échec de l'assemblage");
+
+    // 2) Projeter l'image : aucun parse ni resolve_constants
+    Programme *prog = map_image(image);
+    assert(prog && "Échec de map_image");
+    assert(prog->code_count == 26);
+    assert(prog->code[1].opcode == OPC_MOV);
+    assert(prog->code[1].dest.mode == MODE_REGISTRE && prog->code[1].dest.valeur == REG_BX);
+    assert(prog->code[1].src.mode == MODE_IMMEDIAT && prog->code[1].src.valeur == 6);
+
+    const Symbole *start = find_symbol(prog->labels, prog->label_count, "start");
+    const Symbole *x = find_symbol(prog->variables, prog->variable_count, "x");
+    assert(start && start->valeur == 16);
+    assert(x && x->valeur == 5 && program_data_at(prog, x->valeur) == 42);
+
+    // 3) Exécuter directement depuis l'image : même état final que run_program
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + 120 + 100);
+    assert(cpu && load_program(cpu, prog) == 0);
+    assert(run_decoded_program(cpu, prog) == 0);
+
+    assert(*cpu->registres[REG_AX] == 42);
+    assert(*cpu->registres[REG_BX] == 0);
+    assert(*cpu->registres[REG_IP] == prog->code_count);
+    printf("✅ Image : AX = %d, BX = %d, IP = %d\n",
+           *cpu->registres[REG_AX], *cpu->registres[REG_BX], *cpu->registres[REG_IP]);
+
+    cpu_destroy(cpu);
+    free_program(prog);
+    remove(image);
+
+    printf("✅ test_image_binaire passed\n\n");
+}
+
+static void test_resolution_symboles(void) {
+    printf("=== test_resolution_symboles ===\n");
+
+    // `x` est un préfixe de `xval` : la résolution ne doit jamais toucher aux sous-chaînes
+    const char *source = "/tmp/test_symboles.txt";
+    FILE *f = fopen(source, "w");
+    assert(f);
+    fprintf(f, ".DATA\nx DW 1\nxval DW 7\n.CODE\nMOV AX, xval\nMOV BX, [x]\nADD AX, BX\nJMP fin\nMOV AX, 0\nfin: MOV CX, 1\n");
+    fclose(f);
+
+    ParserResult *res = parse(source);
+    assert(res && res->code_count == 6);
+
+    // 1) Chemin textuel : resolve_constants
+    assert(resolve_constants(res) == 0);
+    assert(strcmp(res->code_instructions[0]->operand2, "[1]") == 0);
+    assert(strcmp(res->code_instructions[1]->operand2, "[0]") == 0);
+    assert(strcmp(res->code_instructions[3]->operand1, "5") == 0);
+    free_parser_result(res);
+
+    // 2) Décodage direct depuis le texte brut : symboles résolus pendant le décodage
+    res = parse(source);
+    Programme *prog = decode_program(res);
+    assert(prog);
+    assert(prog->code[0].src.mode == MODE_DIRECT && prog->code[0].src.valeur == 1);
+    assert(prog->code[3].dest.mode == MODE_IMMEDIAT && prog->code[3].dest.valeur == 5);
+
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, prog) == 0);
+    assert(run_decoded_program(cpu, prog) == 0);
+    assert(*cpu->registres[REG_AX] == 8);
+    printf("✅ AX = %d\n", *cpu->registres[REG_AX]);
+
+    cpu_destroy(cpu);
+    free_program(prog);
+    free_parser_result(res);
+    remove(source);
+
+    printf("✅ test_resolution_symboles passed\n\n");
+}
+
+static void test_assembleur_incremental(void) {
+    printf("=== test_assembleur_incremental ===\n");
+
+    // Sauts en avant, variable déclarée après .CODE, lignes coupées arbitrairement
+    const char *source =
+        ".CODE\n"
+        "MOV AX, [total]\n"
+        "JMP suite\n"
+        "MOV AX, 0\n"
+        "suite: ADD AX, pas\n"
+        "MOV BX, AX\r\n"
+        "JMP fin\n"
+        "MOV BX, 0\n"
+        "fin: MOV CX, 3\n"
+        ".DATA\n"
+        "pas DW 5\n"
+        "total DW 37";   // pas de '\n' final
+
+    Assembleur *as = assembler_create();
+    assert(as);
+    size_t taille = strlen(source);
+    for (size_t i = 0; i < taille; i += 7) {
+        size_t n = taille - i < 7 ? taille - i : 7;
+        assert(assembler_feed(as, source + i, n) == 0);
+    }
+    Programme *prog = assembler_finish(as);
+    assert(prog && prog->code_count == 8 && prog->data_size == 2);
+    assert(prog->code[1].dest.mode == MODE_IMMEDIAT && prog->code[1].dest.valeur == 3);
+    assert(prog->code[0].src.mode == MODE_DIRECT && prog->code[0].src.valeur == 1);
+
+    // Exécution directe, sans fichier temporaire
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, prog) == 0);
+    assert(run_decoded_program(cpu, prog) == 0);
+    // AX = [total] + pas (variable nue en second opérande -> contenu de la case)
+    assert(*cpu->registres[REG_AX] == 42);
+    assert(*cpu->registres[REG_BX] == 42 && *cpu->registres[REG_CX] == 3);
+    printf("✅ AX = %d, BX = %d, CX = %d\n",
+           *cpu->registres[REG_AX], *cpu->registres[REG_BX], *cpu->registres[REG_CX]);
+    cpu_destroy(cpu);
+    free_program(prog);
+
+    // Un symbole jamais défini fait échouer l'assemblage
+    const char *faux = ".CODE\nJMP nulle_part\n";
+    assert(assemble_buffer(faux, strlen(faux)) == NULL);
+
+    printf("✅ test_assembleur_incremental passed\n\n");
+}
+
+static void test_cache_programmes(void) {
+    printf("=== test_cache_programmes ===\n");
+
+    const char *repertoire = "/tmp/cache_cpu_test";
+    const char *source = ".DATA\nx DW 40\n.CODE\nMOV AX, [x]\nADD AX, 2\n";
+    const char *modifie = ".DATA\nx DW 10\n.CODE\nMOV AX, [x]\nADD AX, 2\n";
+    char chemin[256];
+    snprintf(chemin, sizeof(chemin), "%s/%016llx-v%u.img", repertoire,
+             (unsigned long long)hash_source(source, strlen(source)), IMAGE_VERSION);
+    remove(chemin);
+
+    // Premier chargement : assemblage ; second : LRU
+    CacheProgrammes *cache = program_cache_create(repertoire, 1);
+    assert(cache);
+    const Programme *p1 = program_cache_load_buffer(cache, source, strlen(source));
+    assert(p1 && cache->misses == 1);
+    const Programme *p2 = program_cache_load_buffer(cache, source, strlen(source));
+    assert(p2 == p1 && cache->hits_memoire == 1);
+
+    // Un autre source évince le premier (capacité 1)
+    assert(program_cache_load_buffer(cache, modifie, strlen(modifie)));
+    assert(cache->misses == 2 && cache->evictions == 1);
+    program_cache_destroy(cache);
+
+    // Nouveau cache sur le même répertoire : l'image est relue sans assemblage
+    cache = program_cache_create(repertoire, 4);
+    const Programme *p3 = program_cache_load_buffer(cache, source, strlen(source));
+    assert(p3 && cache->hits_disque == 1 && cache->misses == 0);
+    assert(p3->source_hash == hash_source(source, strlen(source)));
+
+    CPU *cpu = cpu_init(p3->data_size + p3->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, p3) == 0);
+    assert(run_decoded_program(cpu, p3) == 0);
+    assert(*cpu->registres[REG_AX] == 42);
+    printf("✅ AX = %d (hits mémoire %ld, disque %ld, échecs %ld)\n",
+           *cpu->registres[REG_AX], cache->hits_memoire, cache->hits_disque, cache->misses);
+    cpu_destroy(cpu);
+
+    // Collision simulée : l'entrée a la même empreinte mais un autre texte, elle n'est pas
+    // rendue ; le source est réassemblé
+    cache->tete->source[0] = '#';
+    const Programme *p4 = program_cache_load_buffer(cache, source, strlen(source));
+    assert(p4 && cache->hits_memoire == 0 && cache->misses == 1 && cache->nb_entrees == 1);
+    assert(program_cache_load_buffer(cache, source, strlen(source)) == p4 && cache->hits_memoire == 1);
+    program_cache_destroy(cache);
+
+    remove(chemin);
+    snprintf(chemin, sizeof(chemin), "%s/%016llx-v%u.img", repertoire,
+             (unsigned long long)hash_source(modifie, strlen(modifie)), IMAGE_VERSION);
+    remove(chemin);
+    rmdir(repertoire);
+
+    printf("✅ test_cache_programmes passed\n\n");
+}
+
+static void test_constantes_dup(void) {
+    printf("=== test_constantes_dup ===\n");
+
+    // Expressions calculées une fois à l'assemblage, tampon de 64K cases en une seule plage
+    const char *source =
+        ".DATA\n"
+        "SIZE EQU 65536\n"
+        "PAS EQU (SIZE/1024) - 60\n"
+        "tete DW SIZE*2+1, PAS, 'A'\n"
+        "tampon DW SIZE DUP(0)\n"
+        "marque DW 3 DUP(PAS*10), ?\n"
+        ".CODE\n"
+        "MOV AX, [tete]\n"
+        "ADD AX, PAS*2\n"
+        "MOV BX, [SIZE+5]\n"
+        "MOV CX, [marque]\n";
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+    assert(prog->data_size == 3 + 65536 + 4);
+    assert(prog->plage_count == 4 && prog->valeur_count == 4);  // littéraux, 0 DUP, 40 DUP, ?
+    assert(program_data_at(prog, 0) == 131073 && program_data_at(prog, 1) == 4);
+    assert(program_data_at(prog, 2) == 'A' && program_data_at(prog, 3 + 65535) == 0);
+    assert(program_data_at(prog, 3 + 65536 + 2) == 40 && program_data_at(prog, 3 + 65536 + 3) == 0);
+
+    const Symbole *marque = find_symbol(prog->variables, prog->variable_count, "marque");
+    assert(marque && marque->valeur == 3 + 65536);
+    assert(find_symbol(prog->variables, prog->variable_count, "SIZE") == NULL);
+    assert(prog->code[1].src.mode == MODE_IMMEDIAT && prog->code[1].src.valeur == 8);
+    assert(prog->code[2].src.mode == MODE_DIRECT && prog->code[2].src.valeur == 65541);
+
+    // Le chargement développe les plages directement dans les mots de DS
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, prog) == 0);
+    assert(run_decoded_program(cpu, prog) == 0);
+    assert(*cpu->registres[REG_AX] == 131081);
+    assert(*cpu->registres[REG_BX] == 40 && *cpu->registres[REG_CX] == 40);
+    printf("✅ AX = %d, BX = %d, CX = %d, %d plages pour %d cases\n", *cpu->registres[REG_AX],
+           *cpu->registres[REG_BX], *cpu->registres[REG_CX], prog->plage_count, prog->data_size);
+    cpu_destroy(cpu);
+
+    // L'image garde la forme compacte
+    const char *image = "/tmp/test_cpu_dup.img";
+    assert(write_image(prog, image) == 0);
+    Programme *projete = map_image(image);
+    assert(projete && projete->plage_count == prog->plage_count);
+    assert(program_data_at(projete, 3 + 65536) == 40);
+    free_program(projete);
+    remove(image);
+    free_program(prog);
+
+    // Constante inconnue ou division par zéro : assemblage refusé
+    const char *faux = ".DATA\nt DW INCONNU DUP(0)\n";
+    assert(assemble_buffer(faux, strlen(faux)) == NULL);
+    faux = ".DATA\nN EQU 4/0\n";
+    assert(assemble_buffer(faux, strlen(faux)) == NULL);
+
+    // Liste entre apostrophes (forme historique) : les apostrophes sont ignorées
+    const char *quotes = ".DATA\nX vb '12,8,9'\nY vb 'B'\n.CODE\nMOV AX, [X]\n";
+    prog = assemble_buffer(quotes, strlen(quotes));
+    assert(prog && prog->data_size == 4);
+    cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, prog) == 0 && run_decoded_program(cpu, prog) == 0);
+    const int attendus[3] = { 12, 8, 9 };
+    for (int i = 0; i < 3; i++) assert(*(int *)cpu->memory_handler->memory[i] == attendus[i]);
+    assert(*(int *)cpu->memory_handler->memory[3] == 'B' && *cpu->registres[REG_AX] == 12);
+    cpu_destroy(cpu);
+    free_program(prog);
+
+    printf("✅ test_constantes_dup passed\n\n");
+}
+
+// Exécute `prog` sur un CPU neuf ; retourne le CPU (à détruire par l'appelant)
+static CPU *executer_programme(const Programme *prog) {
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, prog) == 0);
+    assert(run_decoded_program(cpu, prog) == 0);
+    return cpu;
+}
+
+static void test_superinstructions(void) {
+    printf("=== test_superinstructions ===\n");
+
+    const char *source =
+        ".DATA\n"
+        "n DW 5\n"
+        ".CODE\n"
+        "MOV CX, [n]\n"
+        "boucle: MOV AX, CX\n"
+        "ADD AX, 10\n"
+        "PUSH AX\n"
+        "POP BX\n"
+        "ADD DX, BX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n"
+        "MOV AX, 100\n"
+        "milieu: ADD AX, 1\n"     // cible au milieu d'une paire MOV + ADD
+        "CMP AX, 103\n"
+        "JZ fin\n"
+        "JMP milieu\n"
+        "fin: MOV CX, 7\n";
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+    CPU *reference = executer_programme(prog);
+
+    assert(fuse_superinstructions(prog) == 5);
+    assert(prog->code[1].opcode == OPC_MOV_ADD && prog->code[2].opcode == OPC_ADD);
+    assert(prog->code[3].opcode == OPC_PUSH_POP && prog->code[7].opcode == OPC_CMP_JNZ);
+    assert(prog->code[9].opcode == OPC_MOV_ADD && prog->code[11].opcode == OPC_CMP_JZ);
+    CPU *fusionne = executer_programme(prog);
+
+    // Même état final, moins de dispatchs
+    for (int r = 0; r < NB_REGISTRES; r++) {
+        assert(*reference->registres[r] == *fusionne->registres[r]);
+    }
+    assert(*fusionne->registres[REG_AX] == 103 && *fusionne->registres[REG_DX] == 65);
+    assert(*fusionne->registres[REG_BX] == 11 && *fusionne->registres[REG_CX] == 7);
+    assert(fusionne->dispatchs < reference->dispatchs);
+    printf("✅ dispatchs : %ld sans fusion, %ld avec\n", reference->dispatchs, fusionne->dispatchs);
+    cpu_destroy(reference);
+    cpu_destroy(fusionne);
+
+    // Une image garde les superinstructions ; une paire incohérente est refusée
+    const char *image = "/tmp/test_cpu_super.img";
+    assert(write_image(prog, image) == 0);
+    Programme *projete = map_image(image);
+    assert(projete && projete->code[7].opcode == OPC_CMP_JNZ);
+    free_program(projete);
+
+    InstructionDecodee *code = (InstructionDecodee *)prog->code;
+    code[2].opcode = OPC_MOV;
+    assert(write_image(prog, image) == 0);
+    assert(map_image(image) == NULL);
+    remove(image);
+    free_program(prog);
+
+    printf("✅ test_superinstructions passed\n\n");
+}
+
+static CPU *executer_moteur(const Programme *prog, MoteurExecution moteur) {
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, prog) == 0);
+    assert(run_program_engine(cpu, prog, moteur) == 0);
+    return cpu;
+}
+
+static void test_jit(void) {
+    printf("=== test_jit ===\n");
+
+    const char *source =
+        ".DATA\n"
+        "n DW 6\n"
+        "somme DW 0\n"
+        ".CODE\n"
+        "MOV CX, [n]\n"
+        "boucle: MOV AX, CX\n"
+        "ADD AX, 10\n"
+        "PUSH AX\n"               // pile : exécutée par l'interpréteur
+        "POP BX\n"
+        "ADD DX, BX\n"
+        "ADD [1], CX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n"
+        "MOV AX, [1]\n"
+        "MOV BX, [5000]\n"        // hors mémoire : sans effet
+        "CMP AX, n\n"
+        "JZ fin\n"
+        "MOV BX, 500\n"
+        "ADD [BX], 1\n"           // [BX] désigne BX
+        "MOV [0], BX\n"
+        "fin: MOV CX, 7\n";
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+
+    for (int passe = 0; passe < 2; passe++) {
+        if (passe == 1) assert(fuse_superinstructions(prog) > 0);
+
+        CPU *reference = executer_moteur(prog, MOTEUR_INTERPRETEUR);
+        CPU *natif = executer_moteur(prog, MOTEUR_JIT);
+        for (int r = 0; r < NB_REGISTRES; r++) {
+            assert(*reference->registres[r] == *natif->registres[r]);
+        }
+        for (int i = 0; i < prog->data_size; i++) {
+            assert(*(int *)reference->memory_handler->memory[i] == *(int *)natif->memory_handler->memory[i]);
+        }
+        assert(*natif->registres[REG_AX] == 21 && *natif->registres[REG_BX] == 501);
+        assert(*natif->registres[REG_DX] == 81 && *(int *)natif->memory_handler->memory[0] == 501);
+
+        JitCode *jit = jit_compile(prog);
+        if (jit) {
+            // Seules les instructions de pile passent par l'interpréteur
+            assert(jit->nb_compilees == prog->code_count - 2 && jit->nb_blocs > 0);
+            assert(natif->dispatchs > 0 && natif->dispatchs < reference->dispatchs);
+            printf("✅ passe %d : %d blocs, %ld dispatchs contre %ld\n",
+                   passe, jit->nb_blocs, natif->dispatchs, reference->dispatchs);
+        } else {
+            printf("✅ passe %d : pas de JIT sur cette plateforme, interpréteur utilisé\n", passe);
+        }
+        jit_free(jit);
+        cpu_destroy(reference);
+        cpu_destroy(natif);
+    }
+    free_program(prog);
+
+    printf("✅ test_jit passed\n\n");
+}
+
+// État final au format de run_program, capturé dans une chaîne (à libérer)
+static char *capturer_etat_final(CPU *cpu) {
+    FILE *f = tmpfile();
+    assert(f);
+    fflush(stdout);
+    int sauvegarde = dup(STDOUT_FILENO);
+    dup2(fileno(f), STDOUT_FILENO);
+    printf("\n=== État final du CPU ===\n\n");
+    print_data_segment(cpu);
+    print_registers(cpu);
+    fflush(stdout);
+    dup2(sauvegarde, STDOUT_FILENO);
+    close(sauvegarde);
+
+    long taille = ftell(f);
+    char *texte = calloc(taille + 1, 1);
+    rewind(f);
+    assert(texte && fread(texte, 1, taille, f) == (size_t)taille);
+    fclose(f);
+    return texte;
+}
+
+// Traduit, compile avec cc -O2 et exécute ; retourne la sortie du binaire (à libérer)
+static char *executer_traduction(const Programme *prog, int memory_size) {
+    const char *source = "/tmp/test_cpu_aot.c";
+    FILE *f = fopen(source, "w");
+    assert(f && transpile_program(prog, memory_size, f) == 0);
+    fclose(f);
+    assert(system("cc -O2 -Wall -Werror -o /tmp/test_cpu_aot /tmp/test_cpu_aot.c") == 0);
+
+    FILE *p = popen("/tmp/test_cpu_aot", "r");
+    assert(p);
+    size_t capacite = 4096, longueur = 0, n;
+    char *texte = malloc(capacite);
+    assert(texte);
+    while ((n = fread(texte + longueur, 1, capacite - longueur - 1, p)) > 0) {
+        longueur += n;
+        if (longueur + 1 == capacite) {
+            capacite *= 2;
+            texte = realloc(texte, capacite);
+            assert(texte);
+        }
+    }
+    texte[longueur] = '\0';
+    assert(pclose(p) == 0);
+    remove(source);
+    remove("/tmp/test_cpu_aot");
+    return texte;
+}
+
+static void test_transpileur(void) {
+    printf("=== test_transpileur ===\n");
+    if (system("cc --version > /dev/null 2>&1") != 0) {
+        printf("✅ pas de compilateur C : test ignoré\n");
+        printf("✅ test_transpileur passed\n\n");
+        return;
+    }
+
+    // 1) test.txt : adressages, pile, ALLOC/FREE et [ES:BX]
+    ParserResult *res = parse("test.txt");
+    assert(res);
+    Programme *prog = decode_program(res);
+    assert(prog);
+    int taille = prog->data_size + prog->code_count + STACK_SIZE + 100;
+
+    CPU *cpu = cpu_init(taille);
+    assert(cpu && load_program(cpu, prog) == 0);
+    assert(run_decoded_program(cpu, prog) == 0);
+    char *attendu = capturer_etat_final(cpu);
+    char *obtenu = executer_traduction(prog, taille);
+    assert(strcmp(attendu, obtenu) == 0);
+    free(attendu);
+    free(obtenu);
+    cpu_destroy(cpu);
+    free_program(prog);
+    free_parser_result(res);
+    printf("✅ test.txt : même état final que l'interpréteur\n");
+
+    // 2) Boucle avec superinstructions, saut calculé et lecture de IP
+    const char *source =
+        ".DATA\n"
+        "n DW 5\n"
+        "t DW 3 DUP(7)\n"
+        ".CODE\n"
+        "MOV CX, [n]\n"
+        "boucle: MOV AX, CX\n"
+        "ADD AX, 10\n"
+        "PUSH AX\n"
+        "POP BX\n"
+        "ADD DX, BX\n"
+        "ADD [2], CX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n"
+        "MOV BX, [IP]\n"          // IP = indice de l'instruction suivante
+        "MOV AX, 14\n"           // indice de suite
+        "JMP AX\n"
+        "MOV DX, 0\n"
+        "suite: MOV [3], BX\n"
+        "JMP 99\n"              // sortie par un saut hors du code
+        "MOV CX, 99\n";
+    prog = assemble_buffer(source, strlen(source));
+    assert(prog && fuse_superinstructions(prog) > 0);
+    taille = prog->data_size + prog->code_count + STACK_SIZE;
+
+    cpu = cpu_init(taille);
+    assert(cpu && load_program(cpu, prog) == 0);
+    assert(run_decoded_program(cpu, prog) == 0);
+    assert(*cpu->registres[REG_IP] == 99 && *cpu->registres[REG_BX] == 11);
+    attendu = capturer_etat_final(cpu);
+    obtenu = executer_traduction(prog, taille);
+    assert(strcmp(attendu, obtenu) == 0);
+    free(attendu);
+    free(obtenu);
+    cpu_destroy(cpu);
+    free_program(prog);
+    printf("✅ boucle : même état final que l'interpréteur\n");
+
+    printf("✅ test_transpileur passed\n\n");
+}
+
+static void test_cache_blocs(void) {
+    printf("=== test_cache_blocs ===\n");
+
+    const char *source =
+        ".DATA\n"
+        "n DW 5\n"
+        ".CODE\n"
+        "MOV CX, [n]\n"
+        "boucle: MOV AX, CX\n"
+        "ADD AX, 10\n"
+        "PUSH AX\n"
+        "POP BX\n"
+        "ADD DX, BX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n"
+        "MOV AX, 100\n"
+        "milieu: ADD AX, 1\n"
+        "CMP AX, 103\n"
+        "JZ fin\n"
+        "JMP milieu\n"
+        "fin: MOV CX, 7\n";
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+
+    for (int passe = 0; passe < 2; passe++) {
+        if (passe == 1) assert(fuse_superinstructions(prog) == 5);
+
+        CPU *reference = executer_programme(prog);
+        CacheBlocs *cache = block_cache_create(prog);
+        assert(cache);
+
+        // Deux exécutions avec le même cache : la seconde ne construit aucun bloc
+        for (int essai = 0; essai < 2; essai++) {
+            CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+            assert(cpu && load_program(cpu, prog) == 0);
+            int32_t blocs = cache->nb_blocs;
+            assert(run_block_cache(cpu, cache) == 0);
+            for (int r = 0; r < NB_REGISTRES; r++) {
+                assert(*reference->registres[r] == *cpu->registres[r]);
+            }
+            assert(cpu->dispatchs == reference->dispatchs);
+            if (essai == 1) assert(cache->nb_blocs == blocs);
+            cpu_destroy(cpu);
+        }
+
+        // Blocs : [0..8], [1..8] (entrée par le saut), [9..12], [13], [10..12] (entrée au milieu), [14]
+        assert(cache->nb_blocs == 6);
+        assert(cache->par_ip[1]->longueur == 8 && cache->par_ip[1]->ip_cible == 1);
+        assert(cache->par_ip[1]->pris == cache->par_ip[1]);
+        assert(cache->chainages > cache->recherches);
+        printf("✅ passe %d : %d blocs, %ld chaînages, %ld recherches\n",
+               passe, cache->nb_blocs, cache->chainages, cache->recherches);
+        block_cache_destroy(cache);
+        cpu_destroy(reference);
+    }
+    free_program(prog);
+
+    printf("✅ test_cache_blocs passed\n\n");
+}
+
+static void test_traces(void) {
+    printf("=== test_traces ===\n");
+
+    // Boucle « tant que » : le JMP de retour disparaît de la trace, les deux JZ deviennent
+    // des gardes ; la seconde n'échoue qu'au dernier tour, la première à la sortie
+    const char *source =
+        ".DATA\n"
+        "n DW 50\n"
+        ".CODE\n"
+        "MOV CX, [n]\n"
+        "boucle: CMP CX, 0\n"
+        "JZ fin\n"
+        "MOV AX, CX\n"
+        "ADD AX, 3\n"
+        "ADD DX, AX\n"
+        "CMP AX, 4\n"
+        "JZ saut\n"
+        "ADD BX, 1\n"
+        "saut: PUSH CX\n"
+        "POP AX\n"
+        "ADD CX, -1\n"
+        "JMP boucle\n"
+        "fin: MOV AX, 7\n";
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+
+    for (int passe = 0; passe < 2; passe++) {
+        if (passe == 1) assert(fuse_superinstructions(prog) > 0);
+
+        CPU *reference = executer_programme(prog);
+        CacheBlocs *cache = block_cache_create(prog);
+        assert(cache);
+        block_cache_enable_traces(cache, 5);
+
+        CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+        assert(cpu && load_program(cpu, prog) == 0);
+        assert(run_block_cache(cpu, cache) == 0);
+        for (int r = 0; r < NB_REGISTRES; r++) {
+            assert(*reference->registres[r] == *cpu->registres[r]);
+        }
+        assert(*cpu->registres[REG_BX] == 49 && *cpu->registres[REG_AX] == 7);
+
+        // Une trace sur l'entête de boucle, quittée par chacune des deux gardes
+        assert(cache->nb_traces == 1 && cache->par_ip[1]->trace);
+        Trace *trace = cache->par_ip[1]->trace;
+        assert(trace->executions == 2 && trace->sorties == 2);
+        assert(cpu->dispatchs < reference->dispatchs);
+        printf("✅ passe %d : trace de %d opérations, %ld dispatchs contre %ld\n",
+               passe, trace->nb_ops, cpu->dispatchs, reference->dispatchs);
+
+        cpu_destroy(cpu);
+        cpu_destroy(reference);
+        block_cache_destroy(cache);
+    }
+    free_program(prog);
+
+    printf("✅ test_traces passed\n\n");
+}
+
+static void test_drapeaux(void) {
+    printf("=== test_drapeaux ===\n");
+
+    // API : ZF et SF sont écrits dans les registres par la comparaison
+    CPU *cpu = cpu_init(256);
+    assert(cpu);
+    cpu_set_flags_cmp(cpu, 2, 7);
+    assert(*cpu->registres[REG_ZF] == 0 && *cpu->registres[REG_SF] == 1);
+    cpu_set_flags_cmp(cpu, 4, 4);
+    assert(*cpu->registres[REG_ZF] == 1 && *cpu->registres[REG_SF] == 0);
+    cpu_set_flags_cmp(cpu, -2147483647 - 1, 1);   // différence modulo 2^32 : positive
+    assert(*cpu->registres[REG_SF] == 0 && *cpu->registres[REG_ZF] == 0);
+    cpu_destroy(cpu);
+
+    // Comparaisons écrasées avant d'être lues, lecture de [ZF] / [SF] par un opérande,
+    // écriture de [ZF] après un CMP
+    const char *source =
+        ".CODE\n"
+        "MOV AX, 3\n"
+        "CMP AX, 3\n"
+        "CMP AX, 5\n"
+        "JZ 99\n"
+        "MOV BX, [SF]\n"
+        "CMP AX, 3\n"
+        "MOV [ZF], 0\n"
+        "JZ 99\n"
+        "CMP AX, 2\n"
+        "MOV DX, 8\n"
+        "CMP CX, 0\n"
+        "JNZ 99\n"
+        "MOV CX, 1\n";
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+    for (int passe = 0; passe < 2; passe++) {
+        if (passe == 1) assert(fuse_superinstructions(prog) > 0);
+        cpu = executer_programme(prog);
+        assert(*cpu->registres[REG_IP] == prog->code_count);
+        assert(*cpu->registres[REG_BX] == 1 && *cpu->registres[REG_CX] == 1);
+
+        // Fin de programme : drapeaux du dernier CMP (CX = 0)
+        assert(*cpu->registres[REG_ZF] == 1 && *cpu->registres[REG_SF] == 0);
+        cpu_destroy(cpu);
+    }
+    free_program(prog);
+
+    printf("✅ test_drapeaux passed\n\n");
+}
+
+static void test_constantes_immediates(void) {
+    printf("=== test_constantes_immediates ===\n");
+
+    CPU *cpu = cpu_init(256);
+    assert(cpu);
+
+    // Une case par valeur, partagée et stable
+    int *cinq = immediate_adressing(cpu, "5");
+    assert(cinq && *cinq == 5 && immediate_adressing(cpu, "5") == cinq);
+    int *moins = immediate_adressing(cpu, "-7");
+    assert(moins && *moins == -7);
+    assert(!immediate_adressing(cpu, "+3") && !immediate_adressing(cpu, "4a"));
+    assert(!immediate_adressing(cpu, "-") && !immediate_adressing(cpu, "AX"));
+
+    // Beaucoup de littéraux distincts : les cases déjà données ne bougent pas
+    for (int v = 1000; v > -1000; v--) {
+        char texte[16];
+        snprintf(texte, sizeof(texte), "%d", v * 3);
+        int *c = immediate_adressing(cpu, texte);
+        assert(c && *c == v * 3);
+    }
+    assert(immediate_adressing(cpu, "5") == cinq && *cinq == 5);
+    assert(cpu->constant_pool->count == 2002);
+    assert(constant_table_contains(cpu->constant_pool, cinq));
+    assert(!constant_table_contains(cpu->constant_pool, cpu->registres[REG_AX]));
+
+    // MOV 5, AX n'écrit pas dans la constante ; MOV AX, 5 lit la même case
+    char mov[] = "MOV", cinq_texte[] = "5", ax[] = "AX";
+    Instruction ecrire_constante = { mov, cinq_texte, ax };
+    Instruction lire_constante = { mov, ax, cinq_texte };
+    *cpu->registres[REG_AX] = 9;
+    assert(handle_instruction(cpu, &ecrire_constante, NULL, NULL) == 0);
+    assert(*cinq == 5);
+    assert(handle_instruction(cpu, &lire_constante, NULL, NULL) == 0);
+    assert(*cpu->registres[REG_AX] == 5);
+
+    cpu_destroy(cpu);
+    printf("✅ test_constantes_immediates passed\n\n");
+}
+
+static void test_pile_contigue(void) {
+    printf("=== test_pile_contigue ===\n");
+
+    // Les cases de la pile sont les mots contigus du MemoryHandler : pas d'allocation
+    CPU *cpu = cpu_init(256);
+    assert(cpu);
+    MemoryHandler *m = cpu->memory_handler;
+    int *sp = cpu->registres[REG_SP];
+    for (int k = 0; k < 4; k++) *cpu->registres[REG_AX + k] = k + 1;
+
+    assert(push_value(cpu, 7) == 0 && *sp == 255);
+    assert(m->memory[255] == &m->mots[255] && m->mots[255] == 7);
+    assert(push_all_registers(cpu) == 0 && *sp == 251);
+    assert(m->mots[254] == 1 && m->mots[253] == 2 && m->mots[252] == 3 && m->mots[251] == 4);
+
+    for (int k = 0; k < 4; k++) *cpu->registres[REG_AX + k] = 0;
+    assert(pop_all_registers(cpu) == 0 && *sp == 255);
+    for (int k = 0; k < 4; k++) assert(*cpu->registres[REG_AX + k] == k + 1);
+    assert(m->memory[251] == NULL && m->memory[254] == NULL);
+
+    // Une seule valeur sur la pile : POPA ne touche à rien
+    assert(pop_all_registers(cpu) == -1 && *sp == 255 && *cpu->registres[REG_DX] == 4);
+    int v;
+    assert(pop_value(cpu, &v) == 0 && v == 7 && *sp == 256 && m->memory[255] == NULL);
+    assert(pop_value(cpu, &v) == -1);
+
+    // Moins de quatre places : PUSHA n'empile rien
+    *sp = cpu->pile_debut + 3;
+    assert(push_all_registers(cpu) == -1 && *sp == cpu->pile_debut + 3);
+    assert(push_value(cpu, 1) == 0);
+
+    // SP écrit par le programme sous SS : POP / POPA échouent sans lire ni vider la case
+    int dessous = cpu->pile_debut - 4;
+    for (int k = 0; k < 4; k++) {
+        m->mots[dessous + k] = 50 + k;
+        m->memory[dessous + k] = &m->mots[dessous + k];
+    }
+    *sp = dessous;
+    v = 0;
+    assert(pop_value(cpu, &v) == -1 && v == 0 && *sp == dessous);
+    assert(pop_all_registers(cpu) == -1 && *sp == dessous);
+    for (int k = 0; k < 4; k++) assert(m->memory[dessous + k] == &m->mots[dessous + k]);
+    for (int k = 0; k < 4; k++) m->memory[dessous + k] = NULL;
+    cpu_destroy(cpu);
+
+    // Même chose depuis un programme : MOV [SP] place SP dans DS
+    const char *sous_pile =
+        ".DATA\n"
+        "x DW 77\n"
+        ".CODE\n"
+        "MOV [SP], 0\n"
+        "POP BX\n"
+        "POPA\n";
+    Programme *prog = assemble_buffer(sous_pile, strlen(sous_pile));
+    assert(prog);
+    cpu = executer_programme(prog);
+    assert(*cpu->registres[REG_BX] == 0 && *cpu->registres[REG_SP] == 0);
+    assert(cpu->memory_handler->memory[0] && *(int *)cpu->memory_handler->memory[0] == 77);
+    cpu_destroy(cpu);
+    free_program(prog);
+
+    // Programme : PUSHA/POPA autour d'un PUSH/POP, puis pile remplie par PUSHA en boucle
+    const char *source =
+        ".CODE\n"
+        "MOV AX, 1\n"
+        "MOV BX, 2\n"
+        "MOV CX, 3\n"
+        "MOV DX, 4\n"
+        "PUSHA\n"
+        "MOV AX, 9\n"
+        "MOV DX, 9\n"
+        "PUSH AX\n"
+        "POP CX\n"
+        "ADD BX, CX\n"
+        "POPA\n"
+        "POPA\n"
+        "MOV CX, 40\n"
+        "boucle: ADD CX, -1\n"
+        "PUSHA\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n";
+
+    prog = assemble_buffer(source, strlen(source));
+    assert(prog && prog->code[4].opcode == OPC_PUSHA && prog->code[10].opcode == OPC_POPA);
+    cpu = executer_programme(prog);
+    assert(*cpu->registres[REG_AX] == 1 && *cpu->registres[REG_BX] == 2 && *cpu->registres[REG_DX] == 4);
+    assert(*cpu->registres[REG_SP] == cpu->pile_debut);   // 32 PUSHA sur 40 tiennent dans SS
+
+    if (system("cc --version > /dev/null 2>&1") == 0) {
+        char *attendu = capturer_etat_final(cpu);
+        char *obtenu = executer_traduction(prog, prog->data_size + prog->code_count + STACK_SIZE);
+        assert(strcmp(attendu, obtenu) == 0);
+        free(attendu);
+        free(obtenu);
+        printf("✅ traduction en C : même état final\n");
+    }
+    cpu_destroy(cpu);
+    free_program(prog);
+
+    printf("✅ test_pile_contigue passed\n\n");
+}
+
+static void test_blocs_memoire(void) {
+    printf("=== test_blocs_memoire ===\n");
+
+    // a = [0..4], b = [5..9] ; ES alloué après DS + CS
+    const char *source =
+        ".DATA\n"
+        "a DW 1,2,3,4,5\n"
+        "b DW 5 DUP(0)\n"
+        ".CODE\n"
+        "MOV CX, 5\n"
+        "MOVS [5], [0]\n"
+        "CMPS [5], [0]\n"
+        "JNZ 99\n"
+        "MOV CX, 3\n"
+        "STOS [6], 9\n"
+        "MOV CX, 5\n"
+        "CMPS [0], [5]\n"
+        "MOV DX, [SF]\n"
+        "MOV AX, 4\n"
+        "MOV BX, 0\n"
+        "ALLOC\n"
+        "MOV CX, 4\n"
+        "MOVS [ES:BX], [DS:BX]\n"
+        "MOV CX, 10\n"
+        "STOS [ES:BX], 7\n"
+        "MOV CX, 2\n"
+        "MOV AX, 2\n"
+        "STOS [ES:AX], -1\n"
+        "MOVS [7], [ES:AX]\n"
+        "MOV CX, 4\n"
+        "MOVS [1], [0]\n"
+        "MOV CX, 3\n"
+        "CMPS [ES:BX], [0]\n";
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+    // Place libre pour ES entre CS et la pile
+    int taille = prog->data_size + prog->code_count + 8 + STACK_SIZE;
+    CPU *cpu = cpu_init(taille);
+    assert(cpu && load_program(cpu, prog) == 0);
+    assert(run_decoded_program(cpu, prog) == 0);
+    MemoryHandler *m = cpu->memory_handler;
+
+    // Copie avec recouvrement (memmove), remplissage, ES hors bornes sans effet
+    const int attendu[10] = { 1, 1, 2, 3, 4, 1, 9, -1, -1, 5 };
+    for (int k = 0; k < 10; k++) assert(*(int *)m->memory[k] == attendu[k]);
+    int es = *cpu->registres[REG_ES];
+    assert(es == prog->data_size + prog->code_count);
+    assert(m->mots[es] == 1 && m->mots[es + 1] == 2 && m->mots[es + 2] == -1 && m->mots[es + 3] == -1);
+    assert(*cpu->registres[REG_IP] == prog->code_count);
+    assert(*cpu->registres[REG_DX] == 1);   // SF du CMPS 2 / 9
+    assert(*cpu->registres[REG_ZF] == 0 && *cpu->registres[REG_SF] == 0);   // 2 / 1
+
+    if (system("cc --version > /dev/null 2>&1") == 0) {
+        char *etat = capturer_etat_final(cpu);
+        char *obtenu = executer_traduction(prog, taille);
+        assert(strcmp(etat, obtenu) == 0);
+        free(etat);
+        free(obtenu);
+        printf("✅ traduction en C : même état final\n");
+    }
+
+    // Une case vide dans la plage : STOS ne touche à rien
+    memory_release_cell(m, 9);
+    InstructionDecodee stos = { OPC_STOS, { MODE_DIRECT, 5, 0 }, { MODE_IMMEDIAT, 0, 0 } };
+    *cpu->registres[REG_CX] = 5;
+    assert(execute_decoded(cpu, &stos) == 0);
+    assert(*(int *)m->memory[5] == 1 && m->memory[9] == NULL);
+    *cpu->registres[REG_CX] = 4;
+    assert(execute_decoded(cpu, &stos) == 0);
+    assert(*(int *)m->memory[5] == 0 && *(int *)m->memory[8] == 0);
+
+    cpu_destroy(cpu);
+    free_program(prog);
+    printf("✅ test_blocs_memoire passed\n\n");
+}
+
+static void test_vecteurs(void) {
+    printf("=== test_vecteurs ===\n");
+
+    // Noyaux seuls : longueur non multiple de 8, débordements modulo 2^32
+    int32_t a[37], b[37], reference[37], essai[37];
+    for (int k = 0; k < 37; k++) {
+        a[k] = (int32_t)(k * 0x9E3779B1u);
+        b[k] = (int32_t)(0x7FFFFFF0u - (unsigned)k * 977u);
+    }
+    assert(vector_set_level(VECTEURS_SCALAIRE) == 0);
+    memcpy(reference, a, sizeof(a));
+    vector_mul(reference, b, 37);
+    vector_add_scalar(reference, -7, 37);
+    int32_t somme = vector_sum(reference, 37);
+
+    NiveauVecteurs detecte;
+    assert(vector_set_level(VECTEURS_AUTO) == 0);
+    detecte = vector_level();
+    for (int niveau = VECTEURS_SCALAIRE; niveau <= (int)detecte; niveau++) {
+        assert(vector_set_level((NiveauVecteurs)niveau) == 0);
+        memcpy(essai, a, sizeof(a));
+        vector_mul(essai, b, 37);
+        vector_add_scalar(essai, -7, 37);
+        assert(memcmp(essai, reference, sizeof(essai)) == 0);
+        assert(vector_sum(essai, 37) == somme);
+    }
+
+    // Programme : a = [0..9], b = [10..19] ; VADD [1], [0] recouvre sa source (sommes
+    // préfixes, comme la boucle case par case), CX = 30 sort de DS
+    const char *source =
+        ".DATA\n"
+        "a DW 1,2,3,4,5,6,7,8,9,10\n"
+        "b DW 10 DUP(3)\n"
+        ".CODE\n"
+        "MOV CX, 10\n"
+        "VADD [0], [10]\n"
+        "VMUL [10], 2\n"
+        "VMUL [0], [10]\n"
+        "VSUM AX, [0]\n"
+        "MOV BX, 3\n"
+        "VADD [10], BX\n"
+        "MOV CX, 9\n"
+        "VADD [1], [0]\n"
+        "MOV CX, 30\n"
+        "VSUM DX, [0]\n"
+        "VADD [0], 1\n";
+
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+    char *etat_reference = NULL;
+    for (int niveau = VECTEURS_SCALAIRE; niveau <= (int)detecte; niveau++) {
+        assert(vector_set_level((NiveauVecteurs)niveau) == 0);
+        CPU *cpu = executer_programme(prog);
+        MemoryHandler *m = cpu->memory_handler;
+        int prefixe = 0;
+        for (int k = 0; k < 10; k++) {
+            prefixe += (k + 4) * 6;
+            assert(*(int *)m->memory[k] == prefixe);
+            assert(*(int *)m->memory[10 + k] == 9);
+        }
+        assert(*cpu->registres[REG_AX] == 510 && *cpu->registres[REG_DX] == 0);
+
+        char *etat = capturer_etat_final(cpu);
+        if (!etat_reference) etat_reference = etat;
+        else {
+            assert(strcmp(etat, etat_reference) == 0);
+            free(etat);
+        }
+        cpu_destroy(cpu);
+        printf("✅ niveau %s\n", vector_level_name((NiveauVecteurs)niveau));
+    }
+    assert(vector_set_level(VECTEURS_AUTO) == 0);
+
+    if (system("cc --version > /dev/null 2>&1") == 0) {
+        char *obtenu = executer_traduction(prog, prog->data_size + prog->code_count + STACK_SIZE);
+        assert(strcmp(etat_reference, obtenu) == 0);
+        free(obtenu);
+        printf("✅ traduction en C : même état final\n");
+    }
+
+    free(etat_reference);
+    free_program(prog);
+    printf("✅ test_vecteurs passed\n\n");
+}
+
+static void test_lot(void) {
+    printf("=== test_lot ===\n");
+
+    // r = x * y par additions successives ; deux programmes partagés par toutes les tâches
+    const char *produit =
+        ".DATA\n"
+        "x DW 0\n"
+        "y DW 0\n"
+        "r DW 0\n"
+        ".CODE\n"
+        "MOV CX, [y]\n"
+        "MOV AX, 0\n"
+        "CMP CX, 0\n"
+        "JZ 8\n"
+        "ADD AX, [x]\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ 4\n"
+        "MOV [r], AX\n";
+    const char *somme =
+        ".DATA\n"
+        "x DW 0\n"
+        "y DW 0\n"
+        ".CODE\n"
+        "MOV AX, [x]\n"
+        "ADD AX, [y]\n"
+        "MOV [x], AX\n";
+    Programme *p_produit = assemble_buffer(produit, strlen(produit));
+    Programme *p_somme = assemble_buffer(somme, strlen(somme));
+    assert(p_produit && p_somme);
+
+    enum { NB = 300 };
+    TacheLot *taches = calloc(NB, sizeof(TacheLot));
+    int32_t (*entrees)[2] = calloc(NB, sizeof(*entrees));
+    ResultatLot *un = calloc(NB, sizeof(ResultatLot));
+    ResultatLot *plusieurs = calloc(NB, sizeof(ResultatLot));
+    assert(taches && entrees && un && plusieurs);
+    for (int i = 0; i < NB; i++) {
+        entrees[i][0] = i;
+        entrees[i][1] = i % 17;
+        taches[i].prog = i % 3 == 0 ? p_somme : p_produit;
+        taches[i].entrees = entrees[i];
+        taches[i].nb_entrees = 2;
+    }
+    // Tâche invalide : trop d'entrées pour DS ; les autres ne sont pas touchées
+    taches[7].nb_entrees = 5;
+
+    BilanLot bilan;
+    OptionsLot options = { 1, 0, 0 };
+    assert(batch_run(taches, NB, &options, un, &bilan) == 0);
+    assert(bilan.nb_threads == 1 && bilan.nb_taches == NB && bilan.nb_echecs == 1);
+    options.nb_threads = 4;
+    assert(batch_run(taches, NB, &options, plusieurs, &bilan) == 0);
+    assert(bilan.nb_threads == 4 && bilan.nb_echecs == 1 && bilan.dispatchs > NB);
+
+    for (int i = 0; i < NB; i++) {
+        if (i == 7) {
+            assert(un[i].statut == -1 && plusieurs[i].statut == -1 && !plusieurs[i].ds);
+            continue;
+        }
+        assert(plusieurs[i].statut == 0);
+        if (i % 3 == 0) {
+            assert(plusieurs[i].ds_taille == 2 && plusieurs[i].ds[0] == i + i % 17);
+        } else {
+            assert(plusieurs[i].ds_taille == 3 && plusieurs[i].ds[2] == i * (i % 17));
+            assert(plusieurs[i].registres[REG_CX] == 0 && plusieurs[i].registres[REG_ZF] == 1);
+        }
+        // Même état final quel que soit le nombre de threads
+        assert(memcmp(un[i].registres, plusieurs[i].registres, sizeof(un[i].registres)) == 0);
+        assert(memcmp(un[i].ds, plusieurs[i].ds, sizeof(int32_t) * (size_t)un[i].ds_taille) == 0);
+        assert(un[i].dispatchs == plusieurs[i].dispatchs);
+    }
+    printf("✅ %d tâches, 1 et 4 threads : mêmes résultats\n", NB);
+
+    batch_results_free(un, NB);
+    batch_results_free(plusieurs, NB);
+    free(un);
+    free(plusieurs);
+    free(entrees);
+    free(taches);
+    free_program(p_produit);
+    free_program(p_somme);
+    printf("✅ test_lot passed\n\n");
+}
+
+static void test_lot_tranches(void) {
+    printf("=== test_lot_tranches ===\n");
+
+    // Compte à rebours de n ; la tâche 0 est longue, les suivantes courtes
+    const char *source =
+        ".DATA\n"
+        "n DW 0\n"
+        ".CODE\n"
+        "MOV CX, [n]\n"
+        "boucle: ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n";
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+
+    enum { NB = 40 };
+    TacheLot taches[NB];
+    int32_t n[NB];
+    ResultatLot resultats[NB];
+    for (int i = 0; i < NB; i++) {
+        n[i] = i == 0 ? 200000 : 10 + i;
+        taches[i] = (TacheLot){ prog, &n[i], 1, 0 };
+    }
+
+    // Un thread, tâches jusqu'au bout : les courtes attendent la longue
+    OptionsLot statique = { 1, -1, 1 };
+    BilanLot bilan;
+    assert(batch_run(taches, NB, &statique, resultats, &bilan) == 0);
+    assert(bilan.nb_echecs == 0 && bilan.tranches == NB && bilan.vols == 0);
+    for (int i = 1; i < NB; i++) assert(resultats[i].fin >= resultats[0].fin);
+    batch_results_free(resultats, NB);
+
+    // Tranches de 100 dispatchs : la longue est remise en queue, les courtes finissent avant
+    OptionsLot tranches = { 1, 100, 0 };
+    assert(batch_run(taches, NB, &tranches, resultats, &bilan) == 0);
+    assert(bilan.nb_echecs == 0 && bilan.tranches > 6000);
+    for (int i = 1; i < NB; i++) {
+        assert(resultats[i].fin <= resultats[0].fin);
+        assert(resultats[i].dispatchs == 1 + 3L * n[i]);
+    }
+    assert(resultats[0].dispatchs == 1 + 3L * n[0] && resultats[0].registres[REG_CX] == 0);
+    batch_results_free(resultats, NB);
+
+    // Quatre threads : la file du premier (la longue tâche) est vidée par les autres
+    OptionsLot vol = { 4, 100, 0 };
+    assert(batch_run(taches, NB, &vol, resultats, &bilan) == 0);
+    assert(bilan.nb_echecs == 0 && bilan.nb_threads == 4);
+    assert(bilan.utilisation > 0 && bilan.utilisation <= 1.0);
+    for (int i = 0; i < NB; i++) assert(resultats[i].statut == 0 && resultats[i].registres[REG_CX] == 0);
+    printf("✅ 4 threads : %ld tranches, %ld vols, utilisation %.0f %%\n",
+           bilan.tranches, bilan.vols, bilan.utilisation * 100);
+    batch_results_free(resultats, NB);
+
+    free_program(prog);
+    printf("✅ test_lot_tranches passed\n\n");
+}
+
+static void test_execution_par_tranches(void) {
+    printf("=== test_execution_par_tranches ===\n");
+
+    // Boucle sans fin : seules les tranches rendent la main
+    const char *sans_fin =
+        ".CODE\n"
+        "boucle: ADD AX, 1\n"
+        "JMP boucle\n";
+    Programme *prog = assemble_buffer(sans_fin, strlen(sans_fin));
+    assert(prog);
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(cpu && cpu_run_for(cpu, 10) == CPU_EN_FAUTE);   // rien de chargé
+    assert(load_program(cpu, prog) == 0 && cpu->etat == CPU_EN_COURS);
+    assert(cpu_run_for(cpu, 1000) == CPU_BUDGET_EPUISE && *cpu->registres[REG_AX] == 500);
+    assert(cpu_run_for(cpu, 0) == CPU_BUDGET_EPUISE && cpu->dispatchs == 1000);
+    assert(cpu_run_for(cpu, 1001) == CPU_BUDGET_EPUISE && *cpu->registres[REG_AX] == 1001);
+
+    struct timespec echeance;
+    clock_gettime(CLOCK_MONOTONIC, &echeance);
+    assert(cpu_run_until(cpu, &echeance) == CPU_BUDGET_EPUISE && cpu->dispatchs == 2001);
+    echeance.tv_nsec += 5000000;   // 5 ms
+    if (echeance.tv_nsec >= 1000000000L) {
+        echeance.tv_sec++;
+        echeance.tv_nsec -= 1000000000L;
+    }
+    assert(cpu_run_until(cpu, &echeance) == CPU_BUDGET_EPUISE && cpu->dispatchs > 2001);
+    assert(cpu->etat == CPU_BUDGET_EPUISE);
+    cpu_destroy(cpu);
+    free_program(prog);
+
+    // Un thread, 50 CPU avancés à tour de rôle par tranches de 7 : même état final
+    // qu'une exécution d'un seul tenant
+    const char *source =
+        ".DATA\n"
+        "n DW 0\n"
+        ".CODE\n"
+        "MOV CX, [n]\n"
+        "boucle: ADD AX, CX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n"
+        "HALT 0\n"
+        "MOV AX, -1\n";
+    prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+    enum { NB = 50 };
+    CPU *cpus[NB];
+    for (int i = 0; i < NB; i++) {
+        cpus[i] = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+        assert(cpus[i] && load_program(cpus[i], prog) == 0);
+        *(int *)cpus[i]->memory_handler->memory[0] = i + 1;
+    }
+    int actifs = NB, tours = 0;
+    while (actifs > 0) {
+        actifs = 0;
+        for (int i = 0; i < NB; i++) {
+            EtatCPU etat = cpu_run_for(cpus[i], 7);
+            assert(etat == CPU_BUDGET_EPUISE || etat == CPU_ARRETE);
+            if (etat == CPU_BUDGET_EPUISE) actifs++;
+        }
+        tours++;
+    }
+    for (int i = 0; i < NB; i++) {
+        int n = i + 1;
+        assert(*cpus[i]->registres[REG_AX] == n * (n + 1) / 2 && *cpus[i]->registres[REG_IP] == -1);
+        assert(*cpus[i]->registres[REG_ZF] == 1);
+        assert(cpu_run_for(cpus[i], 7) == CPU_ARRETE);
+        cpu_destroy(cpus[i]);
+    }
+    assert(tours > 1);
+
+    // Faute : JZ vers une case inexistante ; l'état est définitif
+    const char *faute =
+        ".CODE\n"
+        "CMP AX, 0\n"
+        "JZ [9999]\n"
+        "MOV AX, 1\n";
+    Programme *p_faute = assemble_buffer(faute, strlen(faute));
+    assert(p_faute);
+    cpu = cpu_init(p_faute->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, p_faute) == 0);
+    assert(cpu_run_for(cpu, 100) == CPU_EN_FAUTE && *cpu->registres[REG_IP] == 2);
+    assert(cpu_run_for(cpu, 100) == CPU_EN_FAUTE && *cpu->registres[REG_AX] == 0);
+    cpu_destroy(cpu);
+    free_program(p_faute);
+
+    free_program(prog);
+    printf("✅ test_execution_par_tranches passed\n\n");
+}
+
+static void test_multicoeur(void) {
+    printf("=== test_multicoeur ===\n");
+
+    // Sémantique sur un seul cœur
+    const char *simple =
+        ".DATA\n"
+        "a DW 10\n"
+        "b DW 7\n"
+        ".CODE\n"
+        "MOV BX, 5\n"
+        "XADD [0], BX\n"          // a = 15, BX = 10
+        "MOV CX, 3\n"
+        "XCHG [1], CX\n"          // b = 3, CX = 7
+        "MOV AX, 15\n"
+        "CMPXCHG [0], 40\n"       // a == AX : a = 40, ZF = 1
+        "CMPXCHG [1], 99\n"       // b != AX : AX = 3, ZF = 0
+        "MFENCE\n";
+    Programme *prog = assemble_buffer(simple, strlen(simple));
+    assert(prog);
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, prog) == 0 && run_decoded_program(cpu, prog) == 0);
+    int *ds = cpu->memory_handler->mots;
+    assert(ds[0] == 40 && ds[1] == 3);
+    assert(*cpu->registres[REG_BX] == 10 && *cpu->registres[REG_CX] == 7);
+    assert(*cpu->registres[REG_AX] == 3 && *cpu->registres[REG_ZF] == 0);
+    cpu_destroy(cpu);
+    free_program(prog);
+
+    // 4 cœurs : compteur en XADD, puis section critique (verrou CMPXCHG / XCHG) qui
+    // incrémente `total` par MOV / ADD ordinaires. Chaque cœur a sa pile : BX reçoit DX.
+    const char *source =
+        ".DATA\n"
+        "compteur DW 0\n"
+        "verrou DW 0\n"
+        "total DW 0\n"
+        ".CODE\n"
+        "PUSH DX\n"
+        "MOV CX, 1000\n"
+        "boucle: XADD [0], 1\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n"
+        "MOV CX, 500\n"
+        "MOV BX, 1\n"
+        "section: MOV AX, 0\n"
+        "CMPXCHG [1], BX\n"
+        "JNZ section\n"
+        "MOV DX, [2]\n"
+        "ADD DX, 1\n"
+        "MOV [2], DX\n"
+        "MOV AX, 0\n"
+        "XCHG [1], AX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ section\n"
+        "POP BX\n";
+    prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+    assert(machine_create(prog, 4, prog->data_size + prog->code_count + STACK_SIZE) == NULL);   // une seule pile
+
+    Machine *m = machine_create(prog, 4, 0);
+    assert(m && m->nb_coeurs == 4);
+    BilanMachine bilan;
+    assert(machine_run(m, NULL, &bilan) == 0);
+    assert(bilan.nb_coeurs == 4 && bilan.nb_fautes == 0 && bilan.nb_actifs == 0 && bilan.dispatchs > 4 * 1000);
+    ds = m->coeurs[0]->memory_handler->mots;
+    assert(ds[0] == 4000 && ds[1] == 0 && ds[2] == 2000);
+    for (int i = 0; i < 4; i++) {
+        assert(m->coeurs[i]->etat == CPU_ARRETE && *m->coeurs[i]->registres[REG_BX] == i);
+        assert(m->coeurs[i]->memory_handler == m->coeurs[0]->memory_handler);
+    }
+    // Un nouvel appel n'exécute plus rien
+    assert(machine_run(m, NULL, &bilan) == 0 && bilan.dispatchs == 0);
+    machine_destroy(m);
+
+    // ES alloué par le cœur 0 : les autres cœurs le voient après la publication de `pret`
+    const char *partage =
+        ".DATA\n"
+        "pret DW 0\n"
+        "somme DW 0\n"
+        ".CODE\n"
+        "CMP DX, 0\n"
+        "JNZ attente\n"
+        "MOV AX, 4\n"
+        "MOV BX, 0\n"
+        "ALLOC\n"
+        "MOV BX, 2\n"
+        "MOV [ES:BX], 9\n"
+        "MOV AX, 1\n"
+        "XCHG [0], AX\n"
+        "attente: MOV AX, 1\n"
+        "CMPXCHG [0], AX\n"
+        "JNZ attente\n"
+        "MOV BX, 2\n"
+        "MOV CX, [ES:BX]\n"
+        "XADD [1], CX\n";
+    Programme *es = assemble_buffer(partage, strlen(partage));
+    assert(es);
+    m = machine_create(es, 3, es->data_size + es->code_count + 4 + 3 * STACK_SIZE);
+    assert(m);
+    assert(machine_run(m, NULL, &bilan) == 0 && bilan.nb_fautes == 0);
+    assert(m->coeurs[0]->memory_handler->mots[1] == 3 * 9);
+    machine_destroy(m);
+    free_program(es);
+
+    // Échéance : une boucle sans fin rend la main, la machine reste reprenable
+    const char *sans_fin = ".DATA\nx DW 0\n.CODE\nboucle: XADD [0], 1\nJMP boucle\n";
+    Programme *boucle = assemble_buffer(sans_fin, strlen(sans_fin));
+    assert(boucle);
+    m = machine_create(boucle, 2, 0);
+    assert(m);
+    struct timespec echeance;
+    clock_gettime(CLOCK_MONOTONIC, &echeance);
+    assert(machine_run(m, &echeance, &bilan) == 1 && bilan.nb_actifs == 2);
+    machine_destroy(m);
+    free_program(boucle);
+
+    free_program(prog);
+    printf("✅ test_multicoeur passed\n\n");
+}
+
+static void test_canaux(void) {
+    printf("=== test_canaux ===\n");
+
+    // Anneaux seuls : capacité arrondie à 4, ordre FIFO, plein / vide
+    TypeCanal types[] = { CANAL_SPSC, CANAL_MPMC };
+    for (int t = 0; t < 2; t++) {
+        Canal *c = channel_create(types[t], 3);
+        int32_t v;
+        assert(c && channel_type(c) == types[t]);
+        assert(!channel_try_recv(c, &v) && !channel_ready(c, 0) && channel_ready(c, 1));
+        for (int k = 0; k < 4; k++) assert(channel_try_send(c, 10 + k));
+        assert(!channel_try_send(c, 99) && !channel_ready(c, 1));
+        for (int tour = 0; tour < 10; tour++) {
+            assert(channel_try_recv(c, &v) && v == 10 + tour);
+            assert(channel_try_send(c, 14 + tour));
+        }
+        channel_destroy(c);
+    }
+    // Capacité 1 : une case en SPSC, deux en MPMC ; un envoi de trop échoue sans écraser
+    for (int t = 0; t < 2; t++) {
+        Canal *c = channel_create(types[t], 1);
+        int32_t v;
+        int cases = types[t] == CANAL_MPMC ? 2 : 1;
+        assert(c);
+        for (int k = 0; k < cases; k++) assert(channel_try_send(c, 20 + k));
+        assert(!channel_try_send(c, 99));
+        for (int k = 0; k < cases; k++) assert(channel_try_recv(c, &v) && v == 20 + k);
+        assert(!channel_try_recv(c, &v));
+        channel_destroy(c);
+    }
+    Canal *c = channel_create(CANAL_SPSC, 1);
+    assert(channel_bind(c, 1, 0) == 0 && channel_bind(c, 1, 0) == 0 && channel_bind(c, 1, 2) == -1);
+    assert(channel_bind(c, 0, 2) == 0);
+    channel_destroy(c);
+
+    // Pipeline : le cœur 0 envoie 1000..1 au cœur 1 par un SPSC de 4 cases, les cœurs 2 et
+    // 3 envoient chacun 500..1 au cœur 0 par un MPMC de 8 cases
+    const char *source =
+        ".DATA\n"
+        "somme DW 0\n"
+        "total DW 0\n"
+        ".CODE\n"
+        "CMP DX, 0\n"
+        "JZ producteur\n"
+        "CMP DX, 1\n"
+        "JZ consommateur\n"
+        "MOV CX, 500\n"
+        "multiple: SEND 1, CX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ multiple\n"
+        "HALT 0\n"
+        "producteur: MOV CX, 1000\n"
+        "envoi: SEND 0, CX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ envoi\n"
+        "MOV CX, 1000\n"
+        "MOV BX, 0\n"
+        "collecte: RECV AX, 1\n"
+        "ADD BX, AX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ collecte\n"
+        "MOV [1], BX\n"
+        "HALT 0\n"
+        "consommateur: MOV CX, 1000\n"
+        "MOV BX, 0\n"
+        "reception: RECV AX, 0\n"
+        "ADD BX, AX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ reception\n"
+        "MOV [0], BX\n";
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog);
+    Machine *m = machine_create(prog, 4, 0);
+    assert(m);
+    assert(machine_add_channel(m, CANAL_SPSC, 4) == 0 && machine_add_channel(m, CANAL_MPMC, 8) == 1);
+    BilanMachine bilan;
+    assert(machine_run(m, NULL, &bilan) == 0);
+    assert(bilan.nb_fautes == 0 && bilan.nb_bloques == 0 && !bilan.interblocage);
+    int *ds = m->coeurs[0]->memory_handler->mots;
+    assert(ds[0] == 500500 && ds[1] == 2 * 125250);
+    machine_destroy(m);
+
+    // Sans machine, un RECV n'a pas de canal : échec
+    CPU *cpu = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(cpu && load_program(cpu, prog) == 0 && run_decoded_program(cpu, prog) == -1);
+    cpu_destroy(cpu);
+    free_program(prog);
+
+    // Deux cœurs qui attendent chacun un mot que personne n'enverra : interblocage
+    const char *attente = ".CODE\nRECV AX, 0\n";
+    prog = assemble_buffer(attente, strlen(attente));
+    assert(prog);
+    m = machine_create(prog, 2, 0);
+    assert(m && machine_add_channel(m, CANAL_MPMC, 2) == 0);
+    assert(machine_run(m, NULL, &bilan) == -1);
+    assert(bilan.interblocage && bilan.nb_bloques == 2 && bilan.nb_fautes == 0);
+    assert(m->coeurs[0]->etat == CPU_BLOQUE && *m->coeurs[0]->registres[REG_IP] == 0);
+    machine_destroy(m);
+    free_program(prog);
+
+    // Un SPSC n'a qu'un émetteur : le second cœur qui y envoie est en faute
+    const char *deux = ".CODE\nSEND 0, DX\n";
+    prog = assemble_buffer(deux, strlen(deux));
+    assert(prog);
+    m = machine_create(prog, 2, 0);
+    assert(m && machine_add_channel(m, CANAL_SPSC, 4) == 0);
+    assert(machine_run(m, NULL, &bilan) == -1 && bilan.nb_fautes == 1);
+    machine_destroy(m);
+    free_program(prog);
+
+    printf("✅ test_canaux passed\n\n");
+}
+
+// Exécute `prog` en mode déterministe sur `nb` cœurs ; la machine est rendue à l'appelant
+static Machine *deroulement(Programme *prog, int nb, long quantum, int attendu, BilanMachine *bilan) {
+    Machine *m = machine_create(prog, nb, 0);
+    assert(m);
+    assert(machine_run_deterministic(m, quantum, NULL, bilan) == attendu);
+    return m;
+}
+
+static void test_deterministe(void) {
+    printf("=== test_deterministe ===\n");
+
+    // Compteur en MOV / ADD ordinaires : des incréments se perdent (les cœurs avancent au
+    // même pas, chaque tour ne garde que les écritures du dernier), mais toujours les mêmes
+    const char *course =
+        ".DATA\n"
+        "compteur DW 0\n"
+        ".CODE\n"
+        "MOV CX, 1000\n"
+        "boucle: MOV AX, [0]\n"
+        "ADD AX, 1\n"
+        "MOV [0], AX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n";
+    Programme *prog = assemble_buffer(course, strlen(course));
+    assert(prog);
+    BilanMachine premier, second;
+    Machine *a = deroulement(prog, 4, 50, 0, &premier);
+    Machine *b = deroulement(prog, 4, 50, 0, &second);
+    int total = a->coeurs[0]->memory_handler->mots[0];
+    assert(total >= 1000 && total < 4000);
+    assert(b->coeurs[0]->memory_handler->mots[0] == total);
+    assert(premier.dispatchs == second.dispatchs && premier.tours == second.tours && premier.tours > 1);
+    for (int i = 0; i < 4; i++) assert(a->coeurs[i]->dispatchs == b->coeurs[i]->dispatchs);
+    machine_destroy(a);
+    machine_destroy(b);
+    // Un seul cœur : rien ne se perd
+    a = deroulement(prog, 1, 7, 0, &premier);
+    assert(a->coeurs[0]->memory_handler->mots[0] == 1000);
+    machine_destroy(a);
+    free_program(prog);
+
+    // Les instructions atomiques passent aux synchronisations : compteur XADD et verrou exacts
+    const char *verrou =
+        ".DATA\n"
+        "compteur DW 0\n"
+        "verrou DW 0\n"
+        "total DW 0\n"
+        ".CODE\n"
+        "MOV CX, 1000\n"
+        "boucle: XADD [0], 1\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ boucle\n"
+        "MOV CX, 500\n"
+        "MOV BX, 1\n"
+        "section: MOV AX, 0\n"
+        "CMPXCHG [1], BX\n"
+        "JNZ section\n"
+        "MOV DX, [2]\n"
+        "ADD DX, 1\n"
+        "MOV [2], DX\n"
+        "MOV AX, 0\n"
+        "XCHG [1], AX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ section\n";
+    prog = assemble_buffer(verrou, strlen(verrou));
+    assert(prog);
+    a = deroulement(prog, 4, 0, 0, &premier);
+    b = deroulement(prog, 4, 0, 0, &second);
+    int *ds = a->coeurs[0]->memory_handler->mots;
+    assert(ds[0] == 4000 && ds[1] == 0 && ds[2] == 2000);
+    assert(premier.nb_fautes == 0 && premier.nb_actifs == 0 && premier.dispatchs == second.dispatchs);
+    machine_destroy(a);
+    machine_destroy(b);
+    free_program(prog);
+
+    // Canaux : le cœur 0 envoie 100 mots, le cœur 1 les additionne
+    const char *canal =
+        ".DATA\n"
+        "somme DW 0\n"
+        ".CODE\n"
+        "MOV CX, 100\n"
+        "MOV BX, 0\n"
+        "CMP DX, 0\n"
+        "JNZ recepteur\n"
+        "envoi: SEND 0, CX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ envoi\n"
+        "HALT 0\n"
+        "recepteur: RECV AX, 0\n"
+        "ADD BX, AX\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ recepteur\n"
+        "MOV [0], BX\n";
+    prog = assemble_buffer(canal, strlen(canal));
+    assert(prog);
+    a = machine_create(prog, 2, 0);
+    assert(a && machine_add_channel(a, CANAL_SPSC, 4) == 0);
+    assert(machine_run_deterministic(a, 0, NULL, &premier) == 0);
+    assert(a->coeurs[0]->memory_handler->mots[0] == 5050);
+    machine_destroy(a);
+
+    // Sans canal, SEND et RECV sont des fautes ; deux récepteurs sur un canal vide sont un
+    // interblocage, détecté à la barrière
+    a = deroulement(prog, 2, 0, -1, &premier);
+    assert(premier.nb_fautes == 2 && premier.interblocage == 0);
+    machine_destroy(a);
+    a = machine_create(prog, 2, 0);
+    assert(a && machine_add_channel(a, CANAL_MPMC, 4) == 0);
+    *a->coeurs[0]->registres[REG_DX] = 1;
+    assert(machine_run_deterministic(a, 0, NULL, &premier) == -1);
+    assert(premier.interblocage == 1 && premier.nb_bloques == 2);
+    machine_destroy(a);
+    free_program(prog);
+
+    printf("✅ test_deterministe passed\n\n");
+}
+
+// Compare jeu par jeu l'exécution par voies à batch_run (un CPU par jeu)
+static void comparer_voies(const Programme *prog, const int32_t *entrees, int32_t nb_entrees, int nb_jeux,
+                           const ResultatLot *voies) {
+    TacheLot *taches = calloc((size_t)nb_jeux, sizeof(TacheLot));
+    ResultatLot *scalaires = calloc((size_t)nb_jeux, sizeof(ResultatLot));
+    assert(taches && scalaires);
+    for (int j = 0; j < nb_jeux; j++) {
+        taches[j].prog = prog;
+        taches[j].entrees = entrees + (size_t)j * nb_entrees;
+        taches[j].nb_entrees = nb_entrees;
+    }
+    OptionsLot options = { 1, 0, 0 };
+    assert(batch_run(taches, nb_jeux, &options, scalaires, NULL) == 0);
+    for (int j = 0; j < nb_jeux; j++) {
+        assert(voies[j].statut == scalaires[j].statut && voies[j].dispatchs == scalaires[j].dispatchs);
+        assert(memcmp(voies[j].registres, scalaires[j].registres, sizeof(voies[j].registres)) == 0);
+        assert(voies[j].ds_taille == scalaires[j].ds_taille);
+        assert(memcmp(voies[j].ds, scalaires[j].ds, sizeof(int32_t) * (size_t)voies[j].ds_taille) == 0);
+    }
+    batch_results_free(scalaires, nb_jeux);
+    free(scalaires);
+    free(taches);
+}
+
+static void test_voies(void) {
+    printf("=== test_voies ===\n");
+
+    // Boucle de longueur variable (n), puis if / else sur x ; [DS:BX] avec BX hors de DS
+    // laisse le MOV sans effet. Un jeu avec x = 2 saute vers une cible illisible : faute.
+    const char *source =
+        ".DATA\n"
+        "n DW 0\n"
+        "x DW 0\n"
+        "pair DW 0\n"
+        "impair DW 0\n"
+        "cible DW 0\n"
+        ".CODE\n"
+        "MOV CX, [n]\n"
+        "MOV AX, 0\n"
+        "boucle: CMP CX, 0\n"
+        "JZ fin\n"
+        "ADD AX, CX\n"
+        "ADD CX, -1\n"
+        "JMP boucle\n"
+        "fin: MOV BX, [x]\n"
+        "CMP BX, 2\n"
+        "JNZ suite\n"
+        "MOV DX, 100\n"
+        "JZ [DS:DX]\n"
+        "suite: CMP BX, 0\n"
+        "JNZ sinon\n"
+        "MOV [pair], AX\n"
+        "JMP sortie\n"
+        "sinon: ADD BX, 2\n"
+        "MOV [DS:BX], AX\n"
+        "MOV DX, [ZF]\n"
+        "sortie: HALT 0\n"
+        "MOV [cible], 1\n";
+    Programme *prog = assemble_buffer(source, strlen(source));
+    assert(prog && lanes_supported(prog));
+
+    enum { NB = 37 };
+    int32_t entrees[NB][2];
+    for (int j = 0; j < NB; j++) {
+        entrees[j][0] = (j * 7) % 23;
+        entrees[j][1] = j % 5 == 4 ? 2 : (j % 5 == 3 ? 40 : j % 2);
+    }
+    ResultatLot resultats[NB];
+    BilanVoies bilan;
+    // Seconde passe : superinstructions, et groupes compilés sans AVX2
+    for (int passe = 0; passe < 2; passe++) {
+        if (passe == 1) {
+            assert(fuse_superinstructions(prog) > 0 && lanes_supported(prog));
+            assert(vector_set_level(VECTEURS_SCALAIRE) == 0);
+        }
+        for (int largeur = 8; largeur <= 16; largeur += 8) {
+            assert(lanes_run(prog, largeur, &entrees[0][0], 2, NB, resultats, &bilan) == 0);
+            assert(bilan.scalaire == 0 && bilan.nb_groupes == (NB + largeur - 1) / largeur);
+            assert(bilan.nb_echecs == NB / 5 && bilan.occupation > 0 && bilan.occupation <= 1);
+            assert(resultats[1].statut == 0 && resultats[1].ds[3] == 28 && resultats[1].registres[REG_IP] == -1);
+            comparer_voies(prog, &entrees[0][0], 2, NB, resultats);
+            batch_results_free(resultats, NB);
+        }
+    }
+    vector_set_level(VECTEURS_AUTO);
+    free_program(prog);
+
+    // Hors du sous-ensemble (pile) : exécution jeu par jeu, mêmes résultats
+    const char *pile = ".DATA\nx DW 0\n.CODE\nPUSH [0]\nPOP AX\nADD AX, 1\nMOV [x], AX\n";
+    prog = assemble_buffer(pile, strlen(pile));
+    assert(prog && !lanes_supported(prog));
+    assert(lanes_run(prog, 0, &entrees[0][0], 1, 5, resultats, &bilan) == 0);
+    assert(bilan.scalaire == 1 && bilan.largeur == 16 && bilan.nb_echecs == 0);
+    for (int j = 0; j < 5; j++) assert(resultats[j].ds[0] == entrees[j / 2][j % 2] + 1);
+    batch_results_free(resultats, 5);
+    assert(lanes_run(prog, 4, NULL, 0, 5, resultats, NULL) == -1);
+    free_program(prog);
+
+    printf("✅ test_voies passed\n\n");
+}
+
+// Tue le processus travailleur avant les tâches 7, 57, 107... inférieures à *contexte
+static void tuer_travailleur(int tache, void *contexte) {
+    if (tache % 50 == 7 && tache < *(int *)contexte) raise(SIGKILL);
+}
+
+static void test_lot_processus(void) {
+    printf("=== test_lot_processus ===\n");
+
+    const char *produit =
+        ".DATA\n"
+        "x DW 0\n"
+        "y DW 0\n"
+        "r DW 0\n"
+        ".CODE\n"
+        "MOV CX, [y]\n"
+        "MOV AX, 0\n"
+        "CMP CX, 0\n"
+        "JZ 8\n"
+        "ADD AX, [x]\n"
+        "ADD CX, -1\n"
+        "CMP CX, 0\n"
+        "JNZ 4\n"
+        "MOV [r], AX\n";
+    Programme *prog = assemble_buffer(produit, strlen(produit));
+    assert(prog);
+
+    enum { NB = 200 };
+    TacheLot taches[NB];
+    int32_t entrees[NB][2];
+    ResultatLot attendus[NB], resultats[NB];
+    for (int i = 0; i < NB; i++) {
+        entrees[i][0] = i;
+        entrees[i][1] = i % 13;
+        taches[i] = (TacheLot){ prog, entrees[i], 2, 0 };
+    }
+    taches[3].nb_entrees = 99;   // tâche invalide : échec sans plantage
+    OptionsLot un_thread = { 1, 0, 0 };
+    assert(batch_run(taches, NB, &un_thread, attendus, NULL) == 0);
+
+    // Sans plantage : mêmes résultats que batch_run, lus dans la table partagée
+    OptionsProcessus options = { 4, NULL, NULL };
+    BilanProcessus bilan;
+    assert(batch_run_processes(taches, NB, &options, resultats, &bilan) == 0);
+    assert(bilan.nb_processus == 4 && bilan.nb_echecs == 1 && bilan.nb_plantages == 0 && bilan.nb_relances == 0);
+    for (int i = 0; i < NB; i++) {
+        assert(resultats[i].statut == attendus[i].statut && resultats[i].dispatchs == attendus[i].dispatchs);
+        if (resultats[i].statut != 0) continue;
+        assert(memcmp(resultats[i].registres, attendus[i].registres, sizeof(resultats[i].registres)) == 0);
+        assert(resultats[i].ds_taille == 3 && resultats[i].ds[2] == i * (i % 13));
+    }
+    batch_results_free(resultats, NB);
+
+    // Les travailleurs meurent avant les tâches 7, 57, 107 et 157 : seules celles-ci sont
+    // perdues, un nouveau travailleur finit chaque part
+    int limite = NB;
+    options.preparer = tuer_travailleur;
+    options.contexte = &limite;
+    assert(batch_run_processes(taches, NB, &options, resultats, &bilan) == 0);
+    assert(bilan.nb_plantages == 4 && bilan.nb_relances == 4 && bilan.nb_echecs == 5);
+    for (int i = 0; i < NB; i++) {
+        if (i % 50 == 7) {
+            assert(resultats[i].statut == LOT_PLANTAGE && !resultats[i].ds);
+        } else {
+            assert(resultats[i].statut == attendus[i].statut && resultats[i].dispatchs == attendus[i].dispatchs);
+        }
+    }
+    batch_results_free(resultats, NB);
+
+    // Dernière tâche d'une part : rien à relancer
+    limite = 8;
+    options.nb_processus = 25;
+    assert(batch_run_processes(taches, NB, &options, resultats, &bilan) == 0);
+    assert(bilan.nb_plantages == 1 && bilan.nb_relances == 0 && resultats[7].statut == LOT_PLANTAGE);
+    assert(resultats[8].statut == 0 && resultats[6].statut == 0);
+    batch_results_free(resultats, NB);
+
+    batch_results_free(attendus, NB);
+    free_program(prog);
+    printf("✅ test_lot_processus passed\n\n");
+}
+
+typedef struct {
+    ProgrammeFige *fige;
+    int premier;          // Entrée du premier CPU du thread
+    int echecs;
+} TravailFige;
+
+// Chaque thread crée, exécute et détruit ses CPU ; le programme n'est que lu
+static void *executer_fige(void *arg) {
+    TravailFige *travail = arg;
+    for (int k = 0; k < 16; k++) {
+        CPU *cpu = cpu_init_frozen(travail->fige);
+        if (!cpu) {
+            travail->echecs++;
+            continue;
+        }
+        int n = travail->premier + k;
+        *(int *)cpu->memory_handler->memory[1] = n;
+        if (run_decoded_program(cpu, frozen_program(travail->fige)) != 0 ||
+            *(int *)cpu->memory_handler->memory[2] != n * (n + 1) / 2) {
+            travail->echecs++;
+        }
+        cpu_destroy(cpu);
+    }
+    return NULL;
+}
+
+static void test_programme_fige(void) {
+    printf("=== test_programme_fige ===\n");
+
+    const char *somme =
+        ".DATA\n"
+        "i DW 0\n"
+        "n DW 0\n"
+        "s DW 0\n"
+        ".CODE\n"
+        "MOV CX, [n]\n"
+        "MOV AX, 0\n"
+        "CMP CX, 0\n"
+        "JZ 7\n"
+        "ADD AX, CX\n"
+        "ADD CX, -1\n"
+        "JMP 2\n"
+        "MOV [s], AX\n";
+    Programme *prog = assemble_buffer(somme, strlen(somme));
+    assert(prog);
+
+    // Référence : CPU classique, avec CS et table des constantes
+    CPU *reference = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    assert(reference && load_program(reference, prog) == 0);
+    *(int *)reference->memory_handler->memory[1] = 10;
+    assert(run_decoded_program(reference, prog) == 0);
+    int code_count = prog->code_count;
+
+    ProgrammeFige *fige = program_freeze(prog);   // consomme prog
+    assert(fige && frozen_references(fige) == 1);
+    const Programme *vue = frozen_program(fige);
+    assert(vue->code_count == code_count && vue->data_size == 3);
+    assert(find_symbol(vue->variables, vue->variable_count, "s"));
+
+    // Le CPU ne possède que DS et la pile : ni CS ni table des constantes
+    CPU *cpu = cpu_init_frozen(fige);
+    assert(cpu && frozen_references(fige) == 2);
+    assert(cpu->memory_handler->total_size == vue->data_size + STACK_SIZE);
+    assert(hashmap_get(cpu->memory_handler->allocated, "DS"));
+    assert(!hashmap_get(cpu->memory_handler->allocated, "CS"));
+    *(int *)cpu->memory_handler->memory[1] = 10;
+    assert(run_decoded_program(cpu, vue) == 0);
+    assert(!cpu->constant_pool);
+    assert(*(int *)cpu->memory_handler->memory[2] == 55);
+    assert(cpu->dispatchs == reference->dispatchs);
+    for (int r = 0; r < NB_REGISTRES; r++) {
+        if (r != REG_SP && r != REG_BP) assert(*cpu->registres[r] == *reference->registres[r]);
+    }
+    cpu_destroy(cpu);
+    cpu_destroy(reference);
+    assert(frozen_references(fige) == 1);
+
+    // 4 threads × 16 CPU sur la même image, sans verrou
+    pthread_t threads[4];
+    TravailFige travaux[4];
+    for (int t = 0; t < 4; t++) {
+        travaux[t] = (TravailFige){ fige, t * 16, 0 };
+        assert(pthread_create(&threads[t], NULL, executer_fige, &travaux[t]) == 0);
+    }
+    for (int t = 0; t < 4; t++) {
+        pthread_join(threads[t], NULL);
+        assert(travaux[t].echecs == 0);
+    }
+    assert(frozen_references(fige) == 1);
+
+    // Un CPU peut survivre au créateur de l'image : la dernière référence libère
+    cpu = cpu_init_frozen(fige);
+    frozen_release(fige);
+    assert(frozen_references(fige) == 1);
+    assert(run_decoded_program(cpu, frozen_program(fige)) == 0);
+    cpu_destroy(cpu);
+
+    assert(program_freeze(NULL) == NULL && cpu_init_frozen(NULL) == NULL);
+    printf("✅ test_programme_fige passed\n\n");
+}
+
+typedef struct {
+    HashMapConcurrente *map;
+    int valeurs[256];           // Valeur de "k<i>" : &valeurs[i] ou &doubles[i]
+    int doubles[256];
+    atomic_int fini;
+} LectureConcurrente;
+
+typedef struct {
+    LectureConcurrente *commun;
+    int erreurs;
+} Lecteur;
+
+// Lecteur : les clés "k<i>" restent présentes pendant que l'écrivain ajoute, retire et agrandit
+static void *lire_en_boucle(void *arg) {
+    Lecteur *lecteur = arg;
+    LectureConcurrente *l = lecteur->commun;
+    char cle[16];
+    while (!atomic_load(&l->fini)) {
+        for (int i = 0; i < 256; i++) {
+            snprintf(cle, sizeof(cle), "k%d", i);
+            int *v = concurrent_hashmap_get(l->map, cle);
+            if (v != &l->valeurs[i] && v != &l->doubles[i]) lecteur->erreurs++;
+        }
+    }
+    return NULL;
+}
+
+static void test_hashmap_concurrente(void) {
+    printf("=== test_hashmap_concurrente ===\n");
+
+    // Un seul thread : même comportement que HashMap
+    HashMapConcurrente *map = concurrent_hashmap_create();
+    assert(map);
+    int a = 1, b = 2;
+    assert(concurrent_hashmap_insert(map, "AX", &a) == 0);
+    assert(concurrent_hashmap_get(map, "AX") == &a);
+    assert(concurrent_hashmap_insert(map, "AX", &b) == 0);
+    assert(concurrent_hashmap_get(map, "AX") == &b && concurrent_hashmap_count(map) == 1);
+    assert(concurrent_hashmap_get(map, "BX") == NULL);
+    assert(concurrent_hashmap_remove(map, "AX") == 0 && concurrent_hashmap_remove(map, "AX") == -1);
+    assert(concurrent_hashmap_get(map, "AX") == NULL && concurrent_hashmap_count(map) == 0);
+    char cle[16];
+    for (int i = 0; i < 5000; i++) {
+        snprintf(cle, sizeof(cle), "x%d", i);
+        assert(concurrent_hashmap_insert(map, cle, &a) == 0);
+    }
+    for (int i = 0; i < 5000; i += 2) {
+        snprintf(cle, sizeof(cle), "x%d", i);
+        assert(concurrent_hashmap_remove(map, cle) == 0);
+    }
+    assert(concurrent_hashmap_count(map) == 2500);
+    for (int i = 0; i < 5000; i++) {
+        snprintf(cle, sizeof(cle), "x%d", i);
+        assert(concurrent_hashmap_get(map, cle) == (i % 2 ? &a : NULL));
+    }
+    assert(concurrent_hashmap_insert(NULL, "AX", &a) == -1 && concurrent_hashmap_get(map, NULL) == NULL);
+    concurrent_hashmap_destroy(map);
+
+    // 3 lecteurs sans verrou contre un écrivain qui remplace, ajoute, retire et agrandit
+    static LectureConcurrente l;
+    l.map = concurrent_hashmap_create();
+    assert(l.map);
+    atomic_init(&l.fini, 0);
+    for (int i = 0; i < 256; i++) {
+        snprintf(cle, sizeof(cle), "k%d", i);
+        assert(concurrent_hashmap_insert(l.map, cle, &l.valeurs[i]) == 0);
+    }
+    pthread_t lecteurs[3];
+    Lecteur etats[3];
+    for (int t = 0; t < 3; t++) {
+        etats[t] = (Lecteur){ &l, 0 };
+        assert(pthread_create(&lecteurs[t], NULL, lire_en_boucle, &etats[t]) == 0);
+    }
+    for (int tour = 0; tour < 4; tour++) {
+        for (int i = 0; i < 2000; i++) {
+            snprintf(cle, sizeof(cle), "w%d", tour * 2000 + i);
+            assert(concurrent_hashmap_insert(l.map, cle, &a) == 0);
+            if (i % 8 == 0) {
+                snprintf(cle, sizeof(cle), "k%d", i % 256);
+                int *actuelle = concurrent_hashmap_get(l.map, cle);
+                assert(concurrent_hashmap_insert(l.map, cle, actuelle == &l.valeurs[i % 256] ? &l.doubles[i % 256]
+                                                                                               : &l.valeurs[i % 256]) == 0);
+            }
+        }
+        for (int i = 0; i < 2000; i += 2) {
+            snprintf(cle, sizeof(cle), "w%d", tour * 2000 + i);
+            assert(concurrent_hashmap_remove(l.map, cle) == 0);
+        }
+    }
+    atomic_store(&l.fini, 1);
+    for (int t = 0; t < 3; t++) {
+        pthread_join(lecteurs[t], NULL);
+        assert(etats[t].erreurs == 0);
+    }
+    assert(concurrent_hashmap_count(l.map) == 256 + 4 * 1000);
+    concurrent_hashmap_destroy(l.map);
+
+    printf("✅ test_hashmap_concurrente passed\n\n");
+}
 
 // -----------------------------------
 // main
@@ -102,6 +2179,32 @@ static void test_run_program_existing(void) {
 int main(void) {
     // Vos tests précédents...
     test_run_program_existing();
+    test_chemin_textuel();
+    test_image_binaire();
+    test_resolution_symboles();
+    test_assembleur_incremental();
+    test_cache_programmes();
+    test_constantes_dup();
+    test_superinstructions();
+    test_jit();
+    test_transpileur();
+    test_cache_blocs();
+    test_traces();
+    test_drapeaux();
+    test_constantes_immediates();
+    test_pile_contigue();
+    test_blocs_memoire();
+    test_vecteurs();
+    test_lot();
+    test_lot_tranches();
+    test_execution_par_tranches();
+    test_multicoeur();
+    test_canaux();
+    test_deterministe();
+    test_voies();
+    test_lot_processus();
+    test_programme_fige();
+    test_hashmap_concurrente();
 
     return 0;
 }
\ No newline at end of file
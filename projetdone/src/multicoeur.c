@@ -0,0 +1,398 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "../include/multicoeur.h"
+#include "../include/interpreteur.h"
+#include "../include/journal.h"
+
+enum { COEUR_ACTIF, COEUR_GARE, COEUR_SORTI };
+
+typedef struct course Course;
+
+typedef struct {
+    Course *course;
+    CPU *coeur;
+    atomic_int statut;       // COEUR_ACTIF / COEUR_GARE (endormi sur un canal) / COEUR_SORTI
+    atomic_int canal;        // COEUR_GARE : canal attendu et opération (copiés du CPU, que le
+    atomic_int envoi;        // cœur réécrit dès qu'il repart)
+    long dispatchs;
+} Execution;
+
+// État partagé par les threads d'un appel à machine_run
+struct course {
+    Machine *machine;
+    Execution *executions;
+    const struct timespec *echeance;
+    atomic_int arret;        // Mis à 1 par le premier cœur en faute (ou à l'interblocage)
+    atomic_int interblocage;
+    atomic_long changements; // Cœurs garés ou réveillés depuis le début de l'appel
+};
+
+// État partagé par les threads d'un appel à machine_run_deterministic. Les champs écrits par
+// le meneur (celui qui sort de la barrière avec PTHREAD_BARRIER_SERIAL_THREAD) ne sont lus
+// qu'après la barrière suivante : ils n'ont pas besoin d'être atomiques.
+typedef struct {
+    Machine *machine;
+    Journal **journaux;
+    long quantum;
+    const struct timespec *echeance;
+    pthread_barrier_t barriere;
+    pthread_mutex_t verrou;  // Départ : les threads attendent que tous aient été créés
+    pthread_cond_t depart;
+    int partis;
+    int arret;
+    int interblocage;
+    long tours;
+} Synchro;
+
+typedef struct {
+    Synchro *synchro;
+    int numero;
+} Participant;
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int echeance_passee(const struct timespec *echeance) {
+    if (!echeance) return 0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec > echeance->tv_sec ||
+           (ts.tv_sec == echeance->tv_sec && ts.tv_nsec >= echeance->tv_nsec);
+}
+
+Machine *machine_create(const Programme *prog, int nb_coeurs, int memory_size) {
+    if (!prog || nb_coeurs < 1) {
+        fprintf(stderr, "machine_create: paramètres invalides.\n");
+        return NULL;
+    }
+    Machine *m = calloc(1, sizeof(Machine));
+    if (!m) return NULL;
+    m->coeurs = calloc((size_t)nb_coeurs, sizeof(CPU *));
+    if (!m->coeurs) {
+        free(m);
+        return NULL;
+    }
+    m->prog = prog;
+    pthread_mutex_init(&m->verrou_memoire, NULL);
+    atomic_init(&m->bornes_es, 0);
+
+    int taille = memory_size > 0 ? memory_size
+                                 : prog->data_size + prog->code_count + nb_coeurs * STACK_SIZE;
+    CPU *principal = cpu_init(taille);
+    if (!principal || load_program(principal, prog) != 0) {
+        cpu_destroy(principal);
+        free(m->coeurs);
+        pthread_mutex_destroy(&m->verrou_memoire);
+        free(m);
+        return NULL;
+    }
+    principal->verrou_memoire = &m->verrou_memoire;
+    principal->bornes_es = &m->bornes_es;
+    m->coeurs[0] = principal;
+    m->nb_coeurs = 1;
+
+    // Les cœurs secondaires partagent DS / CS déjà chargés : seul l'état d'exécution est posé
+    for (int i = 1; i < nb_coeurs; i++) {
+        CPU *coeur = cpu_init_core(principal, i);
+        if (!coeur) {
+            machine_destroy(m);
+            return NULL;
+        }
+        coeur->programme = prog;
+        coeur->etat = CPU_EN_COURS;
+        *coeur->registres[REG_DX] = i;
+        m->coeurs[m->nb_coeurs++] = coeur;
+    }
+    return m;
+}
+
+int machine_add_channel(Machine *m, TypeCanal type, int capacite) {
+    if (!m) return -1;
+    Canal *canal = channel_create(type, capacite);
+    if (!canal) return -1;
+    Canal **canaux = realloc(m->canaux, sizeof(Canal *) * (size_t)(m->nb_canaux + 1));
+    if (!canaux) {
+        channel_destroy(canal);
+        return -1;
+    }
+    canaux[m->nb_canaux] = canal;
+    m->canaux = canaux;
+    m->nb_canaux++;
+    for (int i = 0; i < m->nb_coeurs; i++) {
+        m->coeurs[i]->canaux = canaux;
+        m->coeurs[i]->nb_canaux = m->nb_canaux;
+    }
+    return m->nb_canaux - 1;
+}
+
+// Interblocage : aucun cœur actif et aucun cœur garé dont le canal permet d'avancer. Seul
+// un cœur actif peut changer un canal ; si aucun cœur ne s'est garé ni réveillé pendant
+// l'examen (`changements` inchangé), l'instantané est cohérent.
+static int interblocage(Course *course) {
+    long avant = atomic_load(&course->changements);
+    int gares = 0;
+    for (int i = 0; i < course->machine->nb_coeurs; i++) {
+        Execution *ex = &course->executions[i];
+        int statut = atomic_load(&ex->statut);
+        if (statut == COEUR_ACTIF) return 0;
+        if (statut == COEUR_SORTI) continue;
+        // Garé : canal et envoi ont été écrits avant le statut
+        Canal *canal = course->machine->canaux[atomic_load(&ex->canal)];
+        if (channel_ready(canal, atomic_load(&ex->envoi))) return 0;
+        gares++;
+    }
+    return gares > 0 && atomic_load(&course->changements) == avant;
+}
+
+// Endort le thread d'un cœur bloqué jusqu'à ce que son canal permette de réessayer
+static void garer(Execution *ex) {
+    Course *course = ex->course;
+    CPU *coeur = ex->coeur;
+    Canal *canal = coeur->canaux[coeur->canal_attendu];
+
+    atomic_store(&ex->canal, coeur->canal_attendu);
+    atomic_store(&ex->envoi, coeur->attente_envoi);
+    atomic_store(&ex->statut, COEUR_GARE);
+    atomic_fetch_add(&course->changements, 1);
+    while (!channel_ready(canal, coeur->attente_envoi)) {
+        if (atomic_load_explicit(&course->arret, memory_order_relaxed) || echeance_passee(course->echeance)) break;
+        struct timespec jusqua;
+        clock_gettime(CLOCK_MONOTONIC, &jusqua);
+        jusqua.tv_nsec += MACHINE_ATTENTE_NS;
+        if (jusqua.tv_nsec >= 1000000000L) {
+            jusqua.tv_sec++;
+            jusqua.tv_nsec -= 1000000000L;
+        }
+        channel_wait(canal, coeur->attente_envoi, &jusqua);
+        if (!channel_ready(canal, coeur->attente_envoi) && interblocage(course)) {
+            atomic_store(&course->interblocage, 1);
+            atomic_store(&course->arret, 1);
+            break;
+        }
+    }
+    atomic_fetch_add(&course->changements, 1);
+    atomic_store(&ex->statut, COEUR_ACTIF);
+}
+
+static void *executer_coeur(void *arg) {
+    Execution *ex = arg;
+    Course *course = ex->course;
+    CPU *coeur = ex->coeur;
+    long avant = coeur->dispatchs;
+
+    while (coeur->etat == CPU_EN_COURS || coeur->etat == CPU_BUDGET_EPUISE || coeur->etat == CPU_BLOQUE) {
+        if (atomic_load_explicit(&course->arret, memory_order_relaxed) || echeance_passee(course->echeance)) break;
+        EtatCPU etat = cpu_run_for(coeur, MACHINE_TRANCHE);
+        if (etat == CPU_EN_FAUTE) atomic_store_explicit(&course->arret, 1, memory_order_relaxed);
+        if (etat == CPU_BLOQUE) garer(ex);
+    }
+    ex->dispatchs = coeur->dispatchs - avant;
+    atomic_store(&ex->statut, COEUR_SORTI);
+    return NULL;
+}
+
+static void remplir_bilan(const Machine *m, long dispatchs, double duree, int bloque, BilanMachine *bilan,
+                          int *fautes, int *actifs) {
+    int bloques = 0;
+    *fautes = 0;
+    *actifs = 0;
+    for (int i = 0; i < m->nb_coeurs; i++) {
+        if (m->coeurs[i]->etat == CPU_EN_FAUTE) (*fautes)++;
+        else if (m->coeurs[i]->etat != CPU_ARRETE) (*actifs)++;
+        if (m->coeurs[i]->etat == CPU_BLOQUE) bloques++;
+    }
+    if (bilan) {
+        memset(bilan, 0, sizeof(*bilan));
+        bilan->nb_coeurs = m->nb_coeurs;
+        bilan->nb_fautes = *fautes;
+        bilan->nb_actifs = *actifs;
+        bilan->nb_bloques = bloques;
+        bilan->interblocage = bloque;
+        bilan->dispatchs = dispatchs;
+        bilan->duree = duree;
+        if (duree > 0) bilan->dispatchs_par_seconde = dispatchs / duree;
+    }
+}
+
+int machine_run(Machine *m, const struct timespec *echeance, BilanMachine *bilan) {
+    if (!m) return -1;
+
+    Course course;
+    course.machine = m;
+    course.echeance = echeance;
+    atomic_init(&course.arret, 0);
+    atomic_init(&course.interblocage, 0);
+    atomic_init(&course.changements, 0);
+    Execution *executions = calloc((size_t)m->nb_coeurs, sizeof(Execution));
+    pthread_t *threads = malloc(sizeof(pthread_t) * (size_t)m->nb_coeurs);
+    if (!executions || !threads) {
+        free(executions);
+        free(threads);
+        return -1;
+    }
+
+    course.executions = executions;
+    double debut = maintenant();
+    int lances = 0;
+    for (int i = 0; i < m->nb_coeurs; i++) {
+        executions[i].course = &course;
+        executions[i].coeur = m->coeurs[i];
+        atomic_init(&executions[i].statut, COEUR_ACTIF);
+        atomic_init(&executions[i].canal, 0);
+        atomic_init(&executions[i].envoi, 0);
+    }
+    while (lances < m->nb_coeurs &&
+           pthread_create(&threads[lances], NULL, executer_coeur, &executions[lances]) == 0) lances++;
+    // Sans tous ses threads, la machine ne peut pas avancer (un cœur peut en attendre un autre)
+    if (lances < m->nb_coeurs) atomic_store(&course.arret, 1);
+    for (int t = 0; t < lances; t++) pthread_join(threads[t], NULL);
+    double duree = maintenant() - debut;
+
+    int fautes, actifs;
+    int bloque = atomic_load(&course.interblocage);
+    long dispatchs = 0;
+    for (int i = 0; i < m->nb_coeurs; i++) dispatchs += executions[i].dispatchs;
+    remplir_bilan(m, dispatchs, duree, bloque, bilan, &fautes, &actifs);
+
+    free(executions);
+    free(threads);
+    if (fautes > 0 || bloque || lances < m->nb_coeurs) return -1;
+    return actifs > 0 ? 1 : 0;
+}
+
+static int executable(const CPU *coeur) {
+    return coeur->etat == CPU_EN_COURS || coeur->etat == CPU_BUDGET_EPUISE;
+}
+
+// Point de synchronisation, exécuté par un seul thread pendant que les autres attendent
+static void synchroniser(Synchro *s) {
+    Machine *m = s->machine;
+    MemoryHandler *memoire = m->coeurs[0]->memory_handler;
+    s->tours++;
+
+    for (int i = 0; i < m->nb_coeurs; i++) journal_commit(s->journaux[i], memoire);
+
+    // Instructions en attente, hors journal : elles voient la mémoire à jour et la modifient
+    // directement. Un canal changé par un cœur profite aux cœurs suivants dès ce tour.
+    int progres = 0, fautes = 0, restants = 0, bloques = 0;
+    for (int i = 0; i < m->nb_coeurs; i++) {
+        CPU *coeur = m->coeurs[i];
+        if (coeur->etat == CPU_SYNCHRO || coeur->etat == CPU_BLOQUE) {
+            long avant = coeur->dispatchs;
+            coeur->journal = NULL;
+            cpu_run_for(coeur, 1);
+            coeur->journal = s->journaux[i];
+            if (coeur->dispatchs != avant) progres = 1;
+        }
+        if (coeur->etat == CPU_EN_FAUTE) fautes++;
+        else if (coeur->etat == CPU_BLOQUE) bloques++;
+        else if (executable(coeur)) restants++;
+    }
+
+    // Aucun cœur exécutable et aucun SEND / RECV passé : les canaux ne changeront plus
+    if (bloques > 0 && restants == 0 && !progres) s->interblocage = 1;
+    if (fautes > 0 || s->interblocage || restants + bloques == 0 || echeance_passee(s->echeance)) s->arret = 1;
+}
+
+static void *derouler_coeur(void *arg) {
+    Participant *p = arg;
+    Synchro *s = p->synchro;
+    CPU *coeur = s->machine->coeurs[p->numero];
+
+    pthread_mutex_lock(&s->verrou);
+    while (!s->partis) pthread_cond_wait(&s->depart, &s->verrou);
+    pthread_mutex_unlock(&s->verrou);
+    if (s->arret) return NULL;
+
+    for (;;) {
+        if (executable(coeur)) cpu_run_for(coeur, s->quantum);
+        if (pthread_barrier_wait(&s->barriere) == PTHREAD_BARRIER_SERIAL_THREAD) synchroniser(s);
+        pthread_barrier_wait(&s->barriere);
+        if (s->arret) break;
+    }
+    return NULL;
+}
+
+int machine_run_deterministic(Machine *m, long quantum, const struct timespec *echeance, BilanMachine *bilan) {
+    if (!m || quantum < 0) return -1;
+
+    Synchro s;
+    memset(&s, 0, sizeof(s));
+    s.machine = m;
+    s.quantum = quantum > 0 ? quantum : MACHINE_QUANTUM;
+    s.echeance = echeance;
+    s.journaux = calloc((size_t)m->nb_coeurs, sizeof(Journal *));
+    Participant *participants = malloc(sizeof(Participant) * (size_t)m->nb_coeurs);
+    pthread_t *threads = malloc(sizeof(pthread_t) * (size_t)m->nb_coeurs);
+    int pret = s.journaux && participants && threads;
+    for (int i = 0; pret && i < m->nb_coeurs; i++) pret = (s.journaux[i] = journal_create()) != NULL;
+    if (!pret || pthread_barrier_init(&s.barriere, NULL, (unsigned)m->nb_coeurs) != 0) {
+        for (int i = 0; s.journaux && i < m->nb_coeurs; i++) journal_destroy(s.journaux[i]);
+        free(s.journaux);
+        free(participants);
+        free(threads);
+        return -1;
+    }
+    pthread_mutex_init(&s.verrou, NULL);
+    pthread_cond_init(&s.depart, NULL);
+
+    long avant = 0;
+    for (int i = 0; i < m->nb_coeurs; i++) {
+        m->coeurs[i]->journal = s.journaux[i];
+        avant += m->coeurs[i]->dispatchs;
+    }
+
+    double debut = maintenant();
+    int lances = 0;
+    for (; lances < m->nb_coeurs; lances++) {
+        participants[lances].synchro = &s;
+        participants[lances].numero = lances;
+        if (pthread_create(&threads[lances], NULL, derouler_coeur, &participants[lances]) != 0) break;
+    }
+    // La barrière attend tous les cœurs : sans tous ses threads, aucun ne démarre
+    pthread_mutex_lock(&s.verrou);
+    if (lances < m->nb_coeurs) s.arret = 1;
+    s.partis = 1;
+    pthread_cond_broadcast(&s.depart);
+    pthread_mutex_unlock(&s.verrou);
+    for (int t = 0; t < lances; t++) pthread_join(threads[t], NULL);
+    double duree = maintenant() - debut;
+
+    long dispatchs = -avant;
+    for (int i = 0; i < m->nb_coeurs; i++) {
+        m->coeurs[i]->journal = NULL;
+        dispatchs += m->coeurs[i]->dispatchs;
+        journal_destroy(s.journaux[i]);
+    }
+    int fautes, actifs;
+    remplir_bilan(m, dispatchs, duree, s.interblocage, bilan, &fautes, &actifs);
+    if (bilan) bilan->tours = s.tours;
+
+    pthread_cond_destroy(&s.depart);
+    pthread_mutex_destroy(&s.verrou);
+    pthread_barrier_destroy(&s.barriere);
+    free(s.journaux);
+    free(participants);
+    free(threads);
+    if (fautes > 0 || s.interblocage || lances < m->nb_coeurs) return -1;
+    return actifs > 0 ? 1 : 0;
+}
+
+void machine_destroy(Machine *m) {
+    if (!m) return;
+    // La mémoire appartient au cœur 0 : il est détruit en dernier
+    for (int i = m->nb_coeurs - 1; i >= 0; i--) cpu_destroy(m->coeurs[i]);
+    free(m->coeurs);
+    for (int k = 0; k < m->nb_canaux; k++) channel_destroy(m->canaux[k]);
+    free(m->canaux);
+    pthread_mutex_destroy(&m->verrou_memoire);
+    free(m);
+}
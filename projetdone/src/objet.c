@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../include/objet.h"
+#include "../include/assembleur.h"
+#include "../include/optimiseur.h"
+
+// Arrondi au multiple de 8 supérieur
+static uint64_t aligner(uint64_t n) {
+    return (n + 7) & ~(uint64_t)7;
+}
+
+// Écrit `taille` octets puis complète avec des zéros jusqu'à l'alignement
+static int ecrire_section(FILE *f, const void *data, size_t taille) {
+    static const char zeros[8] = {0};
+    if (taille > 0 && fwrite(data, 1, taille, f) != taille) return -1;
+    size_t bourrage = aligner(taille) - taille;
+    if (bourrage > 0 && fwrite(zeros, 1, bourrage, f) != bourrage) return -1;
+    return 0;
+}
+
+int write_image(const Programme *prog, const char *path) {
+    if (!prog || !path) return -1;
+
+    ImageEntete entete;
+    memset(&entete, 0, sizeof(entete));
+    memcpy(entete.magic, IMAGE_MAGIC, sizeof(entete.magic));
+    entete.version = IMAGE_VERSION;
+    entete.endianness = IMAGE_ENDIAN_TAG;
+    entete.source_hash = prog->source_hash;
+    entete.code_count = prog->code_count;
+    entete.data_size = prog->data_size;
+    entete.valeur_count = prog->valeur_count;
+    entete.plage_count = prog->plage_count;
+    entete.label_count = prog->label_count;
+    entete.variable_count = prog->variable_count;
+
+    size_t taille_code = sizeof(InstructionDecodee) * prog->code_count;
+    size_t taille_valeurs = sizeof(int32_t) * prog->valeur_count;
+    size_t taille_plages = sizeof(PlageDonnees) * prog->plage_count;
+    size_t taille_labels = sizeof(Symbole) * prog->label_count;
+    size_t taille_variables = sizeof(Symbole) * prog->variable_count;
+
+    entete.code_offset = aligner(sizeof(ImageEntete));
+    entete.valeurs_offset = entete.code_offset + aligner(taille_code);
+    entete.plages_offset = entete.valeurs_offset + aligner(taille_valeurs);
+    entete.labels_offset = entete.plages_offset + aligner(taille_plages);
+    entete.variables_offset = entete.labels_offset + aligner(taille_labels);
+    entete.total_size = entete.variables_offset + aligner(taille_variables);
+
+    // Écriture dans un fichier temporaire puis renommage atomique
+    size_t len = strlen(path) + 16;
+    char *tmp = malloc(len);
+    if (!tmp) return -1;
+    snprintf(tmp, len, "%s.tmp%ld", path, (long)getpid());
+
+    FILE *f = fopen(tmp, "wb");
+    if (!f) {
+        perror("write_image: ouverture");
+        free(tmp);
+        return -1;
+    }
+
+    int rc = ecrire_section(f, &entete, sizeof(entete));
+    if (rc == 0) rc = ecrire_section(f, prog->code, taille_code);
+    if (rc == 0) rc = ecrire_section(f, prog->valeurs, taille_valeurs);
+    if (rc == 0) rc = ecrire_section(f, prog->plages, taille_plages);
+    if (rc == 0) rc = ecrire_section(f, prog->labels, taille_labels);
+    if (rc == 0) rc = ecrire_section(f, prog->variables, taille_variables);
+    if (fclose(f) != 0) rc = -1;
+
+    if (rc == 0 && rename(tmp, path) != 0) {
+        perror("write_image: renommage");
+        rc = -1;
+    }
+    if (rc != 0) unlink(tmp);
+    free(tmp);
+    return rc;
+}
+
+// Vérifie qu'une section [offset, offset + count * taille) tient dans l'image
+static int section_valide(uint64_t offset, uint64_t count, size_t taille, uint64_t total) {
+    if (offset % 8 != 0 || offset > total) return 0;
+    return count <= (total - offset) / taille;
+}
+
+// Vérifie qu'un opérande décodé ne désigne que des registres et segments existants
+static int operande_valide(const Operande *op) {
+    switch (op->mode) {
+        case MODE_AUCUN:
+        case MODE_IMMEDIAT:
+        case MODE_DIRECT:
+            return 1;
+        case MODE_REGISTRE:
+            return op->valeur >= REG_AX && op->valeur <= REG_DX;
+        case MODE_INDIRECT:
+            return op->valeur >= 0 && op->valeur < NB_REGISTRES;
+        case MODE_SEGMENT:
+            return op->valeur >= 0 && op->valeur < NB_REGISTRES &&
+                   op->segment >= 0 && op->segment < NB_SEGMENTS;
+        default:
+            return 0;
+    }
+}
+
+// Les plages doivent couvrir DS exactement, dans l'ordre, sans sortir des valeurs littérales
+static int plages_valides(const PlageDonnees *plages, uint32_t count, uint32_t valeur_count, uint32_t data_size) {
+    int64_t adresse = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const PlageDonnees *p = &plages[i];
+        if (p->adresse != adresse || p->longueur < 0) return 0;
+        if (p->indice >= 0 && (int64_t)p->indice + p->longueur > (int64_t)valeur_count) return 0;
+        adresse += p->longueur;
+    }
+    return adresse == (int64_t)data_size;
+}
+
+static int symboles_valides(const Symbole *table, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (memchr(table[i].nom, '\0', sizeof(table[i].nom)) == NULL) return 0;
+    }
+    return 1;
+}
+
+Programme *map_image(const char *path) {
+    if (!path) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ImageEntete)) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t taille = (size_t)st.st_size;
+    void *base = mmap(NULL, taille, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    const ImageEntete *entete = base;
+    const char *octets = base;
+
+    int valide = memcmp(entete->magic, IMAGE_MAGIC, sizeof(entete->magic)) == 0
+        && entete->version == IMAGE_VERSION
+        && entete->endianness == IMAGE_ENDIAN_TAG
+        && entete->total_size == taille
+        && entete->code_count <= INT32_MAX && entete->data_size <= INT32_MAX
+        && section_valide(entete->code_offset, entete->code_count, sizeof(InstructionDecodee), taille)
+        && section_valide(entete->valeurs_offset, entete->valeur_count, sizeof(int32_t), taille)
+        && section_valide(entete->plages_offset, entete->plage_count, sizeof(PlageDonnees), taille)
+        && section_valide(entete->labels_offset, entete->label_count, sizeof(Symbole), taille)
+        && section_valide(entete->variables_offset, entete->variable_count, sizeof(Symbole), taille);
+
+    const InstructionDecodee *code = (const InstructionDecodee *)(octets + (valide ? entete->code_offset : 0));
+    for (uint32_t i = 0; valide && i < entete->code_count; i++) {
+        valide = code[i].opcode > OPC_INVALIDE && code[i].opcode < NB_OPCODES
+              && superinstruction_valid(code, entete->code_count, i)
+              && operande_valide(&code[i].dest) && operande_valide(&code[i].src);
+    }
+
+    if (valide) {
+        valide = plages_valides((const PlageDonnees *)(octets + entete->plages_offset), entete->plage_count,
+                                entete->valeur_count, entete->data_size)
+              && symboles_valides((const Symbole *)(octets + entete->labels_offset), entete->label_count)
+              && symboles_valides((const Symbole *)(octets + entete->variables_offset), entete->variable_count);
+    }
+
+    Programme *prog = valide ? calloc(1, sizeof(Programme)) : NULL;
+    if (!prog) {
+        if (!valide) fprintf(stderr, "map_image: image '%s' invalide ou d'une autre version.\n", path);
+        munmap(base, taille);
+        return NULL;
+    }
+
+    prog->code = code;
+    prog->code_count = entete->code_count;
+    prog->valeurs = (const int32_t *)(octets + entete->valeurs_offset);
+    prog->valeur_count = entete->valeur_count;
+    prog->plages = (const PlageDonnees *)(octets + entete->plages_offset);
+    prog->plage_count = entete->plage_count;
+    prog->data_size = entete->data_size;
+    prog->labels = (const Symbole *)(octets + entete->labels_offset);
+    prog->label_count = entete->label_count;
+    prog->variables = (const Symbole *)(octets + entete->variables_offset);
+    prog->variable_count = entete->variable_count;
+    prog->source_hash = entete->source_hash;
+    prog->mapping = base;
+    prog->mapping_size = taille;
+    return prog;
+}
+
+int assemble_file(const char *source, const char *image) {
+    FILE *f = fopen(source, "r");
+    if (!f) {
+        perror("assemble_file: ouverture du source");
+        return -1;
+    }
+
+    // Assemblage incrémental : le source est lu par blocs, jamais en entier
+    Programme *prog = assemble_stream(f);
+    fclose(f);
+    if (!prog) return -1;
+
+    int rc = write_image(prog, image);
+    free_program(prog);
+    return rc;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/optimiseur.h"
+
+int superinstruction_for(int premier, int second) {
+    if (premier == OPC_CMP && second == OPC_JZ) return OPC_CMP_JZ;
+    if (premier == OPC_CMP && second == OPC_JNZ) return OPC_CMP_JNZ;
+    if (premier == OPC_MOV && second == OPC_ADD) return OPC_MOV_ADD;
+    if (premier == OPC_PUSH && second == OPC_POP) return OPC_PUSH_POP;
+    return OPC_INVALIDE;
+}
+
+// Opcodes d'origine d'une superinstruction (retourne 0 si ce n'en est pas une)
+static int moities(int opcode, int *premier, int *second) {
+    switch (opcode) {
+        case OPC_CMP_JZ:   *premier = OPC_CMP;  *second = OPC_JZ;  return 1;
+        case OPC_CMP_JNZ:  *premier = OPC_CMP;  *second = OPC_JNZ; return 1;
+        case OPC_MOV_ADD:  *premier = OPC_MOV;  *second = OPC_ADD; return 1;
+        case OPC_PUSH_POP: *premier = OPC_PUSH; *second = OPC_POP; return 1;
+        default:           return 0;
+    }
+}
+
+int superinstruction_first(int opcode) {
+    int premier, second;
+    return moities(opcode, &premier, &second) ? premier : opcode;
+}
+
+int superinstruction_valid(const InstructionDecodee *code, int32_t count, int32_t i) {
+    int premier, second;
+    if (!moities(code[i].opcode, &premier, &second)) return 1;
+    return i + 1 < count && code[i + 1].opcode == second;
+}
+
+int fuse_superinstructions(Programme *prog) {
+    if (!prog) return -1;
+
+    // Le code d'une image projetée est en lecture seule : on travaille sur une copie
+    InstructionDecodee *code = (InstructionDecodee *)prog->code;
+    if (prog->mapping && !prog->code_copie) {
+        code = malloc(sizeof(InstructionDecodee) * (prog->code_count > 0 ? prog->code_count : 1));
+        if (!code) return -1;
+        memcpy(code, prog->code, sizeof(InstructionDecodee) * prog->code_count);
+        prog->code_copie = code;
+        prog->code = code;
+    }
+
+    int fusions = 0;
+    for (int32_t i = 0; i + 1 < prog->code_count; i++) {
+        int super = superinstruction_for(code[i].opcode, code[i + 1].opcode);
+        if (super == OPC_INVALIDE) continue;
+        code[i].opcode = super;
+        fusions++;
+        i++;  // la seconde moitié ne commence pas une autre paire
+    }
+    return fusions;
+}
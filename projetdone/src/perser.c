@@ -1,41 +1,72 @@
 
 #include "../include/perser.h"
+#include "../include/dataSegment.h"
+#include "../include/expression.h"
 
 
 
-static int compteur = 0;
+// Compteur d'adresses de .DATA de parse() : propre à chaque thread, pour que deux threads
+// puissent parser en même temps (get_compteur_value lit celui du thread appelant)
+static _Thread_local int compteur = 0;
 Instruction *parse_data_instruction(const char *line, HashMap *memory_locations) {
-    Instruction *inst = malloc(sizeof(Instruction));
-    if (!inst) return NULL;
+    return parse_data_instruction_r(line, memory_locations, NULL, &compteur);
+}
 
+Instruction *parse_data_instruction_r(const char *line, HashMap *memory_locations, HashMap *constantes, int *compteur) {
     char var_name[100] = "", type[100] = "", value[255] = "";
-    int n = sscanf(line, "%99s %99s %[^\n]", var_name, type, value);
+    int n = sscanf(line, "%99s %99s %254[^\n]", var_name, type, value);
     if (n < 3) {
-        free(inst);
         return NULL;
     }
 
-    inst->mnemonic = strdup(var_name);
-    inst->operand1 = strdup(type);
-    inst->operand2 = strdup(value);
-
-    // On compte les éléments (séparés par des virgules)
-    int nb_elements = 0;
-    char *p = value;
-    while (*p) {
-        if (*p == ',') nb_elements++;
-        p++;
+    // Valeurs réduites une fois pour toutes : constantes remplacées, expressions calculées,
+    // répétitions N DUP(v) gardées compactes
+    char *valeurs = NULL;
+    int32_t nb_elements = 0;
+    int rc = fold_data_values(value, constantes, &valeurs, &nb_elements);
+    if (rc != 0) {
+        fprintf(stderr, "parse_data_instruction: %s dans '%s'\n", expression_error(rc), value);
+        return NULL;
     }
 
-    if (value[0] != '\0') nb_elements++; // au moins une valeur présente
+    // NOM EQU expression : constante d'assemblage, aucune case de DS
+    if (strcmp(type, "EQU") == 0) {
+        int32_t constante;
+        if (!constantes || register_index(var_name) >= 0 ||
+            eval_expression(valeurs, NULL, &constante) != 0) {
+            fprintf(stderr, "parse_data_instruction: constante '%s' invalide\n", var_name);
+            free(valeurs);
+            return NULL;
+        }
+        int *v = hashmap_get(constantes, var_name);
+        if (!v) {
+            v = malloc(sizeof(int));
+            if (!v || hashmap_insert(constantes, var_name, v) != 0) {
+                free(v);
+                free(valeurs);
+                return NULL;
+            }
+        }
+        *v = constante;
+    }
+
+    Instruction *inst = malloc(sizeof(Instruction));
+    if (!inst) {
+        free(valeurs);
+        return NULL;
+    }
+    inst->mnemonic = strdup(var_name);
+    inst->operand1 = strdup(type);
+    inst->operand2 = valeurs;
+    if (strcmp(type, "EQU") == 0) return inst;
 
     // On stocke l'adresse de la variable dans memory_locations
     int *addr = malloc(sizeof(int));
-    *addr = compteur;
+    *addr = *compteur;
     hashmap_insert(memory_locations, var_name, addr);
 
-    // On incrémente le compteur global d’adresses
-    compteur += nb_elements;
+    // On incrémente le compteur d’adresses (une répétition compte pour N cases)
+    *compteur += nb_elements;
 
     return inst;
 }
@@ -61,9 +92,11 @@ Instruction *parse_code_instruction(const char *line, HashMap *labels, int code_
     int n = 0;  // Variable pour stocker le nombre de champs lus
 
     /*** CAS 1 : LABEL + OPCODE + OPERANDE1,OPERANDE2 ***/
+    // Un label ne contient ni espace ni crochet : sinon le ':' est celui d'un opérande
+    // segment ([ES:BX]) et la ligne n'a pas de label
     n = sscanf(line, "%49[^:]: %49s %49[^,],%49s", label, opcode, operand1, operand2);
 
-    if (n == 4) {
+    if (n == 4 && !strpbrk(label, " \t[")) {
  
         int *value = malloc(sizeof(int));
         *value = code_count;
@@ -78,7 +111,7 @@ Instruction *parse_code_instruction(const char *line, HashMap *labels, int code_
 
     /*** CAS 2 : LABEL + OPCODE + OPERANDE1 (PAS DE DEUXIÈME OPERANDE) ***/
     n = sscanf(line, "%49[^:]: %49s %49s", label, opcode, operand1);
-    if (n == 3) {
+    if (n == 3 && !strpbrk(label, " \t[")) {
          int *value = malloc(sizeof(int));
         *value = code_count;
         hashmap_insert(labels, label, value);
@@ -125,12 +158,37 @@ if (strncmp(line, "FREE", 4) == 0) {
     inst->operand2 = NULL;
     return inst;
 }
+
+// Cas spéciaux PUSHA / POPA (tous les registres généraux, sans opérande)
+if (strncmp(line, "PUSHA", 5) == 0 || strncmp(line, "POPA", 4) == 0) {
+    inst->mnemonic = strdup(line[1] == 'U' ? "PUSHA" : "POPA");
+    inst->operand1 = NULL;
+    inst->operand2 = NULL;
+    return inst;
+}
+
+// Cas spécial MFENCE (barrière mémoire, sans opérande)
+if (strncmp(line, "MFENCE", 6) == 0) {
+    inst->mnemonic = strdup("MFENCE");
+    inst->operand1 = NULL;
+    inst->operand2 = NULL;
+    return inst;
+}
     /*** AUCUN FORMAT RECONNU : LIBÉRER LA MÉMOIRE ET RETOURNER NULL ***/
     free(inst);
     return NULL;
 }
 
 
+// Une instruction et ses chaînes (mnémonique et opérandes, NULL acceptés)
+static void liberer_instruction(Instruction *inst) {
+    if (!inst) return;
+    free(inst->mnemonic);
+    free(inst->operand1);
+    free(inst->operand2);
+    free(inst);
+}
+
 // Fonction parse
 ParserResult *parse(const char *filename) {
     FILE *file = fopen(filename, "r");
@@ -139,6 +197,9 @@ ParserResult *parse(const char *filename) {
         return NULL;
     }
 
+    // Nouveau fichier : les adresses de .DATA repartent de 0
+    compteur = 0;
+
     // Initialisation de ParserResult
     ParserResult *result = malloc(sizeof(ParserResult));
     result->data_instructions = NULL;
@@ -147,6 +208,7 @@ ParserResult *parse(const char *filename) {
     result->code_count = 0;
     result->labels = hashmap_create();
     result->memory_locations = hashmap_create();
+    result->constantes = hashmap_create();
 
     char line[256];
     int in_data_section = 0, in_code_section = 0;
@@ -172,8 +234,12 @@ ParserResult *parse(const char *filename) {
 
         // Traitement des instructions DATA
         if (in_data_section) {
-            Instruction *inst = parse_data_instruction(line, result->memory_locations);
-            if (inst) {
+            Instruction *inst = parse_data_instruction_r(line, result->memory_locations, result->constantes, &compteur);
+            if (inst && strcmp(inst->operand1, "EQU") == 0) {
+                // Constante déjà enregistrée : rien à placer dans DS
+                liberer_instruction(inst);
+            }
+            else if (inst) {
                 result->data_count++;
                 result->data_instructions = realloc(result->data_instructions, result->data_count * sizeof(Instruction *));
                 result->data_instructions[result->data_count - 1] = inst;
@@ -203,7 +269,7 @@ void free_parser_result(ParserResult *result) {
     // Free all .DATA instructions
     if (result->data_instructions) {
         for (int i = 0; i < result->data_count; i++) {
-            free(result->data_instructions[i]);  // Free each instruction
+            liberer_instruction(result->data_instructions[i]);  // Free each instruction
         }
         free(result->data_instructions);  // Free the array itself
     }
@@ -211,19 +277,21 @@ void free_parser_result(ParserResult *result) {
     // Free all .CODE instructions
     if (result->code_instructions) {
         for (int i = 0; i < result->code_count; i++) {
-            free(result->code_instructions[i]);  // Free each instruction
+            liberer_instruction(result->code_instructions[i]);  // Free each instruction
         }
         free(result->code_instructions);  // Free the array itself
     }
 
-    // Free the labels hash map if necessary
+    // Labels, adresses des variables et constantes EQU : les valeurs (int*) appartiennent
+    // aux tables
     if (result->labels) {
-        hashmap_destroy(result->labels);  // Assuming a proper function exists
+        hashmap_destroy_values(result->labels, free);
     }
-
-    // Free the memory locations hash map if necessary
     if (result->memory_locations) {
-        hashmap_destroy(result->memory_locations);  // Assuming a proper function exists
+        hashmap_destroy_values(result->memory_locations, free);
+    }
+    if (result->constantes) {
+        hashmap_destroy_values(result->constantes, free);
     }
 
     // Free the ParserResult structure itself
@@ -11,29 +11,20 @@
 int push_value(CPU *cpu, int value) {
     if (!cpu) return -1;
 
-    // 1) Récupérer SP et segment SS
-    int *sp = (int*)hashmap_get(cpu->context, "SP");
-    Segment *ss = (Segment*)hashmap_get(cpu->memory_handler->allocated, "SS");
-    if (!sp || !ss) return -1;
-
-    // 2) Vérifier overflow : SP ne doit pas descendre sous ss->start
-    if (*sp <= ss->start) {
-        // pile pleine
+    // 1) SP et bornes de SS : accès directs, sans passer par les tables
+    int *sp = cpu->registres[REG_SP];
+    MemoryHandler *handler = cpu->memory_handler;
+
+    // 2) Vérifier overflow : SP ne doit pas descendre sous le début de SS
+    if (*sp <= cpu->pile_debut || *sp > cpu->pile_fin) {
+        // pile pleine (ou SP hors de la pile)
         return -1;
     }
 
-    // 3) Décrémenter SP
+    // 3) Décrémenter SP puis écrire dans le mot contigu de la case
     (*sp)--;
-
-    // 4) Allouer et stocker la valeur
-    int *cell = malloc(sizeof(int));
-    if (!cell) {
-        // rollback SP
-        (*sp)++;
-        return -1;
-    }
-    *cell = value;
-    cpu->memory_handler->memory[*sp] = cell;
+    handler->mots[*sp] = value;
+    handler->memory[*sp] = &handler->mots[*sp];
 
     return 0;
 }
@@ -42,27 +33,62 @@ int push_value(CPU *cpu, int value) {
 int pop_value(CPU *cpu, int *dest) {
     if (!cpu || !dest) return -1;
 
-    // 1) Récupérer SP et segment SS
-    int *sp = (int*)hashmap_get(cpu->context, "SP");
-    Segment *ss = (Segment*)hashmap_get(cpu->memory_handler->allocated, "SS");
-    if (!sp || !ss) return -1;
+    // 1) SP et haut de SS
+    int *sp = cpu->registres[REG_SP];
+    MemoryHandler *handler = cpu->memory_handler;
 
-    // 2) Underflow : SP ne doit pas dépasser ss->start + ss->size
-    int stack_top = ss->start + ss->size;
-    if (*sp >= stack_top) {
-        // pile vide
+    // 2) Underflow : SP ne doit pas atteindre la fin de SS, ni sortir de SS par le bas
+    //    (SP modifié par le programme : POP lirait et viderait une case de DS ou d'un autre cœur)
+    if (*sp < cpu->pile_debut || *sp >= cpu->pile_fin) {
+        // pile vide (ou SP hors de la pile)
         return -1;
     }
 
     // 3) Lire la valeur
-    int *cell = (int*)cpu->memory_handler->memory[*sp];
+    int *cell = (int*)handler->memory[*sp];
     if (!cell) return -1;
     *dest = *cell;
 
-    // 4) Libérer la case et incrémenter SP
-    free(cell);
-    cpu->memory_handler->memory[*sp] = NULL;
+    // 4) Vider la case et incrémenter SP
+    memory_release_cell(handler, *sp);
     (*sp)++;
 
     return 0;
 }
+
+int push_all_registers(CPU *cpu) {
+    if (!cpu) return -1;
+
+    int *sp = cpu->registres[REG_SP];
+    MemoryHandler *handler = cpu->memory_handler;
+    if (*sp - 4 < cpu->pile_debut || *sp > cpu->pile_fin) return -1;
+
+    // AX est empilé en premier : il finit à l'adresse la plus haute
+    for (int k = 0; k < 4; k++) {
+        int adresse = *sp - 1 - k;
+        handler->mots[adresse] = *cpu->registres[REG_AX + k];
+        handler->memory[adresse] = &handler->mots[adresse];
+    }
+    *sp -= 4;
+    return 0;
+}
+
+int pop_all_registers(CPU *cpu) {
+    if (!cpu) return -1;
+
+    int *sp = cpu->registres[REG_SP];
+    MemoryHandler *handler = cpu->memory_handler;
+    if (*sp < cpu->pile_debut || *sp + 4 > cpu->pile_fin) return -1;
+    for (int k = 0; k < 4; k++) {
+        if (!handler->memory[*sp + k]) return -1;
+    }
+
+    // DX est au sommet, AX quatre cases plus haut
+    int base = *sp;
+    for (int k = 0; k < 4; k++) {
+        *cpu->registres[REG_DX - k] = *(int *)handler->memory[base + k];
+        memory_release_cell(handler, base + k);
+    }
+    *sp = base + 4;
+    return 0;
+}
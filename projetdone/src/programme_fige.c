@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "../include/programme_fige.h"
+
+struct programme_fige {
+    atomic_int references;
+    Programme vue;          // Tableaux dans `zone`, en lecture seule
+    void *zone;
+    size_t taille;
+};
+
+// Arrondi au multiple de 8 supérieur (mêmes sections que les images binaires)
+static size_t aligner(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+// Recopie `taille` octets à `*position` et avance ; retourne l'adresse de la copie
+static const void *deposer(char *zone, size_t *position, const void *data, size_t taille) {
+    char *copie = zone + *position;
+    if (taille > 0) memcpy(copie, data, taille);
+    *position += aligner(taille);
+    return copie;
+}
+
+ProgrammeFige *program_freeze(Programme *prog) {
+    if (!prog) return NULL;
+
+    size_t taille_code = sizeof(InstructionDecodee) * (size_t)prog->code_count;
+    size_t taille_valeurs = sizeof(int32_t) * (size_t)prog->valeur_count;
+    size_t taille_plages = sizeof(PlageDonnees) * (size_t)prog->plage_count;
+    size_t taille_labels = sizeof(Symbole) * (size_t)prog->label_count;
+    size_t taille_variables = sizeof(Symbole) * (size_t)prog->variable_count;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t taille = aligner(taille_code) + aligner(taille_valeurs) + aligner(taille_plages) +
+                    aligner(taille_labels) + aligner(taille_variables);
+    taille = (taille + page - 1) / page * page;
+    if (taille == 0) taille = page;
+
+    ProgrammeFige *fige = calloc(1, sizeof(ProgrammeFige));
+    char *zone = mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (!fige || zone == MAP_FAILED) {
+        fprintf(stderr, "program_freeze: allocation impossible.\n");
+        if (zone != MAP_FAILED) munmap(zone, taille);
+        free(fige);
+        free_program(prog);
+        return NULL;
+    }
+
+    size_t position = 0;
+    Programme *vue = &fige->vue;
+    vue->code = deposer(zone, &position, prog->code, taille_code);
+    vue->code_count = prog->code_count;
+    vue->valeurs = deposer(zone, &position, prog->valeurs, taille_valeurs);
+    vue->valeur_count = prog->valeur_count;
+    vue->plages = deposer(zone, &position, prog->plages, taille_plages);
+    vue->plage_count = prog->plage_count;
+    vue->data_size = prog->data_size;
+    vue->labels = deposer(zone, &position, prog->labels, taille_labels);
+    vue->label_count = prog->label_count;
+    vue->variables = deposer(zone, &position, prog->variables, taille_variables);
+    vue->variable_count = prog->variable_count;
+    vue->source_hash = prog->source_hash;
+    // Comme pour une image projetée : le contenu est en lecture seule
+    vue->mapping = zone;
+    vue->mapping_size = taille;
+    free_program(prog);
+
+    if (mprotect(zone, taille, PROT_READ) != 0) {
+        fprintf(stderr, "program_freeze: protection impossible.\n");
+        munmap(zone, taille);
+        free(fige);
+        return NULL;
+    }
+    fige->zone = zone;
+    fige->taille = taille;
+    atomic_init(&fige->references, 1);
+    return fige;
+}
+
+ProgrammeFige *frozen_acquire(ProgrammeFige *fige) {
+    if (fige) atomic_fetch_add_explicit(&fige->references, 1, memory_order_relaxed);
+    return fige;
+}
+
+void frozen_release(ProgrammeFige *fige) {
+    if (!fige) return;
+    // acq_rel : les lectures des autres détenteurs précèdent la libération
+    if (atomic_fetch_sub_explicit(&fige->references, 1, memory_order_acq_rel) != 1) return;
+    munmap(fige->zone, fige->taille);
+    free(fige);
+}
+
+const Programme *frozen_program(const ProgrammeFige *fige) {
+    return fige ? &fige->vue : NULL;
+}
+
+int frozen_references(const ProgrammeFige *fige) {
+    return fige ? atomic_load(&fige->references) : 0;
+}
+
+CPU *cpu_init_frozen(ProgrammeFige *fige) {
+    if (!fige) return NULL;
+    CPU *cpu = cpu_init(fige->vue.data_size + STACK_SIZE);
+    if (!cpu) return NULL;
+    if (load_program_data(cpu, &fige->vue) != 0) {
+        cpu_destroy(cpu);
+        return NULL;
+    }
+    cpu->fige = frozen_acquire(fige);
+    return cpu;
+}
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sched.h>
 
 #include "../include/th_generique.h"
 
@@ -9,15 +10,28 @@
 #define TOMBSTONE (( void *) -1)
 
 
-// Fonction de hachage simple : somme les valeurs ASCII des caractères
+// Fonction de hachage FNV-1a : bonne dispersion, y compris pour des noms proches
+// ("x", "xval", "x1"...), contrairement à une simple somme des caractères
 
 unsigned long simple_hash(const char *str) {
-    unsigned long hash = 0;
+    unsigned long hash = 14695981039346656037UL;
     while (*str != '\0') {
-        hash += (unsigned char)(*str);  
+        hash ^= (unsigned char)(*str);
+        hash *= 1099511628211UL;
         str++;
     }
-    return hash % TABLE_SIZE;
+    return hash;
+}
+
+// Alloue un tableau de `taille` entrées vides
+static HashEntry *creer_table(int taille) {
+    HashEntry *table = (HashEntry *)malloc(sizeof(HashEntry) * taille);
+    if (!table) return NULL;
+    for (int i = 0; i < taille; i++) {
+        table[i].key = NULL;
+        table[i].value = NULL;
+    }
+    return table;
 }
 
 
@@ -30,43 +44,69 @@ HashMap *hashmap_create() {
     }
 
     newHash->size = TABLE_SIZE;
+    newHash->count = 0;
 
-    // Allocation du tableau de HashEntry
-    newHash->table = (HashEntry *)malloc(sizeof(HashEntry) * TABLE_SIZE);
+    // Allocation du tableau de HashEntry (entrées initialisées à NULL)
+    newHash->table = creer_table(TABLE_SIZE);
     if (!newHash->table) {
         printf("Erreur d'allocation mémoire pour la table\n");
         free(newHash);
         return NULL;
     }
 
-    // Initialisation des entrées à NULL
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        newHash->table[i].key = NULL;
-        newHash->table[i].value = NULL;
+    return newHash;
+}
+
+// Double la taille de la table et réinsère les clés valides (les TOMBSTONE disparaissent)
+static int hashmap_resize(HashMap *map) {
+    int new_size = map->size * 2;
+    HashEntry *new_table = creer_table(new_size);
+    if (!new_table) return -1;
+
+    int count = 0;
+    for (int i = 0; i < map->size; i++) {
+        char *key = map->table[i].key;
+        if (key == NULL || key == TOMBSTONE) continue;
+
+        // Les clés sont déjà copiées : on déplace simplement l'entrée
+        unsigned long index = simple_hash(key) & (new_size - 1);
+        while (new_table[index].key != NULL) {
+            index = (index + 1) & (new_size - 1);
+        }
+        new_table[index] = map->table[i];
+        count++;
     }
 
-    return newHash;
+    free(map->table);
+    map->table = new_table;
+    map->size = new_size;
+    map->count = count;
+    return 0;
 }
 
 int hashmap_insert(HashMap *map, const char *key, void *value) {
    
     if (!map || !key) return -1;  // Vérification des paramètres
 
-    unsigned long index = simple_hash(key);
+    // Garder un taux de remplissage < 1/2 : le probing reste court et la boucle se termine
+    if (2 * (map->count + 1) > map->size && hashmap_resize(map) != 0) return -1;
+
+    unsigned long index = simple_hash(key) & (map->size - 1);
     
     int tombstone_index = -1;  // Index du premier TOMBSTONE trouvé
 
     // Recherche d'un emplacement libre ou d'un TOMBSTONE
     while (map->table[index].key != NULL) {
-        if (map->table[index].key == TOMBSTONE && tombstone_index == -1) {
-            tombstone_index = index;  // Mémorise le premier TOMBSTONE trouvé
-        }
-        if (strcmp(map->table[index].key, key) == 0) {
+        if (map->table[index].key == TOMBSTONE) {
+            if (tombstone_index == -1) {
+                tombstone_index = index;  // Mémorise le premier TOMBSTONE trouvé
+            }
+        } else if (strcmp(map->table[index].key, key) == 0) {
             // Mise à jour de la valeur si la clé existe déjà
             map->table[index].value = value;
             return 0;
         }
-        index = (index + 1) % map->size;  // Probing linéaire
+        index = (index + 1) & (map->size - 1);  // Probing linéaire
     }
 
     // Si on a trouvé un TOMBSTONE, on l’utilise pour insérer l’élément
@@ -75,10 +115,12 @@ int hashmap_insert(HashMap *map, const char *key, void *value) {
     }
 
     // Insérer la nouvelle clé et la valeur
-    map->table[index].key = strdup(key);
+    char *copie = strdup(key);
     
     // Copier la clé pour éviter une perte de mémoire
-    if (!map->table[index].key) return -1; // Vérification de `strdup`
+    if (!copie) return -1; // Vérification de `strdup`
+    if (tombstone_index == -1) map->count++;  // Un TOMBSTONE réutilisé était déjà compté
+    map->table[index].key = copie;
     map->table[index].value = value;
 
     return 0;  // Succès
@@ -88,7 +130,7 @@ void *hashmap_get(HashMap *map, const char *key) {
     
     if (!map || !key) return NULL;  // Vérification des paramètres
 
-    unsigned long index = simple_hash(key);
+    unsigned long index = simple_hash(key) & (map->size - 1);
     
     while (map->table[index].key != NULL) {
        
@@ -98,14 +140,14 @@ void *hashmap_get(HashMap *map, const char *key) {
            
             return map->table[index].value;  // Clé trouvée, renvoyer la valeur associée
         }
-        index = (index + 1) % map->size;  // Probing linéaire
+        index = (index + 1) & (map->size - 1);  // Probing linéaire
     }
 
     return NULL;  // Clé non trouvée
 }
 int hashmap_remove(HashMap *map, const char *key) {
     if (!map || !key) return -1;  // Vérification des paramètres    
-    unsigned long index = simple_hash(key);
+    unsigned long index = simple_hash(key) & (map->size - 1);
     while (map->table[index].key != NULL) {
         if (map->table[index].key != TOMBSTONE && strcmp(map->table[index].key, key) == 0) {
      
@@ -115,11 +157,20 @@ int hashmap_remove(HashMap *map, const char *key) {
      map->table[index].value = NULL;
      return 0;
     }
+        index = (index + 1) & (map->size - 1);  // Probing linéaire
     }
     return -1;
 }
 
 
+void hashmap_destroy_values(HashMap *map, void (*free_value)(void *)) {
+    if (!map) return;
+    for (int i = 0; i < map->size; i++) {
+        if (map->table[i].key != NULL && map->table[i].key != TOMBSTONE) free_value(map->table[i].value);
+    }
+    hashmap_destroy(map);
+}
+
 void hashmap_destroy(HashMap *map) {
     if (!map) return;  // Vérification du pointeur
 
@@ -134,4 +185,203 @@ void hashmap_destroy(HashMap *map) {
     free(map);         // Libérer la structure de la hashmap
 }
 
+// -----------------------------------
+// Variante concurrente
+// -----------------------------------
+
+// Bande de compteurs du thread courant, attribuée à sa première lecture
+static _Thread_local int bande_courante = -1;
+static atomic_int prochaine_bande;
+
+static TableConcurrente *creer_table_concurrente(int taille) {
+    TableConcurrente *table = malloc(sizeof(TableConcurrente) + sizeof(table->cases[0]) * taille);
+    if (!table) return NULL;
+    table->size = taille;
+    table->count = 0;
+    for (int i = 0; i < taille; i++) atomic_init(&table->cases[i], NULL);
+    return table;
+}
+
+HashMapConcurrente *concurrent_hashmap_create(void) {
+    HashMapConcurrente *map = aligned_alloc(_Alignof(HashMapConcurrente), sizeof(HashMapConcurrente));
+    if (!map) {
+        printf("Erreur d'allocation mémoire pour HashMapConcurrente\n");
+        return NULL;
+    }
+    TableConcurrente *table = creer_table_concurrente(TABLE_SIZE);
+    if (!table) {
+        printf("Erreur d'allocation mémoire pour la table\n");
+        free(map);
+        return NULL;
+    }
+    atomic_init(&map->table, table);
+    atomic_init(&map->phase, 0);
+    atomic_init(&map->nb_cles, 0);
+    pthread_mutex_init(&map->verrou, NULL);
+    for (int b = 0; b < BANDES_LECTEURS; b++) {
+        atomic_init(&map->lecteurs[b].actifs[0], 0);
+        atomic_init(&map->lecteurs[b].actifs[1], 0);
+    }
+    return map;
+}
+
+// Entrée dans une section de lecture : le compteur incrémenté doit être rendu à `sortir`.
+// Les opérations sont séquentiellement cohérentes : un lecteur inscrit après le contrôle
+// d'`attendre_lecteurs` voit forcément la table publiée avant ce contrôle.
+static atomic_long *entrer(HashMapConcurrente *map) {
+    if (bande_courante < 0) bande_courante = atomic_fetch_add(&prochaine_bande, 1) % BANDES_LECTEURS;
+    atomic_long *compteur = &map->lecteurs[bande_courante].actifs[atomic_load(&map->phase)];
+    atomic_fetch_add(compteur, 1);
+    return compteur;
+}
+
+static void sortir(atomic_long *compteur) {
+    atomic_fetch_sub(compteur, 1);
+}
+
+// Période de grâce (écrivain, verrou tenu) : au retour, aucun lecteur ne tient plus ce qui a
+// été retiré de la table avant l'appel. Les nouveaux lecteurs sont envoyés sur l'autre phase
+// avant d'attendre la première ; deux tours couvrent un lecteur qui a lu la phase juste
+// avant l'inversion et ne s'est inscrit qu'après.
+static void attendre_lecteurs(HashMapConcurrente *map) {
+    for (int tour = 0; tour < 2; tour++) {
+        int ancienne = atomic_load(&map->phase);
+        atomic_store(&map->phase, ancienne ^ 1);
+        for (int b = 0; b < BANDES_LECTEURS; b++) {
+            while (atomic_load(&map->lecteurs[b].actifs[ancienne]) != 0) sched_yield();
+        }
+    }
+}
+
+// Case de `key` dans `table`, ou -1 (écrivain seulement)
+static int chercher_case(TableConcurrente *table, const char *key, unsigned long hash) {
+    unsigned long index = hash & (table->size - 1);
+    EntreeConcurrente *e;
+    while ((e = atomic_load_explicit(&table->cases[index], memory_order_relaxed)) != NULL) {
+        if (e != TOMBSTONE && e->hash == hash && strcmp(e->key, key) == 0) return (int)index;
+        index = (index + 1) & (table->size - 1);
+    }
+    return -1;
+}
+
+// Reconstruit la table à côté (plus grande si besoin, sans TOMBSTONE) puis la publie : les
+// entrées sont reprises telles quelles, seule l'ancienne table est libérée
+static int agrandir(HashMapConcurrente *map, TableConcurrente *ancienne) {
+    int cles = atomic_load_explicit(&map->nb_cles, memory_order_relaxed);
+    int taille = 4 * (cles + 1) > ancienne->size ? ancienne->size * 2 : ancienne->size;
+    TableConcurrente *table = creer_table_concurrente(taille);
+    if (!table) return -1;
+    for (int i = 0; i < ancienne->size; i++) {
+        EntreeConcurrente *e = atomic_load_explicit(&ancienne->cases[i], memory_order_relaxed);
+        if (e == NULL || e == TOMBSTONE) continue;
+        unsigned long index = e->hash & (taille - 1);
+        while (atomic_load_explicit(&table->cases[index], memory_order_relaxed) != NULL) {
+            index = (index + 1) & (taille - 1);
+        }
+        atomic_store_explicit(&table->cases[index], e, memory_order_relaxed);
+        table->count++;
+    }
+    atomic_store(&map->table, table);
+    attendre_lecteurs(map);
+    free(ancienne);
+    return 0;
+}
+
+int concurrent_hashmap_insert(HashMapConcurrente *map, const char *key, void *value) {
+    if (!map || !key) return -1;
+    unsigned long hash = simple_hash(key);
+    int statut = -1;
+
+    pthread_mutex_lock(&map->verrou);
+    TableConcurrente *table = atomic_load_explicit(&map->table, memory_order_relaxed);
+    int trouvee = chercher_case(table, key, hash);
+    if (trouvee >= 0) {
+        EntreeConcurrente *e = atomic_load_explicit(&table->cases[trouvee], memory_order_relaxed);
+        atomic_store_explicit(&e->value, value, memory_order_release);
+        statut = 0;
+    } else {
+        // Même taux de remplissage que HashMap : moins de la moitié des cases occupées
+        if (2 * (table->count + 1) > table->size) {
+            if (agrandir(map, table) != 0) goto fin;
+            table = atomic_load_explicit(&map->table, memory_order_relaxed);
+        }
+        size_t longueur = strlen(key) + 1;
+        EntreeConcurrente *e = malloc(sizeof(EntreeConcurrente) + longueur);
+        if (!e) goto fin;
+        e->hash = hash;
+        atomic_init(&e->value, value);
+        memcpy(e->key, key, longueur);
+
+        // Une case NULL seulement : réutiliser un TOMBSTONE couperait la chaîne d'un lecteur
+        // qui le franchit en ce moment ; les TOMBSTONE disparaissent à la reconstruction
+        unsigned long index = hash & (table->size - 1);
+        while (atomic_load_explicit(&table->cases[index], memory_order_relaxed) != NULL) {
+            index = (index + 1) & (table->size - 1);
+        }
+        table->count++;
+        atomic_fetch_add_explicit(&map->nb_cles, 1, memory_order_relaxed);
+        // release : l'entrée est entièrement écrite avant d'être visible
+        atomic_store_explicit(&table->cases[index], e, memory_order_release);
+        statut = 0;
+    }
+fin:
+    pthread_mutex_unlock(&map->verrou);
+    return statut;
+}
+
+void *concurrent_hashmap_get(HashMapConcurrente *map, const char *key) {
+    if (!map || !key) return NULL;
+    unsigned long hash = simple_hash(key);
+    void *value = NULL;
+
+    atomic_long *compteur = entrer(map);
+    TableConcurrente *table = atomic_load(&map->table);
+    unsigned long index = hash & (table->size - 1);
+    EntreeConcurrente *e;
+    while ((e = atomic_load_explicit(&table->cases[index], memory_order_acquire)) != NULL) {
+        if (e != TOMBSTONE && e->hash == hash && strcmp(e->key, key) == 0) {
+            value = atomic_load_explicit(&e->value, memory_order_acquire);
+            break;
+        }
+        index = (index + 1) & (table->size - 1);
+    }
+    sortir(compteur);
+    return value;
+}
+
+int concurrent_hashmap_remove(HashMapConcurrente *map, const char *key) {
+    if (!map || !key) return -1;
+    unsigned long hash = simple_hash(key);
+    int statut = -1;
+
+    pthread_mutex_lock(&map->verrou);
+    TableConcurrente *table = atomic_load_explicit(&map->table, memory_order_relaxed);
+    int trouvee = chercher_case(table, key, hash);
+    if (trouvee >= 0) {
+        EntreeConcurrente *e = atomic_load_explicit(&table->cases[trouvee], memory_order_relaxed);
+        // La case reste occupée (TOMBSTONE) : les chaînes de sondage ne sont pas coupées
+        atomic_store(&table->cases[trouvee], TOMBSTONE);
+        atomic_fetch_sub_explicit(&map->nb_cles, 1, memory_order_relaxed);
+        attendre_lecteurs(map);
+        free(e);
+        statut = 0;
+    }
+    pthread_mutex_unlock(&map->verrou);
+    return statut;
+}
+
+int concurrent_hashmap_count(HashMapConcurrente *map) {
+    return map ? atomic_load_explicit(&map->nb_cles, memory_order_relaxed) : 0;
+}
 
+void concurrent_hashmap_destroy(HashMapConcurrente *map) {
+    if (!map) return;
+    TableConcurrente *table = atomic_load(&map->table);
+    for (int i = 0; i < table->size; i++) {
+        EntreeConcurrente *e = atomic_load_explicit(&table->cases[i], memory_order_relaxed);
+        if (e != NULL && e != TOMBSTONE) free(e);
+    }
+    free(table);
+    pthread_mutex_destroy(&map->verrou);
+    free(map);
+}
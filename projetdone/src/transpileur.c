@@ -0,0 +1,704 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../include/transpileur.h"
+#include "../include/optimiseur.h"
+
+// Variables locales du programme généré, indexées par IndexRegistre
+static const char *const REGISTRES_C[NB_REGISTRES] = {
+    "ax", "bx", "cx", "dx", "ip", "zf", "sf", "es", "sp", "bp"
+};
+
+typedef enum {
+    OPC_C_ABSENT,   // ne désigne rien : l'instruction est sans effet (ou échoue)
+    OPC_C_VALEUR,   // expression C toujours valide (littéral, registre, mem[n])
+    OPC_C_CELLULE   // expression de type int * qui peut valoir NULL
+} GenreOperandeC;
+
+typedef struct {
+    GenreOperandeC genre;
+    int modifiable;       // VALEUR utilisable à gauche d'une affectation
+    char texte[96];
+} OperandeC;
+
+typedef struct {
+    FILE *out;
+    const Programme *prog;
+    int memory_size;
+    int ds_statique;      // aucune case de DS ne peut être libérée : accès direct à mem[n]
+    uint8_t *cible;       // label L_<i> nécessaire
+    int repartir;         // le switch sur IP est utilisé
+    int echec;            // le chemin d'échec est utilisé
+    int blocs;            // instructions de bloc présentes : fonction plage() émise
+} Traduction;
+
+static void entier_c(char *buf, size_t taille, int32_t v) {
+    if (v == INT32_MIN) snprintf(buf, taille, "(-2147483647 - 1)");
+    else snprintf(buf, taille, "%d", v);
+}
+
+static int reference_registre(const Operande *op, int reg) {
+    return (op->mode == MODE_REGISTRE || op->mode == MODE_INDIRECT || op->mode == MODE_SEGMENT) &&
+           op->valeur == reg;
+}
+
+static int instruction_reference(const InstructionDecodee *instr, int reg) {
+    return reference_registre(&instr->dest, reg) || reference_registre(&instr->src, reg);
+}
+
+// Traduit un opérande en expression C, avec la même résolution que operande_cellule
+static void traduire_operande(const Traduction *t, const Operande *op, OperandeC *o) {
+    memset(o, 0, sizeof(*o));
+    o->genre = OPC_C_ABSENT;
+    const Programme *prog = t->prog;
+
+    switch (op->mode) {
+        case MODE_IMMEDIAT:
+            o->genre = OPC_C_VALEUR;
+            entier_c(o->texte, sizeof(o->texte), op->valeur);
+            break;
+
+        case MODE_REGISTRE:
+        case MODE_INDIRECT:
+            if (op->valeur < 0 || op->valeur >= NB_REGISTRES) break;
+            o->genre = OPC_C_VALEUR;
+            o->modifiable = 1;
+            snprintf(o->texte, sizeof(o->texte), "%s", REGISTRES_C[op->valeur]);
+            break;
+
+        case MODE_DIRECT:
+            if (op->valeur < 0 || op->valeur >= t->memory_size) break;
+            if (t->ds_statique && op->valeur < prog->data_size) {
+                o->genre = OPC_C_VALEUR;
+                o->modifiable = 1;
+                snprintf(o->texte, sizeof(o->texte), "mem[%d]", op->valeur);
+            } else {
+                o->genre = OPC_C_CELLULE;
+                snprintf(o->texte, sizeof(o->texte), "cellule(%d)", op->valeur);
+            }
+            break;
+
+        case MODE_SEGMENT: {
+            if (op->valeur < 0 || op->valeur >= NB_REGISTRES) break;
+            const char *reg = REGISTRES_C[op->valeur];
+            switch (op->segment) {
+                case SEG_DS:
+                    if (prog->data_size <= 0) break;
+                    o->genre = OPC_C_CELLULE;
+                    snprintf(o->texte, sizeof(o->texte), "cellule_segment(0, %d, %s)", prog->data_size, reg);
+                    break;
+                case SEG_SS:
+                    o->genre = OPC_C_CELLULE;
+                    snprintf(o->texte, sizeof(o->texte), "cellule_segment(PILE_DEBUT, TAILLE_PILE, %s)", reg);
+                    break;
+                case SEG_ES:
+                    o->genre = OPC_C_CELLULE;
+                    snprintf(o->texte, sizeof(o->texte),
+                             "(es_alloue ? cellule_segment(es_debut, es_taille, %s) : NULL)", reg);
+                    break;
+                default:
+                    break;  // les cases de CS ne contiennent pas de données
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+static int est_modifiable(const OperandeC *o) {
+    return o->genre == OPC_C_CELLULE || (o->genre == OPC_C_VALEUR && o->modifiable);
+}
+
+// Déclaration, condition de présence et expression d'accès d'un opérande
+typedef struct {
+    char decl[128];
+    char cond[8];
+    char expr[112];
+} AccesC;
+
+static void preparer(const OperandeC *o, const char *nom, AccesC *a) {
+    a->decl[0] = a->cond[0] = '\0';
+    if (o->genre == OPC_C_CELLULE) {
+        snprintf(a->decl, sizeof(a->decl), "int *%s = %s; ", nom, o->texte);
+        snprintf(a->cond, sizeof(a->cond), "%s", nom);
+        snprintf(a->expr, sizeof(a->expr), "*%s", nom);
+    } else {
+        snprintf(a->expr, sizeof(a->expr), "%s", o->texte);
+    }
+}
+
+static const char *condition(const AccesC *a, const AccesC *b, char *buf, size_t taille) {
+    if (a->cond[0] && b->cond[0]) snprintf(buf, taille, "%s && %s", a->cond, b->cond);
+    else snprintf(buf, taille, "%s", a->cond[0] ? a->cond : b->cond);
+    return buf;
+}
+
+// Continuer à l'instruction `cible` connue à la traduction
+static void aller_a(const Traduction *t, int32_t cible, char *buf, size_t taille) {
+    if (cible >= 0 && cible < t->prog->code_count) snprintf(buf, taille, "goto L_%d;", cible);
+    else snprintf(buf, taille, "{ ip = %d; goto fin; }", cible);
+}
+
+// MOV (ajouter == 0) ou ADD
+static void traduire_affectation(Traduction *t, const InstructionDecodee *instr, int ajouter) {
+    OperandeC d, s;
+    traduire_operande(t, &instr->dest, &d);
+    traduire_operande(t, &instr->src, &s);
+    if (!est_modifiable(&d) || s.genre == OPC_C_ABSENT) {
+        fprintf(t->out, "    ;\n");
+        return;
+    }
+
+    AccesC ad, as;
+    char valeur[256], cond[24];
+    preparer(&d, "d", &ad);
+    preparer(&s, "s", &as);
+    if (ajouter) snprintf(valeur, sizeof(valeur), "(int)((unsigned)%s + (unsigned)%s)", ad.expr, as.expr);
+    else snprintf(valeur, sizeof(valeur), "%s", as.expr);
+
+    if (d.genre == OPC_C_VALEUR && s.genre == OPC_C_VALEUR) {
+        fprintf(t->out, "    %s = %s;\n", ad.expr, valeur);
+    } else {
+        fprintf(t->out, "    { %s%sif (%s) %s = %s; }\n",
+                ad.decl, as.decl, condition(&ad, &as, cond, sizeof(cond)), ad.expr, valeur);
+    }
+}
+
+// CMP : seule instruction qui écrit ZF et SF
+static void traduire_comparaison(Traduction *t, const InstructionDecodee *instr) {
+    OperandeC a, b;
+    traduire_operande(t, &instr->dest, &a);
+    traduire_operande(t, &instr->src, &b);
+    if (a.genre == OPC_C_ABSENT || b.genre == OPC_C_ABSENT) {
+        fprintf(t->out, "    ;\n");
+        return;
+    }
+
+    AccesC aa, ab;
+    char cond[24];
+    preparer(&a, "a", &aa);
+    preparer(&b, "b", &ab);
+    if (a.genre == OPC_C_VALEUR && b.genre == OPC_C_VALEUR) {
+        fprintf(t->out, "    { int diff = (int)((unsigned)%s - (unsigned)%s); zf = diff == 0; sf = diff < 0; }\n",
+                aa.expr, ab.expr);
+    } else {
+        fprintf(t->out, "    { %s%sif (%s) { int diff = (int)((unsigned)%s - (unsigned)%s); zf = diff == 0; sf = diff < 0; } }\n",
+                aa.decl, ab.decl, condition(&aa, &ab, cond, sizeof(cond)), aa.expr, ab.expr);
+    }
+}
+
+// JMP (condition NULL), JZ ou JNZ ; une cible illisible est une erreur pour JZ/JNZ seulement
+static void traduire_saut(Traduction *t, int32_t i, const InstructionDecodee *instr, const char *cond) {
+    char corps[256];
+    OperandeC o;
+    traduire_operande(t, &instr->dest, &o);
+
+    if (instr->dest.mode == MODE_IMMEDIAT) {
+        aller_a(t, instr->dest.valeur, corps, sizeof(corps));
+    } else if (o.genre == OPC_C_VALEUR) {
+        snprintf(corps, sizeof(corps), "{ ip = %s; goto repartir; }", o.texte);
+        t->repartir = 1;
+    } else if (o.genre == OPC_C_CELLULE) {
+        if (cond) {
+            snprintf(corps, sizeof(corps), "{ int *c = %s; if (!c) { ip = %d; goto echec; } ip = *c; goto repartir; }",
+                     o.texte, i + 1);
+            t->echec = 1;
+        } else {
+            snprintf(corps, sizeof(corps), "{ int *c = %s; if (c) { ip = *c; goto repartir; } }", o.texte);
+        }
+        t->repartir = 1;
+    } else if (cond) {
+        snprintf(corps, sizeof(corps), "{ ip = %d; goto echec; }", i + 1);
+        t->echec = 1;
+    } else {
+        fprintf(t->out, "    ;\n");
+        return;
+    }
+
+    if (cond) fprintf(t->out, "    if (%s) %s\n", cond, corps);
+    else fprintf(t->out, "    %s\n", corps);
+}
+
+// PUSH : valeur lue avant de toucher SP (PUSH SP empile l'ancienne valeur)
+static void traduire_push(Traduction *t, int32_t i, const InstructionDecodee *instr) {
+    char valeur[192];
+    OperandeC o;
+    if (instr->dest.mode == MODE_AUCUN) {
+        snprintf(valeur, sizeof(valeur), "int v = ax; ");
+    } else {
+        traduire_operande(t, &instr->dest, &o);
+        if (o.genre == OPC_C_ABSENT) {
+            fprintf(t->out, "    ip = %d; goto echec;\n", i + 1);
+            t->echec = 1;
+            return;
+        }
+        if (o.genre == OPC_C_VALEUR) {
+            snprintf(valeur, sizeof(valeur), "int v = %s; ", o.texte);
+        } else {
+            snprintf(valeur, sizeof(valeur), "int *c = %s; if (!c) { ip = %d; goto echec; } int v = *c; ",
+                     o.texte, i + 1);
+            t->echec = 1;
+        }
+    }
+    fprintf(t->out, "    { %sif (sp > PILE_DEBUT && sp <= TAILLE) { sp--; mem[sp] = v; present[sp] = 1; } }\n",
+            valeur);
+}
+
+// POP : comme pop_value, la case libérée est celle désignée par SP après l'écriture
+static void traduire_pop(Traduction *t, int32_t i, const InstructionDecodee *instr) {
+    OperandeC o;
+    AccesC a;
+    if (instr->dest.mode == MODE_AUCUN) {
+        o.genre = OPC_C_VALEUR;
+        o.modifiable = 1;
+        snprintf(o.texte, sizeof(o.texte), "ax");
+    } else {
+        traduire_operande(t, &instr->dest, &o);
+    }
+    if (!est_modifiable(&o)) {
+        fprintf(t->out, "    ip = %d; goto echec;\n", i + 1);
+        t->echec = 1;
+        return;
+    }
+
+    preparer(&o, "d", &a);
+    if (o.genre == OPC_C_CELLULE) {
+        fprintf(t->out, "    { %sif (!d) { ip = %d; goto echec; }", a.decl, i + 1);
+        t->echec = 1;
+    } else {
+        fprintf(t->out, "    {");
+    }
+    fprintf(t->out, " if (sp >= PILE_DEBUT && sp < TAILLE && present[sp]) { %s = mem[sp]; liberer(sp); sp++; } }\n", a.expr);
+}
+
+// Plage de `n` cases d'un opérande d'instruction de bloc, comme operande_plage : expression de
+// type int * qui vaut NULL si la plage sort de son segment ou contient une case vide
+static void traduire_plage(const Traduction *t, const Operande *op, const char *n, char *buf, size_t taille) {
+    snprintf(buf, taille, "NULL");
+    if (op->mode == MODE_SEGMENT) {
+        if (op->valeur < 0 || op->valeur >= NB_REGISTRES) return;
+        const char *reg = REGISTRES_C[op->valeur];
+        switch (op->segment) {
+            case SEG_DS:
+                if (t->prog->data_size > 0) snprintf(buf, taille, "plage(0, DS_TAILLE, %s, %s)", reg, n);
+                break;
+            case SEG_SS:
+                snprintf(buf, taille, "plage(PILE_DEBUT, TAILLE_PILE, %s, %s)", reg, n);
+                break;
+            case SEG_ES:
+                snprintf(buf, taille, "(es_alloue ? plage(es_debut, es_taille, %s, %s) : NULL)", reg, n);
+                break;
+            default:
+                break;
+        }
+    } else if (op->mode == MODE_DIRECT) {
+        int32_t a = op->valeur;
+        if (a < 0 || a >= t->memory_size) return;
+        if (a < t->prog->data_size) {
+            snprintf(buf, taille, "plage(0, DS_TAILLE, %d, %s)", a, n);
+        } else if (a >= t->memory_size - STACK_SIZE) {
+            snprintf(buf, taille, "plage(PILE_DEBUT, TAILLE_PILE, %d - PILE_DEBUT, %s)", a, n);
+        } else {
+            snprintf(buf, taille,
+                     "(es_alloue && %d >= es_debut && %d < es_debut + es_taille ? plage(es_debut, es_taille, %d - es_debut, %s) : NULL)",
+                     a, a, a, n);
+        }
+    }
+}
+
+// MOVS / STOS / CMPS sur CX cases
+static void traduire_bloc(Traduction *t, const InstructionDecodee *instr) {
+    char dest[192], src[192];
+    traduire_plage(t, &instr->dest, "n", dest, sizeof(dest));
+
+    if (instr->opcode == OPC_STOS) {
+        // La valeur est lue une fois, avant le remplissage
+        OperandeC o;
+        AccesC a;
+        traduire_operande(t, &instr->src, &o);
+        if (o.genre == OPC_C_ABSENT) {
+            fprintf(t->out, "    ;\n");
+            return;
+        }
+        preparer(&o, "v", &a);
+        fprintf(t->out, "    { int n = cx; %sif (n > 0%s%s) { int x = %s; int *d = %s; if (d) for (int k = 0; k < n; k++) d[k] = x; } }\n",
+                a.decl, a.cond[0] ? " && " : "", a.cond, a.expr, dest);
+        return;
+    }
+
+    traduire_plage(t, &instr->src, "n", src, sizeof(src));
+    if (instr->opcode == OPC_MOVS) {
+        fprintf(t->out, "    { int n = cx; if (n > 0) { int *d = %s; int *s = %s; if (d && s) memmove(d, s, sizeof(int) * (size_t)n); } }\n",
+                dest, src);
+    } else {
+        fprintf(t->out,
+                "    { int n = cx; if (n > 0) { int *a = %s; int *b = %s; if (a && b) {\n"
+                "        int k = 0; while (k < n - 1 && a[k] == b[k]) k++;\n"
+                "        int diff = (int)((unsigned)a[k] - (unsigned)b[k]); zf = diff == 0; sf = diff < 0; } } }\n",
+                dest, src);
+    }
+}
+
+// VADD / VMUL / VSUM : boucles simples dans l'ordre croissant, que le compilateur C
+// vectorise lui-même
+static void traduire_vecteur(Traduction *t, const InstructionDecodee *instr) {
+    char dest[192], src[192];
+    traduire_plage(t, &instr->src, "n", src, sizeof(src));
+
+    if (instr->opcode == OPC_VSUM) {
+        OperandeC o;
+        AccesC a;
+        traduire_operande(t, &instr->dest, &o);
+        if (!est_modifiable(&o)) {
+            fprintf(t->out, "    ;\n");
+            return;
+        }
+        preparer(&o, "d", &a);
+        fprintf(t->out, "    { int n = cx; %sif (n > 0%s%s) { int *s = %s; if (s) { unsigned somme = 0; for (int k = 0; k < n; k++) somme += (unsigned)s[k]; %s = (int)somme; } } }\n",
+                a.decl, a.cond[0] ? " && " : "", a.cond, src, a.expr);
+        return;
+    }
+
+    const char *op = instr->opcode == OPC_VMUL ? "*" : "+";
+    traduire_plage(t, &instr->dest, "n", dest, sizeof(dest));
+    if (instr->src.mode == MODE_IMMEDIAT || instr->src.mode == MODE_REGISTRE) {
+        OperandeC o;
+        traduire_operande(t, &instr->src, &o);
+        if (o.genre != OPC_C_VALEUR) {
+            fprintf(t->out, "    ;\n");
+            return;
+        }
+        fprintf(t->out, "    { int n = cx; if (n > 0) { unsigned x = (unsigned)%s; int *d = %s; if (d) for (int k = 0; k < n; k++) d[k] = (int)((unsigned)d[k] %s x); } }\n",
+                o.texte, dest, op);
+    } else {
+        fprintf(t->out, "    { int n = cx; if (n > 0) { int *d = %s; int *s = %s; if (d && s) for (int k = 0; k < n; k++) d[k] = (int)((unsigned)d[k] %s (unsigned)s[k]); } }\n",
+                dest, src, op);
+    }
+}
+
+// XCHG / CMPXCHG / XADD : le programme C n'a qu'un cœur, les instructions atomiques y sont
+// de simples lectures-écritures (mêmes résultats qu'execute_decoded)
+static void traduire_atomique(Traduction *t, const InstructionDecodee *instr) {
+    OperandeC d, s;
+    traduire_operande(t, &instr->dest, &d);
+    traduire_operande(t, &instr->src, &s);
+    int xchg = instr->opcode == OPC_XCHG;
+    if (!est_modifiable(&d) || s.genre == OPC_C_ABSENT || (xchg && !est_modifiable(&s))) {
+        fprintf(t->out, "    ;\n");
+        return;
+    }
+
+    AccesC ad, as;
+    char cond[24], corps[640];
+    preparer(&d, "d", &ad);
+    preparer(&s, "s", &as);
+    if (xchg) {
+        snprintf(corps, sizeof(corps), "int x = %s; %s = %s; %s = x;", ad.expr, ad.expr, as.expr, as.expr);
+    } else if (instr->opcode == OPC_XADD) {
+        if (est_modifiable(&s)) {
+            snprintf(corps, sizeof(corps), "int x = %s; %s = (int)((unsigned)x + (unsigned)%s); %s = x;",
+                     ad.expr, ad.expr, as.expr, as.expr);
+        } else {
+            snprintf(corps, sizeof(corps), "%s = (int)((unsigned)%s + (unsigned)%s);", ad.expr, ad.expr, as.expr);
+        }
+    } else {
+        snprintf(corps, sizeof(corps),
+                 "int x = %s; int diff = (int)((unsigned)ax - (unsigned)x); zf = diff == 0; sf = diff < 0; "
+                 "if (diff == 0) %s = %s; else ax = x;",
+                 ad.expr, ad.expr, as.expr);
+    }
+    condition(&ad, &as, cond, sizeof(cond));
+    if (cond[0]) fprintf(t->out, "    { %s%sif (%s) { %s } }\n", ad.decl, as.decl, cond, corps);
+    else fprintf(t->out, "    { %s }\n", corps);
+}
+
+// PUSHA / POPA : un seul contrôle de bornes pour les quatre mots, comme push_all_registers
+static void traduire_pusha(Traduction *t) {
+    fprintf(t->out,
+            "    if (sp - 4 >= PILE_DEBUT && sp <= TAILLE) {\n"
+            "        sp -= 4; mem[sp + 3] = ax; mem[sp + 2] = bx; mem[sp + 1] = cx; mem[sp] = dx;\n"
+            "        for (int k = 0; k < 4; k++) present[sp + k] = 1;\n"
+            "    }\n");
+}
+
+static void traduire_popa(Traduction *t) {
+    fprintf(t->out,
+            "    if (sp >= PILE_DEBUT && sp + 4 <= TAILLE && present[sp] && present[sp + 1] && present[sp + 2] && present[sp + 3]) {\n"
+            "        dx = mem[sp]; cx = mem[sp + 1]; bx = mem[sp + 2]; ax = mem[sp + 3];\n"
+            "        for (int k = 0; k < 4; k++) liberer(sp + k);\n"
+            "        sp += 4;\n"
+            "    }\n");
+}
+
+static void traduire_instruction(Traduction *t, int32_t i) {
+    const InstructionDecodee *instr = &t->prog->code[i];
+    int opcode = superinstruction_first(instr->opcode);
+    FILE *out = t->out;
+
+    if (t->cible[i]) fprintf(out, "L_%d:\n", i);
+    const char *nom = mnemonic_name(opcode);
+    fprintf(out, "    /* %d : %s */\n", i, nom ? nom : "?");
+
+    // IP lu ou écrit : il doit valoir i + 1, comme pendant l'exécution, puis on repart de sa valeur
+    int ip_visible = instruction_reference(instr, REG_IP);
+    if (ip_visible) fprintf(out, "    ip = %d;\n", i + 1);
+
+    switch (opcode) {
+        case OPC_MOV:
+            traduire_affectation(t, instr, 0);
+            break;
+        case OPC_ADD:
+            traduire_affectation(t, instr, 1);
+            break;
+        case OPC_CMP:
+            traduire_comparaison(t, instr);
+            break;
+        case OPC_JMP:
+            traduire_saut(t, i, instr, NULL);
+            break;
+        case OPC_JZ:
+            traduire_saut(t, i, instr, "zf == 1");
+            break;
+        case OPC_JNZ:
+            traduire_saut(t, i, instr, "zf == 0");
+            break;
+        case OPC_HALT:
+            fprintf(out, "    ip = -1; goto fin;\n");
+            break;
+        case OPC_PUSH:
+            traduire_push(t, i, instr);
+            break;
+        case OPC_POP:
+            traduire_pop(t, i, instr);
+            break;
+        case OPC_PUSHA:
+            traduire_pusha(t);
+            break;
+        case OPC_POPA:
+            traduire_popa(t);
+            break;
+        case OPC_MOVS:
+        case OPC_STOS:
+        case OPC_CMPS:
+            traduire_bloc(t, instr);
+            break;
+        case OPC_VADD:
+        case OPC_VMUL:
+        case OPC_VSUM:
+            traduire_vecteur(t, instr);
+            break;
+        case OPC_XCHG:
+        case OPC_CMPXCHG:
+        case OPC_XADD:
+            traduire_atomique(t, instr);
+            break;
+        case OPC_MFENCE:
+            fprintf(out, "    ;\n");
+            break;
+        case OPC_ALLOC:
+            // L'espace libéré par FREE n'est pas rendu à la liste libre : ES est toujours
+            // pris au début du seul bloc libre, quelle que soit la stratégie (BX)
+            fprintf(out,
+                    "    if (ax <= 0 || bx < 0 || bx > 2 || ax > PILE_DEBUT - libre) {\n"
+                    "        zf = 1;\n"
+                    "    } else {\n"
+                    "        es_debut = libre; es_taille = ax; libre += ax; es_alloue = 1;\n"
+                    "        for (int k = 0; k < es_taille; k++) { mem[es_debut + k] = 0; present[es_debut + k] = 1; }\n"
+                    "        es = es_debut; zf = 0;\n"
+                    "    }\n");
+            break;
+        case OPC_FREE:
+            fprintf(out,
+                    "    if (es != -1 && es_alloue) {\n"
+                    "        for (int k = 0; k < es_taille; k++) liberer(es_debut + k);\n"
+                    "        es_alloue = 0; es = -1;\n"
+                    "    }\n");
+            break;
+        default:
+            fprintf(out, "    ip = %d; goto echec;\n", i + 1);
+            t->echec = 1;
+            break;
+    }
+
+    if (ip_visible) {
+        fprintf(out, "    goto repartir;\n");
+        t->repartir = 1;
+    }
+}
+
+// Valeurs initiales de DS, plage par plage (les répétitions DUP restent des boucles)
+static void traduire_donnees(const Traduction *t) {
+    const Programme *prog = t->prog;
+    FILE *out = t->out;
+
+    fprintf(out, "static const int valeurs[%d] = {", prog->valeur_count > 0 ? prog->valeur_count : 1);
+    for (int32_t k = 0; k < prog->valeur_count; k++) {
+        char v[24];
+        entier_c(v, sizeof(v), prog->valeurs[k]);
+        fprintf(out, "%s%s%s", k % 16 == 0 ? "\n    " : "", v, k + 1 < prog->valeur_count ? ", " : "");
+    }
+    fprintf(out, "%s\n};\n\n", prog->valeur_count > 0 ? "" : "0");
+
+    fprintf(out, "static void charger_donnees(void) {\n");
+    fprintf(out, "    (void)valeurs;\n");
+    for (int32_t k = 0; k < prog->plage_count; k++) {
+        const PlageDonnees *p = &prog->plages[k];
+        if (p->indice >= 0) {
+            fprintf(out, "    for (int k = 0; k < %d; k++) mem[%d + k] = valeurs[%d + k];\n",
+                    p->longueur, p->adresse, p->indice);
+        } else {
+            char v[24];
+            entier_c(v, sizeof(v), p->valeur);
+            fprintf(out, "    for (int k = 0; k < %d; k++) mem[%d + k] = %s;\n", p->longueur, p->adresse, v);
+        }
+    }
+    fprintf(out, "    for (int k = 0; k < DS_TAILLE; k++) present[k] = 1;\n");
+    fprintf(out, "}\n\n");
+}
+
+int transpile_program(const Programme *prog, int memory_size, FILE *out) {
+    if (!prog || !out) {
+        fprintf(stderr, "transpile_program: paramètres invalides\n");
+        return -1;
+    }
+    if (memory_size < STACK_SIZE + prog->data_size + prog->code_count) {
+        fprintf(stderr, "transpile_program: mémoire trop petite (%d cases)\n", memory_size);
+        return -1;
+    }
+
+    int32_t n = prog->code_count;
+    Traduction t;
+    memset(&t, 0, sizeof(t));
+    t.out = out;
+    t.prog = prog;
+    t.memory_size = memory_size;
+    t.cible = calloc(n > 0 ? n : 1, 1);
+    if (!t.cible) return -1;
+
+    // Labels nécessaires : cibles immédiates, ou tous si IP peut être calculé
+    int ip_calcule = 0;
+    t.ds_statique = 1;
+    for (int32_t i = 0; i < n; i++) {
+        const InstructionDecodee *instr = &prog->code[i];
+        int opcode = superinstruction_first(instr->opcode);
+        if (opcode == OPC_JMP || opcode == OPC_JZ || opcode == OPC_JNZ) {
+            if (instr->dest.mode == MODE_IMMEDIAT) {
+                if (instr->dest.valeur >= 0 && instr->dest.valeur < n) t.cible[instr->dest.valeur] = 1;
+            } else {
+                ip_calcule = 1;
+            }
+        }
+        if (instruction_reference(instr, REG_IP)) ip_calcule = 1;
+        // SP modifiable par le programme : POP peut alors libérer une case de DS
+        if (instruction_reference(instr, REG_SP)) t.ds_statique = 0;
+        if (opcode >= OPC_MOVS && opcode <= OPC_VSUM) t.blocs = 1;
+    }
+    if (ip_calcule) memset(t.cible, 1, n > 0 ? n : 1);
+
+    fprintf(out, "/* Généré par transpile_program : %d instructions, DS = %d cases, mémoire = %d cases */\n",
+            n, prog->data_size, memory_size);
+    fprintf(out, "#include <stdio.h>\n");
+    if (t.blocs) fprintf(out, "#include <string.h>\n");
+    fprintf(out, "\n");
+    fprintf(out, "#define TAILLE %d\n", memory_size);
+    fprintf(out, "#define DS_TAILLE %d\n", prog->data_size);
+    fprintf(out, "#define CS_TAILLE %d\n", n);
+    fprintf(out, "#define TAILLE_PILE %d\n", STACK_SIZE);
+    fprintf(out, "#define PILE_DEBUT (TAILLE - TAILLE_PILE)\n\n");
+    fprintf(out, "static int mem[TAILLE];\n");
+    fprintf(out, "static unsigned char present[TAILLE];  /* case non NULL dans le MemoryHandler */\n\n");
+    fprintf(out, "static int *cellule(int a) {\n"
+                 "    return a >= 0 && a < TAILLE && present[a] ? &mem[a] : NULL;\n"
+                 "}\n\n");
+    fprintf(out, "static int *cellule_segment(int debut, int taille, int offset) {\n"
+                 "    return offset >= 0 && offset < taille ? cellule(debut + offset) : NULL;\n"
+                 "}\n\n");
+    fprintf(out, "static void liberer(int a) {\n"
+                 "    if (a >= 0 && a < TAILLE) present[a] = 0;\n"
+                 "}\n\n");
+    if (t.blocs) {
+        fprintf(out, "static int *plage(int debut, int taille, int offset, int n) {\n"
+                     "    if (offset < 0 || offset > taille - n) return NULL;\n"
+                     "    for (int k = 0; k < n; k++) if (!present[debut + offset + k]) return NULL;\n"
+                     "    return &mem[debut + offset];\n"
+                     "}\n\n");
+    }
+    traduire_donnees(&t);
+
+    fprintf(out, "int main(void) {\n");
+    fprintf(out, "    int ax = 0, bx = 0, cx = 0, dx = 0, ip = 0, zf = 0, sf = 0, es = -1, sp = TAILLE, bp = TAILLE;\n");
+    fprintf(out, "    int es_debut = 0, es_taille = 0, es_alloue = 0, libre = DS_TAILLE + CS_TAILLE;\n");
+    fprintf(out, "    int code = 0;\n");
+    fprintf(out, "    charger_donnees();\n\n");
+
+    for (int32_t i = 0; i < n; i++) traduire_instruction(&t, i);
+    fprintf(out, "    ip = %d;\n    goto fin;\n\n", n);
+
+    if (t.repartir) {
+        fprintf(out, "repartir:\n    switch (ip) {\n");
+        for (int32_t i = 0; i < n; i++) fprintf(out, "        case %d: goto L_%d;\n", i, i);
+        fprintf(out, "        default: goto fin;\n    }\n\n");
+    }
+    if (t.echec) {
+        fprintf(out, "echec:\n"
+                     "    fprintf(stderr, \"run_decoded_program: échec exécution à IP=%%d\\n\", ip - 1);\n"
+                     "    code = 1;\n\n");
+    }
+
+    // État final au format de run_program
+    fprintf(out, "fin:\n");
+    fprintf(out, "    printf(\"\\n=== État final du CPU ===\\n\\n\");\n");
+    fprintf(out, "    if (DS_TAILLE > 0) {\n"
+                 "        printf(\"=== Segment DS (start=0, size=%%d) ===\\n\", DS_TAILLE);\n"
+                 "        for (int k = 0; k < DS_TAILLE; k++) {\n"
+                 "            if (present[k]) printf(\"  [%%2d] = %%d\\n\", k, mem[k]);\n"
+                 "            else printf(\"  [%%2d] = NULL\\n\", k);\n"
+                 "        }\n"
+                 "        printf(\"\\n\");\n"
+                 "    } else {\n"
+                 "        printf(\"Segment DS non alloué.\\n\\n\");\n"
+                 "    }\n");
+    fprintf(out, "    printf(\"=== Registres ===\\n\");\n");
+    for (int r = REG_AX; r <= REG_ES; r++) {
+        fprintf(out, "    printf(\"  %s = %%d\\n\", %s);\n", NOMS_REGISTRES[r], REGISTRES_C[r]);
+    }
+    fprintf(out, "    printf(\"\\n\");\n");
+    fprintf(out, "    (void)sp; (void)bp; (void)es_debut; (void)es_taille; (void)es_alloue; (void)libre;\n");
+    fprintf(out, "    (void)cellule_segment; (void)liberer;\n");
+    fprintf(out, "    return code;\n}\n");
+
+    free(t.cible);
+    return ferror(out) ? -1 : 0;
+}
+
+int transpile_parser_result(ParserResult *result, int memory_size, FILE *out) {
+    Programme *prog = decode_program(result);
+    if (!prog) {
+        fprintf(stderr, "transpile_parser_result: décodage impossible\n");
+        return -1;
+    }
+    if (memory_size == 0) memory_size = prog->data_size + prog->code_count + STACK_SIZE;
+    int rc = transpile_program(prog, memory_size, out);
+    free_program(prog);
+    return rc;
+}
+
+int transpile_file(const char *source, const char *sortie, int memory_size) {
+    ParserResult *result = parse(source);
+    if (!result) return -1;
+
+    FILE *f = fopen(sortie, "w");
+    if (!f) {
+        perror("transpile_file: ouverture de la sortie");
+        free_parser_result(result);
+        return -1;
+    }
+    int rc = transpile_parser_result(result, memory_size, f);
+    if (fclose(f) != 0) rc = -1;
+    free_parser_result(result);
+    return rc;
+}
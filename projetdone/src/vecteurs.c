@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "../include/vecteurs.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VECTEURS_X86 1
+#include <immintrin.h>
+#endif
+
+static NiveauVecteurs niveau_force = VECTEURS_AUTO;
+
+// Meilleur niveau du processeur ; __builtin_cpu_supports lit le résultat de CPUID
+// relevé au démarrage, l'appel ne coûte qu'une lecture
+static NiveauVecteurs detecter(void) {
+#ifdef VECTEURS_X86
+    if (__builtin_cpu_supports("avx2")) return VECTEURS_AVX2;
+    if (__builtin_cpu_supports("sse2")) return VECTEURS_SSE2;
+#endif
+    return VECTEURS_SCALAIRE;
+}
+
+int vector_set_level(NiveauVecteurs niveau) {
+    if (niveau != VECTEURS_AUTO && niveau > detecter()) {
+        fprintf(stderr, "vector_set_level: niveau %s indisponible\n", vector_level_name(niveau));
+        return -1;
+    }
+    niveau_force = niveau;
+    return 0;
+}
+
+NiveauVecteurs vector_level(void) {
+    return niveau_force != VECTEURS_AUTO ? niveau_force : detecter();
+}
+
+const char *vector_level_name(NiveauVecteurs niveau) {
+    switch (niveau) {
+        case VECTEURS_SCALAIRE: return "scalaire";
+        case VECTEURS_SSE2:     return "sse2";
+        case VECTEURS_AVX2:     return "avx2";
+        default:                return "auto";
+    }
+}
+
+// dest commence à l'intérieur de src : une écriture serait relue par la suite de la boucle,
+// le calcul par blocs donnerait un autre résultat que la boucle scalaire
+static int recouvrement_avant(const int32_t *dest, const int32_t *src, int n) {
+    uintptr_t d = (uintptr_t)dest, s = (uintptr_t)src;
+    return d > s && d < s + sizeof(int32_t) * (size_t)n;
+}
+
+// -----------------------------------
+// Noyaux scalaires (et fin des boucles vectorielles)
+// -----------------------------------
+
+static void add_scalaire(int32_t *dest, const int32_t *src, int k, int n) {
+    for (; k < n; k++) dest[k] = (int32_t)((uint32_t)dest[k] + (uint32_t)src[k]);
+}
+
+static void add_valeur_scalaire(int32_t *dest, int32_t valeur, int k, int n) {
+    for (; k < n; k++) dest[k] = (int32_t)((uint32_t)dest[k] + (uint32_t)valeur);
+}
+
+static void mul_scalaire(int32_t *dest, const int32_t *src, int k, int n) {
+    for (; k < n; k++) dest[k] = (int32_t)((uint32_t)dest[k] * (uint32_t)src[k]);
+}
+
+static void mul_valeur_scalaire(int32_t *dest, int32_t valeur, int k, int n) {
+    for (; k < n; k++) dest[k] = (int32_t)((uint32_t)dest[k] * (uint32_t)valeur);
+}
+
+static uint32_t sum_scalaire(const int32_t *src, int k, int n) {
+    uint32_t somme = 0;
+    for (; k < n; k++) somme += (uint32_t)src[k];
+    return somme;
+}
+
+#ifdef VECTEURS_X86
+
+// -----------------------------------
+// SSE2 : 4 mots ; SSE2 n'a pas de produit 32 bits, il est recomposé à partir de deux
+// produits 32 x 32 -> 64 (mots pairs, puis mots impairs)
+// -----------------------------------
+
+__attribute__((target("sse2")))
+static inline __m128i mul32_sse2(__m128i a, __m128i b) {
+    __m128i pairs = _mm_mul_epu32(a, b);
+    __m128i impairs = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(pairs, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(impairs, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+__attribute__((target("sse2")))
+static void add_sse2(int32_t *dest, const int32_t *src, int n) {
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(dest + k));
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + k));
+        _mm_storeu_si128((__m128i *)(dest + k), _mm_add_epi32(d, s));
+    }
+    add_scalaire(dest, src, k, n);
+}
+
+__attribute__((target("sse2")))
+static void add_valeur_sse2(int32_t *dest, int32_t valeur, int n) {
+    __m128i v = _mm_set1_epi32(valeur);
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(dest + k));
+        _mm_storeu_si128((__m128i *)(dest + k), _mm_add_epi32(d, v));
+    }
+    add_valeur_scalaire(dest, valeur, k, n);
+}
+
+__attribute__((target("sse2")))
+static void mul_sse2(int32_t *dest, const int32_t *src, int n) {
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(dest + k));
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + k));
+        _mm_storeu_si128((__m128i *)(dest + k), mul32_sse2(d, s));
+    }
+    mul_scalaire(dest, src, k, n);
+}
+
+__attribute__((target("sse2")))
+static void mul_valeur_sse2(int32_t *dest, int32_t valeur, int n) {
+    __m128i v = _mm_set1_epi32(valeur);
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(dest + k));
+        _mm_storeu_si128((__m128i *)(dest + k), mul32_sse2(d, v));
+    }
+    mul_valeur_scalaire(dest, valeur, k, n);
+}
+
+__attribute__((target("sse2")))
+static uint32_t sum_sse2(const int32_t *src, int n) {
+    __m128i acc = _mm_setzero_si128();
+    int k = 0;
+    for (; k + 4 <= n; k += 4) acc = _mm_add_epi32(acc, _mm_loadu_si128((const __m128i *)(src + k)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (uint32_t)_mm_cvtsi128_si32(acc) + sum_scalaire(src, k, n);
+}
+
+// -----------------------------------
+// AVX2 : 8 mots
+// -----------------------------------
+
+__attribute__((target("avx2")))
+static void add_avx2(int32_t *dest, const int32_t *src, int n) {
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dest + k));
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + k));
+        _mm256_storeu_si256((__m256i *)(dest + k), _mm256_add_epi32(d, s));
+    }
+    add_scalaire(dest, src, k, n);
+}
+
+__attribute__((target("avx2")))
+static void add_valeur_avx2(int32_t *dest, int32_t valeur, int n) {
+    __m256i v = _mm256_set1_epi32(valeur);
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dest + k));
+        _mm256_storeu_si256((__m256i *)(dest + k), _mm256_add_epi32(d, v));
+    }
+    add_valeur_scalaire(dest, valeur, k, n);
+}
+
+__attribute__((target("avx2")))
+static void mul_avx2(int32_t *dest, const int32_t *src, int n) {
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dest + k));
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + k));
+        _mm256_storeu_si256((__m256i *)(dest + k), _mm256_mullo_epi32(d, s));
+    }
+    mul_scalaire(dest, src, k, n);
+}
+
+__attribute__((target("avx2")))
+static void mul_valeur_avx2(int32_t *dest, int32_t valeur, int n) {
+    __m256i v = _mm256_set1_epi32(valeur);
+    int k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dest + k));
+        _mm256_storeu_si256((__m256i *)(dest + k), _mm256_mullo_epi32(d, v));
+    }
+    mul_valeur_scalaire(dest, valeur, k, n);
+}
+
+__attribute__((target("avx2")))
+static uint32_t sum_avx2(const int32_t *src, int n) {
+    __m256i acc = _mm256_setzero_si256();
+    int k = 0;
+    for (; k + 8 <= n; k += 8) acc = _mm256_add_epi32(acc, _mm256_loadu_si256((const __m256i *)(src + k)));
+    __m128i moitie = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    moitie = _mm_add_epi32(moitie, _mm_shuffle_epi32(moitie, _MM_SHUFFLE(1, 0, 3, 2)));
+    moitie = _mm_add_epi32(moitie, _mm_shuffle_epi32(moitie, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (uint32_t)_mm_cvtsi128_si32(moitie) + sum_scalaire(src, k, n);
+}
+
+#endif /* VECTEURS_X86 */
+
+// -----------------------------------
+// Points d'entrée : choix du noyau selon le niveau
+// -----------------------------------
+
+void vector_add(int32_t *dest, const int32_t *src, int n) {
+    if (n <= 0) return;
+    NiveauVecteurs niveau = recouvrement_avant(dest, src, n) ? VECTEURS_SCALAIRE : vector_level();
+#ifdef VECTEURS_X86
+    if (niveau == VECTEURS_AVX2) { add_avx2(dest, src, n); return; }
+    if (niveau == VECTEURS_SSE2) { add_sse2(dest, src, n); return; }
+#else
+    (void)niveau;
+#endif
+    add_scalaire(dest, src, 0, n);
+}
+
+void vector_add_scalar(int32_t *dest, int32_t valeur, int n) {
+    if (n <= 0) return;
+#ifdef VECTEURS_X86
+    NiveauVecteurs niveau = vector_level();
+    if (niveau == VECTEURS_AVX2) { add_valeur_avx2(dest, valeur, n); return; }
+    if (niveau == VECTEURS_SSE2) { add_valeur_sse2(dest, valeur, n); return; }
+#endif
+    add_valeur_scalaire(dest, valeur, 0, n);
+}
+
+void vector_mul(int32_t *dest, const int32_t *src, int n) {
+    if (n <= 0) return;
+    NiveauVecteurs niveau = recouvrement_avant(dest, src, n) ? VECTEURS_SCALAIRE : vector_level();
+#ifdef VECTEURS_X86
+    if (niveau == VECTEURS_AVX2) { mul_avx2(dest, src, n); return; }
+    if (niveau == VECTEURS_SSE2) { mul_sse2(dest, src, n); return; }
+#else
+    (void)niveau;
+#endif
+    mul_scalaire(dest, src, 0, n);
+}
+
+void vector_mul_scalar(int32_t *dest, int32_t valeur, int n) {
+    if (n <= 0) return;
+#ifdef VECTEURS_X86
+    NiveauVecteurs niveau = vector_level();
+    if (niveau == VECTEURS_AVX2) { mul_valeur_avx2(dest, valeur, n); return; }
+    if (niveau == VECTEURS_SSE2) { mul_valeur_sse2(dest, valeur, n); return; }
+#endif
+    mul_valeur_scalaire(dest, valeur, 0, n);
+}
+
+int32_t vector_sum(const int32_t *src, int n) {
+    if (n <= 0) return 0;
+#ifdef VECTEURS_X86
+    NiveauVecteurs niveau = vector_level();
+    if (niveau == VECTEURS_AVX2) return (int32_t)sum_avx2(src, n);
+    if (niveau == VECTEURS_SSE2) return (int32_t)sum_sse2(src, n);
+#endif
+    return (int32_t)sum_scalaire(src, 0, n);
+}
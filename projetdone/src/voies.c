@@ -0,0 +1,405 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#include "../include/voies.h"
+#include "../include/interpreteur.h"
+#include "../include/vecteurs.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VOIES_X86 1
+#endif
+
+#define LIGNE_CACHE 64
+
+// État d'un groupe, rangé par voie : registres[r][v] est le registre r de la voie v, et la
+// case a de DS de la voie v est ds[a * largeur + v]. Les masques valent -1 (voie concernée)
+// ou 0, pour être appliqués par des ET / OU sans branchement.
+typedef struct {
+    _Alignas(LIGNE_CACHE) int32_t registres[NB_REGISTRES][VOIES_MAX];
+    _Alignas(LIGNE_CACHE) int32_t faute[VOIES_MAX];   // -1 : voie arrêtée par une faute
+    long dispatchs[VOIES_MAX];
+    int32_t *ds;
+    int32_t data_size;
+    long pas;
+} Groupe;
+
+static double maintenant(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// -----------------------------------
+// Sous-ensemble exécutable par voies
+// -----------------------------------
+
+// Registre nommé par [XX] : les autres (IP, SP, ES...) ne sont pas tenus par voie
+static int registre_voie(int index) {
+    return (index >= REG_AX && index <= REG_DX) || index == REG_ZF || index == REG_SF;
+}
+
+static int operande_accepte(const Operande *op, int32_t data_size) {
+    switch (op->mode) {
+        case MODE_AUCUN:
+        case MODE_IMMEDIAT:
+            return 1;
+        case MODE_REGISTRE:
+        case MODE_INDIRECT:
+            return registre_voie(op->valeur);
+        case MODE_DIRECT:
+            return op->valeur >= 0 && op->valeur < data_size;
+        case MODE_SEGMENT:
+            return op->segment == SEG_DS && registre_voie(op->valeur);
+        default:
+            return 0;
+    }
+}
+
+int lanes_supported(const Programme *prog) {
+    if (!prog) return 0;
+    for (int32_t i = 0; i < prog->code_count; i++) {
+        const InstructionDecodee *instr = &prog->code[i];
+        switch (instr->opcode) {
+            case OPC_MOV: case OPC_ADD: case OPC_CMP:
+            case OPC_JMP: case OPC_JZ: case OPC_JNZ: case OPC_HALT:
+            case OPC_CMP_JZ: case OPC_CMP_JNZ: case OPC_MOV_ADD:
+                break;
+            default:
+                return 0;
+        }
+        // La seconde moitié d'une superinstruction est l'instruction suivante, vérifiée ensuite
+        if (EST_SUPERINSTRUCTION(instr->opcode) && i + 1 >= prog->code_count) return 0;
+        if (!operande_accepte(&instr->dest, prog->data_size) || !operande_accepte(&instr->src, prog->data_size)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// -----------------------------------
+// Opérations sur une ligne de voies. `largeur` est une constante dans chaque copie de
+// executer_groupe : les boucles ont un nombre de tours fixe et sont vectorisées.
+// -----------------------------------
+
+// Valeurs d'un opérande pour chaque voie ; ok[v] = 0 si l'opérande ne désigne rien pour v
+static inline __attribute__((always_inline))
+void lire(Groupe *g, const Operande *op, int32_t *x, int32_t *ok, const int largeur) {
+    const int32_t *ligne;
+    switch (op->mode) {
+        case MODE_IMMEDIAT:
+            for (int v = 0; v < largeur; v++) x[v] = op->valeur, ok[v] = -1;
+            return;
+        case MODE_REGISTRE:
+        case MODE_INDIRECT:
+            ligne = g->registres[op->valeur];
+            break;
+        case MODE_DIRECT:
+            ligne = g->ds + (size_t)op->valeur * largeur;
+            break;
+        case MODE_SEGMENT: {
+            const int32_t *offsets = g->registres[op->valeur];
+            for (int v = 0; v < largeur; v++) {
+                int dedans = (uint32_t)offsets[v] < (uint32_t)g->data_size;
+                x[v] = dedans ? g->ds[(size_t)offsets[v] * largeur + v] : 0;
+                ok[v] = -dedans;
+            }
+            return;
+        }
+        default:
+            for (int v = 0; v < largeur; v++) x[v] = 0, ok[v] = 0;
+            return;
+    }
+    for (int v = 0; v < largeur; v++) x[v] = ligne[v], ok[v] = -1;
+}
+
+// Écrit x dans les voies de `masque` ; une destination qui ne désigne rien est ignorée
+// (MOV / ADD sans effet, comme `affecter`)
+static inline __attribute__((always_inline))
+void ecrire(Groupe *g, const Operande *op, const int32_t *x, const int32_t *masque, const int largeur) {
+    int32_t *ligne;
+    switch (op->mode) {
+        case MODE_REGISTRE:
+        case MODE_INDIRECT:
+            ligne = g->registres[op->valeur];
+            break;
+        case MODE_DIRECT:
+            ligne = g->ds + (size_t)op->valeur * largeur;
+            break;
+        case MODE_SEGMENT: {
+            const int32_t *offsets = g->registres[op->valeur];
+            for (int v = 0; v < largeur; v++) {
+                if (masque[v] && (uint32_t)offsets[v] < (uint32_t)g->data_size) {
+                    g->ds[(size_t)offsets[v] * largeur + v] = x[v];
+                }
+            }
+            return;
+        }
+        default:
+            return;
+    }
+    for (int v = 0; v < largeur; v++) ligne[v] = (x[v] & masque[v]) | (ligne[v] & ~masque[v]);
+}
+
+// MOV (ajouter == 0) ou ADD : la destination n'est écrite que si les deux opérandes existent
+static inline __attribute__((always_inline))
+void affecter(Groupe *g, const InstructionDecodee *instr, const int32_t *actif, int ajouter, const int largeur) {
+    int32_t x[VOIES_MAX], ok[VOIES_MAX], d[VOIES_MAX], ok_d[VOIES_MAX], masque[VOIES_MAX];
+    lire(g, &instr->src, x, ok, largeur);
+    if (ajouter) {
+        lire(g, &instr->dest, d, ok_d, largeur);
+        for (int v = 0; v < largeur; v++) {
+            x[v] = (int32_t)((uint32_t)d[v] + (uint32_t)x[v]);
+            ok[v] &= ok_d[v];
+        }
+    }
+    for (int v = 0; v < largeur; v++) masque[v] = actif[v] & ok[v];
+    ecrire(g, &instr->dest, x, masque, largeur);
+}
+
+// CMP : ZF et SF sont calculés tout de suite (ils sont dans des lignes, les différer ne
+// ferait rien gagner)
+static inline __attribute__((always_inline))
+void comparer(Groupe *g, const InstructionDecodee *instr, const int32_t *actif, const int largeur) {
+    int32_t a[VOIES_MAX], ok_a[VOIES_MAX], b[VOIES_MAX], ok_b[VOIES_MAX];
+    lire(g, &instr->dest, a, ok_a, largeur);
+    lire(g, &instr->src, b, ok_b, largeur);
+    int32_t *zf = g->registres[REG_ZF], *sf = g->registres[REG_SF];
+    for (int v = 0; v < largeur; v++) {
+        int32_t m = actif[v] & ok_a[v] & ok_b[v];
+        int32_t diff = (int32_t)((uint32_t)a[v] - (uint32_t)b[v]);
+        zf[v] = ((diff == 0) & m) | (zf[v] & ~m);
+        sf[v] = ((diff < 0) & m) | (sf[v] & ~m);
+    }
+}
+
+// JMP (condition < 0), JZ (1) ou JNZ (0). Une voie qui doit sauter vers une cible
+// illisible est en faute, sauf pour JMP qui est alors sans effet (comme `executer`).
+static inline __attribute__((always_inline))
+void sauter(Groupe *g, const InstructionDecodee *instr, const int32_t *actif, int condition, const int largeur) {
+    int32_t cible[VOIES_MAX], ok[VOIES_MAX];
+    lire(g, &instr->dest, cible, ok, largeur);
+    int32_t *ip = g->registres[REG_IP];
+    const int32_t *zf = g->registres[REG_ZF];
+    for (int v = 0; v < largeur; v++) {
+        int32_t saute = condition < 0 ? actif[v] : actif[v] & -(zf[v] == condition);
+        int32_t m = saute & ok[v];
+        ip[v] = (cible[v] & m) | (ip[v] & ~m);
+        if (condition >= 0) g->faute[v] |= saute & ~ok[v];
+    }
+}
+
+// Exécute le groupe jusqu'à ce que toutes ses voies soient sorties du code ou en faute
+static inline __attribute__((always_inline))
+void executer_groupe(Groupe *g, const Programme *prog, const int largeur) {
+    int32_t *ip = g->registres[REG_IP];
+    const int32_t fin = prog->code_count;
+
+    for (;;) {
+        // Instruction de plus petit IP parmi les voies vivantes : les voies en retard
+        // rattrapent les autres, qui les attendent au point de jonction
+        int32_t pc = INT32_MAX;
+        for (int v = 0; v < largeur; v++) {
+            int vivante = !g->faute[v] & ((uint32_t)ip[v] < (uint32_t)fin);
+            int32_t candidat = vivante ? ip[v] : INT32_MAX;
+            pc = candidat < pc ? candidat : pc;
+        }
+        if (pc == INT32_MAX) break;
+
+        int32_t actif[VOIES_MAX];
+        for (int v = 0; v < largeur; v++) {
+            actif[v] = -((ip[v] == pc) & !g->faute[v]);
+            ip[v] -= actif[v];                       // IP avance avant l'exécution
+            g->dispatchs[v] -= actif[v];
+        }
+        g->pas++;
+
+        const InstructionDecodee *instr = &prog->code[pc];
+        switch (instr->opcode) {
+            case OPC_MOV:
+                affecter(g, instr, actif, 0, largeur);
+                break;
+            case OPC_ADD:
+                affecter(g, instr, actif, 1, largeur);
+                break;
+            case OPC_CMP:
+                comparer(g, instr, actif, largeur);
+                break;
+            case OPC_JMP:
+                sauter(g, instr, actif, -1, largeur);
+                break;
+            case OPC_JZ:
+            case OPC_JNZ:
+                sauter(g, instr, actif, instr->opcode == OPC_JZ, largeur);
+                break;
+            case OPC_HALT:
+                for (int v = 0; v < largeur; v++) ip[v] = (-1 & actif[v]) | (ip[v] & ~actif[v]);
+                break;
+            // Superinstructions : IP avance entre les deux moitiés, comme dans `executer`
+            case OPC_CMP_JZ:
+            case OPC_CMP_JNZ:
+                comparer(g, instr, actif, largeur);
+                for (int v = 0; v < largeur; v++) ip[v] -= actif[v];
+                sauter(g, instr + 1, actif, instr->opcode == OPC_CMP_JZ, largeur);
+                break;
+            case OPC_MOV_ADD:
+                affecter(g, instr, actif, 0, largeur);
+                for (int v = 0; v < largeur; v++) ip[v] -= actif[v];
+                affecter(g, instr + 1, actif, 1, largeur);
+                break;
+            default:
+                // Exclu par lanes_supported
+                for (int v = 0; v < largeur; v++) g->faute[v] |= actif[v];
+                break;
+        }
+    }
+}
+
+static void executer_8(Groupe *g, const Programme *prog) { executer_groupe(g, prog, 8); }
+static void executer_16(Groupe *g, const Programme *prog) { executer_groupe(g, prog, 16); }
+
+#ifdef VOIES_X86
+__attribute__((target("avx2")))
+static void executer_8_avx2(Groupe *g, const Programme *prog) { executer_groupe(g, prog, 8); }
+__attribute__((target("avx2")))
+static void executer_16_avx2(Groupe *g, const Programme *prog) { executer_groupe(g, prog, 16); }
+#endif
+
+// -----------------------------------
+// Lots de jeux
+// -----------------------------------
+
+// Programme hors du sous-ensemble : un CPU par jeu, sur un seul thread
+static int executer_scalaire(const Programme *prog, const int32_t *entrees, int32_t nb_entrees, int nb_jeux,
+                             ResultatLot *resultats, BilanVoies *bilan) {
+    TacheLot *taches = calloc((size_t)(nb_jeux > 0 ? nb_jeux : 1), sizeof(TacheLot));
+    if (!taches) return -1;
+    for (int j = 0; j < nb_jeux; j++) {
+        taches[j].prog = prog;
+        taches[j].entrees = nb_entrees > 0 ? entrees + (size_t)j * nb_entrees : NULL;
+        taches[j].nb_entrees = nb_entrees;
+    }
+    OptionsLot options = { 1, -1, 1 };
+    BilanLot bilan_lot;
+    int rc = batch_run(taches, nb_jeux, &options, resultats, &bilan_lot);
+    free(taches);
+    if (rc == 0 && bilan) {
+        bilan->scalaire = 1;
+        bilan->nb_echecs = bilan_lot.nb_echecs;
+        bilan->dispatchs = bilan_lot.dispatchs;
+        bilan->pas = bilan_lot.dispatchs;
+        bilan->occupation = 1.0 / bilan->largeur;
+        bilan->duree = bilan_lot.duree;
+    }
+    return rc;
+}
+
+int lanes_run(const Programme *prog, int largeur, const int32_t *entrees, int32_t nb_entrees, int nb_jeux,
+              ResultatLot *resultats, BilanVoies *bilan) {
+    if (largeur == 0) largeur = VOIES_MAX;
+    if (!prog || !resultats || nb_jeux < 0 || (largeur != 8 && largeur != 16) ||
+        nb_entrees < 0 || nb_entrees > prog->data_size || (nb_entrees > 0 && !entrees)) {
+        fprintf(stderr, "lanes_run: paramètres invalides.\n");
+        return -1;
+    }
+    if (bilan) {
+        memset(bilan, 0, sizeof(*bilan));
+        bilan->largeur = largeur;
+        bilan->nb_jeux = nb_jeux;
+    }
+    memset(resultats, 0, sizeof(ResultatLot) * (size_t)nb_jeux);
+    double debut = maintenant();
+
+    if (!lanes_supported(prog)) {
+        int rc = executer_scalaire(prog, entrees, nb_entrees, nb_jeux, resultats, bilan);
+        if (rc == 0 && bilan && bilan->duree > 0) {
+            bilan->jeux_par_seconde = nb_jeux / bilan->duree;
+            bilan->dispatchs_par_seconde = bilan->dispatchs / bilan->duree;
+        }
+        return rc;
+    }
+
+    // Registres de départ (SP, ES... compris) et DS initial : ceux d'un CPU chargé
+    CPU *modele = cpu_init(prog->data_size + prog->code_count + STACK_SIZE);
+    if (!modele || load_program(modele, prog) != 0) {
+        cpu_destroy(modele);
+        return -1;
+    }
+    Groupe *g = aligned_alloc(LIGNE_CACHE, sizeof(Groupe));
+    size_t taille_ds = (sizeof(int32_t) * (size_t)prog->data_size * largeur + LIGNE_CACHE - 1) / LIGNE_CACHE * LIGNE_CACHE;
+    int32_t *ds = aligned_alloc(LIGNE_CACHE, taille_ds > 0 ? taille_ds : LIGNE_CACHE);
+    if (!g || !ds) {
+        free(g);
+        free(ds);
+        cpu_destroy(modele);
+        return -1;
+    }
+    const int32_t *ds_initial = modele->memory_handler->mots;
+
+    void (*executer)(Groupe *, const Programme *) = largeur == 8 ? executer_8 : executer_16;
+#ifdef VOIES_X86
+    if (vector_level() == VECTEURS_AVX2) executer = largeur == 8 ? executer_8_avx2 : executer_16_avx2;
+#endif
+
+    int nb_groupes = 0;
+    long pas = 0;
+    for (int premier = 0; premier < nb_jeux; premier += largeur) {
+        int nb = nb_jeux - premier < largeur ? nb_jeux - premier : largeur;
+        memset(g, 0, sizeof(*g));
+        g->ds = ds;
+        g->data_size = prog->data_size;
+        for (int r = 0; r < NB_REGISTRES; r++) {
+            for (int v = 0; v < largeur; v++) g->registres[r][v] = *modele->registres[r];
+        }
+        // Voies sans jeu : sorties du code dès le départ
+        for (int v = nb; v < largeur; v++) g->registres[REG_IP][v] = -1;
+        for (int32_t a = 0; a < prog->data_size; a++) {
+            for (int v = 0; v < largeur; v++) {
+                ds[(size_t)a * largeur + v] = v < nb && a < nb_entrees ? entrees[(size_t)(premier + v) * nb_entrees + a]
+                                                                       : ds_initial[a];
+            }
+        }
+
+        executer(g, prog);
+        nb_groupes++;
+        pas += g->pas;
+
+        double fin = maintenant() - debut;
+        for (int v = 0; v < nb; v++) {
+            ResultatLot *res = &resultats[premier + v];
+            res->statut = g->faute[v] ? -1 : 0;
+            for (int r = 0; r < NB_REGISTRES; r++) res->registres[r] = g->registres[r][v];
+            res->dispatchs = g->dispatchs[v];
+            res->fin = fin;
+            res->ds = malloc(sizeof(int32_t) * (size_t)(prog->data_size > 0 ? prog->data_size : 1));
+            if (!res->ds) {
+                res->statut = -1;
+                continue;
+            }
+            res->ds_taille = prog->data_size;
+            for (int32_t a = 0; a < prog->data_size; a++) res->ds[a] = ds[(size_t)a * largeur + v];
+        }
+    }
+    double duree = maintenant() - debut;
+
+    if (bilan) {
+        bilan->nb_groupes = nb_groupes;
+        bilan->pas = pas;
+        bilan->duree = duree;
+        for (int j = 0; j < nb_jeux; j++) {
+            if (resultats[j].statut != 0) bilan->nb_echecs++;
+            bilan->dispatchs += resultats[j].dispatchs;
+        }
+        if (pas > 0) bilan->occupation = (double)bilan->dispatchs / ((double)pas * largeur);
+        if (duree > 0) {
+            bilan->jeux_par_seconde = nb_jeux / duree;
+            bilan->dispatchs_par_seconde = bilan->dispatchs / duree;
+        }
+    }
+    free(ds);
+    free(g);
+    cpu_destroy(modele);
+    return 0;
+}